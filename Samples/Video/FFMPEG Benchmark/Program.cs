@@ -0,0 +1,312 @@
+﻿// FFMPEG benchmark sample application
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2006-2012
+// contacts@aforgenet.com
+//
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Drawing;
+using System.Drawing.Imaging;
+using System.Globalization;
+using System.IO;
+using System.Runtime.InteropServices;
+using AForge.Video.FFMPEG;
+
+namespace FFMPEGBenchmark
+{
+    // The application generates deterministic synthetic clips with VideoFileWriter for all
+    // supported codecs and several frame sizes, reads them back with VideoFileReader and
+    // reports encoding/decoding speed, per stage cost and managed allocations per frame.
+    //
+    // Usage: FFMPEGBenchmark [frames] [output folder] [results file]
+    //
+    // Results are written in CSV format (one line per codec/size pair) to the specified
+    // results file (results.csv in the output folder by default), so they can be compared
+    // between runs to spot regressions.
+    class Program
+    {
+        // frame sizes to test
+        private static readonly Size[] sizes = new Size[]
+        {
+            new Size( 320, 240 ),
+            new Size( 640, 480 ),
+            new Size( 1280, 720 ),
+        };
+
+        private const int frameRate = 25;
+        private const int bitRate   = 2000000;
+
+        static void Main( string[] args )
+        {
+            int    framesCount  = ( args.Length > 0 ) ? int.Parse( args[0] ) : 100;
+            string outputFolder = ( args.Length > 1 ) ? args[1] : Path.Combine( Path.GetTempPath( ), "FFMPEGBenchmark" );
+            string resultsFile  = ( args.Length > 2 ) ? args[2] : Path.Combine( outputFolder, "results.csv" );
+
+            // clips without frames can not be decoded and give no timings to average
+            if ( framesCount <= 0 )
+            {
+                Console.WriteLine( "Number of frames per clip must be greater than zero." );
+                return;
+            }
+
+            Directory.CreateDirectory( outputFolder );
+
+            // allocations are measured with the help of application domain's resource monitoring
+            AppDomain.MonitoringIsEnabled = true;
+
+            Console.WriteLine( "Frames per clip: " + framesCount );
+            Console.WriteLine( "Output folder:   " + outputFolder );
+            Console.WriteLine( );
+
+            using ( StreamWriter results = new StreamWriter( resultsFile, false ) )
+            {
+                results.WriteLine( BenchmarkResult.CsvHeader );
+
+                foreach ( VideoCodec codec in Enum.GetValues( typeof( VideoCodec ) ) )
+                {
+                    foreach ( Size size in sizes )
+                    {
+                        BenchmarkResult result = RunBenchmark( codec, size, framesCount, outputFolder );
+
+                        Console.WriteLine( result.ToString( ) );
+                        results.WriteLine( result.ToCsv( ) );
+                    }
+                }
+            }
+
+            Console.WriteLine( );
+            Console.WriteLine( "Results are saved to: " + resultsFile );
+        }
+
+        // Run encoding and decoding benchmark for the specified codec and frame size
+        private static BenchmarkResult RunBenchmark( VideoCodec codec, Size size, int framesCount, string outputFolder )
+        {
+            BenchmarkResult result = new BenchmarkResult( );
+            result.Codec  = codec;
+            result.Width  = size.Width;
+            result.Height = size.Height;
+
+            string fileName = Path.Combine( outputFolder, string.Format( "{0}_{1}x{2}.{3}",
+                codec, size.Width, size.Height, ( codec == VideoCodec.FLV1 ) ? "flv" : "avi" ) );
+
+            try
+            {
+                Encode( fileName, codec, size, framesCount, result );
+                Decode( fileName, result );
+
+                result.FileSize = new FileInfo( fileName ).Length;
+            }
+            catch ( Exception ex )
+            {
+                result.Error = ex.Message;
+            }
+
+            return result;
+        }
+
+        // Write synthetic clip measuring encoding speed
+        private static void Encode( string fileName, VideoCodec codec, Size size, int framesCount, BenchmarkResult result )
+        {
+            Bitmap frame = new Bitmap( size.Width, size.Height, PixelFormat.Format24bppRgb );
+            byte[] buffer = null;
+            Stopwatch stopwatch = new Stopwatch( );
+
+            using ( VideoFileWriter writer = new VideoFileWriter( ) )
+            {
+                writer.Open( fileName, size.Width, size.Height, frameRate, codec, bitRate );
+
+                long allocatedBefore = GetAllocatedBytes( );
+
+                for ( int i = 0; i < framesCount; i++ )
+                {
+                    // frame generation is not measured
+                    GenerateFrame( frame, i, ref buffer );
+
+                    stopwatch.Start( );
+                    writer.WriteVideoFrame( frame );
+                    stopwatch.Stop( );
+                }
+
+                stopwatch.Start( );
+                writer.Close( );
+                stopwatch.Stop( );
+
+                result.EncodeAllocatedPerFrame = (double) ( GetAllocatedBytes( ) - allocatedBefore - (long) buffer.Length ) / framesCount;
+                result.EncodeFps = framesCount / stopwatch.Elapsed.TotalSeconds;
+
+                VideoStatisticsSnapshot snapshot = writer.Statistics.GetSnapshot( );
+                result.EncodeConversionTime  = AverageMicroseconds( snapshot, VideoStage.Conversion );
+                result.EncodeMarshallingTime = AverageMicroseconds( snapshot, VideoStage.Marshalling );
+                result.EncodingTime          = AverageMicroseconds( snapshot, VideoStage.Encoding );
+            }
+
+            frame.Dispose( );
+        }
+
+        // Read the clip back measuring decoding speed
+        private static void Decode( string fileName, BenchmarkResult result )
+        {
+            Stopwatch stopwatch = new Stopwatch( );
+            int framesRead = 0;
+
+            using ( VideoFileReader reader = new VideoFileReader( ) )
+            {
+                // opening and probing the file is not measured
+                reader.Open( fileName );
+
+                long allocatedBefore = GetAllocatedBytes( );
+
+                stopwatch.Start( );
+
+                while ( true )
+                {
+                    Bitmap frame = reader.ReadVideoFrame( );
+
+                    if ( frame == null )
+                        break;
+
+                    framesRead++;
+                    frame.Dispose( );
+                }
+
+                reader.Close( );
+                stopwatch.Stop( );
+
+                result.FramesDecoded = framesRead;
+
+                if ( framesRead != 0 )
+                {
+                    result.DecodeAllocatedPerFrame = (double) ( GetAllocatedBytes( ) - allocatedBefore ) / framesRead;
+                    result.DecodeFps = framesRead / stopwatch.Elapsed.TotalSeconds;
+                }
+
+                VideoStatisticsSnapshot snapshot = reader.Statistics.GetSnapshot( );
+                result.DecodeConversionTime  = AverageMicroseconds( snapshot, VideoStage.Conversion );
+                result.DecodeMarshallingTime = AverageMicroseconds( snapshot, VideoStage.Marshalling );
+                result.DecodingTime          = AverageMicroseconds( snapshot, VideoStage.Decoding );
+            }
+        }
+
+        // Generate deterministic frame - moving gradient background with a moving box on top of it,
+        // so that encoders get both smooth areas and motion to deal with
+        private static void GenerateFrame( Bitmap frame, int index, ref byte[] buffer )
+        {
+            int width  = frame.Width;
+            int height = frame.Height;
+
+            BitmapData data = frame.LockBits( new Rectangle( 0, 0, width, height ),
+                ImageLockMode.WriteOnly, PixelFormat.Format24bppRgb );
+
+            int stride = data.Stride;
+
+            if ( ( buffer == null ) || ( buffer.Length != stride * height ) )
+            {
+                buffer = new byte[stride * height];
+            }
+
+            int boxSize = height / 4;
+            int boxX = ( index * 7 ) % ( width - boxSize );
+            int boxY = ( index * 3 ) % ( height - boxSize );
+
+            for ( int y = 0; y < height; y++ )
+            {
+                int offset = y * stride;
+
+                for ( int x = 0; x < width; x++, offset += 3 )
+                {
+                    if ( ( x >= boxX ) && ( x < boxX + boxSize ) && ( y >= boxY ) && ( y < boxY + boxSize ) )
+                    {
+                        buffer[offset]     = 32;
+                        buffer[offset + 1] = 64;
+                        buffer[offset + 2] = 224;
+                    }
+                    else
+                    {
+                        buffer[offset]     = (byte) ( x + index );
+                        buffer[offset + 1] = (byte) ( y + index * 2 );
+                        buffer[offset + 2] = (byte) ( x + y );
+                    }
+                }
+            }
+
+            Marshal.Copy( buffer, 0, data.Scan0, buffer.Length );
+            frame.UnlockBits( data );
+        }
+
+        // Get number of bytes allocated in the application domain so far
+        private static long GetAllocatedBytes( )
+        {
+            // the value is updated on garbage collection only
+            GC.Collect( );
+            return AppDomain.CurrentDomain.MonitoringTotalAllocatedMemorySize;
+        }
+
+        // Get average time of the stage in microseconds
+        private static double AverageMicroseconds( VideoStatisticsSnapshot snapshot, VideoStage stage )
+        {
+            return snapshot.Stages[(int) stage].AverageTime.Ticks / 10.0;
+        }
+    }
+
+    // Results of a single benchmark run
+    class BenchmarkResult
+    {
+        public VideoCodec Codec;
+        public int    Width;
+        public int    Height;
+        public int    FramesDecoded;
+        public long   FileSize;
+        public double EncodeFps;
+        public double DecodeFps;
+        public double EncodingTime;
+        public double EncodeConversionTime;
+        public double EncodeMarshallingTime;
+        public double DecodingTime;
+        public double DecodeConversionTime;
+        public double DecodeMarshallingTime;
+        public double EncodeAllocatedPerFrame;
+        public double DecodeAllocatedPerFrame;
+        public string Error;
+
+        public const string CsvHeader =
+            "codec,width,height,frames_decoded,file_size," +
+            "encode_fps,decode_fps," +
+            "encoding_us,encode_conversion_us,encode_marshalling_us," +
+            "decoding_us,decode_conversion_us,decode_marshalling_us," +
+            "encode_allocated_bytes_per_frame,decode_allocated_bytes_per_frame,error";
+
+        public string ToCsv( )
+        {
+            CultureInfo ci = CultureInfo.InvariantCulture;
+
+            return string.Join( ",", new string[]
+            {
+                Codec.ToString( ), Width.ToString( ci ), Height.ToString( ci ),
+                FramesDecoded.ToString( ci ), FileSize.ToString( ci ),
+                EncodeFps.ToString( "F2", ci ), DecodeFps.ToString( "F2", ci ),
+                EncodingTime.ToString( "F1", ci ), EncodeConversionTime.ToString( "F1", ci ), EncodeMarshallingTime.ToString( "F1", ci ),
+                DecodingTime.ToString( "F1", ci ), DecodeConversionTime.ToString( "F1", ci ), DecodeMarshallingTime.ToString( "F1", ci ),
+                EncodeAllocatedPerFrame.ToString( "F0", ci ), DecodeAllocatedPerFrame.ToString( "F0", ci ),
+                ( Error == null ) ? string.Empty : "\"" + Error.Replace( "\"", "'" ) + "\""
+            } );
+        }
+
+        public override string ToString( )
+        {
+            string name = string.Format( "{0,-10} {1,4}x{2,-4}", Codec, Width, Height );
+
+            if ( Error != null )
+            {
+                return name + " | failed: " + Error;
+            }
+
+            return string.Format( "{0} | encode: {1,8:F2} fps | decode: {2,8:F2} fps | conversion: {3,8:F1} / {4,8:F1} us | alloc: {5,8:F0} / {6,8:F0} B/frame",
+                name, EncodeFps, DecodeFps, EncodeConversionTime, DecodeConversionTime,
+                EncodeAllocatedPerFrame, DecodeAllocatedPerFrame );
+        }
+    }
+}
@@ -12,56 +12,129 @@
 namespace AForge
 {
     using System;
+    using System.Collections.Generic;
+    using System.Reflection;
     using System.Threading;
 
     /// <summary>
     /// The class provides support for parallel computations, paralleling loop's iterations.
     /// </summary>
-    /// 
+    ///
     /// <remarks><para>The class allows to parallel loop's iteration computing them in separate threads,
     /// what allows their simultaneous execution on multiple CPUs/cores.
-    /// </para></remarks>
+    /// </para>
+    ///
+    /// <para>Iterations of a loop are split into contiguous ranges, one for each participating thread
+    /// (the calling thread participates in computations as well). Each thread takes chunks of iterations
+    /// from its own range and, when the range is exhausted, steals half of the remaining iterations
+    /// from ranges of other threads. Ranges are updated with interlocked operations only, so
+    /// there is no synchronization per iteration. The class supports concurrent loops started from
+    /// different threads, as well as nested loops started from loop's body.</para>
+    /// </remarks>
     ///
     public sealed class Parallel
     {
         /// <summary>
         /// Delegate defining for-loop's body.
         /// </summary>
-        /// 
+        ///
         /// <param name="index">Loop's index.</param>
-        /// 
+        ///
         public delegate void ForLoopBody( int index );
 
+        /// <summary>
+        /// Delegate defining body of for-loop processing a range of iterations.
+        /// </summary>
+        ///
+        /// <param name="start">Index of the first iteration of the range.</param>
+        /// <param name="stop">Index of the iteration following the last iteration of the range.</param>
+        ///
+        public delegate void ForRangeBody( int start, int stop );
+
+        /// <summary>
+        /// Delegate defining initialization of for-loop's thread-local state.
+        /// </summary>
+        ///
+        /// <typeparam name="TLocal">Type of the thread-local state.</typeparam>
+        ///
+        /// <returns>Returns initial thread-local state of a thread participating in loop's execution.</returns>
+        ///
+        public delegate TLocal ForLocalInit<TLocal>( );
+
+        /// <summary>
+        /// Delegate defining for-loop's body, which accumulates into thread-local state.
+        /// </summary>
+        ///
+        /// <typeparam name="TLocal">Type of the thread-local state.</typeparam>
+        ///
+        /// <param name="index">Loop's index.</param>
+        /// <param name="local">Thread-local state of the thread executing the iteration.</param>
+        ///
+        /// <returns>Returns updated thread-local state to be passed to the next iteration executed by the thread.</returns>
+        ///
+        public delegate TLocal ForLocalBody<TLocal>( int index, TLocal local );
+
+        /// <summary>
+        /// Delegate defining merge of for-loop's thread-local state into final result.
+        /// </summary>
+        ///
+        /// <typeparam name="TLocal">Type of the thread-local state.</typeparam>
+        ///
+        /// <param name="local">Final thread-local state of a thread participated in loop's execution.</param>
+        ///
+        public delegate void ForLocalMerge<TLocal>( TLocal local );
+
+        /// <summary>
+        /// Delegate defining body of 2D loop processing a tile.
+        /// </summary>
+        ///
+        /// <param name="startX">X coordinate of tile's left column.</param>
+        /// <param name="startY">Y coordinate of tile's top row.</param>
+        /// <param name="stopX">X coordinate of the column following tile's right column.</param>
+        /// <param name="stopY">Y coordinate of the row following tile's bottom row.</param>
+        ///
+        public delegate void ForTileBody( int startX, int startY, int stopX, int stopY );
+
+        /// <summary>
+        /// Delegate defining body of 2D loop processing a tile, which accumulates into thread-local state.
+        /// </summary>
+        ///
+        /// <typeparam name="TLocal">Type of the thread-local state.</typeparam>
+        ///
+        /// <param name="startX">X coordinate of tile's left column.</param>
+        /// <param name="startY">Y coordinate of tile's top row.</param>
+        /// <param name="stopX">X coordinate of the column following tile's right column.</param>
+        /// <param name="stopY">Y coordinate of the row following tile's bottom row.</param>
+        /// <param name="local">Thread-local state of the thread processing the tile.</param>
+        ///
+        /// <returns>Returns updated thread-local state to be passed to the next tile processed by the thread.</returns>
+        ///
+        public delegate TLocal ForTileLocalBody<TLocal>( int startX, int startY, int stopX, int stopY, TLocal local );
+
         // number of threads for parallel computations
         private static int threadsCount = System.Environment.ProcessorCount;
-        // object used for synchronization
+        // object used for synchronization of jobs' queue and worker threads
         private static object sync = new Object( );
 
-        // single instance of the class to implement singleton pattern
-        private static volatile Parallel instance = null;
-        // background threads for parallel computation
-        private Thread[] threads = null;
+        // jobs, which have not distributed iterations
+        private static List<Job> jobs = new List<Job>( );
+        // number of started worker threads
+        private static int workersCount = 0;
 
-        // events to signal about job availability and thread availability
-        private AutoResetEvent[] jobAvailable = null;
-        private ManualResetEvent[] threadIdle = null;
-
-        // loop's body and its current and stop index
-        private int currentIndex;
-        private int stopIndex;
-        private ForLoopBody loopBody;
+        // each thread's range is split into the specified number of chunks at least
+        private const int ChunksPerThread = 4;
 
         /// <summary>
         /// Number of threads used for parallel computations.
         /// </summary>
-        /// 
-        /// <remarks><para>The property sets how many worker threads are created for paralleling
-        /// loops' computations.</para>
-        /// 
+        ///
+        /// <remarks><para>The property sets how many threads are used for paralleling
+        /// loops' computations (including the thread calling <see cref="For(int, int, ForLoopBody)"/>).</para>
+        ///
         /// <para>By default the property is set to number of CPU's in the system
         /// (see <see cref="System.Environment.ProcessorCount"/>).</para>
         /// </remarks>
-        /// 
+        ///
         public static int ThreadsCount
         {
             get { return threadsCount; }
@@ -70,23 +143,29 @@ namespace AForge
                 lock ( sync )
                 {
                     threadsCount = Math.Max( 1, value );
+                    // wake up idle workers, so extra ones could exit
+                    Monitor.PulseAll( sync );
                 }
             }
         }
 
         /// <summary>
-        /// Executes a for-loop in which iterations may run in parallel. 
+        /// Executes a for-loop in which iterations may run in parallel.
         /// </summary>
-        /// 
+        ///
         /// <param name="start">Loop's start index.</param>
         /// <param name="stop">Loop's stop index.</param>
         /// <param name="loopBody">Loop's body.</param>
-        /// 
+        ///
         /// <remarks><para>The method is used to parallel for-loop running its iterations in
         /// different threads. The <b>start</b> and <b>stop</b> parameters define loop's
         /// starting and ending loop's indexes. The number of iterations is equal to <b>stop - start</b>.
         /// </para>
-        /// 
+        ///
+        /// <para>If loop's body throws an exception, remaining iterations are not executed and the
+        /// method throws <see cref="TargetInvocationException"/> after all running iterations complete.
+        /// The exception thrown by loop's body is kept as inner exception with its original stack trace.</para>
+        ///
         /// <para>Sample usage:</para>
         /// <code>
         /// Parallel.For( 0, 20, delegate( int i )
@@ -98,139 +177,731 @@ namespace AForge
         /// } );
         /// </code>
         /// </remarks>
-        /// 
+        ///
+        /// <exception cref="TargetInvocationException">Loop's body has thrown an exception.</exception>
+        ///
         public static void For( int start, int stop, ForLoopBody loopBody  )
         {
-            lock ( sync )
-            {
-                // get instance of parallel computation manager
-                Parallel instance = Instance;
+            Run( new Job( start, stop, new LoopBody( loopBody ) ) );
+        }
 
-                instance.currentIndex   = start - 1;
-                instance.stopIndex      = stop;
-                instance.loopBody       = loopBody;
+        /// <summary>
+        /// Executes a for-loop in which ranges of iterations may run in parallel.
+        /// </summary>
+        ///
+        /// <param name="start">Loop's start index.</param>
+        /// <param name="stop">Loop's stop index.</param>
+        /// <param name="rangeBody">Loop's body processing a range of iterations.</param>
+        ///
+        /// <remarks><para>The method is similar to <see cref="For(int, int, ForLoopBody)"/>, but
+        /// loop's body is invoked once for each chunk of contiguous iterations instead of each iteration.
+        /// This saves delegate invocation per iteration and allows the body to keep its local state
+        /// (pointers, accumulators, etc.) while processing a chunk, what is preferred for loops
+        /// with cheap iterations, like processing rows of small images.</para>
+        ///
+        /// <para>Sample usage:</para>
+        /// <code>
+        /// Parallel.ForRange( 0, height, delegate( int startY, int stopY )
+        /// {
+        ///     for ( int y = startY; y &lt; stopY; y++ )
+        ///     {
+        ///         // process image's row
+        ///     }
+        /// } );
+        /// </code>
+        /// </remarks>
+        ///
+        /// <exception cref="TargetInvocationException">Loop's body has thrown an exception.</exception>
+        ///
+        public static void ForRange( int start, int stop, ForRangeBody rangeBody )
+        {
+            Run( new Job( start, stop, new RangeBody( rangeBody ) ) );
+        }
+
+        /// <summary>
+        /// Executes a for-loop in which iterations may run in parallel accumulating results into thread-local state.
+        /// </summary>
+        ///
+        /// <typeparam name="TLocal">Type of the thread-local state.</typeparam>
+        ///
+        /// <param name="start">Loop's start index.</param>
+        /// <param name="stop">Loop's stop index.</param>
+        /// <param name="localInit">Initialization of thread-local state.</param>
+        /// <param name="loopBody">Loop's body.</param>
+        /// <param name="localMerge">Merge of thread-local state into final result.</param>
+        ///
+        /// <remarks><para>The method is aimed for loops, which accumulate some result (histograms, sums,
+        /// accumulators of Hough transformation, etc.). Each thread participating in loop's execution
+        /// gets its own state created by <paramref name="localInit"/> before its first iteration, so
+        /// iterations update state of their thread without any synchronization and without sharing cache
+        /// lines with other threads. After a thread has completed all its iterations, its state is passed
+        /// to <paramref name="localMerge"/>.</para>
+        ///
+        /// <para>Invocations of <paramref name="localMerge"/> are serialized, so it may update final
+        /// result without locking. All merges are complete by the time the method returns.</para>
+        ///
+        /// <para>Sample usage:</para>
+        /// <code>
+        /// int[] histogram = new int[256];
+        ///
+        /// Parallel.For&lt;int[]&gt;( 0, height,
+        ///     delegate { return new int[256]; },
+        ///     delegate( int y, int[] localHistogram )
+        ///     {
+        ///         for ( int x = 0; x &lt; width; x++ )
+        ///         {
+        ///             localHistogram[pixels[y, x]]++;
+        ///         }
+        ///         return localHistogram;
+        ///     },
+        ///     delegate( int[] localHistogram )
+        ///     {
+        ///         for ( int i = 0; i &lt; 256; i++ )
+        ///         {
+        ///             histogram[i] += localHistogram[i];
+        ///         }
+        ///     } );
+        /// </code>
+        /// </remarks>
+        ///
+        /// <exception cref="TargetInvocationException">Loop's body has thrown an exception.</exception>
+        ///
+        public static void For<TLocal>( int start, int stop, ForLocalInit<TLocal> localInit,
+            ForLocalBody<TLocal> loopBody, ForLocalMerge<TLocal> localMerge )
+        {
+            Run( new Job( start, stop, new LocalBody<TLocal>( localInit, loopBody, localMerge, new Object( ) ) ) );
+        }
 
-                // signal about available job for all threads and mark them busy
-                for ( int i = 0; i < threadsCount; i++ )
+        /// <summary>
+        /// Executes a 2D loop in which tiles of the specified area may be processed in parallel.
+        /// </summary>
+        ///
+        /// <param name="startX">Loop's start X coordinate.</param>
+        /// <param name="startY">Loop's start Y coordinate.</param>
+        /// <param name="stopX">Loop's stop X coordinate.</param>
+        /// <param name="stopY">Loop's stop Y coordinate.</param>
+        /// <param name="tileWidth">Width of tiles to split the area into.</param>
+        /// <param name="tileHeight">Height of tiles to split the area into.</param>
+        /// <param name="tileBody">Loop's body processing a tile.</param>
+        ///
+        /// <remarks><para>The method splits the area into tiles of the specified size (tiles in the last
+        /// column and row may be smaller) and invokes loop's body for each tile. Tiles are distributed
+        /// between threads in row-major order, so each thread processes neighbour tiles, what keeps its data
+        /// in cache. Unlike parallel processing of rows, tiles allow to parallel areas, which are
+        /// only few rows high, and to bound amount of data processed by a single invocation of the body.</para>
+        /// </remarks>
+        ///
+        /// <exception cref="ArgumentOutOfRangeException">Tile's width or height is not positive.</exception>
+        /// <exception cref="TargetInvocationException">Loop's body has thrown an exception.</exception>
+        ///
+        public static void ForTiles( int startX, int startY, int stopX, int stopY,
+            int tileWidth, int tileHeight, ForTileBody tileBody )
+        {
+            Tiling tiling = new Tiling( startX, startY, stopX, stopY, tileWidth, tileHeight );
+            Run( new Job( 0, tiling.Count, new TileBody( tiling, tileBody ) ) );
+        }
+
+        /// <summary>
+        /// Executes a 2D loop in which tiles of the specified area may be processed in parallel
+        /// accumulating results into thread-local state.
+        /// </summary>
+        ///
+        /// <typeparam name="TLocal">Type of the thread-local state.</typeparam>
+        ///
+        /// <param name="startX">Loop's start X coordinate.</param>
+        /// <param name="startY">Loop's start Y coordinate.</param>
+        /// <param name="stopX">Loop's stop X coordinate.</param>
+        /// <param name="stopY">Loop's stop Y coordinate.</param>
+        /// <param name="tileWidth">Width of tiles to split the area into.</param>
+        /// <param name="tileHeight">Height of tiles to split the area into.</param>
+        /// <param name="localInit">Initialization of thread-local state.</param>
+        /// <param name="tileBody">Loop's body processing a tile.</param>
+        /// <param name="localMerge">Merge of thread-local state into final result.</param>
+        ///
+        /// <remarks><para>The method combines tiling of <see cref="ForTiles(int, int, int, int, int, int, ForTileBody)"/>
+        /// with thread-local state of <see cref="For{TLocal}(int, int, ForLocalInit{TLocal}, ForLocalBody{TLocal}, ForLocalMerge{TLocal})"/>.
+        /// Invocations of <paramref name="localMerge"/> are serialized.</para>
+        /// </remarks>
+        ///
+        /// <exception cref="ArgumentOutOfRangeException">Tile's width or height is not positive.</exception>
+        /// <exception cref="TargetInvocationException">Loop's body has thrown an exception.</exception>
+        ///
+        public static void ForTiles<TLocal>( int startX, int startY, int stopX, int stopY,
+            int tileWidth, int tileHeight, ForLocalInit<TLocal> localInit,
+            ForTileLocalBody<TLocal> tileBody, ForLocalMerge<TLocal> localMerge )
+        {
+            Tiling tiling = new Tiling( startX, startY, stopX, stopY, tileWidth, tileHeight );
+            Run( new Job( 0, tiling.Count, new TileLocalBody<TLocal>( tiling, localInit, tileBody, localMerge, new Object( ) ) ) );
+        }
+
+        // Private constructor to avoid class instantiation
+        private Parallel( ) { }
+
+        // Run the job in the calling thread with help of worker threads
+        private static void Run( Job job )
+        {
+            if ( job.Count <= 0 )
+                return;
+
+            if ( job.SlotsCount > 1 )
+            {
+                lock ( sync )
                 {
-                    instance.threadIdle[i].Reset( );
-                    instance.jobAvailable[i].Set( );
+                    // start missing worker threads
+                    while ( workersCount < threadsCount - 1 )
+                    {
+                        Thread thread = new Thread( new ThreadStart( WorkerThread ) );
+                        thread.Name = "AForge.Parallel";
+                        thread.IsBackground = true;
+                        thread.Start( );
+
+                        workersCount++;
+                    }
+
+                    // publish the job and wake up as many idle workers as it has slots for
+                    jobs.Add( job );
+                    for ( int i = 1; i < job.SlotsCount; i++ )
+                    {
+                        Monitor.Pulse( sync );
+                    }
                 }
+            }
+
+            job.Execute( );
+            job.WaitCompletion( );
+
+            // exception is wrapped, so its stack trace is not lost
+            if ( job.Exception != null )
+            {
+                throw new TargetInvocationException( job.Exception );
+            }
+        }
 
-                // wait until all threads become idle
-                for ( int i = 0; i < threadsCount; i++ )
+        // Remove job, which has no more iterations to distribute, from the queue
+        private static void RemoveJob( Job job )
+        {
+            lock ( sync )
+            {
+                jobs.Remove( job );
+            }
+        }
+
+        // Worker thread helping to execute published jobs
+        private static void WorkerThread( )
+        {
+            while ( true )
+            {
+                Job job = null;
+
+                lock ( sync )
                 {
-                    instance.threadIdle[i].WaitOne( );
+                    while ( true )
+                    {
+                        // exit if there are more workers than required
+                        if ( workersCount > threadsCount - 1 )
+                        {
+                            workersCount--;
+                            return;
+                        }
+
+                        // take the most recent job, which is a nested one if any
+                        for ( int i = jobs.Count - 1; i >= 0; i-- )
+                        {
+                            if ( !jobs[i].IsDistributed )
+                            {
+                                job = jobs[i];
+                                break;
+                            }
+                        }
+
+                        if ( job != null )
+                            break;
+
+                        // wait until there is job to do
+                        Monitor.Wait( sync );
+                    }
                 }
 
-                instance.loopBody = null;
+                job.Execute( );
             }
         }
 
-        // Private constructor to avoid class instantiation
-        private Parallel( ) { }
-
-        // Get instace of the Parallel class
-        private static Parallel Instance
+        // Single loop executed in parallel
+        private sealed class Job
         {
-            get
+            private readonly int start;
+            private readonly int count;
+            private readonly int chunkSize;
+            private readonly Body body;
+
+            // ranges of the slots packed as offsets of their next and stop iterations
+            private readonly long[] slots;
+            // number of slots taken by participating threads
+            private int takenSlots = 0;
+
+            // number of iterations, which are not completed yet
+            private int remaining;
+            // set to true when there are no more iterations to distribute
+            private volatile bool distributed = false;
+            // first exception thrown by loop's body
+            private volatile Exception exception = null;
+
+            public int Count
+            {
+                get { return count; }
+            }
+
+            public int SlotsCount
+            {
+                get { return slots.Length; }
+            }
+
+            public Exception Exception
+            {
+                get { return exception; }
+            }
+
+            public bool IsDistributed
             {
-                if ( instance == null )
+                get { return distributed; }
+            }
+
+            public Job( int start, int stop, Body body )
+            {
+                this.start = start;
+                this.count = Math.Max( 0, stop - start );
+                this.body  = body;
+
+                int slotsCount = Math.Max( 1, Math.Min( threadsCount, count ) );
+
+                slots     = new long[slotsCount];
+                remaining = count;
+                chunkSize = Math.Max( 1, count / ( slotsCount * ChunksPerThread ) );
+
+                for ( int i = 0; i < slotsCount; i++ )
                 {
-                    instance = new Parallel( );
-                    instance.Initialize( );
+                    slots[i] = Pack( (int) ( (long) count * i / slotsCount ), (int) ( (long) count * ( i + 1 ) / slotsCount ) );
+                }
+            }
+
+            // Take part in the job's execution
+            public void Execute( )
+            {
+                if ( distributed )
+                    return;
+
+                int slot = Interlocked.Increment( ref takenSlots ) - 1;
+                int chunkStart, chunkStop;
+
+                // body used by the thread (created on the first chunk) and number of iterations it has completed
+                Body threadBody = null;
+                int  completed  = 0;
+
+                if ( slot < slots.Length )
+                {
+                    // process own slot
+                    while ( TakeChunk( slot, out chunkStart, out chunkStop ) )
+                    {
+                        completed += ExecuteChunk( ref threadBody, chunkStart, chunkStop );
+                    }
                 }
                 else
                 {
-                    if ( instance.threads.Length != threadsCount )
+                    // late helper has no own slot, so it only steals
+                    slot = -1;
+                }
+
+                // steal from other slots until there is nothing to steal
+                bool stolen = true;
+
+                while ( stolen )
+                {
+                    stolen = false;
+
+                    // look for a victim starting from the next slot
+                    for ( int i = 1; i <= slots.Length; i++ )
                     {
-                        // terminate old threads
-                        instance.Terminate( );
-                        // reinitialize
-                        instance.Initialize( );
+                        int victim = ( slot + i + slots.Length ) % slots.Length;
+
+                        if ( Steal( victim, out chunkStart, out chunkStop ) )
+                        {
+                            if ( slot >= 0 )
+                            {
+                                // put stolen range into own slot, so others could steal from it as well
+                                Interlocked.Exchange( ref slots[slot], Pack( chunkStart, chunkStop ) );
 
-                        // TODO: change reinitialization to reuse already created objects
+                                while ( TakeChunk( slot, out chunkStart, out chunkStop ) )
+                                {
+                                    completed += ExecuteChunk( ref threadBody, chunkStart, chunkStop );
+                                }
+                            }
+                            else
+                            {
+                                completed += ExecuteChunk( ref threadBody, chunkStart, chunkStop );
+                            }
+
+                            stolen = true;
+                            break;
+                        }
                     }
                 }
-                return instance;
+
+                if ( !distributed )
+                {
+                    distributed = true;
+                    RemoveJob( this );
+                }
+
+                if ( completed != 0 )
+                {
+                    // complete thread's part of the job before reporting its iterations as done,
+                    // so thread-local state is merged by the time the job completes
+                    if ( ( threadBody != null ) && ( exception == null ) )
+                    {
+                        try
+                        {
+                            threadBody.Complete( );
+                        }
+                        catch ( Exception ex )
+                        {
+                            SetException( ex );
+                        }
+                    }
+
+                    if ( Interlocked.Add( ref remaining, -completed ) == 0 )
+                    {
+                        lock ( this )
+                        {
+                            Monitor.PulseAll( this );
+                        }
+                    }
+                }
+            }
+
+            // Wait until all iterations of the job are completed
+            public void WaitCompletion( )
+            {
+                lock ( this )
+                {
+                    while ( remaining != 0 )
+                    {
+                        Monitor.Wait( this );
+                    }
+                }
+            }
+
+            // Execute the specified chunk of iterations, returning number of completed iterations
+            private int ExecuteChunk( ref Body threadBody, int chunkStart, int chunkStop )
+            {
+                // skip iterations if the loop has failed
+                if ( exception == null )
+                {
+                    try
+                    {
+                        if ( threadBody == null )
+                        {
+                            threadBody = body.ForThread( );
+                        }
+                        threadBody.Execute( start + chunkStart, start + chunkStop );
+                    }
+                    catch ( Exception ex )
+                    {
+                        SetException( ex );
+                    }
+                }
+
+                return chunkStop - chunkStart;
+            }
+
+            // Keep the first exception thrown by loop's body
+            private void SetException( Exception ex )
+            {
+                lock ( this )
+                {
+                    if ( exception == null )
+                    {
+                        exception = ex;
+                    }
+                }
+            }
+
+            // Take chunk of iterations from the beginning of the slot's range
+            private bool TakeChunk( int slot, out int chunkStart, out int chunkStop )
+            {
+                while ( true )
+                {
+                    long state = Interlocked.Read( ref slots[slot] );
+                    int  next  = (int) ( state >> 32 );
+                    int  stop  = (int) state;
+
+                    if ( next >= stop )
+                    {
+                        chunkStart = chunkStop = 0;
+                        return false;
+                    }
+
+                    chunkStart = next;
+                    chunkStop  = Math.Min( stop, next + chunkSize );
+
+                    if ( Interlocked.CompareExchange( ref slots[slot], Pack( chunkStop, stop ), state ) == state )
+                    {
+                        return true;
+                    }
+                }
+            }
+
+            // Steal half of the iterations from the end of the slot's range
+            private bool Steal( int slot, out int chunkStart, out int chunkStop )
+            {
+                while ( true )
+                {
+                    long state = Interlocked.Read( ref slots[slot] );
+                    int  next  = (int) ( state >> 32 );
+                    int  stop  = (int) state;
+
+                    if ( next >= stop )
+                    {
+                        chunkStart = chunkStop = 0;
+                        return false;
+                    }
+
+                    chunkStart = stop - ( stop - next + 1 ) / 2;
+                    chunkStop  = stop;
+
+                    if ( Interlocked.CompareExchange( ref slots[slot], Pack( next, chunkStart ), state ) == state )
+                    {
+                        return true;
+                    }
+                }
+            }
+
+            // Pack range of iterations' offsets into single value
+            private static long Pack( int next, int stop )
+            {
+                return ( (long) next << 32 ) | (uint) stop;
+            }
+        }
+
+        // Split of 2D area into tiles, which are indexed in row-major order
+        private sealed class Tiling
+        {
+            private readonly int startX, startY, stopX, stopY;
+            private readonly int tileWidth, tileHeight;
+            private readonly int tilesInRow = 0;
+            private readonly int count = 0;
+
+            public int Count
+            {
+                get { return count; }
+            }
+
+            public Tiling( int startX, int startY, int stopX, int stopY, int tileWidth, int tileHeight )
+            {
+                if ( tileWidth <= 0 )
+                    throw new ArgumentOutOfRangeException( "tileWidth", "Tile's width must be positive." );
+                if ( tileHeight <= 0 )
+                    throw new ArgumentOutOfRangeException( "tileHeight", "Tile's height must be positive." );
+
+                this.startX     = startX;
+                this.startY     = startY;
+                this.stopX      = stopX;
+                this.stopY      = stopY;
+                this.tileWidth  = tileWidth;
+                this.tileHeight = tileHeight;
+
+                if ( ( stopX > startX ) && ( stopY > startY ) )
+                {
+                    long tilesInColumn = ( (long) stopY - startY + tileHeight - 1 ) / tileHeight;
+
+                    tilesInRow = (int) ( ( (long) stopX - startX + tileWidth - 1 ) / tileWidth );
+                    count      = (int) Math.Min( int.MaxValue, tilesInRow * tilesInColumn );
+                }
+            }
+
+            // Get bounds of the tile with the specified index
+            public void GetTile( int index, out int tileStartX, out int tileStartY, out int tileStopX, out int tileStopY )
+            {
+                tileStartX = startX + ( index % tilesInRow ) * tileWidth;
+                tileStartY = startY + ( index / tilesInRow ) * tileHeight;
+                tileStopX  = (int) Math.Min( stopX, (long) tileStartX + tileWidth );
+                tileStopY  = (int) Math.Min( stopY, (long) tileStartY + tileHeight );
+            }
+        }
+
+        // Loop's body executing ranges of iterations
+        private abstract class Body
+        {
+            // Get instance of the body to be used by a single participating thread
+            public virtual Body ForThread( )
+            {
+                return this;
+            }
+
+            // Execute the specified range of iterations
+            public abstract void Execute( int start, int stop );
+
+            // Complete thread's part of the loop after all its iterations are executed
+            public virtual void Complete( )
+            {
             }
         }
 
-        // Initialize Parallel class's instance creating required number of threads
-        // and synchronization objects
-        private void Initialize( )
+        // Body invoking delegate for each iteration
+        private sealed class LoopBody : Body
         {
-            // array of events, which signal about available job
-            jobAvailable = new AutoResetEvent[threadsCount];
-            // array of events, which signal about available thread
-            threadIdle = new ManualResetEvent[threadsCount];
-            // array of threads
-            threads = new Thread[threadsCount];
+            private readonly ForLoopBody loopBody;
 
-            for ( int i = 0; i < threadsCount; i++ )
+            public LoopBody( ForLoopBody loopBody )
             {
-                jobAvailable[i] = new AutoResetEvent( false );
-                threadIdle[i]   = new ManualResetEvent( true );
+                this.loopBody = loopBody;
+            }
 
-                threads[i] = new Thread( new ParameterizedThreadStart( WorkerThread ) );
-                threads[i].Name = "AForge.Parallel";
-                threads[i].IsBackground = true;
-                threads[i].Start( i );
+            public override void Execute( int start, int stop )
+            {
+                for ( int i = start; i < stop; i++ )
+                {
+                    loopBody( i );
+                }
             }
         }
 
-        // Terminate all worker threads used for parallel computations and close all
-        // synchronization objects
-        private void Terminate( )
+        // Body invoking delegate for each range of iterations
+        private sealed class RangeBody : Body
         {
-            // finish thread by setting null loop body and signaling about available work
-            loopBody = null;
-            for ( int i = 0, threadsCount = threads.Length ; i < threadsCount; i++ )
+            private readonly ForRangeBody rangeBody;
+
+            public RangeBody( ForRangeBody rangeBody )
             {
-                jobAvailable[i].Set( );
-                // wait for thread termination
-                threads[i].Join( );
+                this.rangeBody = rangeBody;
+            }
 
-                // close events
-                jobAvailable[i].Close( );
-                threadIdle[i].Close( );
+            public override void Execute( int start, int stop )
+            {
+                rangeBody( start, stop );
             }
+        }
+
+        // Body invoking delegate for each tile
+        private sealed class TileBody : Body
+        {
+            private readonly Tiling tiling;
+            private readonly ForTileBody tileBody;
 
-            // clean all array references
-            jobAvailable    = null;
-            threadIdle      = null;
-            threads         = null;
+            public TileBody( Tiling tiling, ForTileBody tileBody )
+            {
+                this.tiling   = tiling;
+                this.tileBody = tileBody;
+            }
+
+            public override void Execute( int start, int stop )
+            {
+                int tileStartX, tileStartY, tileStopX, tileStopY;
+
+                for ( int i = start; i < stop; i++ )
+                {
+                    tiling.GetTile( i, out tileStartX, out tileStartY, out tileStopX, out tileStopY );
+                    tileBody( tileStartX, tileStartY, tileStopX, tileStopY );
+                }
+            }
         }
 
-        // Worker thread performing parallel computations in loop
-        private void WorkerThread( object index )
+        // Base class of bodies with thread-local state. Each participating thread gets its own
+        // instance of the body, which initializes the state on the first executed range and
+        // merges it on completion (merges of all threads are serialized with the shared object)
+        private abstract class LocalStateBody<TLocal> : Body
         {
-            int threadIndex = (int) index;
-            int localIndex = 0;
+            protected readonly ForLocalInit<TLocal> localInit;
+            protected readonly ForLocalMerge<TLocal> localMerge;
+            protected readonly object mergeSync;
 
-            while ( true )
+            protected TLocal local;
+            private bool initialized = false;
+
+            protected LocalStateBody( ForLocalInit<TLocal> localInit, ForLocalMerge<TLocal> localMerge, object mergeSync )
+            {
+                this.localInit  = localInit;
+                this.localMerge = localMerge;
+                this.mergeSync  = mergeSync;
+            }
+
+            public override void Execute( int start, int stop )
             {
-                // wait until there is job to do
-                jobAvailable[threadIndex].WaitOne( );
+                if ( !initialized )
+                {
+                    local = localInit( );
+                    initialized = true;
+                }
 
-                // exit on null body
-                if ( loopBody == null )
-                    break;
+                ExecuteLocal( start, stop );
+            }
 
-                while ( true )
+            public override void Complete( )
+            {
+                if ( initialized )
                 {
-                    // get local index incrementing global loop's current index
-                    localIndex = Interlocked.Increment( ref currentIndex );
+                    lock ( mergeSync )
+                    {
+                        localMerge( local );
+                    }
+                }
+            }
 
-                    if ( localIndex >= stopIndex )
-                        break;
+            // Execute the specified range of iterations updating thread-local state
+            protected abstract void ExecuteLocal( int start, int stop );
+        }
 
-                    // run loop's body
-                    loopBody( localIndex );
+        // Body invoking delegate with thread-local state for each iteration
+        private sealed class LocalBody<TLocal> : LocalStateBody<TLocal>
+        {
+            private readonly ForLocalBody<TLocal> loopBody;
+
+            public LocalBody( ForLocalInit<TLocal> localInit, ForLocalBody<TLocal> loopBody,
+                ForLocalMerge<TLocal> localMerge, object mergeSync ) : base( localInit, localMerge, mergeSync )
+            {
+                this.loopBody = loopBody;
+            }
+
+            public override Body ForThread( )
+            {
+                return new LocalBody<TLocal>( localInit, loopBody, localMerge, mergeSync );
+            }
+
+            protected override void ExecuteLocal( int start, int stop )
+            {
+                for ( int i = start; i < stop; i++ )
+                {
+                    local = loopBody( i, local );
                 }
+            }
+        }
 
-                // signal about thread availability
-                threadIdle[threadIndex].Set( );
+        // Body invoking delegate with thread-local state for each tile
+        private sealed class TileLocalBody<TLocal> : LocalStateBody<TLocal>
+        {
+            private readonly Tiling tiling;
+            private readonly ForTileLocalBody<TLocal> tileBody;
+
+            public TileLocalBody( Tiling tiling, ForLocalInit<TLocal> localInit, ForTileLocalBody<TLocal> tileBody,
+                ForLocalMerge<TLocal> localMerge, object mergeSync ) : base( localInit, localMerge, mergeSync )
+            {
+                this.tiling   = tiling;
+                this.tileBody = tileBody;
+            }
+
+            public override Body ForThread( )
+            {
+                return new TileLocalBody<TLocal>( tiling, localInit, tileBody, localMerge, mergeSync );
+            }
+
+            protected override void ExecuteLocal( int start, int stop )
+            {
+                int tileStartX, tileStartY, tileStopX, tileStopY;
+
+                for ( int i = start; i < stop; i++ )
+                {
+                    tiling.GetTile( i, out tileStartX, out tileStartY, out tileStopX, out tileStopY );
+                    local = tileBody( tileStartX, tileStartY, tileStopX, tileStopY, local );
+                }
             }
         }
     }
@@ -0,0 +1,593 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging
+{
+    using System;
+    using System.Drawing;
+    using System.Drawing.Imaging;
+
+    /// <summary>
+    /// Binary image keeping one bit per pixel.
+    /// </summary>
+    ///
+    /// <remarks><para>The class represents binary image (mask), like result of <see cref="Filters.Threshold"/> filter
+    /// or motion detector, packing 64 pixels into each 64-bit word. Pixel (x, y) is kept in the bit <b>x % 64</b>
+    /// of the word <b>x / 64</b> of the row <b>y</b>. Such representation needs 8 times less memory than
+    /// 8 bpp image and allows to process 64 pixels by a single operation - <see cref="Erode()">erosion</see>
+    /// and <see cref="Dilate()">dilatation</see> with 3x3 structuring element,
+    /// <see cref="And">AND</see>/<see cref="Or">OR</see>/<see cref="Xor">XOR</see> of two images and
+    /// <see cref="CountPixels">counting</see> of set pixels.</para>
+    ///
+    /// <para>Conversion from 8 bpp grayscale image treats all pixels with non zero value as set pixels.
+    /// Conversion to 8 bpp grayscale image sets such pixels to 255.</para>
+    ///
+    /// <para>Sample usage:</para>
+    /// <code>
+    /// // get binary image from the result of motion detection/thresholding
+    /// BinaryImage mask = BinaryImage.FromBitmap( thresholdedImage );
+    /// // remove noise
+    /// mask = mask.Erode( );
+    /// mask = mask.Dilate( );
+    /// // get number of pixels in motion
+    /// int count = mask.CountPixels( );
+    /// // get back 8 bpp grayscale image
+    /// UnmanagedImage image = mask.ToUnmanagedImage( );
+    /// </code>
+    /// </remarks>
+    ///
+    /// <seealso cref="Filters.BinaryErosion3x3"/>
+    /// <seealso cref="Filters.BinaryDilatation3x3"/>
+    ///
+    public class BinaryImage
+    {
+        // image's width and height
+        private int width;
+        private int height;
+        // number of words per row
+        private int stride;
+        // image's data
+        private ulong[] data;
+
+        /// <summary>
+        /// Image's width.
+        /// </summary>
+        public int Width
+        {
+            get { return width; }
+        }
+
+        /// <summary>
+        /// Image's height.
+        /// </summary>
+        public int Height
+        {
+            get { return height; }
+        }
+
+        /// <summary>
+        /// Number of 64-bit words in image's row.
+        /// </summary>
+        public int Stride
+        {
+            get { return stride; }
+        }
+
+        /// <summary>
+        /// Provides access to internal array keeping image's data.
+        /// </summary>
+        ///
+        /// <remarks><para>The array keeps <see cref="Height"/> rows of <see cref="Stride"/> words each.
+        /// Pixel (x, y) is kept in the bit <b>x % 64</b> of the word <b>y * Stride + x / 64</b>.</para>
+        ///
+        /// <para><note>Bits of the last word of each row, which are beyond image's width, must be set to zero.
+        /// Methods of the class rely on this.</note></para>
+        /// </remarks>
+        ///
+        public ulong[] InternalData
+        {
+            get { return data; }
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="BinaryImage"/> class.
+        /// </summary>
+        ///
+        /// <param name="width">Image's width.</param>
+        /// <param name="height">Image's height.</param>
+        ///
+        /// <remarks><para>The new image does not have any set pixels.</para></remarks>
+        ///
+        /// <exception cref="ArgumentException">Invalid image size was specified.</exception>
+        ///
+        public BinaryImage( int width, int height )
+        {
+            if ( ( width <= 0 ) || ( height <= 0 ) )
+                throw new ArgumentException( "Invalid image size specified." );
+
+            this.width  = width;
+            this.height = height;
+            this.stride = ( width + 63 ) >> 6;
+            this.data   = new ulong[stride * height];
+        }
+
+        /// <summary>
+        /// Clone the binary image.
+        /// </summary>
+        ///
+        /// <returns>Returns clone of the binary image.</returns>
+        ///
+        public BinaryImage Clone( )
+        {
+            BinaryImage image = new BinaryImage( width, height );
+            Array.Copy( data, image.data, data.Length );
+            return image;
+        }
+
+        /// <summary>
+        /// Construct binary image from source grayscale image.
+        /// </summary>
+        ///
+        /// <param name="image">Source grayscale image.</param>
+        ///
+        /// <returns>Returns binary image, which has set pixels, where the source image has non zero pixels.</returns>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        ///
+        public static BinaryImage FromBitmap( Bitmap image )
+        {
+            // check image format
+            if ( image.PixelFormat != PixelFormat.Format8bppIndexed )
+            {
+                throw new UnsupportedImageFormatException( "Source image can be grayscale (8 bpp indexed) image only." );
+            }
+
+            // lock source image
+            BitmapData imageData = image.LockBits(
+                new Rectangle( 0, 0, image.Width, image.Height ),
+                ImageLockMode.ReadOnly, PixelFormat.Format8bppIndexed );
+
+            // process the image
+            BinaryImage binaryImage = FromBitmap( imageData );
+
+            // unlock image
+            image.UnlockBits( imageData );
+
+            return binaryImage;
+        }
+
+        /// <summary>
+        /// Construct binary image from source grayscale image.
+        /// </summary>
+        ///
+        /// <param name="imageData">Source image data.</param>
+        ///
+        /// <returns>Returns binary image, which has set pixels, where the source image has non zero pixels.</returns>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        ///
+        public static BinaryImage FromBitmap( BitmapData imageData )
+        {
+            return FromBitmap( new UnmanagedImage( imageData ) );
+        }
+
+        /// <summary>
+        /// Construct binary image from source grayscale image.
+        /// </summary>
+        ///
+        /// <param name="image">Source unmanaged image.</param>
+        ///
+        /// <returns>Returns binary image, which has set pixels, where the source image has non zero pixels.</returns>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        ///
+        public static BinaryImage FromBitmap( UnmanagedImage image )
+        {
+            // check image format
+            if ( image.PixelFormat != PixelFormat.Format8bppIndexed )
+            {
+                throw new UnsupportedImageFormatException( "Source image can be grayscale (8 bpp indexed) image only." );
+            }
+
+            int width  = image.Width;
+            int height = image.Height;
+
+            BinaryImage binaryImage = new BinaryImage( width, height );
+            int stride = binaryImage.stride;
+            // number of pixels, which are packed 8 at once
+            int fastWidth = width & ~7;
+
+            unsafe
+            {
+                fixed ( ulong* data = binaryImage.data )
+                {
+                    for ( int y = 0; y < height; y++ )
+                    {
+                        byte* src = (byte*) image.ImageData.ToPointer( ) + (long) y * image.Stride;
+                        byte* dst = (byte*) ( data + y * stride );
+                        int x = 0;
+
+                        // pack 8 pixels at once: set highest bit of each non zero byte and gather
+                        // the highest bits into single byte by multiplication
+                        for ( ; x < fastWidth; x += 8 )
+                        {
+                            ulong v = *( (ulong*) ( src + x ) );
+                            ulong t = ( ( ( v & 0x7F7F7F7F7F7F7F7FUL ) + 0x7F7F7F7F7F7F7F7FUL ) | v ) & 0x8080808080808080UL;
+
+                            dst[x >> 3] = (byte) ( ( ( t >> 7 ) * 0x0102040810204080UL ) >> 56 );
+                        }
+
+                        // rest of the pixels
+                        for ( ; x < width; x++ )
+                        {
+                            if ( src[x] != 0 )
+                            {
+                                dst[x >> 3] |= (byte) ( 1 << ( x & 7 ) );
+                            }
+                        }
+                    }
+                }
+            }
+
+            return binaryImage;
+        }
+
+        /// <summary>
+        /// Convert binary image to 8 bpp grayscale unmanaged image.
+        /// </summary>
+        ///
+        /// <returns>Returns 8 bpp grayscale image, which has pixels set to 255 where the binary image
+        /// has set pixels and 0 for the rest of pixels.</returns>
+        ///
+        public UnmanagedImage ToUnmanagedImage( )
+        {
+            UnmanagedImage image = UnmanagedImage.Create( width, height, PixelFormat.Format8bppIndexed );
+            ToUnmanagedImage( image );
+            return image;
+        }
+
+        /// <summary>
+        /// Convert binary image to 8 bpp grayscale unmanaged image.
+        /// </summary>
+        ///
+        /// <param name="image">Destination image to put result into.</param>
+        ///
+        /// <remarks><para>The method sets pixels of the destination image to 255 where the binary image
+        /// has set pixels and to 0 for the rest of pixels. The method allows to avoid allocation of new image,
+        /// when processing video frames.</para></remarks>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">The destination image has incorrect pixel format.</exception>
+        /// <exception cref="InvalidImagePropertiesException">Destination image must have the same size as the binary image.</exception>
+        ///
+        public unsafe void ToUnmanagedImage( UnmanagedImage image )
+        {
+            if ( image.PixelFormat != PixelFormat.Format8bppIndexed )
+            {
+                throw new UnsupportedImageFormatException( "Destination image can be grayscale (8 bpp indexed) image only." );
+            }
+            if ( ( image.Width != width ) || ( image.Height != height ) )
+            {
+                throw new InvalidImagePropertiesException( "Destination image must have the same size as the binary image." );
+            }
+
+            int fastWidth = width & ~7;
+
+            fixed ( ulong* data = this.data )
+            {
+                for ( int y = 0; y < height; y++ )
+                {
+                    byte* src = (byte*) ( data + y * stride );
+                    byte* dst = (byte*) image.ImageData.ToPointer( ) + (long) y * image.Stride;
+                    int x = 0;
+
+                    // unpack 8 pixels at once: spread bits of a byte into separate bytes and
+                    // turn non zero bytes into 255
+                    for ( ; x < fastWidth; x += 8 )
+                    {
+                        ulong t = ( src[x >> 3] * 0x0101010101010101UL ) & 0x8040201008040201UL;
+
+                        t = ( ( ( t & 0x7F7F7F7F7F7F7F7FUL ) + 0x7F7F7F7F7F7F7F7FUL ) | t ) & 0x8080808080808080UL;
+                        *( (ulong*) ( dst + x ) ) = ( t >> 7 ) * 0xFF;
+                    }
+
+                    // rest of the pixels
+                    for ( ; x < width; x++ )
+                    {
+                        dst[x] = (byte) ( ( ( src[x >> 3] >> ( x & 7 ) ) & 1 ) * 255 );
+                    }
+                }
+            }
+        }
+
+        /// <summary>
+        /// Convert binary image to 8 bpp grayscale managed image.
+        /// </summary>
+        ///
+        /// <returns>Returns 8 bpp grayscale image, which has pixels set to 255 where the binary image
+        /// has set pixels and 0 for the rest of pixels.</returns>
+        ///
+        public Bitmap ToManagedImage( )
+        {
+            UnmanagedImage image = ToUnmanagedImage( );
+            Bitmap bitmap = image.ToManagedImage( );
+            image.Dispose( );
+            return bitmap;
+        }
+
+        /// <summary>
+        /// Check if the specified pixel is set.
+        /// </summary>
+        ///
+        /// <param name="x">X coordinate of the pixel.</param>
+        /// <param name="y">Y coordinate of the pixel.</param>
+        ///
+        /// <returns>Returns <see langword="true"/> if the pixel is set or <see langword="false"/> otherwise.
+        /// Pixels outside of the image are not set.</returns>
+        ///
+        public bool GetPixel( int x, int y )
+        {
+            if ( ( x < 0 ) || ( y < 0 ) || ( x >= width ) || ( y >= height ) )
+                return false;
+
+            return ( ( data[y * stride + ( x >> 6 )] >> ( x & 63 ) ) & 1 ) != 0;
+        }
+
+        /// <summary>
+        /// Set or clear the specified pixel.
+        /// </summary>
+        ///
+        /// <param name="x">X coordinate of the pixel.</param>
+        /// <param name="y">Y coordinate of the pixel.</param>
+        /// <param name="value">Specifies if the pixel should be set or cleared.</param>
+        ///
+        /// <remarks><para>The method does nothing for pixels outside of the image.</para></remarks>
+        ///
+        public void SetPixel( int x, int y, bool value )
+        {
+            if ( ( x < 0 ) || ( y < 0 ) || ( x >= width ) || ( y >= height ) )
+                return;
+
+            if ( value )
+                data[y * stride + ( x >> 6 )] |= 1UL << ( x & 63 );
+            else
+                data[y * stride + ( x >> 6 )] &= ~( 1UL << ( x & 63 ) );
+        }
+
+        /// <summary>
+        /// Count set pixels of the image.
+        /// </summary>
+        ///
+        /// <returns>Returns number of set pixels.</returns>
+        ///
+        public int CountPixels( )
+        {
+            int count = 0;
+
+            for ( int i = 0; i < data.Length; i++ )
+            {
+                count += PopCount( data[i] );
+            }
+
+            return count;
+        }
+
+        /// <summary>
+        /// Intersect the image with another binary image.
+        /// </summary>
+        ///
+        /// <param name="image">Binary image to intersect with.</param>
+        ///
+        /// <remarks><para>The method keeps only those set pixels of this image, which are also set
+        /// in the specified image.</para></remarks>
+        ///
+        /// <exception cref="InvalidImagePropertiesException">The specified image must have the same size as this image.</exception>
+        ///
+        public void And( BinaryImage image )
+        {
+            CheckSize( image );
+
+            ulong[] other = image.data;
+
+            for ( int i = 0; i < data.Length; i++ )
+            {
+                data[i] &= other[i];
+            }
+        }
+
+        /// <summary>
+        /// Merge the image with another binary image.
+        /// </summary>
+        ///
+        /// <param name="image">Binary image to merge with.</param>
+        ///
+        /// <remarks><para>The method sets those pixels of this image, which are set in the specified image.</para></remarks>
+        ///
+        /// <exception cref="InvalidImagePropertiesException">The specified image must have the same size as this image.</exception>
+        ///
+        public void Or( BinaryImage image )
+        {
+            CheckSize( image );
+
+            ulong[] other = image.data;
+
+            for ( int i = 0; i < data.Length; i++ )
+            {
+                data[i] |= other[i];
+            }
+        }
+
+        /// <summary>
+        /// Find difference between the image and another binary image.
+        /// </summary>
+        ///
+        /// <param name="image">Binary image to find difference with.</param>
+        ///
+        /// <remarks><para>The method keeps set only those pixels, which are set either in this image
+        /// or in the specified image, but not in both.</para></remarks>
+        ///
+        /// <exception cref="InvalidImagePropertiesException">The specified image must have the same size as this image.</exception>
+        ///
+        public void Xor( BinaryImage image )
+        {
+            CheckSize( image );
+
+            ulong[] other = image.data;
+
+            for ( int i = 0; i < data.Length; i++ )
+            {
+                data[i] ^= other[i];
+            }
+        }
+
+        /// <summary>
+        /// Erosion with 3x3 square structuring element.
+        /// </summary>
+        ///
+        /// <returns>Returns new binary image containing result of erosion.</returns>
+        ///
+        /// <remarks><para>Pixel of the result image is set only if the corresponding pixel of this image
+        /// and all its 8 neighbours are set. Pixels outside of the image are treated as not set, so pixels
+        /// on image's edges are cleared. The result is the same as result of <see cref="Filters.BinaryErosion3x3"/>
+        /// filter.</para></remarks>
+        ///
+        public BinaryImage Erode( )
+        {
+            BinaryImage result = new BinaryImage( width, height );
+            Erode( result );
+            return result;
+        }
+
+        /// <summary>
+        /// Erosion with 3x3 square structuring element.
+        /// </summary>
+        ///
+        /// <param name="destination">Destination image to put result into (may be this image).</param>
+        ///
+        /// <remarks><para>See <see cref="Erode()"/> for details.</para></remarks>
+        ///
+        /// <exception cref="InvalidImagePropertiesException">Destination image must have the same size as this image.</exception>
+        ///
+        public void Erode( BinaryImage destination )
+        {
+            ProcessMorphology( destination, false );
+        }
+
+        /// <summary>
+        /// Dilatation with 3x3 square structuring element.
+        /// </summary>
+        ///
+        /// <returns>Returns new binary image containing result of dilatation.</returns>
+        ///
+        /// <remarks><para>Pixel of the result image is set if the corresponding pixel of this image
+        /// or any of its 8 neighbours is set. The result is the same as result of
+        /// <see cref="Filters.BinaryDilatation3x3"/> filter.</para></remarks>
+        ///
+        public BinaryImage Dilate( )
+        {
+            BinaryImage result = new BinaryImage( width, height );
+            Dilate( result );
+            return result;
+        }
+
+        /// <summary>
+        /// Dilatation with 3x3 square structuring element.
+        /// </summary>
+        ///
+        /// <param name="destination">Destination image to put result into (may be this image).</param>
+        ///
+        /// <remarks><para>See <see cref="Dilate()"/> for details.</para></remarks>
+        ///
+        /// <exception cref="InvalidImagePropertiesException">Destination image must have the same size as this image.</exception>
+        ///
+        public void Dilate( BinaryImage destination )
+        {
+            ProcessMorphology( destination, true );
+        }
+
+        // Process erosion or dilatation - first horizontal pass combining each pixel with its left
+        // and right neighbours by shifting words, and then vertical pass combining rows
+        private void ProcessMorphology( BinaryImage destination, bool dilatation )
+        {
+            CheckSize( destination );
+
+            ulong[] src = data;
+            ulong[] dst = destination.data;
+            // mask of valid bits of the last word in a row
+            ulong lastMask = ( ( width & 63 ) == 0 ) ? ulong.MaxValue : ( 1UL << ( width & 63 ) ) - 1;
+
+            // result of horizontal pass for the previous, current and next rows
+            ulong[] previousRow = new ulong[stride];
+            ulong[] currentRow  = new ulong[stride];
+            ulong[] nextRow     = new ulong[stride];
+
+            HorizontalPass( src, 0, currentRow, dilatation, lastMask );
+
+            for ( int y = 0; y < height; y++ )
+            {
+                if ( y + 1 < height )
+                {
+                    HorizontalPass( src, ( y + 1 ) * stride, nextRow, dilatation, lastMask );
+                }
+                else
+                {
+                    Array.Clear( nextRow, 0, stride );
+                }
+
+                int offset = y * stride;
+
+                for ( int i = 0; i < stride; i++ )
+                {
+                    dst[offset + i] = ( dilatation ) ?
+                        previousRow[i] | currentRow[i] | nextRow[i] :
+                        previousRow[i] & currentRow[i] & nextRow[i];
+                }
+
+                // rotate rows' buffers
+                ulong[] temp = previousRow;
+                previousRow = currentRow;
+                currentRow  = nextRow;
+                nextRow     = temp;
+            }
+        }
+
+        // Combine each pixel of a row with its left and right neighbours
+        private void HorizontalPass( ulong[] src, int offset, ulong[] dst, bool dilatation, ulong lastMask )
+        {
+            for ( int i = 0; i < stride; i++ )
+            {
+                ulong word  = src[offset + i];
+                // words with left and right neighbours of the pixels
+                ulong left  = ( word << 1 ) | ( ( i > 0 ) ? src[offset + i - 1] >> 63 : 0 );
+                ulong right = ( word >> 1 ) | ( ( i < stride - 1 ) ? src[offset + i + 1] << 63 : 0 );
+
+                dst[i] = ( dilatation ) ? word | left | right : word & left & right;
+            }
+
+            // clear bits beyond image's width
+            dst[stride - 1] &= lastMask;
+        }
+
+        // Check that the specified image has the same size
+        private void CheckSize( BinaryImage image )
+        {
+            if ( ( image.width != width ) || ( image.height != height ) )
+            {
+                throw new InvalidImagePropertiesException( "Binary images must have the same size." );
+            }
+        }
+
+        // Count set bits of the word
+        private static int PopCount( ulong v )
+        {
+            v = v - ( ( v >> 1 ) & 0x5555555555555555UL );
+            v = ( v & 0x3333333333333333UL ) + ( ( v >> 2 ) & 0x3333333333333333UL );
+            v = ( v + ( v >> 4 ) ) & 0x0F0F0F0F0F0F0F0FUL;
+            return (int) ( ( v * 0x0101010101010101UL ) >> 56 );
+        }
+    }
+}
@@ -88,8 +88,14 @@ namespace AForge.Imaging
     /// 
     public abstract class BlobCounterBase
     {
-        // found blobs
-        List<Blob> blobs = new List<Blob>( );
+        /// <summary>
+        /// Found blobs.
+        /// </summary>
+        /// 
+        /// <remarks><para>The list keeps blobs in the order they are provided by
+        /// <see cref="GetObjectsInformation"/> method.</para></remarks>
+        /// 
+        protected List<Blob> blobs = new List<Blob>( );
 
         // objects' sort order
         private ObjectsOrder objectsOrder = ObjectsOrder.None;
@@ -429,49 +435,13 @@ namespace AForge.Imaging
                 // check dimension of all objects and filter them
                 int objectsToRemove = 0;
 
-                if ( filter == null )
+                for ( int i = objectsCount - 1; i >= 0; i-- )
                 {
-                    for ( int i = objectsCount - 1; i >= 0; i-- )
+                    if ( !IsBlobAccepted( blobs[i] ) )
                     {
-                        int blobWidth  = blobs[i].Rectangle.Width;
-                        int blobHeight = blobs[i].Rectangle.Height;
-
-                        if ( coupledSizeFiltering == false )
-                        {
-                            // uncoupled filtering
-                            if (
-                                ( blobWidth < minWidth ) || ( blobHeight < minHeight ) ||
-                                ( blobWidth > maxWidth ) || ( blobHeight > maxHeight ) )
-                            {
-                                labelsMap[i + 1] = 0;
-                                objectsToRemove++;
-                                blobs.RemoveAt( i );
-                            }
-                        }
-                        else
-                        {
-                            // coupled filtering
-                            if (
-                                ( ( blobWidth < minWidth ) && ( blobHeight < minHeight ) ) ||
-                                ( ( blobWidth > maxWidth ) && ( blobHeight > maxHeight ) ) )
-                            {
-                                labelsMap[i + 1] = 0;
-                                objectsToRemove++;
-                                blobs.RemoveAt( i );
-                            }
-                        }
-                    }
-                }
-                else
-                {
-                    for ( int i = objectsCount - 1; i >= 0; i-- )
-                    {
-                        if ( !filter.Check( blobs[i] ) )
-                        {
-                            labelsMap[i + 1] = 0;
-                            objectsToRemove++;
-                            blobs.RemoveAt( i );
-                        }
+                        labelsMap[i + 1] = 0;
+                        objectsToRemove++;
+                        blobs.RemoveAt( i );
                     }
                 }
 
@@ -503,6 +473,50 @@ namespace AForge.Imaging
             }
 
             // do we need to sort the list?
+            SortBlobs( );
+        }
+
+        /// <summary>
+        /// Check if a blob passes blobs' filtering.
+        /// </summary>
+        /// 
+        /// <param name="blob">Blob to check.</param>
+        /// 
+        /// <returns>Returns <see langword="true"/> if the blob should be kept or <see langword="false"/>
+        /// if it should be removed according to <see cref="FilterBlobs"/>, <see cref="BlobsFilter"/> and
+        /// size filtering properties.</returns>
+        /// 
+        protected bool IsBlobAccepted( Blob blob )
+        {
+            if ( !filterBlobs )
+                return true;
+
+            if ( filter != null )
+                return filter.Check( blob );
+
+            int blobWidth  = blob.Rectangle.Width;
+            int blobHeight = blob.Rectangle.Height;
+
+            if ( coupledSizeFiltering == false )
+            {
+                // uncoupled filtering
+                return !(
+                    ( blobWidth < minWidth ) || ( blobHeight < minHeight ) ||
+                    ( blobWidth > maxWidth ) || ( blobHeight > maxHeight ) );
+            }
+
+            // coupled filtering
+            return !(
+                ( ( blobWidth < minWidth ) && ( blobHeight < minHeight ) ) ||
+                ( ( blobWidth > maxWidth ) && ( blobHeight > maxHeight ) ) );
+        }
+
+        /// <summary>
+        /// Sort found blobs according to <see cref="ObjectsOrder"/> property.
+        /// </summary>
+        /// 
+        protected void SortBlobs( )
+        {
             if ( objectsOrder != ObjectsOrder.None )
             {
                 blobs.Sort( new BlobsSorter( objectsOrder ) );
@@ -1163,10 +1177,20 @@ namespace AForge.Imaging
         protected abstract void BuildObjectsMap( UnmanagedImage image );
 
 
-        #region Private Methods - Collecting objects' rectangles
+        #region Collecting objects' information
 
-        // Collect objects' rectangles
-        private unsafe void CollectObjectsInfo( UnmanagedImage image )
+        /// <summary>
+        /// Collect information about found objects.
+        /// </summary>
+        /// 
+        /// <param name="image">Unmanaged image to process.</param>
+        /// 
+        /// <remarks><para>The method is called after <see cref="BuildObjectsMap"/> and collects information
+        /// about blobs walking through <see cref="objectLabels">objects' labels</see> and the source image.
+        /// Classes, which gather the information while building objects map, may override the method
+        /// passing the gathered information to <see cref="CreateBlobs"/> method.</para></remarks>
+        /// 
+        protected virtual unsafe void CollectObjectsInfo( UnmanagedImage image )
         {
             int i = 0, label;
 
@@ -1309,27 +1333,84 @@ namespace AForge.Imaging
                 }
             }
 
+            CreateBlobs( x1, y1, x2, y2, area, xc, yc, meanR, meanG, meanB, stdDevR, stdDevG, stdDevB );
+        }
+
+        /// <summary>
+        /// Create blobs from collected information about objects.
+        /// </summary>
+        /// 
+        /// <param name="x1">Minimum X coordinates of objects' pixels.</param>
+        /// <param name="y1">Minimum Y coordinates of objects' pixels.</param>
+        /// <param name="x2">Maximum X coordinates of objects' pixels.</param>
+        /// <param name="y2">Maximum Y coordinates of objects' pixels.</param>
+        /// <param name="area">Objects' areas.</param>
+        /// <param name="xc">Sums of X coordinates of objects' pixels.</param>
+        /// <param name="yc">Sums of Y coordinates of objects' pixels.</param>
+        /// <param name="meanR">Sums of red values of objects' pixels.</param>
+        /// <param name="meanG">Sums of green values of objects' pixels.</param>
+        /// <param name="meanB">Sums of blue values of objects' pixels.</param>
+        /// <param name="stdDevR">Sums of squared red values of objects' pixels.</param>
+        /// <param name="stdDevG">Sums of squared green values of objects' pixels.</param>
+        /// <param name="stdDevB">Sums of squared blue values of objects' pixels.</param>
+        /// 
+        /// <remarks><para>All arrays are indexed by objects' labels, so they must have at least
+        /// <see cref="objectsCount"/> + 1 elements (element with index 0 is not used). For grayscale
+        /// images all three color channels' sums should be set to sums of pixels' intensities.</para></remarks>
+        /// 
+        protected void CreateBlobs( int[] x1, int[] y1, int[] x2, int[] y2, int[] area, long[] xc, long[] yc,
+                                    long[] meanR, long[] meanG, long[] meanB, long[] stdDevR, long[] stdDevG, long[] stdDevB )
+        {
             // create blobs
             blobs.Clear( );
 
             for ( int j = 1; j <= objectsCount; j++ )
             {
-                int blobArea = area[j];
-
-                Blob blob = new Blob( j, new Rectangle( x1[j], y1[j], x2[j] - x1[j] + 1, y2[j] - y1[j] + 1 ) );
-                blob.Area = blobArea;
-                blob.Fullness = (double) blobArea / ( ( x2[j] - x1[j] + 1 ) * ( y2[j] - y1[j] + 1 ) );
-                blob.CenterOfGravity = new AForge.Point( (float) xc[j] / blobArea, (float) yc[j] / blobArea );
-                blob.ColorMean = Color.FromArgb( (byte) ( meanR[j] / blobArea ), (byte) ( meanG[j] / blobArea ), (byte) ( meanB[j] / blobArea ) );
-                blob.ColorStdDev = Color.FromArgb(
-                    (byte) ( Math.Sqrt( stdDevR[j] / blobArea - blob.ColorMean.R * blob.ColorMean.R ) ),
-                    (byte) ( Math.Sqrt( stdDevG[j] / blobArea - blob.ColorMean.G * blob.ColorMean.G ) ),
-                    (byte) ( Math.Sqrt( stdDevB[j] / blobArea - blob.ColorMean.B * blob.ColorMean.B ) ) );
-
-                blobs.Add( blob );
+                blobs.Add( CreateBlob( j, x1, y1, x2, y2, area, xc, yc, meanR, meanG, meanB, stdDevR, stdDevG, stdDevB ) );
             }
         }
 
+        /// <summary>
+        /// Create blob from collected information about objects.
+        /// </summary>
+        /// 
+        /// <param name="j">Label of the object to create blob for.</param>
+        /// <param name="x1">Minimum X coordinates of objects' pixels.</param>
+        /// <param name="y1">Minimum Y coordinates of objects' pixels.</param>
+        /// <param name="x2">Maximum X coordinates of objects' pixels.</param>
+        /// <param name="y2">Maximum Y coordinates of objects' pixels.</param>
+        /// <param name="area">Objects' areas.</param>
+        /// <param name="xc">Sums of X coordinates of objects' pixels.</param>
+        /// <param name="yc">Sums of Y coordinates of objects' pixels.</param>
+        /// <param name="meanR">Sums of red values of objects' pixels.</param>
+        /// <param name="meanG">Sums of green values of objects' pixels.</param>
+        /// <param name="meanB">Sums of blue values of objects' pixels.</param>
+        /// <param name="stdDevR">Sums of squared red values of objects' pixels.</param>
+        /// <param name="stdDevG">Sums of squared green values of objects' pixels.</param>
+        /// <param name="stdDevB">Sums of squared blue values of objects' pixels.</param>
+        /// 
+        /// <returns>Returns blob with ID set to the specified label.</returns>
+        /// 
+        /// <remarks><para>See <see cref="CreateBlobs"/> for description of the arrays.</para></remarks>
+        /// 
+        protected static Blob CreateBlob( int j, int[] x1, int[] y1, int[] x2, int[] y2, int[] area, long[] xc, long[] yc,
+                                          long[] meanR, long[] meanG, long[] meanB, long[] stdDevR, long[] stdDevG, long[] stdDevB )
+        {
+            int blobArea = area[j];
+
+            Blob blob = new Blob( j, new Rectangle( x1[j], y1[j], x2[j] - x1[j] + 1, y2[j] - y1[j] + 1 ) );
+            blob.Area = blobArea;
+            blob.Fullness = (double) blobArea / ( ( x2[j] - x1[j] + 1 ) * ( y2[j] - y1[j] + 1 ) );
+            blob.CenterOfGravity = new AForge.Point( (float) xc[j] / blobArea, (float) yc[j] / blobArea );
+            blob.ColorMean = Color.FromArgb( (byte) ( meanR[j] / blobArea ), (byte) ( meanG[j] / blobArea ), (byte) ( meanB[j] / blobArea ) );
+            blob.ColorStdDev = Color.FromArgb(
+                (byte) ( Math.Sqrt( stdDevR[j] / blobArea - blob.ColorMean.R * blob.ColorMean.R ) ),
+                (byte) ( Math.Sqrt( stdDevG[j] / blobArea - blob.ColorMean.G * blob.ColorMean.G ) ),
+                (byte) ( Math.Sqrt( stdDevB[j] / blobArea - blob.ColorMean.B * blob.ColorMean.B ) ) );
+
+            return blob;
+        }
+
         // Rectangles' and blobs' sorter
         private class BlobsSorter : System.Collections.Generic.IComparer<Blob>
         {
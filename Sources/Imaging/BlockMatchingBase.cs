@@ -0,0 +1,453 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging
+{
+    using System;
+    using System.Collections.Generic;
+    using System.Drawing;
+    using System.Drawing.Imaging;
+    using System.Threading.Tasks;
+
+    /// <summary>
+    /// Base class for different block matching algorithms.
+    /// </summary>
+    ///
+    /// <remarks><para>The class is abstract and serves as a base for different block matching algorithms
+    /// (see documentation for <see cref="IBlockMatching"/> for information about block matching algorithms).
+    /// Classes, which inherit from this base class, require to implement <see cref="SearchBlock"/>
+    /// method, which defines the order of checking block's locations within search window. Everything else -
+    /// checking images, comparing blocks and collecting found matches - is done by the base class.</para>
+    ///
+    /// <para>Blocks are compared using sum of absolute differences of their pixels' values. In 64 bit processes
+    /// the sum is calculated for 8 bytes at once using 64 bit integer arithmetic. Its calculation stops as soon as
+    /// it becomes bigger than difference of the best block found so far. Reference points are processed
+    /// in parallel on multi-core systems.</para>
+    ///
+    /// <para><note>The class processes only grayscale (8 bpp indexed) and color (24 bpp) images.</note></para>
+    /// </remarks>
+    ///
+    public abstract class BlockMatchingBase : IBlockMatching
+    {
+        // block size to search for
+        private int blockSize = 16;
+        // search radius (maximum shift from base position, in all 4 directions)
+        private int searchRadius = 12;
+        // blocks' similarity threshold
+        private float similarityThreshold = 0.9f;
+        // blocks' similarity, which is enough to stop search
+        private float sufficientSimilarity = 1.0f;
+
+        // minimum number of points to process them in parallel
+        private const int MinPointsForParallelProcessing = 4;
+
+        // masks of even bytes and of 9th bit of each 16 bit word
+        private const ulong EvenBytesMask = 0x00FF00FF00FF00FF;
+        private const ulong NinthBitsMask = 0x0100010001000100;
+        private const ulong LowBitsMask   = 0x0001000100010001;
+
+        /// <summary>
+        /// Search radius.
+        /// </summary>
+        ///
+        /// <remarks><para>The value specifies the shift from reference point in all
+        /// four directions, used to search for the best matching block.</para>
+        ///
+        /// <para>Default value is set to <b>12</b>.</para>
+        /// </remarks>
+        ///
+        public int SearchRadius
+        {
+            get { return searchRadius; }
+            set { searchRadius = value; }
+        }
+
+        /// <summary>
+        /// Block size to search for.
+        /// </summary>
+        ///
+        /// <remarks><para>The value specifies block size to search for. For each provided
+        /// reference pointer, a square block of this size is taken from the source image
+        /// (reference point becomes the coordinate of block's center) and the best match
+        /// is searched in second image within specified <see cref="SearchRadius">search
+        /// radius</see>.</para>
+        ///
+        /// <para>Default value is set to <b>16</b>.</para>
+        /// </remarks>
+        ///
+        public int BlockSize
+        {
+            get { return blockSize; }
+            set { blockSize = value; }
+        }
+
+        /// <summary>
+        /// Similarity threshold, [0..1].
+        /// </summary>
+        ///
+        /// <remarks><para>The property sets the minimal acceptable similarity between blocks
+        /// in source and search images. If similarity is lower than this value,
+        /// then the candidate block in search image is not treated as a match for the block
+        /// in source image.
+        /// </para>
+        ///
+        /// <para>Default value is set to <b>0.9</b>.</para>
+        /// </remarks>
+        ///
+        public float SimilarityThreshold
+        {
+            get { return similarityThreshold; }
+            set { similarityThreshold = Math.Min( 1, Math.Max( 0, value ) ); }
+        }
+
+        /// <summary>
+        /// Similarity, which is enough to stop search, [0..1].
+        /// </summary>
+        ///
+        /// <remarks><para>The property sets similarity between blocks, which is treated as good enough
+        /// to stop searching for the best match. As soon as block with such or higher similarity is found
+        /// in search image, it is taken as a match and the rest locations within search window are not checked.
+        /// Setting the property to a value lower than 1 allows to limit processing time, but the found match
+        /// may be not the best one.</para>
+        ///
+        /// <para>Default value is set to <b>1</b> - search is stopped only when the same block is found.</para>
+        /// </remarks>
+        ///
+        public float SufficientSimilarity
+        {
+            get { return sufficientSimilarity; }
+            set { sufficientSimilarity = Math.Min( 1, Math.Max( 0, value ) ); }
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="BlockMatchingBase"/> class.
+        /// </summary>
+        ///
+        protected BlockMatchingBase( ) { }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="BlockMatchingBase"/> class.
+        /// </summary>
+        ///
+        /// <param name="blockSize">Block size to search for.</param>
+        /// <param name="searchRadius">Search radius.</param>
+        ///
+        protected BlockMatchingBase( int blockSize, int searchRadius )
+        {
+            this.blockSize = blockSize;
+            this.searchRadius = searchRadius;
+        }
+
+        /// <summary>
+        /// Process images matching blocks between them.
+        /// </summary>
+        ///
+        /// <param name="sourceImage">Source image with reference points.</param>
+        /// <param name="coordinates">List of reference points to be matched.</param>
+        /// <param name="searchImage">Image in which the reference points will be looked for.</param>
+        ///
+        /// <returns>Returns list of found block matches. The list is sorted by similarity
+        /// of found matches in descending order.</returns>
+        ///
+        /// <exception cref="InvalidImagePropertiesException">Source and search images sizes must match.</exception>
+        /// <exception cref="UnsupportedImageFormatException">Source images can be grayscale (8 bpp indexed) or color (24 bpp) image only.</exception>
+        /// <exception cref="InvalidImagePropertiesException">Source and search images must have same pixel format.</exception>
+        ///
+        public List<BlockMatch> ProcessImage( Bitmap sourceImage, List<IntPoint> coordinates, Bitmap searchImage )
+        {
+            // lock source image
+            BitmapData sourceImageData = sourceImage.LockBits(
+                new Rectangle( 0, 0, sourceImage.Width, sourceImage.Height ),
+                ImageLockMode.ReadOnly, sourceImage.PixelFormat );
+
+            BitmapData searchImageData = searchImage.LockBits(
+                new Rectangle( 0, 0, searchImage.Width, searchImage.Height ),
+                ImageLockMode.ReadOnly, searchImage.PixelFormat );
+
+            List<BlockMatch> matchings;
+
+            try
+            {
+                // process the image
+                matchings = ProcessImage( new UnmanagedImage( sourceImageData ),
+                    coordinates, new UnmanagedImage( searchImageData ) );
+            }
+            finally
+            {
+                // unlock image
+                sourceImage.UnlockBits( sourceImageData );
+                searchImage.UnlockBits( searchImageData );
+            }
+
+            return matchings;
+        }
+
+        /// <summary>
+        /// Process images matching blocks between them.
+        /// </summary>
+        ///
+        /// <param name="sourceImageData">Source image with reference points.</param>
+        /// <param name="coordinates">List of reference points to be matched.</param>
+        /// <param name="searchImageData">Image in which the reference points will be looked for.</param>
+        ///
+        /// <returns>Returns list of found block matches. The list is sorted by similarity
+        /// of found matches in descending order.</returns>
+        ///
+        /// <exception cref="InvalidImagePropertiesException">Source and search images sizes must match.</exception>
+        /// <exception cref="UnsupportedImageFormatException">Source images can be grayscale (8 bpp indexed) or color (24 bpp) image only.</exception>
+        /// <exception cref="InvalidImagePropertiesException">Source and search images must have same pixel format.</exception>
+        ///
+        public List<BlockMatch> ProcessImage( BitmapData sourceImageData, List<IntPoint> coordinates, BitmapData searchImageData )
+        {
+            return ProcessImage( new UnmanagedImage( sourceImageData ), coordinates, new UnmanagedImage( searchImageData ) );
+        }
+
+        /// <summary>
+        /// Process images matching blocks between them.
+        /// </summary>
+        ///
+        /// <param name="sourceImage">Source unmanaged image with reference points.</param>
+        /// <param name="coordinates">List of reference points to be matched.</param>
+        /// <param name="searchImage">Unmanaged image in which the reference points will be looked for.</param>
+        ///
+        /// <returns>Returns list of found block matches. The list is sorted by similarity
+        /// of found matches in descending order.</returns>
+        ///
+        /// <exception cref="InvalidImagePropertiesException">Source and search images sizes must match.</exception>
+        /// <exception cref="UnsupportedImageFormatException">Source images can be grayscale (8 bpp indexed) or color (24 bpp) image only.</exception>
+        /// <exception cref="InvalidImagePropertiesException">Source and search images must have same pixel format.</exception>
+        ///
+        public List<BlockMatch> ProcessImage( UnmanagedImage sourceImage, List<IntPoint> coordinates, UnmanagedImage searchImage )
+        {
+            // source images sizes must match.
+            if ( ( sourceImage.Width != searchImage.Width ) || ( sourceImage.Height != searchImage.Height ) )
+                throw new InvalidImagePropertiesException( "Source and search images sizes must match" );
+
+            // sources images must be graysclae or color.
+            if ( ( sourceImage.PixelFormat != PixelFormat.Format8bppIndexed ) && ( sourceImage.PixelFormat != PixelFormat.Format24bppRgb ) )
+                throw new UnsupportedImageFormatException( "Source images can be graysclae (8 bpp indexed) or color (24 bpp) image only" );
+
+            // source images must have the same pixel format.
+            if ( sourceImage.PixelFormat != searchImage.PixelFormat )
+                throw new InvalidImagePropertiesException( "Source and search images must have same pixel format" );
+
+            int pointsCount = coordinates.Count;
+
+            // found matches of all points
+            BlockMatch[] matches = new BlockMatch[pointsCount];
+
+            // do the job
+            unsafe
+            {
+                byte* ptrSource = (byte*) sourceImage.ImageData.ToPointer( );
+                byte* ptrSearch = (byte*) searchImage.ImageData.ToPointer( );
+
+                if ( ( Environment.ProcessorCount > 1 ) && ( pointsCount >= MinPointsForParallelProcessing ) )
+                {
+                    Parallel.For( 0, pointsCount, delegate( int i )
+                    {
+                        matches[i] = MatchBlock( ptrSource, ptrSearch, sourceImage, coordinates[i] );
+                    } );
+                }
+                else
+                {
+                    for ( int i = 0; i < pointsCount; i++ )
+                    {
+                        matches[i] = MatchBlock( ptrSource, ptrSearch, sourceImage, coordinates[i] );
+                    }
+                }
+            }
+
+            // found matches
+            List<BlockMatch> matchingsList = new List<BlockMatch>( );
+
+            foreach ( BlockMatch match in matches )
+            {
+                if ( match != null )
+                    matchingsList.Add( match );
+            }
+
+            // sort in descending order
+            matchingsList.Sort( new MatchingsSorter( ) );
+
+            return matchingsList;
+        }
+
+        /// <summary>
+        /// Delegate, which calculates difference between block in source image and displaced block in search image.
+        /// </summary>
+        ///
+        /// <param name="dx">Horizontal displacement of block in search image.</param>
+        /// <param name="dy">Vertical displacement of block in search image.</param>
+        /// <param name="maxDifference">Difference, after reaching which its calculation may be stopped.</param>
+        ///
+        /// <returns>Returns sum of absolute differences of blocks' pixels' values. If the returned value
+        /// is not less than <paramref name="maxDifference"/>, it may be not the actual difference, but
+        /// some value it reached before its calculation was stopped. Returns <see cref="int.MaxValue"/>
+        /// if displaced block is out of search window or out of image.</returns>
+        ///
+        protected delegate int BlockDifference( int dx, int dy, int maxDifference );
+
+        /// <summary>
+        /// Search for block's location with minimal difference within search window.
+        /// </summary>
+        ///
+        /// <param name="difference">Method to calculate difference of blocks for the specified displacement.</param>
+        /// <param name="sufficientDifference">Difference, which is small enough to stop search.</param>
+        /// <param name="minDifference">Difference of the best found location.</param>
+        ///
+        /// <returns>Returns displacement of the best found location of block in search image.</returns>
+        ///
+        /// <remarks><para>The method is called for each reference point, which block is inside of source image.
+        /// Displacements in the [-<see cref="SearchRadius"/>, <see cref="SearchRadius"/>] range
+        /// (in both directions) are treated as search window. Zero displacement is always inside of image.
+        /// If several locations have the same minimal difference, implementations are expected to prefer
+        /// zero displacement.</para>
+        ///
+        /// <para><note>The method may be called from different threads at the same time, so it should not
+        /// modify object's state.</note></para>
+        /// </remarks>
+        ///
+        protected abstract IntPoint SearchBlock( BlockDifference difference, int sufficientDifference, out int minDifference );
+
+        // Find match for the block around the specified reference point
+        private unsafe BlockMatch MatchBlock( byte* ptrSource, byte* ptrSearch, UnmanagedImage image, IntPoint point )
+        {
+            int width  = image.Width;
+            int height = image.Height;
+            int stride = image.Stride;
+            int pixelSize = ( image.PixelFormat == PixelFormat.Format8bppIndexed ) ? 1 : 3;
+
+            int blockSize    = this.blockSize;
+            int searchRadius = this.searchRadius;
+            int blockRadius  = blockSize / 2;
+            int blockLineSize = blockSize * pixelSize;
+
+            // make sure the source block is inside the image
+            if (
+                ( ( point.X - blockRadius < 0 ) || ( point.X + blockRadius >= width ) ) ||
+                ( ( point.Y - blockRadius < 0 ) || ( point.Y + blockRadius >= height ) )
+                )
+            {
+                // skip point
+                return null;
+            }
+
+            // maximum possible difference of blocks
+            int maxDiff = blockSize * blockSize * pixelSize * 255;
+
+            // block's upper left point in source and search images
+            int blockX = point.X - blockRadius;
+            int blockY = point.Y - blockRadius;
+
+            byte* ptrSourceBlock = ptrSource + blockY * stride + blockX * pixelSize;
+
+            int minError;
+            IntPoint shift = SearchBlock(
+                delegate( int dx, int dy, int maxDifference )
+                {
+                    int x = blockX + dx;
+                    int y = blockY + dy;
+
+                    if ( ( dx < -searchRadius ) || ( dx > searchRadius ) || ( dy < -searchRadius ) || ( dy > searchRadius ) ||
+                         ( x < 0 ) || ( y < 0 ) || ( x + blockSize > width ) || ( y + blockSize > height ) )
+                    {
+                        return int.MaxValue;
+                    }
+
+                    return CalculateDifference( ptrSourceBlock, ptrSearch + y * stride + x * pixelSize,
+                        stride, blockLineSize, blockSize, maxDifference );
+                },
+                maxDiff - (int) ( sufficientSimilarity * maxDiff ), out minError );
+
+            // calculate blocks' similarity and compare it with threshold
+            int blockSimilarity = maxDiff - minError;
+
+            if ( blockSimilarity < (int) ( similarityThreshold * maxDiff ) )
+                return null;
+
+            return new BlockMatch( point, new IntPoint( point.X + shift.X, point.Y + shift.Y ),
+                (float) blockSimilarity / maxDiff );
+        }
+
+        // Calculate sum of absolute differences of two blocks stopping as soon as the specified limit is reached
+        private static unsafe int CalculateDifference( byte* src1, byte* src2, int stride, int lineSize, int lines, int maxDifference )
+        {
+            // 64 bit words are read only where unaligned access to them is fast and safe
+            int words = ( PixelKernels.IsEnabled ) ? lineSize / 8 : 0;
+            int error = 0;
+
+            for ( int y = 0; y < lines; y++ )
+            {
+                ulong* w1 = (ulong*) src1;
+                ulong* w2 = (ulong*) src2;
+
+                // process 8 bytes at once keeping differences of even and odd bytes in 16 bit words;
+                // the words are summed up every 32 words of source, so their total sum fits into 16 bits
+                for ( int i = 0; i < words; )
+                {
+                    int stop = i + 32;
+                    ulong sum = 0;
+
+                    if ( stop > words )
+                        stop = words;
+
+                    for ( ; i < stop; i++ )
+                    {
+                        ulong a = w1[i];
+                        ulong b = w2[i];
+
+                        sum += AbsoluteDifference( a & EvenBytesMask, b & EvenBytesMask );
+                        sum += AbsoluteDifference( ( a >> 8 ) & EvenBytesMask, ( b >> 8 ) & EvenBytesMask );
+                    }
+
+                    // sum of four 16 bit words is accumulated in the highest word
+                    error += (int) ( ( sum * LowBitsMask ) >> 48 );
+                }
+
+                // process remaining bytes
+                for ( int i = words * 8; i < lineSize; i++ )
+                {
+                    int diff = src1[i] - src2[i];
+                    error += ( diff > 0 ) ? diff : -diff;
+                }
+
+                // stop if the block is already worse than the limit
+                if ( error >= maxDifference )
+                    break;
+
+                src1 += stride;
+                src2 += stride;
+            }
+
+            return error;
+        }
+
+        // Calculate absolute differences of four pairs of 16 bit words, which keep values in the [0, 255] range
+        private static ulong AbsoluteDifference( ulong a, ulong b )
+        {
+            // each word is set to 256 + a - b, which is in the [1, 511] range, so no borrow happens between words
+            ulong v = ( a | NinthBitsMask ) - b;
+            // 1 in words where a is less than b
+            ulong negative = ( ~v >> 8 ) & LowBitsMask;
+            // absolute value of low byte's two's complement value
+            return ( ( v & EvenBytesMask ) ^ ( negative * 0xFF ) ) + negative;
+        }
+
+        // Sorter of found matchings
+        private class MatchingsSorter : System.Collections.Generic.IComparer<BlockMatch>
+        {
+            public int Compare( BlockMatch x, BlockMatch y )
+            {
+                float diff = y.Similarity - x.Similarity;
+
+                return ( diff > 0 ) ? 1 : ( diff < 0 ) ? -1 : 0;
+            }
+        }
+    }
+}
@@ -0,0 +1,771 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging
+{
+    using System;
+    using System.Collections.Generic;
+    using System.Drawing;
+    using System.Drawing.Imaging;
+    using System.Numerics;
+    using AForge.Math;
+
+    /// <summary>
+    /// Template matching based on normalized cross correlation.
+    /// </summary>
+    ///
+    /// <remarks><para>The class implements template matching algorithm, which uses normalized cross correlation
+    /// as similarity measure - correlation of template's and image's pixels' values with subtracted mean values
+    /// divided by their standard deviations. The similarity is in the [-1, 1] range, where 1 means that
+    /// image's fragment equals to template with some brightness and contrast change, so the measure is not
+    /// sensitive to lighting conditions unlike sum of absolute differences used by <see cref="ExhaustiveTemplateMatching"/>.
+    /// </para>
+    ///
+    /// <para>By default the class calculates correlation at all positions of template using Fast Fourier
+    /// transformation (see <see cref="FourierTransform"/>) - the search zone is split into blocks, which
+    /// size is power of 2 and several times bigger than template's size, and correlation of each block with
+    /// template is calculated as inverse Fourier transformation of product of their spectrums. Sums and sums of
+    /// squares of image's pixels under template, which are required for normalization, are calculated using
+    /// integral images. So processing time depends on template's size only logarithmically. Templates, which
+    /// do not fit into the largest block supported by Fourier transformation, are correlated directly.</para>
+    ///
+    /// <para>If <see cref="PyramidLevels"/> is set, the search is done in coarse-to-fine manner. Source image
+    /// and template are reduced twice the specified number of times, and all template's positions are checked
+    /// only at the coarsest level. Local maximums with similarity not less than <see cref="SimilarityThreshold"/>
+    /// minus 0.2 are taken as candidates, which are refined at each finer level checking only few positions
+    /// around each candidate. This makes search much faster, but matches, which are not distinctive at the coarse
+    /// level (for example, templates with fine textures), may be missed.</para>
+    ///
+    /// <para>The class processes only grayscale 8 bpp and color 24 bpp images. For color images correlation
+    /// is calculated for all color components together.</para>
+    ///
+    /// <para>Sample usage:</para>
+    /// <code>
+    /// // create template matching algorithm's instance
+    /// CorrelationTemplateMatching tm = new CorrelationTemplateMatching( 0.9f );
+    /// // search in reduced 4 times images first
+    /// tm.PyramidLevels = 2;
+    /// // find all matchings with specified above similarity
+    /// TemplateMatch[] matchings = tm.ProcessImage( sourceImage, templateImage );
+    /// // highlight found matchings
+    /// BitmapData data = sourceImage.LockBits(
+    ///     new Rectangle( 0, 0, sourceImage.Width, sourceImage.Height ),
+    ///     ImageLockMode.ReadWrite, sourceImage.PixelFormat );
+    /// foreach ( TemplateMatch m in matchings )
+    /// {
+    ///     Drawing.Rectangle( data, m.Rectangle, Color.White );
+    ///     // do something else with matching
+    /// }
+    /// sourceImage.UnlockBits( data );
+    /// </code>
+    /// </remarks>
+    ///
+    /// <seealso cref="ExhaustiveTemplateMatching"/>
+    ///
+    public class CorrelationTemplateMatching : ITemplateMatching
+    {
+        private float similarityThreshold = 0.9f;
+        private int pyramidLevels = 0;
+
+        // decrease of similarity threshold for candidates at coarse pyramid's levels
+        private const float CandidatesThresholdDecrease = 0.2f;
+        // minimum size of template at the coarsest pyramid's level
+        private const int MinTemplateSize = 8;
+
+        /// <summary>
+        /// Similarity threshold, [0..1].
+        /// </summary>
+        ///
+        /// <remarks><para>The property sets the minimal acceptable similarity between template
+        /// and potential found candidate. If similarity is lower than this value,
+        /// then object is not treated as matching with template.
+        /// </para>
+        ///
+        /// <para>Default value is set to <b>0.9</b>.</para>
+        /// </remarks>
+        ///
+        public float SimilarityThreshold
+        {
+            get { return similarityThreshold; }
+            set { similarityThreshold = Math.Min( 1, Math.Max( 0, value ) ); }
+        }
+
+        /// <summary>
+        /// Number of image pyramid's levels for coarse-to-fine search, [0..5].
+        /// </summary>
+        ///
+        /// <remarks><para>The property sets how many times source image and template are reduced twice
+        /// before full search. The number of levels is limited so template is not reduced below 8 pixels
+        /// on any side. If the value is set to 0, all template's positions are checked in the source image
+        /// without reduction.</para>
+        ///
+        /// <para>Default value is set to <b>0</b>.</para>
+        /// </remarks>
+        ///
+        public int PyramidLevels
+        {
+            get { return pyramidLevels; }
+            set { pyramidLevels = Math.Min( 5, Math.Max( 0, value ) ); }
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="CorrelationTemplateMatching"/> class.
+        /// </summary>
+        ///
+        public CorrelationTemplateMatching( ) { }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="CorrelationTemplateMatching"/> class.
+        /// </summary>
+        ///
+        /// <param name="similarityThreshold">Similarity threshold.</param>
+        ///
+        public CorrelationTemplateMatching( float similarityThreshold )
+        {
+            SimilarityThreshold = similarityThreshold;
+        }
+
+        /// <summary>
+        /// Process image looking for matchings with specified template.
+        /// </summary>
+        ///
+        /// <param name="image">Source image to process.</param>
+        /// <param name="template">Template image to search for.</param>
+        ///
+        /// <returns>Returns array of found template matches. The array is sorted by similarity
+        /// of found matches in descending order.</returns>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        /// <exception cref="InvalidImagePropertiesException">Template image is bigger than source image.</exception>
+        ///
+        public TemplateMatch[] ProcessImage( Bitmap image, Bitmap template )
+        {
+            return ProcessImage( image, template, new Rectangle( 0, 0, image.Width, image.Height ) );
+        }
+
+        /// <summary>
+        /// Process image looking for matchings with specified template.
+        /// </summary>
+        ///
+        /// <param name="image">Source image to process.</param>
+        /// <param name="template">Template image to search for.</param>
+        /// <param name="searchZone">Rectangle in source image to search template for.</param>
+        ///
+        /// <returns>Returns array of found template matches. The array is sorted by similarity
+        /// of found matches in descending order.</returns>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        /// <exception cref="InvalidImagePropertiesException">Template image is bigger than source image.</exception>
+        ///
+        public TemplateMatch[] ProcessImage( Bitmap image, Bitmap template, Rectangle searchZone )
+        {
+            // check image format
+            if (
+                ( ( image.PixelFormat != PixelFormat.Format8bppIndexed ) &&
+                  ( image.PixelFormat != PixelFormat.Format24bppRgb ) ) ||
+                ( image.PixelFormat != template.PixelFormat ) )
+            {
+                throw new UnsupportedImageFormatException( "Unsupported pixel format of the source or template image." );
+            }
+
+            // check template's size
+            if ( ( template.Width > image.Width ) || ( template.Height > image.Height ) )
+            {
+                throw new InvalidImagePropertiesException( "Template's size should be smaller or equal to source image's size." );
+            }
+
+            // lock source and template images
+            BitmapData imageData = image.LockBits(
+                new Rectangle( 0, 0, image.Width, image.Height ),
+                ImageLockMode.ReadOnly, image.PixelFormat );
+            BitmapData templateData = template.LockBits(
+                new Rectangle( 0, 0, template.Width, template.Height ),
+                ImageLockMode.ReadOnly, template.PixelFormat );
+
+            TemplateMatch[] matchings;
+
+            try
+            {
+                // process the image
+                matchings = ProcessImage(
+                    new UnmanagedImage( imageData ),
+                    new UnmanagedImage( templateData ),
+                    searchZone );
+            }
+            finally
+            {
+                // unlock images
+                image.UnlockBits( imageData );
+                template.UnlockBits( templateData );
+            }
+
+            return matchings;
+        }
+
+        /// <summary>
+        /// Process image looking for matchings with specified template.
+        /// </summary>
+        ///
+        /// <param name="imageData">Source image data to process.</param>
+        /// <param name="templateData">Template image to search for.</param>
+        ///
+        /// <returns>Returns array of found template matches. The array is sorted by similarity
+        /// of found matches in descending order.</returns>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        /// <exception cref="InvalidImagePropertiesException">Template image is bigger than source image.</exception>
+        ///
+        public TemplateMatch[] ProcessImage( BitmapData imageData, BitmapData templateData )
+        {
+            return ProcessImage( new UnmanagedImage( imageData ), new UnmanagedImage( templateData ),
+                new Rectangle( 0, 0, imageData.Width, imageData.Height ) );
+        }
+
+        /// <summary>
+        /// Process image looking for matchings with specified template.
+        /// </summary>
+        ///
+        /// <param name="imageData">Source image data to process.</param>
+        /// <param name="templateData">Template image to search for.</param>
+        /// <param name="searchZone">Rectangle in source image to search template for.</param>
+        ///
+        /// <returns>Returns array of found template matches. The array is sorted by similarity
+        /// of found matches in descending order.</returns>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        /// <exception cref="InvalidImagePropertiesException">Template image is bigger than source image.</exception>
+        ///
+        public TemplateMatch[] ProcessImage( BitmapData imageData, BitmapData templateData, Rectangle searchZone )
+        {
+            return ProcessImage( new UnmanagedImage( imageData ), new UnmanagedImage( templateData ), searchZone );
+        }
+
+        /// <summary>
+        /// Process image looking for matchings with specified template.
+        /// </summary>
+        ///
+        /// <param name="image">Unmanaged source image to process.</param>
+        /// <param name="template">Unmanaged template image to search for.</param>
+        ///
+        /// <returns>Returns array of found template matches. The array is sorted by similarity
+        /// of found matches in descending order.</returns>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        /// <exception cref="InvalidImagePropertiesException">Template image is bigger than source image.</exception>
+        ///
+        public TemplateMatch[] ProcessImage( UnmanagedImage image, UnmanagedImage template )
+        {
+            return ProcessImage( image, template, new Rectangle( 0, 0, image.Width, image.Height ) );
+        }
+
+        /// <summary>
+        /// Process image looking for matchings with specified template.
+        /// </summary>
+        ///
+        /// <param name="image">Unmanaged source image to process.</param>
+        /// <param name="template">Unmanaged template image to search for.</param>
+        /// <param name="searchZone">Rectangle in source image to search template for.</param>
+        ///
+        /// <returns>Returns array of found template matches. The array is sorted by similarity
+        /// of found matches in descending order.</returns>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        /// <exception cref="InvalidImagePropertiesException">Template image is bigger than search zone.</exception>
+        ///
+        public TemplateMatch[] ProcessImage( UnmanagedImage image, UnmanagedImage template, Rectangle searchZone )
+        {
+            // check image format
+            if (
+                ( ( image.PixelFormat != PixelFormat.Format8bppIndexed ) &&
+                  ( image.PixelFormat != PixelFormat.Format24bppRgb ) ) ||
+                ( image.PixelFormat != template.PixelFormat ) )
+            {
+                throw new UnsupportedImageFormatException( "Unsupported pixel format of the source or template image." );
+            }
+
+            // clip search zone
+            Rectangle zone = searchZone;
+            zone.Intersect( new Rectangle( 0, 0, image.Width, image.Height ) );
+
+            // check template's size
+            if ( ( template.Width > zone.Width ) || ( template.Height > zone.Height ) )
+            {
+                throw new InvalidImagePropertiesException( "Template's size should be smaller or equal to search zone." );
+            }
+
+            int pixelSize = ( image.PixelFormat == PixelFormat.Format8bppIndexed ) ? 1 : 3;
+
+            // build pyramids of source image and template
+            List<Plane> sources   = new List<Plane>( );
+            List<Plane> templates = new List<Plane>( );
+
+            sources.Add( new Plane( image, zone, pixelSize ) );
+            templates.Add( new Plane( template, new Rectangle( 0, 0, template.Width, template.Height ), pixelSize ) );
+
+            for ( int level = 0; level < pyramidLevels; level++ )
+            {
+                Plane tpl = templates[level];
+
+                if ( ( tpl.Width / 2 < MinTemplateSize ) || ( tpl.Height / 2 < MinTemplateSize ) )
+                    break;
+
+                sources.Add( sources[level].Reduce( ) );
+                templates.Add( tpl.Reduce( ) );
+            }
+
+            int levels = sources.Count;
+            float candidatesThreshold = ( levels == 1 ) ? similarityThreshold :
+                Math.Max( 0, similarityThreshold - CandidatesThresholdDecrease );
+
+            // check all positions at the coarsest level
+            Correlator correlator = new Correlator( sources[levels - 1], templates[levels - 1] );
+            List<TemplateMatch> candidates = correlator.FindLocalMaximums( correlator.CalculateMap( ), candidatesThreshold );
+
+            // refine candidates at finer levels
+            for ( int level = levels - 2; level >= 0; level-- )
+            {
+                correlator = new Correlator( sources[level], templates[level] );
+                candidates = correlator.Refine( candidates, ( level == 0 ) ? similarityThreshold : candidatesThreshold );
+            }
+
+            // convert list to array
+            TemplateMatch[] matchings = new TemplateMatch[candidates.Count];
+
+            for ( int i = 0; i < matchings.Length; i++ )
+            {
+                Rectangle rect = candidates[i].Rectangle;
+
+                matchings[i] = new TemplateMatch(
+                    new Rectangle( rect.X + zone.X, rect.Y + zone.Y, template.Width, template.Height ),
+                    candidates[i].Similarity );
+            }
+
+            // sort in descending order
+            Array.Sort( matchings, new MatchingsSorter( ) );
+
+            return matchings;
+        }
+
+        // Pixels' values of an image (with interleaved color components)
+        private class Plane
+        {
+            public readonly float[] Data;
+            public readonly int Width;
+            public readonly int Height;
+            public readonly int PixelSize;
+            public readonly int LineLength;
+
+            public Plane( int width, int height, int pixelSize )
+            {
+                Width      = width;
+                Height     = height;
+                PixelSize  = pixelSize;
+                LineLength = width * pixelSize;
+                Data       = new float[LineLength * height];
+            }
+
+            public unsafe Plane( UnmanagedImage image, Rectangle rect, int pixelSize ) :
+                this( rect.Width, rect.Height, pixelSize )
+            {
+                for ( int y = 0; y < Height; y++ )
+                {
+                    byte* src = (byte*) image.ImageData.ToPointer( ) + ( rect.Y + y ) * image.Stride + rect.X * pixelSize;
+
+                    for ( int i = 0, k = y * LineLength; i < LineLength; i++, k++ )
+                    {
+                        Data[k] = src[i];
+                    }
+                }
+            }
+
+            // Reduce size of the plane twice averaging 2x2 blocks of pixels
+            public Plane Reduce( )
+            {
+                Plane reduced = new Plane( Width / 2, Height / 2, PixelSize );
+
+                for ( int y = 0; y < reduced.Height; y++ )
+                {
+                    int k1 = 2 * y * LineLength;
+                    int k2 = k1 + LineLength;
+                    int k  = y * reduced.LineLength;
+
+                    for ( int x = 0; x < reduced.Width; x++ )
+                    {
+                        for ( int c = 0; c < PixelSize; c++, k++, k1++, k2++ )
+                        {
+                            reduced.Data[k] = ( Data[k1] + Data[k1 + PixelSize] + Data[k2] + Data[k2 + PixelSize] ) * 0.25f;
+                        }
+                        k1 += PixelSize;
+                        k2 += PixelSize;
+                    }
+                }
+
+                return reduced;
+            }
+        }
+
+        // Normalized cross correlation of template with source image
+        private class Correlator
+        {
+            private Plane source;
+            private Plane template;
+
+            // size of similarity map
+            private int mapWidth;
+            private int mapHeight;
+
+            // number of values under template
+            private int count;
+            // template's values with subtracted mean value and sum of their squares
+            private float[] zeroMeanTemplate;
+            private double templateSquaresSum;
+
+            // integral images of source values and their squares
+            private double[] sums;
+            private double[] squaresSums;
+
+            public Correlator( Plane source, Plane template )
+            {
+                this.source   = source;
+                this.template = template;
+
+                mapWidth  = source.Width - template.Width + 1;
+                mapHeight = source.Height - template.Height + 1;
+
+                count = template.LineLength * template.Height;
+
+                // subtract mean value from template
+                double mean = 0;
+
+                foreach ( float v in template.Data )
+                {
+                    mean += v;
+                }
+                mean /= count;
+
+                zeroMeanTemplate = new float[count];
+
+                for ( int i = 0; i < count; i++ )
+                {
+                    double v = template.Data[i] - mean;
+
+                    zeroMeanTemplate[i] = (float) v;
+                    templateSquaresSum += v * v;
+                }
+
+                // integral images of source
+                int integralWidth = source.LineLength + 1;
+
+                sums        = new double[integralWidth * ( source.Height + 1 )];
+                squaresSums = new double[integralWidth * ( source.Height + 1 )];
+
+                for ( int y = 0; y < source.Height; y++ )
+                {
+                    double rowSum = 0, rowSquaresSum = 0;
+                    int k = ( y + 1 ) * integralWidth + 1;
+
+                    for ( int i = 0, j = y * source.LineLength; i < source.LineLength; i++, j++, k++ )
+                    {
+                        double v = source.Data[j];
+
+                        rowSum        += v;
+                        rowSquaresSum += v * v;
+
+                        sums[k]        = sums[k - integralWidth] + rowSum;
+                        squaresSums[k] = squaresSums[k - integralWidth] + rowSquaresSum;
+                    }
+                }
+            }
+
+            // Calculate similarity map for all positions of template using Fast Fourier transformation
+            public float[,] CalculateMap( )
+            {
+                float[,] map = new float[mapHeight, mapWidth];
+
+                int pixelSize      = source.PixelSize;
+                int templateLength = template.LineLength;
+                int templateHeight = template.Height;
+
+                // size of blocks to process at once
+                int blockWidth  = Math.Min( GetBlockSize( templateLength ), GetBlockSize( source.LineLength ) );
+                int blockHeight = Math.Min( GetBlockSize( templateHeight ), GetBlockSize( source.Height ) );
+                // number of correlation values calculated from each block
+                int stepX = blockWidth - templateLength + 1;
+                int stepY = blockHeight - templateHeight + 1;
+                // scale factor of backward transformation
+                double scale = (double) blockWidth * blockHeight;
+
+                // template does not fit into the largest block supported by Fourier transformation,
+                // so correlation is calculated directly
+                if ( ( stepX < 1 ) || ( stepY < 1 ) )
+                {
+                    for ( int y = 0; y < mapHeight; y++ )
+                    {
+                        for ( int x = 0; x < mapWidth; x++ )
+                        {
+                            map[y, x] = Calculate( x, y );
+                        }
+                    }
+
+                    return map;
+                }
+
+                // spectrum of template
+                Complex[,] templateSpectrum = new Complex[blockHeight, blockWidth];
+
+                for ( int y = 0; y < templateHeight; y++ )
+                {
+                    for ( int x = 0; x < templateLength; x++ )
+                    {
+                        templateSpectrum[y, x] = new Complex( zeroMeanTemplate[y * templateLength + x], 0 );
+                    }
+                }
+
+                FourierTransform.FFT2( templateSpectrum, FourierTransform.Direction.Forward );
+
+                Complex[,] block = new Complex[blockHeight, blockWidth];
+                int mapLength = ( mapWidth - 1 ) * pixelSize + 1;
+
+                for ( int blockY = 0; blockY < mapHeight; blockY += stepY )
+                {
+                    for ( int blockX = 0; blockX < mapLength; blockX += stepX )
+                    {
+                        // copy source's block
+                        for ( int y = 0; y < blockHeight; y++ )
+                        {
+                            int sy = blockY + y;
+
+                            for ( int x = 0; x < blockWidth; x++ )
+                            {
+                                int sx = blockX + x;
+
+                                block[y, x] = ( ( sy < source.Height ) && ( sx < source.LineLength ) ) ?
+                                    new Complex( source.Data[sy * source.LineLength + sx], 0 ) : Complex.Zero;
+                            }
+                        }
+
+                        // correlation is inverse transformation of block's spectrum multiplied
+                        // by complex conjugate of template's spectrum
+                        FourierTransform.FFT2( block, FourierTransform.Direction.Forward );
+
+                        for ( int y = 0; y < blockHeight; y++ )
+                        {
+                            for ( int x = 0; x < blockWidth; x++ )
+                            {
+                                block[y, x] *= Complex.Conjugate( templateSpectrum[y, x] );
+                            }
+                        }
+
+                        FourierTransform.FFT2( block, FourierTransform.Direction.Backward );
+
+                        // normalize correlation values, which correspond to pixels' positions
+                        for ( int y = 0, stopY = Math.Min( stepY, mapHeight - blockY ); y < stopY; y++ )
+                        {
+                            for ( int x = ( pixelSize - blockX % pixelSize ) % pixelSize,
+                                  stopX = Math.Min( stepX, mapLength - blockX ); x < stopX; x += pixelSize )
+                            {
+                                int mx = ( blockX + x ) / pixelSize;
+                                int my = blockY + y;
+
+                                map[my, mx] = Normalize( block[y, x].Real * scale, mx, my );
+                            }
+                        }
+                    }
+                }
+
+                return map;
+            }
+
+            // Calculate similarity of template placed at the specified position
+            public float Calculate( int x, int y )
+            {
+                int templateLength = template.LineLength;
+                double correlation = 0;
+
+                for ( int i = 0; i < template.Height; i++ )
+                {
+                    int k = ( y + i ) * source.LineLength + x * source.PixelSize;
+                    int t = i * templateLength;
+
+                    for ( int j = 0; j < templateLength; j++, k++, t++ )
+                    {
+                        correlation += source.Data[k] * zeroMeanTemplate[t];
+                    }
+                }
+
+                return Normalize( correlation, x, y );
+            }
+
+            // Find local maximums of similarity map with similarity not less than the specified threshold
+            public List<TemplateMatch> FindLocalMaximums( float[,] map, float threshold )
+            {
+                List<TemplateMatch> matchings = new List<TemplateMatch>( );
+
+                // for each row
+                for ( int y = 0; y < mapHeight; y++ )
+                {
+                    // for each pixel
+                    for ( int x = 0; x < mapWidth; x++ )
+                    {
+                        float currentValue = map[y, x];
+
+                        if ( ( currentValue < threshold ) || ( currentValue <= 0 ) )
+                            continue;
+
+                        bool isMaximum = true;
+
+                        // for each windows' row
+                        for ( int i = Math.Max( 0, y - 2 ), maxI = Math.Min( mapHeight - 1, y + 2 ); ( isMaximum ) && ( i <= maxI ); i++ )
+                        {
+                            // for each windows' pixel
+                            for ( int j = Math.Max( 0, x - 2 ), maxJ = Math.Min( mapWidth - 1, x + 2 ); j <= maxJ; j++ )
+                            {
+                                if ( map[i, j] > currentValue )
+                                {
+                                    isMaximum = false;
+                                    break;
+                                }
+                            }
+                        }
+
+                        if ( isMaximum )
+                        {
+                            matchings.Add( new TemplateMatch( new Rectangle( x, y, template.Width, template.Height ), currentValue ) );
+                        }
+                    }
+                }
+
+                return matchings;
+            }
+
+            // Refine positions of candidates found at the coarser level
+            public List<TemplateMatch> Refine( List<TemplateMatch> candidates, float threshold )
+            {
+                // map of similarities calculated so far (NaN - not calculated)
+                float[,] map = new float[mapHeight, mapWidth];
+                List<TemplateMatch> refined = new List<TemplateMatch>( );
+
+                for ( int y = 0; y < mapHeight; y++ )
+                {
+                    for ( int x = 0; x < mapWidth; x++ )
+                    {
+                        map[y, x] = float.NaN;
+                    }
+                }
+
+                foreach ( TemplateMatch candidate in candidates )
+                {
+                    int bestX = 0, bestY = 0;
+                    float bestSimilarity = float.MinValue;
+
+                    // check positions around the candidate's position at this level
+                    for ( int y = Math.Max( 0, candidate.Rectangle.Y * 2 - 2 ),
+                          maxY = Math.Min( mapHeight - 1, candidate.Rectangle.Y * 2 + 3 ); y <= maxY; y++ )
+                    {
+                        for ( int x = Math.Max( 0, candidate.Rectangle.X * 2 - 2 ),
+                              maxX = Math.Min( mapWidth - 1, candidate.Rectangle.X * 2 + 3 ); x <= maxX; x++ )
+                        {
+                            if ( float.IsNaN( map[y, x] ) )
+                            {
+                                map[y, x] = Calculate( x, y );
+                            }
+
+                            if ( map[y, x] > bestSimilarity )
+                            {
+                                bestSimilarity = map[y, x];
+                                bestX = x;
+                                bestY = y;
+                            }
+                        }
+                    }
+
+                    if ( ( bestSimilarity >= threshold ) && ( bestSimilarity > 0 ) )
+                    {
+                        refined.Add( new TemplateMatch( new Rectangle( bestX, bestY, template.Width, template.Height ), bestSimilarity ) );
+                    }
+                }
+
+                // remove candidates, which are close to better candidates
+                refined.Sort( new MatchingsSorter( ) );
+
+                List<TemplateMatch> result = new List<TemplateMatch>( );
+
+                foreach ( TemplateMatch candidate in refined )
+                {
+                    bool isMaximum = true;
+
+                    foreach ( TemplateMatch better in result )
+                    {
+                        if ( ( Math.Abs( better.Rectangle.X - candidate.Rectangle.X ) <= 2 ) &&
+                             ( Math.Abs( better.Rectangle.Y - candidate.Rectangle.Y ) <= 2 ) )
+                        {
+                            isMaximum = false;
+                            break;
+                        }
+                    }
+
+                    if ( isMaximum )
+                    {
+                        result.Add( candidate );
+                    }
+                }
+
+                return result;
+            }
+
+            // Normalize correlation of zero mean template with source at the specified position
+            private float Normalize( double correlation, int x, int y )
+            {
+                int integralWidth = source.LineLength + 1;
+                int x1 = x * source.PixelSize;
+                int x2 = x1 + template.LineLength;
+                int y1 = y * integralWidth;
+                int y2 = ( y + template.Height ) * integralWidth;
+
+                double sum = sums[y2 + x2] - sums[y2 + x1] - sums[y1 + x2] + sums[y1 + x1];
+                double squaresSum = squaresSums[y2 + x2] - squaresSums[y2 + x1] - squaresSums[y1 + x2] + squaresSums[y1 + x1];
+                double variance = squaresSum - sum * sum / count;
+
+                // similarity is not defined for flat areas
+                if ( ( variance <= 1e-6 * count ) || ( templateSquaresSum <= 1e-6 * count ) )
+                    return 0;
+
+                return (float) Math.Max( -1, Math.Min( 1, correlation / Math.Sqrt( variance * templateSquaresSum ) ) );
+            }
+
+            // Get size of block for Fourier transformation, which is power of 2 several times bigger than the specified size
+            private static int GetBlockSize( int size )
+            {
+                int blockSize = 2;
+
+                while ( ( blockSize < size * 4 ) && ( blockSize < 16384 ) )
+                {
+                    blockSize <<= 1;
+                }
+
+                return blockSize;
+            }
+        }
+
+        // Sorter of found matchings
+        private class MatchingsSorter : System.Collections.IComparer, IComparer<TemplateMatch>
+        {
+            public int Compare( Object x, Object y )
+            {
+                return Compare( (TemplateMatch) x, (TemplateMatch) y );
+            }
+
+            public int Compare( TemplateMatch x, TemplateMatch y )
+            {
+                float diff = y.Similarity - x.Similarity;
+
+                return ( diff > 0 ) ? 1 : ( diff < 0 ) ? -1 : 0;
+            }
+        }
+    }
+}
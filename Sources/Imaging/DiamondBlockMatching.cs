@@ -0,0 +1,140 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging
+{
+    using System;
+
+    /// <summary>
+    /// Block matching implementation with the diamond search algorithm.
+    /// </summary>
+    ///
+    /// <remarks><para>The class implements diamond search block matching algorithm
+    /// (see documentation for <see cref="IBlockMatching"/> for information about
+    /// block matching algorithms). The algorithm checks locations of a large diamond pattern (8 locations
+    /// at a distance of 2 around the center) moving the pattern to the best location, until the center
+    /// becomes the best one. Then the final location is chosen checking 4 nearest neighbours of the
+    /// center. Since only few new locations are checked on each move, the algorithm is very fast for
+    /// small displacements, which are typical for video processing, but still can follow displacements
+    /// up to the whole search radius.</para>
+    ///
+    /// <para><note>The algorithm assumes that difference of blocks grows monotonically with the distance
+    /// from the best match, so it may stop at a local minimum in the case of repetitive textures.</note></para>
+    ///
+    /// <para><note>The class processes only grayscale (8 bpp indexed) and color (24 bpp) images.</note></para>
+    ///
+    /// <para>Sample usage:</para>
+    /// <code>
+    /// // collect reference points using corners detector (for example)
+    /// SusanCornersDetector scd = new SusanCornersDetector( 30, 18 );
+    /// List&lt;IntPoint&gt; points = scd.ProcessImage( sourceImage );
+    ///
+    /// // create block matching algorithm's instance
+    /// DiamondBlockMatching bm = new DiamondBlockMatching( 8, 12 );
+    /// // stop search as soon as very similar block is found
+    /// bm.SufficientSimilarity = 0.98f;
+    /// // process images searching for block matchings
+    /// List&lt;BlockMatch&gt; matches = bm.ProcessImage( sourceImage, points, searchImage );
+    /// </code>
+    /// </remarks>
+    ///
+    /// <seealso cref="ExhaustiveBlockMatching"/>
+    /// <seealso cref="ThreeStepBlockMatching"/>
+    ///
+    public class DiamondBlockMatching : BlockMatchingBase
+    {
+        // large diamond search pattern
+        private static readonly int[] largeDiamondX = new int[] { 0, 1, 2, 1, 0, -1, -2, -1 };
+        private static readonly int[] largeDiamondY = new int[] { -2, -1, 0, 1, 2, 1, 0, -1 };
+        // small diamond search pattern
+        private static readonly int[] smallDiamondX = new int[] { 0, 1, 0, -1 };
+        private static readonly int[] smallDiamondY = new int[] { -1, 0, 1, 0 };
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="DiamondBlockMatching"/> class.
+        /// </summary>
+        public DiamondBlockMatching( ) { }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="DiamondBlockMatching"/> class.
+        /// </summary>
+        ///
+        /// <param name="blockSize">Block size to search for.</param>
+        /// <param name="searchRadius">Search radius.</param>
+        ///
+        public DiamondBlockMatching( int blockSize, int searchRadius )
+            : base( blockSize, searchRadius ) { }
+
+        /// <summary>
+        /// Search for block's location with minimal difference within search window.
+        /// </summary>
+        ///
+        /// <param name="difference">Method to calculate difference of blocks for the specified displacement.</param>
+        /// <param name="sufficientDifference">Difference, which is small enough to stop search.</param>
+        /// <param name="minDifference">Difference of the best found location.</param>
+        ///
+        /// <returns>Returns displacement of the best found location of block in search image.</returns>
+        ///
+        protected override IntPoint SearchBlock( BlockDifference difference, int sufficientDifference, out int minDifference )
+        {
+            int centerX = 0, centerY = 0;
+            minDifference = difference( 0, 0, int.MaxValue );
+
+            // move large diamond until its center is the best location
+            while ( minDifference > sufficientDifference )
+            {
+                int bestX = centerX, bestY = centerY;
+
+                for ( int i = 0; i < largeDiamondX.Length; i++ )
+                {
+                    int dx = centerX + largeDiamondX[i];
+                    int dy = centerY + largeDiamondY[i];
+                    int error = difference( dx, dy, minDifference );
+
+                    if ( error < minDifference )
+                    {
+                        minDifference = error;
+                        bestX = dx;
+                        bestY = dy;
+                    }
+                }
+
+                if ( ( bestX == centerX ) && ( bestY == centerY ) )
+                    break;
+
+                centerX = bestX;
+                centerY = bestY;
+            }
+
+            // final check with small diamond
+            if ( minDifference > sufficientDifference )
+            {
+                int bestX = centerX, bestY = centerY;
+
+                for ( int i = 0; i < smallDiamondX.Length; i++ )
+                {
+                    int dx = centerX + smallDiamondX[i];
+                    int dy = centerY + smallDiamondY[i];
+                    int error = difference( dx, dy, minDifference );
+
+                    if ( error < minDifference )
+                    {
+                        minDifference = error;
+                        bestX = dx;
+                        bestY = dy;
+                    }
+                }
+
+                centerX = bestX;
+                centerY = bestY;
+            }
+
+            return new IntPoint( centerX, centerY );
+        }
+    }
+}
@@ -12,6 +12,7 @@ namespace AForge.Imaging
     using System.Drawing;
     using System.Drawing.Imaging;
     using System.Collections.Generic;
+    using System.Threading.Tasks;
 
     /// <summary>
     /// Exhaustive template matching.
@@ -23,6 +24,10 @@ namespace AForge.Imaging
     /// 
     /// <para>The class processes only grayscale 8 bpp and color 24 bpp images.</para>
     /// 
+    /// <para>When many templates should be searched in the same image, it is much faster to pass
+    /// all of them to single <see cref="ProcessImage(UnmanagedImage, UnmanagedImage[], Rectangle)"/> call
+    /// instead of calling the method for each template separately.</para>
+    /// 
     /// <para>Sample usage:</para>
     /// <code>
     /// // create template matching algorithm's instance
@@ -343,6 +348,504 @@ namespace AForge.Imaging
                 }
             }
 
+            return CollectMatchings( map, mapWidth, mapHeight, startX, startY,
+                templateWidth, templateHeight, maxDiff );
+        }
+
+        /// <summary>
+        /// Process image looking for matchings with several templates.
+        /// </summary>
+        /// 
+        /// <param name="image">Source image to process.</param>
+        /// <param name="templates">Template images to search for.</param>
+        /// 
+        /// <returns>Returns array of found matches for each template in the order templates are
+        /// specified. Each array is sorted by similarity of found matches in descending order.</returns>
+        /// 
+        /// <remarks><para>See <see cref="ProcessImage(UnmanagedImage, UnmanagedImage[], Rectangle)"/>
+        /// for details.</para></remarks>
+        /// 
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        /// <exception cref="InvalidImagePropertiesException">Template image is bigger than source image.</exception>
+        /// 
+        public TemplateMatch[][] ProcessImage( Bitmap image, Bitmap[] templates )
+        {
+            return ProcessImage( image, templates, new Rectangle( 0, 0, image.Width, image.Height ) );
+        }
+
+        /// <summary>
+        /// Process image looking for matchings with several templates.
+        /// </summary>
+        /// 
+        /// <param name="image">Source image to process.</param>
+        /// <param name="templates">Template images to search for.</param>
+        /// <param name="searchZone">Rectangle in source image to search templates for.</param>
+        /// 
+        /// <returns>Returns array of found matches for each template in the order templates are
+        /// specified. Each array is sorted by similarity of found matches in descending order.</returns>
+        /// 
+        /// <remarks><para>See <see cref="ProcessImage(UnmanagedImage, UnmanagedImage[], Rectangle)"/>
+        /// for details.</para></remarks>
+        /// 
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        /// <exception cref="InvalidImagePropertiesException">Template image is bigger than source image.</exception>
+        /// 
+        public TemplateMatch[][] ProcessImage( Bitmap image, Bitmap[] templates, Rectangle searchZone )
+        {
+            // check image format
+            if ( ( image.PixelFormat != PixelFormat.Format8bppIndexed ) &&
+                 ( image.PixelFormat != PixelFormat.Format24bppRgb ) )
+            {
+                throw new UnsupportedImageFormatException( "Unsupported pixel format of the source image." );
+            }
+
+            foreach ( Bitmap template in templates )
+            {
+                if ( template.PixelFormat != image.PixelFormat )
+                    throw new UnsupportedImageFormatException( "Unsupported pixel format of the template image." );
+            }
+
+            // lock source and template images
+            BitmapData imageData = image.LockBits(
+                new Rectangle( 0, 0, image.Width, image.Height ),
+                ImageLockMode.ReadOnly, image.PixelFormat );
+            BitmapData[] templatesData = new BitmapData[templates.Length];
+
+            TemplateMatch[][] matchings;
+
+            try
+            {
+                UnmanagedImage[] unmanagedTemplates = new UnmanagedImage[templates.Length];
+
+                for ( int i = 0; i < templates.Length; i++ )
+                {
+                    templatesData[i] = templates[i].LockBits(
+                        new Rectangle( 0, 0, templates[i].Width, templates[i].Height ),
+                        ImageLockMode.ReadOnly, templates[i].PixelFormat );
+                    unmanagedTemplates[i] = new UnmanagedImage( templatesData[i] );
+                }
+
+                // process the image
+                matchings = ProcessImage( new UnmanagedImage( imageData ), unmanagedTemplates, searchZone );
+            }
+            finally
+            {
+                // unlock images
+                image.UnlockBits( imageData );
+
+                for ( int i = 0; i < templates.Length; i++ )
+                {
+                    if ( templatesData[i] != null )
+                        templates[i].UnlockBits( templatesData[i] );
+                }
+            }
+
+            return matchings;
+        }
+
+        /// <summary>
+        /// Process image looking for matchings with several templates.
+        /// </summary>
+        /// 
+        /// <param name="imageData">Source image data to process.</param>
+        /// <param name="templatesData">Template images to search for.</param>
+        /// 
+        /// <returns>Returns array of found matches for each template in the order templates are
+        /// specified. Each array is sorted by similarity of found matches in descending order.</returns>
+        /// 
+        /// <remarks><para>See <see cref="ProcessImage(UnmanagedImage, UnmanagedImage[], Rectangle)"/>
+        /// for details.</para></remarks>
+        /// 
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        /// <exception cref="InvalidImagePropertiesException">Template image is bigger than source image.</exception>
+        /// 
+        public TemplateMatch[][] ProcessImage( BitmapData imageData, BitmapData[] templatesData )
+        {
+            return ProcessImage( imageData, templatesData, new Rectangle( 0, 0, imageData.Width, imageData.Height ) );
+        }
+
+        /// <summary>
+        /// Process image looking for matchings with several templates.
+        /// </summary>
+        /// 
+        /// <param name="imageData">Source image data to process.</param>
+        /// <param name="templatesData">Template images to search for.</param>
+        /// <param name="searchZone">Rectangle in source image to search templates for.</param>
+        /// 
+        /// <returns>Returns array of found matches for each template in the order templates are
+        /// specified. Each array is sorted by similarity of found matches in descending order.</returns>
+        /// 
+        /// <remarks><para>See <see cref="ProcessImage(UnmanagedImage, UnmanagedImage[], Rectangle)"/>
+        /// for details.</para></remarks>
+        /// 
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        /// <exception cref="InvalidImagePropertiesException">Template image is bigger than source image.</exception>
+        /// 
+        public TemplateMatch[][] ProcessImage( BitmapData imageData, BitmapData[] templatesData, Rectangle searchZone )
+        {
+            UnmanagedImage[] templates = new UnmanagedImage[templatesData.Length];
+
+            for ( int i = 0; i < templatesData.Length; i++ )
+            {
+                templates[i] = new UnmanagedImage( templatesData[i] );
+            }
+
+            return ProcessImage( new UnmanagedImage( imageData ), templates, searchZone );
+        }
+
+        /// <summary>
+        /// Process image looking for matchings with several templates.
+        /// </summary>
+        /// 
+        /// <param name="image">Unmanaged source image to process.</param>
+        /// <param name="templates">Unmanaged template images to search for.</param>
+        /// 
+        /// <returns>Returns array of found matches for each template in the order templates are
+        /// specified. Each array is sorted by similarity of found matches in descending order.</returns>
+        /// 
+        /// <remarks><para>See <see cref="ProcessImage(UnmanagedImage, UnmanagedImage[], Rectangle)"/>
+        /// for details.</para></remarks>
+        /// 
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        /// <exception cref="InvalidImagePropertiesException">Template image is bigger than source image.</exception>
+        ///
+        public TemplateMatch[][] ProcessImage( UnmanagedImage image, UnmanagedImage[] templates )
+        {
+            return ProcessImage( image, templates, new Rectangle( 0, 0, image.Width, image.Height ) );
+        }
+
+        /// <summary>
+        /// Process image looking for matchings with several templates.
+        /// </summary>
+        /// 
+        /// <param name="image">Unmanaged source image to process.</param>
+        /// <param name="templates">Unmanaged template images to search for.</param>
+        /// <param name="searchZone">Rectangle in source image to search templates for.</param>
+        /// 
+        /// <returns>Returns array of found matches for each template in the order templates are
+        /// specified. Each array is sorted by similarity of found matches in descending order.</returns>
+        /// 
+        /// <remarks><para>The method provides the same result as calling <see cref="ProcessImage(UnmanagedImage, UnmanagedImage, Rectangle)"/>
+        /// for each template, but it is much faster when many templates are searched in the same image.
+        /// Templates of the same size are grouped and each group is processed with single pass over the
+        /// source image - each window of the source image is compared with all templates of the group
+        /// while it stays in CPU cache. Only few last rows of similarity map are kept for each template,
+        /// so memory usage does not grow much with the number of templates. Bands of rows of the source
+        /// image are processed in parallel on multi-core systems.</para></remarks>
+        /// 
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        /// <exception cref="InvalidImagePropertiesException">Template image is bigger than search zone.</exception>
+        ///
+        public TemplateMatch[][] ProcessImage( UnmanagedImage image, UnmanagedImage[] templates, Rectangle searchZone )
+        {
+            // check image format
+            if ( ( image.PixelFormat != PixelFormat.Format8bppIndexed ) &&
+                 ( image.PixelFormat != PixelFormat.Format24bppRgb ) )
+            {
+                throw new UnsupportedImageFormatException( "Unsupported pixel format of the source image." );
+            }
+
+            // clip search zone
+            Rectangle zone = searchZone;
+            zone.Intersect( new Rectangle( 0, 0, image.Width, image.Height ) );
+
+            // group templates by size
+            List<List<int>> groups = new List<List<int>>( );
+
+            for ( int i = 0; i < templates.Length; i++ )
+            {
+                UnmanagedImage template = templates[i];
+
+                if ( template.PixelFormat != image.PixelFormat )
+                {
+                    throw new UnsupportedImageFormatException( "Unsupported pixel format of the template image." );
+                }
+
+                // check template's size
+                if ( ( template.Width > zone.Width ) || ( template.Height > zone.Height ) )
+                {
+                    throw new InvalidImagePropertiesException( "Template's size should be smaller or equal to search zone." );
+                }
+
+                List<int> group = null;
+
+                foreach ( List<int> g in groups )
+                {
+                    if ( ( templates[g[0]].Width == template.Width ) && ( templates[g[0]].Height == template.Height ) )
+                    {
+                        group = g;
+                        break;
+                    }
+                }
+
+                if ( group == null )
+                {
+                    group = new List<int>( );
+                    groups.Add( group );
+                }
+                group.Add( i );
+            }
+
+            TemplateMatch[][] matchings = new TemplateMatch[templates.Length][];
+
+            foreach ( List<int> group in groups )
+            {
+                ProcessTemplatesGroup( image, templates, group.ToArray( ), zone, matchings );
+            }
+
+            return matchings;
+        }
+
+        // Search for group of templates of the same size
+        private void ProcessTemplatesGroup( UnmanagedImage image, UnmanagedImage[] templates, int[] group,
+            Rectangle zone, TemplateMatch[][] matchings )
+        {
+            int templatesCount = group.Length;
+            int templateWidth  = templates[group[0]].Width;
+            int templateHeight = templates[group[0]].Height;
+
+            int pixelSize = ( image.PixelFormat == PixelFormat.Format8bppIndexed ) ? 1 : 3;
+            int templateWidthInBytes = templateWidth * pixelSize;
+
+            // size of similarity maps
+            int mapWidth  = zone.Width - templateWidth + 1;
+            int mapHeight = zone.Height - templateHeight + 1;
+
+            // maximum possible difference with template
+            int maxDiff = templateWidthInBytes * templateHeight * 255;
+
+            // integer similarity threshold
+            int threshold = (int) ( similarityThreshold * maxDiff );
+
+            // values of all templates are copied into single array, so they can be
+            // compared one after another with the same window of source image
+            int templateSize = templateWidthInBytes * templateHeight;
+            byte[] values = new byte[templateSize * templatesCount];
+
+            // rows of similarity maps are split into bands, which are processed in parallel. each band
+            // also calculates 2 rows of its neighbour bands, which are needed for non-maximum suppression
+            int bandsCount = ( Environment.ProcessorCount > 1 ) ?
+                Math.Max( 1, Math.Min( Environment.ProcessorCount * 2, mapHeight / 16 ) ) : 1;
+            List<TemplateMatch>[,] bandsMatchings = new List<TemplateMatch>[bandsCount, templatesCount];
+
+            unsafe
+            {
+                for ( int k = 0, v = 0; k < templatesCount; k++ )
+                {
+                    UnmanagedImage template = templates[group[k]];
+                    byte* tpl = (byte*) template.ImageData.ToPointer( );
+
+                    for ( int i = 0; i < templateHeight; i++ )
+                    {
+                        for ( int j = 0; j < templateWidthInBytes; j++, v++ )
+                        {
+                            values[v] = tpl[i * template.Stride + j];
+                        }
+                    }
+                }
+
+                byte* baseSrc = (byte*) image.ImageData.ToPointer( ) + zone.Y * image.Stride + zone.X * pixelSize;
+                int stride = image.Stride;
+
+                // each worker keeps only few last rows of similarity map for each template
+                Parallel.For( 0, bandsCount, delegate
+                {
+                    return new SimilarityRows( templatesCount, mapWidth );
+                },
+                delegate( int band, ParallelLoopState state, SimilarityRows rows )
+                {
+                    int startY = band * mapHeight / bandsCount;
+                    int stopY  = ( band + 1 ) * mapHeight / bandsCount;
+
+                    for ( int k = 0; k < templatesCount; k++ )
+                    {
+                        bandsMatchings[band, k] = new List<TemplateMatch>( );
+                    }
+
+                    fixed ( byte* tpl = values )
+                    {
+                        for ( int y = startY - 2; y < stopY + 2; y++ )
+                        {
+                            if ( ( y >= 0 ) && ( y < mapHeight ) )
+                            {
+                                ProcessTemplatesRow( baseSrc + y * stride, stride, pixelSize, tpl, templatesCount,
+                                    templateWidthInBytes, templateHeight, mapWidth, maxDiff, threshold, rows, y );
+                            }
+                            else
+                            {
+                                rows.ClearRow( y );
+                            }
+
+                            // all neighbours of the row, which is 2 rows above, are known now
+                            if ( y - 2 >= startY )
+                            {
+                                for ( int k = 0; k < templatesCount; k++ )
+                                {
+                                    CollectRowMatchings( rows, k, y - 2, mapWidth, zone.X, zone.Y,
+                                        templateWidth, templateHeight, maxDiff, bandsMatchings[band, k] );
+                                }
+                            }
+                        }
+                    }
+
+                    return rows;
+                },
+                delegate( SimilarityRows rows ) { } );
+            }
+
+            for ( int k = 0; k < templatesCount; k++ )
+            {
+                // merge matchings of all bands in the order of rows, so sorting them gives
+                // the same result as for the single template
+                List<TemplateMatch> matchingsList = new List<TemplateMatch>( );
+
+                for ( int band = 0; band < bandsCount; band++ )
+                {
+                    matchingsList.AddRange( bandsMatchings[band, k] );
+                }
+
+                TemplateMatch[] templateMatchings = matchingsList.ToArray( );
+                Array.Sort( templateMatchings, new MatchingsSorter( ) );
+
+                matchings[group[k]] = templateMatchings;
+            }
+        }
+
+        // Last rows of similarity maps of a group of templates. Rows are increased by 2 from
+        // each side to increase performance of non-maximum suppresion
+        private class SimilarityRows
+        {
+            // number of rows needed for non-maximum suppression in 5x5 window
+            public const int RowsCount = 5;
+
+            public readonly int RowLength;
+            public readonly int[][] Maps;
+
+            public SimilarityRows( int templatesCount, int mapWidth )
+            {
+                RowLength = mapWidth + 4;
+                Maps = new int[templatesCount][];
+
+                for ( int k = 0; k < templatesCount; k++ )
+                {
+                    Maps[k] = new int[RowsCount * RowLength];
+                }
+            }
+
+            // Offset of the first pixel of the specified row of similarity map (y >= -2)
+            public int RowOffset( int y )
+            {
+                return ( ( y + 2 ) % RowsCount ) * RowLength + 2;
+            }
+
+            // Clear the specified row of all similarity maps
+            public void ClearRow( int y )
+            {
+                int offset = RowOffset( y ) - 2;
+
+                foreach ( int[] map in Maps )
+                {
+                    Array.Clear( map, offset, RowLength );
+                }
+            }
+        }
+
+        // Compare group of templates with source image at all positions of the specified row
+        private static unsafe void ProcessTemplatesRow( byte* src, int stride, int pixelSize, byte* values, int templatesCount,
+            int templateWidthInBytes, int templateHeight, int mapWidth, int maxDiff, int threshold, SimilarityRows rows, int y )
+        {
+            int sourceOffset = stride - templateWidthInBytes;
+            // maximum difference, which still gives similarity above threshold
+            int maxAllowedDiff = maxDiff - threshold;
+            int rowOffset = rows.RowOffset( y );
+
+            // for each pixel of the source image's row
+            for ( int x = 0; x < mapWidth; x++ )
+            {
+                byte* tpl = values;
+
+                // compare all templates with the same window of source image,
+                // which stays in cache while templates are compared
+                for ( int k = 0; k < templatesCount; k++ )
+                {
+                    byte* s = src + x * pixelSize;
+                    int dif = 0;
+
+                    // for each row of the template
+                    for ( int i = 0; i < templateHeight; i++ )
+                    {
+                        // for each pixel of the template
+                        for ( int j = 0; j < templateWidthInBytes; j++, s++, tpl++ )
+                        {
+                            int d = *s - *tpl;
+                            if ( d > 0 )
+                            {
+                                dif += d;
+                            }
+                            else
+                            {
+                                dif -= d;
+                            }
+                        }
+                        s += sourceOffset;
+
+                        // similarity can not reach threshold any more
+                        if ( dif > maxAllowedDiff )
+                        {
+                            tpl += ( templateHeight - i - 1 ) * templateWidthInBytes;
+                            break;
+                        }
+                    }
+
+                    // rows are reused, so values below threshold must be cleared
+                    rows.Maps[k][rowOffset + x] = ( dif <= maxAllowedDiff ) ? maxDiff - dif : 0;
+                }
+            }
+        }
+
+        // Collect points of the specified row, which are local maximums of similarity map, as matchings
+        private static void CollectRowMatchings( SimilarityRows rows, int k, int y, int mapWidth, int startX, int startY,
+            int templateWidth, int templateHeight, int maxDiff, List<TemplateMatch> matchingsList )
+        {
+            int[] map = rows.Maps[k];
+            int rowOffset = rows.RowOffset( y );
+
+            // for each pixel
+            for ( int x = 0; x < mapWidth; x++ )
+            {
+                int currentValue = map[rowOffset + x];
+
+                // for each windows' row
+                for ( int i = -2; ( currentValue != 0 ) && ( i <= 2 ); i++ )
+                {
+                    int offset = rows.RowOffset( y + i ) + x;
+
+                    // for each windows' pixel
+                    for ( int j = -2; j <= 2; j++ )
+                    {
+                        if ( map[offset + j] > currentValue )
+                        {
+                            currentValue = 0;
+                            break;
+                        }
+                    }
+                }
+
+                // check if this point is really interesting
+                if ( currentValue != 0 )
+                {
+                    matchingsList.Add( new TemplateMatch(
+                        new Rectangle( x + startX, y + startY, templateWidth, templateHeight ),
+                        (float) currentValue / maxDiff ) );
+                }
+            }
+        }
+
+        // Collect points, which are local maximums of similarity map, as matchings
+        // sorted in descending order
+        private static TemplateMatch[] CollectMatchings( int[,] map, int mapWidth, int mapHeight,
+            int startX, int startY, int templateWidth, int templateHeight, int maxDiff )
+        {
             // collect interesting points - only those points, which are local maximums
             List<TemplateMatch> matchingsList = new List<TemplateMatch>( );
 
@@ -146,8 +146,18 @@ namespace AForge.Imaging.Filters
                 // for each line
                 for ( int y = 0; y < height; y++ )
                 {
+                    int x = 0;
+
+                    // process 8 bytes at once
+                    if ( PixelKernels.IsEnabled )
+                    {
+                        x = PixelKernels.Difference( ptr, ovr, lineSize );
+                        ptr += x;
+                        ovr += x;
+                    }
+
                     // for each pixel
-                    for ( int x = 0; x < lineSize; x++, ptr++, ovr++ )
+                    for ( ; x < lineSize; x++, ptr++, ovr++ )
                     {
                         // abs(sub)
                         v = (int) *ptr - (int) *ovr;
@@ -136,8 +136,18 @@ namespace AForge.Imaging.Filters
                 // for each line
                 for ( int y = 0; y < height; y++ )
                 {
+                    int x = 0;
+
+                    // process 8 bytes at once
+                    if ( PixelKernels.IsEnabled )
+                    {
+                        x = PixelKernels.Min( ptr, ovr, lineSize );
+                        ptr += x;
+                        ovr += x;
+                    }
+
                     // for each pixel
-                    for ( int x = 0; x < lineSize; x++, ptr++, ovr++ )
+                    for ( ; x < lineSize; x++, ptr++, ovr++ )
                     {
                         if ( *ovr < *ptr )
                             *ptr = *ovr;
@@ -140,8 +140,18 @@ namespace AForge.Imaging.Filters
                 // for each line
                 for ( int y = 0; y < height; y++ )
                 {
+                    int x = 0;
+
+                    // process 8 bytes at once
+                    if ( PixelKernels.IsEnabled )
+                    {
+                        x = PixelKernels.Subtract( ptr, ovr, lineSize );
+                        ptr += x;
+                        ovr += x;
+                    }
+
                     // for each pixel
-                    for ( int x = 0; x < lineSize; x++, ptr++, ovr++ )
+                    for ( ; x < lineSize; x++, ptr++, ovr++ )
                     {
                         v = (int) *ptr - (int) *ovr;
                         *ptr = ( v < 0 ) ? (byte) 0 : (byte) v;
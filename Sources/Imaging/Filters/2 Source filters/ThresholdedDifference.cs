@@ -147,12 +147,25 @@ namespace AForge.Imaging.Filters
                 int srcOffset = sourceData.Stride - width;
                 int ovrOffset = overlay.Stride - width;
                 int dstOffset = destinationData.Stride - width;
+                // vectorized processing is possible only if threshold fits into a byte
+                bool useKernels = ( PixelKernels.IsEnabled ) && ( threshold >= 0 ) && ( threshold <= 255 );
 
                 // for each line
                 for ( int y = 0; y < height; y++ )
                 {
+                    int x = 0;
+
+                    // process 8 pixels at once
+                    if ( useKernels )
+                    {
+                        x = PixelKernels.ThresholdedDifference( src, ovr, dst, width, (byte) threshold, ref whitePixelsCount );
+                        src += x;
+                        ovr += x;
+                        dst += x;
+                    }
+
                     // for each pixel
-                    for ( int x = 0; x < width; x++, src++, ovr++, dst++ )
+                    for ( ; x < width; x++, src++, ovr++, dst++ )
                     {
                         int diff = *src - *ovr;
 
@@ -74,6 +74,18 @@ namespace AForge.Imaging.Filters
             set { minError = value; }
         }
 
+        /// <summary>
+        /// Specifies if processing of image's rows by the filter is independent.
+        /// </summary>
+        /// 
+        /// <remarks><para>The filter calculates threshold for the entire processing rectangle, so its
+        /// stripes can not be processed independently.</para></remarks>
+        /// 
+        protected override bool IsRowIndependent
+        {
+            get { return false; }
+        }
+
         /// <summary>
         /// Initializes a new instance of the <see cref="IterativeThreshold"/> class.
         /// </summary>
@@ -292,6 +304,19 @@ namespace AForge.Imaging.Filters
             return calculatedThreshold;
         }
 
+        /// <summary>
+        /// Get lookup tables, which are used by the filter for images of the specified pixel format.
+        /// </summary>
+        /// 
+        /// <param name="pixelFormat">Pixel format of image to get lookup tables for.</param>
+        /// 
+        /// <returns>Always returns <see langword="null"/>, since threshold value depends on the processed image.</returns>
+        /// 
+        public override byte[][] GetLookupTables( PixelFormat pixelFormat )
+        {
+            return null;
+        }
+
         /// <summary>
         /// Process the filter on the specified image.
         /// </summary>
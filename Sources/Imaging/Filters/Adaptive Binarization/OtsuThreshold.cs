@@ -11,6 +11,7 @@ namespace AForge.Imaging.Filters
     using System.Collections.Generic;
     using System.Drawing;
     using System.Drawing.Imaging;
+    using System.Threading.Tasks;
 
     /// <summary>
     /// Otsu thresholding.
@@ -24,7 +25,9 @@ namespace AForge.Imaging.Filters
     /// does maximization of between-class variance, what gives the same result. The approach is
     /// described in <a href="http://sampl.ece.ohio-state.edu/EE863/2004/ECE863-G-segclust2.ppt">this presentation</a>.</para>
     /// 
-    /// <para>The filter accepts 8 bpp grayscale images for processing.</para>
+    /// <para>The filter accepts 8 bpp grayscale images for processing. Histogram of big images is collected
+    /// splitting them into horizontal stripes, which are processed in parallel (see
+    /// <see cref="BaseInPlacePartialFilter.MaxDegreeOfParallelism"/>).</para>
     /// 
     /// <para>Sample usage:</para>
     /// <code>
@@ -167,7 +170,8 @@ namespace AForge.Imaging.Filters
             int startY  = rect.Top;
             int stopX   = startX + rect.Width;
             int stopY   = startY + rect.Height;
-            int offset  = image.Stride - rect.Width;
+            int stride  = image.Stride;
+            int offset  = stride - rect.Width;
 
             // histogram array
             int[] integerHistogram = new int[256];
@@ -179,17 +183,55 @@ namespace AForge.Imaging.Filters
                 byte* ptr = (byte*) image.ImageData.ToPointer( );
 
                 // allign pointer to the first pixel to process
-                ptr += ( startY * image.Stride + startX );
+                ptr += ( startY * stride + startX );
 
-                // for each line	
-                for ( int y = startY; y < stopY; y++ )
+                int stripesCount = FilterParallelism.GetStripesCount( rect, MaxDegreeOfParallelism );
+
+                if ( stripesCount > 1 )
+                {
+                    // each thread collects histogram of its stripes, which is
+                    // added to the resulting histogram when the thread completes
+                    Parallel.For<int[]>( 0, stripesCount,
+                        delegate { return new int[256]; },
+                        delegate( int stripe, ParallelLoopState state, int[] localHistogram )
+                        {
+                            int stripeStartY = (int) ( (long) rect.Height * stripe / stripesCount );
+                            int stripeStopY  = (int) ( (long) rect.Height * ( stripe + 1 ) / stripesCount );
+
+                            for ( int y = stripeStartY; y < stripeStopY; y++ )
+                            {
+                                byte* rowPtr = ptr + y * stride;
+
+                                for ( int x = startX; x < stopX; x++, rowPtr++ )
+                                {
+                                    localHistogram[*rowPtr]++;
+                                }
+                            }
+                            return localHistogram;
+                        },
+                        delegate( int[] localHistogram )
+                        {
+                            lock ( integerHistogram )
+                            {
+                                for ( int i = 0; i < 256; i++ )
+                                {
+                                    integerHistogram[i] += localHistogram[i];
+                                }
+                            }
+                        } );
+                }
+                else
                 {
-                    // for each pixel
-                    for ( int x = startX; x < stopX; x++, ptr++ )
+                    // for each line
+                    for ( int y = startY; y < stopY; y++ )
                     {
-                        integerHistogram[*ptr]++;
+                        // for each pixel
+                        for ( int x = startX; x < stopX; x++, ptr++ )
+                        {
+                            integerHistogram[*ptr]++;
+                        }
+                        ptr += offset;
                     }
-                    ptr += offset;
                 }
 
                 // pixels count in the processing region
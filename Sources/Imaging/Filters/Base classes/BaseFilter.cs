@@ -44,6 +44,51 @@ namespace AForge.Imaging.Filters
         ///
         public abstract Dictionary<PixelFormat, PixelFormat> FormatTranslations { get; }
 
+        private int maxDegreeOfParallelism = 0;
+
+        // processor of image's stripes
+        private readonly FilterParallelism.StripeProcessor stripeProcessor;
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="BaseFilter"/> class.
+        /// </summary>
+        /// 
+        protected BaseFilter( )
+        {
+            stripeProcessor = new FilterParallelism.StripeProcessor( ProcessStripe );
+        }
+
+        /// <summary>
+        /// Maximum number of image's stripes processed in parallel by the filter.
+        /// </summary>
+        /// 
+        /// <remarks><para>Value <b>0</b> means that the limit is set by <see cref="FilterParallelism.MaxDegreeOfParallelism"/>.
+        /// See <see cref="FilterParallelism"/> for details.</para>
+        /// 
+        /// <para>Default value is set to <b>0</b>.</para>
+        /// </remarks>
+        /// 
+        public int MaxDegreeOfParallelism
+        {
+            get { return maxDegreeOfParallelism; }
+            set { maxDegreeOfParallelism = Math.Max( 0, value ); }
+        }
+
+        /// <summary>
+        /// Specifies if processing of image's rows by the filter is independent.
+        /// </summary>
+        /// 
+        /// <remarks><para>If the property is set to <see langword="true"/>, <see cref="ProcessFilter(UnmanagedImage, UnmanagedImage)"/>
+        /// is called for stripes of image in parallel (see <see cref="FilterParallelism"/>).</para>
+        /// 
+        /// <para>Default value is set to <see langword="false"/>.</para>
+        /// </remarks>
+        /// 
+        protected virtual bool IsRowIndependent
+        {
+            get { return false; }
+        }
+
 		/// <summary>
 		/// Apply filter to an image.
 		/// </summary>
@@ -125,7 +170,8 @@ namespace AForge.Imaging.Filters
             try
             {
                 // process the filter
-                ProcessFilter( new UnmanagedImage( imageData ), new UnmanagedImage( dstData ) );
+                FilterParallelism.ProcessStripes( new UnmanagedImage( imageData ), new UnmanagedImage( dstData ),
+                    new Rectangle( 0, 0, width, height ), IsRowIndependent, maxDegreeOfParallelism, stripeProcessor );
             }
             finally
             {
@@ -159,7 +205,8 @@ namespace AForge.Imaging.Filters
             UnmanagedImage dstImage = UnmanagedImage.Create( image.Width, image.Height, FormatTranslations[image.PixelFormat] );
 
             // process the filter
-            ProcessFilter( image, dstImage );
+            FilterParallelism.ProcessStripes( image, dstImage, new Rectangle( 0, 0, image.Width, image.Height ),
+                IsRowIndependent, maxDegreeOfParallelism, stripeProcessor );
 
             return dstImage;
         }
@@ -201,7 +248,8 @@ namespace AForge.Imaging.Filters
             }
 
             // process the filter
-            ProcessFilter( sourceImage, destinationImage );
+            FilterParallelism.ProcessStripes( sourceImage, destinationImage, new Rectangle( 0, 0, sourceImage.Width, sourceImage.Height ),
+                IsRowIndependent, maxDegreeOfParallelism, stripeProcessor );
         }
 
         /// <summary>
@@ -213,6 +261,20 @@ namespace AForge.Imaging.Filters
         /// 
         protected abstract unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData );
 
+        // Process the specified rows of images
+        private void ProcessStripe( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect, int startY, int stopY )
+        {
+            if ( ( startY == rect.Top ) && ( stopY == rect.Bottom ) )
+            {
+                ProcessFilter( sourceData, destinationData );
+            }
+            else
+            {
+                ProcessFilter( FilterParallelism.GetRowsView( sourceData, startY, stopY ),
+                               FilterParallelism.GetRowsView( destinationData, startY, stopY ) );
+            }
+        }
+
         // Check pixel format of the source image
         private void CheckSourceFormat( PixelFormat pixelFormat )
         {
@@ -38,6 +38,51 @@ namespace AForge.Imaging.Filters
         ///
         public abstract Dictionary<PixelFormat, PixelFormat> FormatTranslations { get; }
 
+        private int maxDegreeOfParallelism = 0;
+
+        // processor of image's stripes
+        private readonly FilterParallelism.StripeProcessor stripeProcessor;
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="BaseInPlacePartialFilter"/> class.
+        /// </summary>
+        /// 
+        protected BaseInPlacePartialFilter( )
+        {
+            stripeProcessor = new FilterParallelism.StripeProcessor( ProcessStripe );
+        }
+
+        /// <summary>
+        /// Maximum number of image's stripes processed in parallel by the filter.
+        /// </summary>
+        /// 
+        /// <remarks><para>Value <b>0</b> means that the limit is set by <see cref="FilterParallelism.MaxDegreeOfParallelism"/>.
+        /// See <see cref="FilterParallelism"/> for details.</para>
+        /// 
+        /// <para>Default value is set to <b>0</b>.</para>
+        /// </remarks>
+        /// 
+        public int MaxDegreeOfParallelism
+        {
+            get { return maxDegreeOfParallelism; }
+            set { maxDegreeOfParallelism = Math.Max( 0, value ); }
+        }
+
+        /// <summary>
+        /// Specifies if processing of image's rows by the filter is independent.
+        /// </summary>
+        /// 
+        /// <remarks><para>If the property is set to <see langword="true"/>, <see cref="ProcessFilter(UnmanagedImage, Rectangle)"/>
+        /// is called for stripes of image in parallel (see <see cref="FilterParallelism"/>).</para>
+        /// 
+        /// <para>Default value is set to <see langword="false"/>.</para>
+        /// </remarks>
+        /// 
+        protected virtual bool IsRowIndependent
+        {
+            get { return false; }
+        }
+
         /// <summary>
         /// Apply filter to an image.
         /// </summary>
@@ -122,7 +167,10 @@ namespace AForge.Imaging.Filters
             try
             {
                 // process the filter
-                ProcessFilter( new UnmanagedImage( dstData ), new Rectangle( 0, 0, width, height ) );
+                UnmanagedImage image = new UnmanagedImage( dstData );
+
+                FilterParallelism.ProcessStripes( image, image, new Rectangle( 0, 0, width, height ),
+                    IsRowIndependent, maxDegreeOfParallelism, stripeProcessor );
             }
             finally
             {
@@ -217,7 +265,9 @@ namespace AForge.Imaging.Filters
             }
 
             // process the filter
-            ProcessFilter( destinationImage, new Rectangle( 0, 0, destinationImage.Width, destinationImage.Height ) );
+            FilterParallelism.ProcessStripes( destinationImage, destinationImage,
+                new Rectangle( 0, 0, destinationImage.Width, destinationImage.Height ),
+                IsRowIndependent, maxDegreeOfParallelism, stripeProcessor );
         }
 
         /// <summary>
@@ -252,7 +302,10 @@ namespace AForge.Imaging.Filters
             CheckSourceFormat( imageData.PixelFormat );
 
             // apply the filter
-            ProcessFilter( new UnmanagedImage( imageData ), new Rectangle( 0, 0, imageData.Width, imageData.Height ) );
+            UnmanagedImage image = new UnmanagedImage( imageData );
+
+            FilterParallelism.ProcessStripes( image, image, new Rectangle( 0, 0, imageData.Width, imageData.Height ),
+                IsRowIndependent, maxDegreeOfParallelism, stripeProcessor );
         }
 
         /// <summary>
@@ -271,7 +324,8 @@ namespace AForge.Imaging.Filters
             CheckSourceFormat( image.PixelFormat );
 
             // process the filter
-            ProcessFilter( image, new Rectangle( 0, 0, image.Width, image.Height ) );
+            FilterParallelism.ProcessStripes( image, image, new Rectangle( 0, 0, image.Width, image.Height ),
+                IsRowIndependent, maxDegreeOfParallelism, stripeProcessor );
         }
 
         /// <summary>
@@ -342,7 +396,7 @@ namespace AForge.Imaging.Filters
 
             // process the filter if rectangle is not empty
             if ( ( rect.Width | rect.Height ) != 0 )
-                ProcessFilter( image, rect );
+                FilterParallelism.ProcessStripes( image, image, rect, IsRowIndependent, maxDegreeOfParallelism, stripeProcessor );
         }
 
         /// <summary>
@@ -354,6 +408,12 @@ namespace AForge.Imaging.Filters
         ///
         protected abstract unsafe void ProcessFilter( UnmanagedImage image, Rectangle rect );
 
+        // Process the specified rows of image's rectangle
+        private void ProcessStripe( UnmanagedImage source, UnmanagedImage image, Rectangle rect, int startY, int stopY )
+        {
+            ProcessFilter( image, new Rectangle( rect.Left, startY, rect.Width, stopY - startY ) );
+        }
+
         // Check pixel format of the source image
         private void CheckSourceFormat( PixelFormat pixelFormat )
         {
@@ -47,6 +47,51 @@ namespace AForge.Imaging.Filters
         ///
         public abstract Dictionary<PixelFormat, PixelFormat> FormatTranslations { get; }
 
+        private int maxDegreeOfParallelism = 0;
+
+        // processor of image's stripes
+        private readonly FilterParallelism.StripeProcessor stripeProcessor;
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="BaseUsingCopyPartialFilter"/> class.
+        /// </summary>
+        /// 
+        protected BaseUsingCopyPartialFilter( )
+        {
+            stripeProcessor = new FilterParallelism.StripeProcessor( ProcessStripe );
+        }
+
+        /// <summary>
+        /// Maximum number of image's stripes processed in parallel by the filter.
+        /// </summary>
+        /// 
+        /// <remarks><para>Value <b>0</b> means that the limit is set by <see cref="FilterParallelism.MaxDegreeOfParallelism"/>.
+        /// See <see cref="FilterParallelism"/> for details.</para>
+        /// 
+        /// <para>Default value is set to <b>0</b>.</para>
+        /// </remarks>
+        /// 
+        public int MaxDegreeOfParallelism
+        {
+            get { return maxDegreeOfParallelism; }
+            set { maxDegreeOfParallelism = Math.Max( 0, value ); }
+        }
+
+        /// <summary>
+        /// Specifies if processing of image's rows by the filter is independent.
+        /// </summary>
+        /// 
+        /// <remarks><para>If the property is set to <see langword="true"/>, <see cref="ProcessFilter(UnmanagedImage, UnmanagedImage, Rectangle, int, int)"/>
+        /// is called for stripes of image in parallel (see <see cref="FilterParallelism"/>).</para>
+        /// 
+        /// <para>Default value is set to <see langword="false"/>.</para>
+        /// </remarks>
+        /// 
+        protected virtual bool IsRowIndependent
+        {
+            get { return false; }
+        }
+
         /// <summary>
         /// Apply filter to an image.
         /// </summary>
@@ -128,7 +173,8 @@ namespace AForge.Imaging.Filters
             try
             {
                 // process the filter
-                ProcessFilter( new UnmanagedImage( imageData ), new UnmanagedImage( dstData ), new Rectangle( 0, 0, width, height ) );
+                FilterParallelism.ProcessStripes( new UnmanagedImage( imageData ), new UnmanagedImage( dstData ),
+                    new Rectangle( 0, 0, width, height ), IsRowIndependent, maxDegreeOfParallelism, stripeProcessor );
             }
             finally
             {
@@ -162,7 +208,8 @@ namespace AForge.Imaging.Filters
             UnmanagedImage dstImage = UnmanagedImage.Create( image.Width, image.Height, FormatTranslations[image.PixelFormat] );
 
             // process the filter
-            ProcessFilter( image, dstImage, new Rectangle( 0, 0, image.Width, image.Height ) );
+            FilterParallelism.ProcessStripes( image, dstImage, new Rectangle( 0, 0, image.Width, image.Height ),
+                IsRowIndependent, maxDegreeOfParallelism, stripeProcessor );
 
             return dstImage;
         }
@@ -204,7 +251,8 @@ namespace AForge.Imaging.Filters
             }
 
             // process the filter
-            ProcessFilter( sourceImage, destinationImage, new Rectangle( 0, 0, sourceImage.Width, sourceImage.Height ) );
+            FilterParallelism.ProcessStripes( sourceImage, destinationImage, new Rectangle( 0, 0, sourceImage.Width, sourceImage.Height ),
+                IsRowIndependent, maxDegreeOfParallelism, stripeProcessor );
         }
 
         /// <summary>
@@ -331,9 +379,9 @@ namespace AForge.Imaging.Filters
                 AForge.SystemTools.CopyUnmanagedMemory( imageCopy, image.ImageData, size );
 
                 // process the filter
-                ProcessFilter(
+                FilterParallelism.ProcessStripes(
                     new UnmanagedImage( imageCopy, image.Width, image.Height, image.Stride, image.PixelFormat ),
-                    image, rect );
+                    image, rect, IsRowIndependent, maxDegreeOfParallelism, stripeProcessor );
 
                 MemoryManager.Free( imageCopy );
             }
@@ -349,6 +397,40 @@ namespace AForge.Imaging.Filters
         /// 
         protected abstract unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect );
 
+        /// <summary>
+        /// Process the filter on the specified rows of image's rectangle.
+        /// </summary>
+        /// 
+        /// <param name="sourceData">Source image data.</param>
+        /// <param name="destinationData">Destination image data.</param>
+        /// <param name="rect">Image rectangle for processing by the filter.</param>
+        /// <param name="startY">First row of the rectangle to process.</param>
+        /// <param name="stopY">Row following the last row of the rectangle to process.</param>
+        /// 
+        /// <remarks><para>The method is used to process stripes of image in parallel (see <see cref="IsRowIndependent"/>).
+        /// It must put into destination image only rows of the [<paramref name="startY"/>, <paramref name="stopY"/>) range,
+        /// but may use all pixels of the rectangle as neighbours, so the result does not depend on the way image was split.
+        /// Default implementation processes rectangle of the specified rows, which is enough for filters producing each
+        /// row from the same row of source image. Filters, which use neighbour rows, must override the method.</para></remarks>
+        /// 
+        protected virtual unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect, int startY, int stopY )
+        {
+            ProcessFilter( sourceData, destinationData, new Rectangle( rect.Left, startY, rect.Width, stopY - startY ) );
+        }
+
+        // Process the specified rows of image's rectangle
+        private void ProcessStripe( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect, int startY, int stopY )
+        {
+            if ( ( startY == rect.Top ) && ( stopY == rect.Bottom ) )
+            {
+                ProcessFilter( sourceData, destinationData, rect );
+            }
+            else
+            {
+                ProcessFilter( sourceData, destinationData, rect, startY, stopY );
+            }
+        }
+
         // Check pixel format of the source image
         private void CheckSourceFormat( PixelFormat pixelFormat )
         {
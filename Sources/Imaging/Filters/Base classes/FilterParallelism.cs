@@ -0,0 +1,143 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging.Filters
+{
+    using System;
+    using System.Drawing;
+    using System.Drawing.Imaging;
+    using System.Threading.Tasks;
+
+    /// <summary>
+    /// Global settings of parallel image processing done by filters.
+    /// </summary>
+    /// 
+    /// <remarks><para>Filters based on <see cref="BaseFilter"/>, <see cref="BaseInPlacePartialFilter"/>
+    /// and <see cref="BaseUsingCopyPartialFilter"/> may declare that processing of image's rows is
+    /// independent overriding <b>IsRowIndependent</b> property. It is the case for filters, which produce
+    /// each row of result image from the corresponding row of source image (or from its neighbourhood for
+    /// <see cref="BaseUsingCopyPartialFilter"/>) and do not keep any state between rows. Such filters process
+    /// images splitting them into horizontal stripes, which are processed in parallel, so their <b>ProcessFilter()</b>
+    /// method must be safe to be called from multiple threads.</para>
+    /// 
+    /// <para>The class allows to limit the number of stripes processed simultaneously by all such filters.
+    /// The limit may be overridden by each filter (see <see cref="BaseFilter.MaxDegreeOfParallelism"/>
+    /// for example), where value <b>0</b> means that the global limit is used and value <b>1</b> disables
+    /// parallel processing.</para>
+    /// 
+    /// <para>Sample usage:</para>
+    /// <code>
+    /// // process images by all filters in a single thread
+    /// FilterParallelism.MaxDegreeOfParallelism = 1;
+    /// // ... but let median filter to use 2 threads
+    /// Median filter = new Median( );
+    /// filter.MaxDegreeOfParallelism = 2;
+    /// filter.ApplyInPlace( image );
+    /// </code>
+    /// </remarks>
+    /// 
+    public static class FilterParallelism
+    {
+        private static int maxDegreeOfParallelism = Environment.ProcessorCount;
+
+        // minimum number of pixels in a stripe, so it is worth processing it in a separate thread
+        private const int MinPixelsInStripe = 64 * 1024;
+
+        /// <summary>
+        /// Maximum number of image's stripes processed in parallel by filters.
+        /// </summary>
+        /// 
+        /// <remarks><para>The value is used by filters, which have their own limit set to <b>0</b>.
+        /// Setting the property to <b>1</b> disables parallel processing of such filters.</para>
+        /// 
+        /// <para>Default value is set to the number of CPUs in the system (see <see cref="Environment.ProcessorCount"/>).
+        /// Minimum allowed value is <b>1</b>.</para>
+        /// </remarks>
+        /// 
+        public static int MaxDegreeOfParallelism
+        {
+            get { return maxDegreeOfParallelism; }
+            set { maxDegreeOfParallelism = Math.Max( 1, value ); }
+        }
+
+        // Delegate processing rows of the [startY, stopY) range of images' rectangle
+        internal delegate void StripeProcessor( UnmanagedImage source, UnmanagedImage destination, Rectangle rect, int startY, int stopY );
+
+        // Get number of stripes to split the rectangle into taking into account filter's degree of parallelism
+        internal static int GetStripesCount( Rectangle rect, int filterMaxDegreeOfParallelism )
+        {
+            int degreeOfParallelism = ( filterMaxDegreeOfParallelism > 0 ) ?
+                filterMaxDegreeOfParallelism : maxDegreeOfParallelism;
+
+            if ( ( degreeOfParallelism <= 1 ) || ( rect.Height < 2 ) )
+                return 1;
+
+            long stripes = (long) rect.Width * rect.Height / MinPixelsInStripe;
+
+            return (int) Math.Max( 1, Math.Min( Math.Min( degreeOfParallelism, rect.Height ), stripes ) );
+        }
+
+        // Process the rectangle of images by a filter splitting it into stripes, if the filter's rows are independent
+        internal static void ProcessStripes( UnmanagedImage source, UnmanagedImage destination, Rectangle rect,
+                                             bool isRowIndependent, int filterMaxDegreeOfParallelism, StripeProcessor processor )
+        {
+            int stripesCount = ( isRowIndependent ) ? GetStripesCount( rect, filterMaxDegreeOfParallelism ) : 1;
+
+            ProcessStripes( source, destination, rect, stripesCount, processor );
+        }
+
+        // Process the rectangle of images in the specified number of stripes. Each stripe is processed
+        // by the processor directly in the specified images, getting range of the stripe's rows.
+        internal static void ProcessStripes( UnmanagedImage source, UnmanagedImage destination, Rectangle rect,
+                                             int stripesCount, StripeProcessor processor )
+        {
+            if ( stripesCount <= 1 )
+            {
+                processor( source, destination, rect, rect.Top, rect.Bottom );
+            }
+            else
+            {
+                ProcessStripesInParallel( source, destination, rect, stripesCount, processor );
+            }
+        }
+
+        // Process stripes in parallel (kept separately, so processing single stripe does not allocate
+        // anything for variables captured by the anonymous method)
+        private static void ProcessStripesInParallel( UnmanagedImage source, UnmanagedImage destination, Rectangle rect,
+                                                      int stripesCount, StripeProcessor processor )
+        {
+            Parallel.For( 0, stripesCount, delegate( int stripe )
+            {
+                int startY = rect.Top + (int) ( (long) rect.Height * stripe / stripesCount );
+                int stopY  = rect.Top + (int) ( (long) rect.Height * ( stripe + 1 ) / stripesCount );
+
+                processor( source, destination, rect, startY, stopY );
+            } );
+        }
+
+        // Fill with black those pixels of the rectangle's border, which belong to the specified rows
+        internal static void ClearBorder( UnmanagedImage image, Rectangle rect, int startY, int stopY )
+        {
+            if ( startY == rect.Top )
+                Drawing.FillRectangle( image, new Rectangle( rect.Left, rect.Top, rect.Width, 1 ), Color.Black );
+            if ( stopY == rect.Bottom )
+                Drawing.FillRectangle( image, new Rectangle( rect.Left, rect.Bottom - 1, rect.Width, 1 ), Color.Black );
+
+            Drawing.FillRectangle( image, new Rectangle( rect.Left, startY, 1, stopY - startY ), Color.Black );
+            Drawing.FillRectangle( image, new Rectangle( rect.Right - 1, startY, 1, stopY - startY ), Color.Black );
+        }
+
+        // Get image representing the specified rows of the image without copying them
+        internal static unsafe UnmanagedImage GetRowsView( UnmanagedImage image, int startY, int stopY )
+        {
+            return new UnmanagedImage(
+                new IntPtr( (byte*) image.ImageData.ToPointer( ) + (long) startY * image.Stride ),
+                image.Width, stopY - startY, image.Stride, image.PixelFormat );
+        }
+    }
+}
@@ -0,0 +1,48 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging.Filters
+{
+    using System;
+    using System.Collections.Generic;
+
+    // Arrays, which are used by a filter as working memory and kept between filter's calls, so they
+    // are not allocated for each processed image. Each stripe of image processed in parallel (see
+    // FilterParallelism) takes its own array and returns it back, when the stripe is done.
+    internal sealed class ScratchArrays<T>
+    {
+        private readonly Stack<T[]> arrays = new Stack<T[]>( );
+
+        // Take array of at least the specified length, which content is undefined
+        public T[] Take( int length )
+        {
+            lock ( arrays )
+            {
+                // arrays, which are too short, are dropped, so the kept ones grow up to the longest required
+                while ( arrays.Count != 0 )
+                {
+                    T[] array = arrays.Pop( );
+
+                    if ( array.Length >= length )
+                        return array;
+                }
+            }
+
+            return new T[length];
+        }
+
+        // Return array taken before, so it could be used again
+        public void Return( T[] array )
+        {
+            lock ( arrays )
+            {
+                arrays.Push( array );
+            }
+        }
+    }
+}
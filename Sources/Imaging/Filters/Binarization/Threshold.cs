@@ -41,7 +41,7 @@ namespace AForge.Imaging.Filters
     /// <img src="img/imaging/threshold.jpg" width="480" height="361" />
     /// </remarks>
     /// 
-    public class Threshold : BaseInPlacePartialFilter
+    public class Threshold : BaseInPlacePartialFilter, ILookupTableFilter
     {
         /// <summary>
         /// Threshold value.
@@ -59,6 +59,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>
         /// Threshold value.
         /// </summary>
@@ -94,6 +100,31 @@ namespace AForge.Imaging.Filters
             this.threshold = threshold;
         }
 
+        /// <summary>
+        /// Get lookup tables, which are used by the filter for images of the specified pixel format.
+        /// </summary>
+        /// 
+        /// <param name="pixelFormat">Pixel format of image to get lookup tables for.</param>
+        /// 
+        /// <returns>Returns array of lookup tables or <see langword="null"/> if the pixel format is not
+        /// supported (see <see cref="ILookupTableFilter.GetLookupTables"/>).</returns>
+        /// 
+        public virtual byte[][] GetLookupTables( PixelFormat pixelFormat )
+        {
+            // 16 bpp grayscale images are not processed using lookup table
+            if ( pixelFormat != PixelFormat.Format8bppIndexed )
+                return null;
+
+            byte[] table = new byte[256];
+
+            for ( int i = 0; i < 256; i++ )
+            {
+                table[i] = (byte) ( ( i >= threshold ) ? 255 : 0 );
+            }
+
+            return new byte[][] { table };
+        }
+
         /// <summary>
         /// Process the filter on the specified image.
         /// </summary>
@@ -111,6 +142,8 @@ namespace AForge.Imaging.Filters
             if ( image.PixelFormat == PixelFormat.Format8bppIndexed )
             {
                 int offset = image.Stride - rect.Width;
+                // vectorized processing is possible only if threshold fits into a byte
+                bool useKernels = ( PixelKernels.IsEnabled ) && ( threshold >= 0 ) && ( threshold <= 255 );
 
                 // do the job
                 byte* ptr = (byte*) image.ImageData.ToPointer( );
@@ -121,8 +154,18 @@ namespace AForge.Imaging.Filters
                 // for each line	
                 for ( int y = startY; y < stopY; y++ )
                 {
+                    int x = startX;
+
+                    // process 8 pixels at once
+                    if ( useKernels )
+                    {
+                        int processed = PixelKernels.Threshold( ptr, rect.Width, (byte) threshold );
+                        x   += processed;
+                        ptr += processed;
+                    }
+
                     // for each pixel
-                    for ( int x = startX; x < stopX; x++, ptr++ )
+                    for ( ; x < stopX; x++, ptr++ )
                     {
                         *ptr = (byte) ( ( *ptr >= threshold ) ? 255 : 0 );
                     }
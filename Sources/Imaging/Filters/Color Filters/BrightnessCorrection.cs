@@ -47,7 +47,7 @@ namespace AForge.Imaging.Filters
     /// 
     /// <seealso cref="LevelsLinear"/>
     /// 
-    public class BrightnessCorrection : BaseInPlacePartialFilter
+    public class BrightnessCorrection : BaseInPlacePartialFilter, ILookupTableFilter
     {
         private LevelsLinear baseFilter = new LevelsLinear( );
         private int adjustValue;
@@ -115,6 +115,20 @@ namespace AForge.Imaging.Filters
             AdjustValue = adjustValue;
         }
 
+        /// <summary>
+        /// Get lookup tables, which are used by the filter for images of the specified pixel format.
+        /// </summary>
+        /// 
+        /// <param name="pixelFormat">Pixel format of image to get lookup tables for.</param>
+        /// 
+        /// <returns>Returns array of lookup tables or <see langword="null"/> if the pixel format is not
+        /// supported (see <see cref="ILookupTableFilter.GetLookupTables"/>).</returns>
+        /// 
+        public byte[][] GetLookupTables( PixelFormat pixelFormat )
+        {
+            return baseFilter.GetLookupTables( pixelFormat );
+        }
+
         /// <summary>
         /// Process the filter on the specified image.
         /// </summary>
@@ -78,6 +78,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         #region Public properties
 
         /// <summary>
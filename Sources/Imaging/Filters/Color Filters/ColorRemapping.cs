@@ -45,7 +45,7 @@ namespace AForge.Imaging.Filters
     /// <img src="img/imaging/color_remapping.jpg" width="480" height="361" />
     /// </remarks>
     /// 
-    public class ColorRemapping : BaseInPlacePartialFilter
+    public class ColorRemapping : BaseInPlacePartialFilter, ILookupTableFilter
     {
         // color maps
         private byte[] redMap;
@@ -64,6 +64,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>
         /// Remapping array for red color plane.
         /// </summary>
@@ -208,6 +214,31 @@ namespace AForge.Imaging.Filters
             GrayMap = grayMap;
         }
 
+        /// <summary>
+        /// Get lookup tables, which are used by the filter for images of the specified pixel format.
+        /// </summary>
+        /// 
+        /// <param name="pixelFormat">Pixel format of image to get lookup tables for.</param>
+        /// 
+        /// <returns>Returns array of lookup tables or <see langword="null"/> if the pixel format is not
+        /// supported (see <see cref="ILookupTableFilter.GetLookupTables"/>).</returns>
+        /// 
+        public byte[][] GetLookupTables( PixelFormat pixelFormat )
+        {
+            if ( !formatTranslations.ContainsKey( pixelFormat ) )
+                return null;
+
+            if ( pixelFormat == PixelFormat.Format8bppIndexed )
+                return new byte[][] { (byte[]) grayMap.Clone( ) };
+
+            byte[][] tables = new byte[3][];
+            tables[RGB.R] = (byte[]) redMap.Clone( );
+            tables[RGB.G] = (byte[]) greenMap.Clone( );
+            tables[RGB.B] = (byte[]) blueMap.Clone( );
+
+            return tables;
+        }
+
         /// <summary>
         /// Process the filter on the specified image.
         /// </summary>
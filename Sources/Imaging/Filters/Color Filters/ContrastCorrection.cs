@@ -48,7 +48,7 @@ namespace AForge.Imaging.Filters
     ///
     /// <seealso cref="LevelsLinear"/>
     /// 
-    public class ContrastCorrection : BaseInPlacePartialFilter
+    public class ContrastCorrection : BaseInPlacePartialFilter, ILookupTableFilter
     {
         private LevelsLinear baseFilter = new LevelsLinear( );
         private int factor;
@@ -122,6 +122,20 @@ namespace AForge.Imaging.Filters
             Factor = factor;
         }
 
+        /// <summary>
+        /// Get lookup tables, which are used by the filter for images of the specified pixel format.
+        /// </summary>
+        /// 
+        /// <param name="pixelFormat">Pixel format of image to get lookup tables for.</param>
+        /// 
+        /// <returns>Returns array of lookup tables or <see langword="null"/> if the pixel format is not
+        /// supported (see <see cref="ILookupTableFilter.GetLookupTables"/>).</returns>
+        /// 
+        public byte[][] GetLookupTables( PixelFormat pixelFormat )
+        {
+            return baseFilter.GetLookupTables( pixelFormat );
+        }
+
         /// <summary>
         /// Process the filter on the specified image.
         /// </summary>
@@ -61,6 +61,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>
         /// RGB sphere's radius, [0, 450].
         /// </summary>
@@ -56,6 +56,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>
         /// ARGB channel to extract.
         /// </summary>
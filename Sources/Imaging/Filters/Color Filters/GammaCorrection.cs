@@ -36,7 +36,7 @@ namespace AForge.Imaging.Filters
     /// <img src="img/imaging/gamma.jpg" width="480" height="361" />
     /// </remarks>
     /// 
-    public class GammaCorrection : BaseInPlacePartialFilter
+    public class GammaCorrection : BaseInPlacePartialFilter, ILookupTableFilter
     {
         private double gamma;
         private byte[] table = new byte[256];
@@ -52,6 +52,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>
         /// Gamma value, [0.1, 5.0].
         /// </summary>
@@ -98,6 +104,31 @@ namespace AForge.Imaging.Filters
         }
 
 
+        /// <summary>
+        /// Get lookup tables, which are used by the filter for images of the specified pixel format.
+        /// </summary>
+        /// 
+        /// <param name="pixelFormat">Pixel format of image to get lookup tables for.</param>
+        /// 
+        /// <returns>Returns array of lookup tables or <see langword="null"/> if the pixel format is not
+        /// supported (see <see cref="ILookupTableFilter.GetLookupTables"/>).</returns>
+        /// 
+        public byte[][] GetLookupTables( PixelFormat pixelFormat )
+        {
+            if ( !formatTranslations.ContainsKey( pixelFormat ) )
+                return null;
+
+            int channels = ( pixelFormat == PixelFormat.Format8bppIndexed ) ? 1 : 3;
+            byte[][] tables = new byte[channels][];
+
+            for ( int i = 0; i < channels; i++ )
+            {
+                tables[i] = (byte[]) table.Clone( );
+            }
+
+            return tables;
+        }
+
         /// <summary>
         /// Process the filter on the specified image.
         /// </summary>
@@ -141,6 +141,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>
         /// Initializes a new instance of the <see cref="Grayscale"/> class.
         /// </summary>
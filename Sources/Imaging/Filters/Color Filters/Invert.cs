@@ -34,7 +34,7 @@ namespace AForge.Imaging.Filters
     /// <img src="img/imaging/invert.jpg" width="480" height="361" />
     /// </remarks>
     ///
-    public sealed class Invert : BaseInPlacePartialFilter
+    public sealed class Invert : BaseInPlacePartialFilter, ILookupTableFilter
     {
         // private format translation dictionary
         private Dictionary<PixelFormat, PixelFormat> formatTranslations = new Dictionary<PixelFormat, PixelFormat>( );
@@ -47,6 +47,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
         
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>   
         /// Initializes a new instance of the <see cref="Invert"/> class.
         /// </summary>
@@ -58,6 +64,37 @@ namespace AForge.Imaging.Filters
             formatTranslations[PixelFormat.Format48bppRgb]       = PixelFormat.Format48bppRgb;
         }
 
+        /// <summary>
+        /// Get lookup tables, which are used by the filter for images of the specified pixel format.
+        /// </summary>
+        /// 
+        /// <param name="pixelFormat">Pixel format of image to get lookup tables for.</param>
+        /// 
+        /// <returns>Returns array of lookup tables or <see langword="null"/> if the pixel format is not
+        /// supported (see <see cref="ILookupTableFilter.GetLookupTables"/>).</returns>
+        /// 
+        public byte[][] GetLookupTables( PixelFormat pixelFormat )
+        {
+            // 16 bpp grayscale and 48 bpp color images are not processed using lookup tables
+            if ( ( pixelFormat != PixelFormat.Format8bppIndexed ) && ( pixelFormat != PixelFormat.Format24bppRgb ) )
+                return null;
+
+            int channels = ( pixelFormat == PixelFormat.Format8bppIndexed ) ? 1 : 3;
+            byte[][] tables = new byte[channels][];
+
+            for ( int i = 0; i < channels; i++ )
+            {
+                tables[i] = new byte[256];
+
+                for ( int j = 0; j < 256; j++ )
+                {
+                    tables[i][j] = (byte) ( 255 - j );
+                }
+            }
+
+            return tables;
+        }
+
         /// <summary>
         /// Process the filter on the specified image.
         /// </summary>
@@ -90,7 +127,17 @@ namespace AForge.Imaging.Filters
                 // invert
                 for ( int y = startY; y < stopY; y++ )
                 {
-                    for ( int x = startX; x < stopX; x++, ptr++ )
+                    int x = startX;
+
+                    // process 8 bytes at once
+                    if ( PixelKernels.IsEnabled )
+                    {
+                        int processed = PixelKernels.Invert( ptr, stopX - startX );
+                        x   += processed;
+                        ptr += processed;
+                    }
+
+                    for ( ; x < stopX; x++, ptr++ )
                     {
                         // ivert each pixel
                         *ptr = (byte) ( 255 - *ptr );
@@ -45,7 +45,7 @@ namespace AForge.Imaging.Filters
     /// <seealso cref="HSLLinear"/>
     /// <seealso cref="YCbCrLinear"/>
     /// 
-    public class LevelsLinear : BaseInPlacePartialFilter
+    public class LevelsLinear : BaseInPlacePartialFilter, ILookupTableFilter
     {
         private IntRange inRed      = new IntRange( 0, 255 );
         private IntRange inGreen    = new IntRange( 0, 255 );
@@ -70,6 +70,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         #region Public Propertis
 
         /// <summary>
@@ -228,6 +234,31 @@ namespace AForge.Imaging.Filters
             formatTranslations[PixelFormat.Format32bppArgb]   = PixelFormat.Format32bppArgb;
         }
 
+        /// <summary>
+        /// Get lookup tables, which are used by the filter for images of the specified pixel format.
+        /// </summary>
+        /// 
+        /// <param name="pixelFormat">Pixel format of image to get lookup tables for.</param>
+        /// 
+        /// <returns>Returns array of lookup tables or <see langword="null"/> if the pixel format is not
+        /// supported (see <see cref="ILookupTableFilter.GetLookupTables"/>).</returns>
+        /// 
+        public byte[][] GetLookupTables( PixelFormat pixelFormat )
+        {
+            if ( !formatTranslations.ContainsKey( pixelFormat ) )
+                return null;
+
+            if ( pixelFormat == PixelFormat.Format8bppIndexed )
+                return new byte[][] { (byte[]) mapGreen.Clone( ) };
+
+            byte[][] tables = new byte[3][];
+            tables[RGB.R] = (byte[]) mapRed.Clone( );
+            tables[RGB.G] = (byte[]) mapGreen.Clone( );
+            tables[RGB.B] = (byte[]) mapBlue.Clone( );
+
+            return tables;
+        }
+
         /// <summary>
         /// Process the filter on the specified image.
         /// </summary>
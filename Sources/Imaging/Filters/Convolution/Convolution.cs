@@ -31,6 +31,11 @@ namespace AForge.Imaging.Filters
     /// color images for processing. Note: depending on the value of <see cref="ProcessAlpha"/>
     /// property, the alpha channel is either copied as is or processed with the kernel.</para>
     /// 
+    /// <para>If the kernel is separable (it is outer product of two integer 1D kernels, like
+    /// kernels of <see cref="GaussianBlur"/> and <see cref="Mean"/> filters), images with 8 bpp channels
+    /// are processed in two 1D passes, which gives exactly the same result much faster
+    /// (see <see cref="SeparableConvolution"/>).</para>
+    /// 
     /// <para>Sample usage:</para>
     /// <code>
     /// // define emboss kernel
@@ -64,6 +69,9 @@ namespace AForge.Imaging.Filters
         private bool dynamicDivisorForEdges = true;
         // specifies if alpha channel must be processed or just copied
         private bool processAlpha = false;
+        // decomposition of the kernel into 1D kernels and working memory of separable processing kept between calls
+        private KernelDecomposition decomposition = null;
+        private readonly ScratchArrays<long> scratch = new ScratchArrays<long>( );
 
         // private format translation dictionary
         private Dictionary<PixelFormat, PixelFormat> formatTranslations = new Dictionary<PixelFormat, PixelFormat>( );
@@ -76,6 +84,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>
         /// Convolution kernel.
         /// </summary>
@@ -258,18 +272,51 @@ namespace AForge.Imaging.Filters
         /// <param name="rect">Image rectangle for processing by the filter.</param>
         /// 
         protected override unsafe void ProcessFilter( UnmanagedImage source, UnmanagedImage destination, Rectangle rect )
+        {
+            ProcessFilter( source, destination, rect, rect.Top, rect.Bottom );
+        }
+
+        /// <summary>
+        /// Process the filter on the specified rows of image's rectangle.
+        /// </summary>
+        /// 
+        /// <param name="source">Source image data.</param>
+        /// <param name="destination">Destination image data.</param>
+        /// <param name="rect">Image rectangle for processing by the filter.</param>
+        /// <param name="startY">First row of the rectangle to process.</param>
+        /// <param name="stopY">Row following the last row of the rectangle to process.</param>
+        /// 
+        protected override unsafe void ProcessFilter( UnmanagedImage source, UnmanagedImage destination, Rectangle rect, int startY, int stopY )
         {
             int pixelSize = Image.GetPixelFormatSize( source.PixelFormat ) / 8;
 
-            // processing start and stop X,Y positions
+            // processing start and stop X positions
             int startX  = rect.Left;
-            int startY  = rect.Top;
             int stopX   = startX + rect.Width;
-            int stopY   = startY + rect.Height;
+            // rows of the rectangle, which can be used as neighbours
+            int top     = rect.Top;
+            int bottom  = rect.Bottom;
 
             // check pixel size to find if we deal with 8 or 16 bpp channels
             if ( ( pixelSize <= 4 ) && ( pixelSize != 2 ) )
             {
+                KernelDecomposition kd = decomposition;
+
+                if ( ( kd == null ) || ( !kd.IsSuitable( kernel ) ) )
+                {
+                    kd = new KernelDecomposition( kernel );
+                    decomposition = kd;
+                }
+
+                // kernel, which is outer product of two 1D kernels, is processed in
+                // two 1D passes giving the same result (see SeparableConvolution)
+                if ( kd.IsSeparable )
+                {
+                    SeparableConvolution.Process( source, destination, rect, startY, stopY, kd.HorizontalKernel, kd.VerticalKernel,
+                        divisor, threshold, dynamicDivisorForEdges, processAlpha, scratch );
+                    return;
+                }
+
                 int srcStride = source.Stride;
                 int dstStride = destination.Stride;
 
@@ -287,18 +334,18 @@ namespace AForge.Imaging.Filters
                 if ( destination.PixelFormat == PixelFormat.Format8bppIndexed )
                 {
                     // grayscale image
-                    Process8bppImage( src, dst, srcStride, dstStride, srcOffset, dstOffset, startX, startY, stopX, stopY );
+                    Process8bppImage( src, dst, srcStride, dstStride, srcOffset, dstOffset, startX, startY, stopX, stopY, top, bottom );
                 }
                 else
                 {
                     // RGB image
                     if ( ( pixelSize == 3 ) || ( !processAlpha ) )
                     {
-                        Process24bppImage( src, dst, srcStride, dstStride, srcOffset, dstOffset, startX, startY, stopX, stopY, pixelSize );
+                        Process24bppImage( src, dst, srcStride, dstStride, srcOffset, dstOffset, startX, startY, stopX, stopY, top, bottom, pixelSize );
                     }
                     else
                     {
-                        Process32bppImage( src, dst, srcStride, dstStride, srcOffset, dstOffset, startX, startY, stopX, stopY );
+                        Process32bppImage( src, dst, srcStride, dstStride, srcOffset, dstOffset, startX, startY, stopX, stopY, top, bottom );
                     }
                 }
             }
@@ -320,18 +367,18 @@ namespace AForge.Imaging.Filters
                 if ( source.PixelFormat == PixelFormat.Format16bppGrayScale )
                 {
                     // 16 bpp grayscale image
-                    Process16bppImage( baseSrc, baseDst, srcStride, dstStride, startX, startY, stopX, stopY );
+                    Process16bppImage( baseSrc, baseDst, srcStride, dstStride, startX, startY, stopX, stopY, top, bottom );
                 }
                 else
                 {
                     // RGB image
                     if ( ( pixelSize == 3 ) || ( !processAlpha ) )
                     {
-                        Process48bppImage( baseSrc, baseDst, srcStride, dstStride, startX, startY, stopX, stopY, pixelSize );
+                        Process48bppImage( baseSrc, baseDst, srcStride, dstStride, startX, startY, stopX, stopY, top, bottom, pixelSize );
                     }
                     else
                     {
-                        Process64bppImage( baseSrc, baseDst, srcStride, dstStride, startX, startY, stopX, stopY );
+                        Process64bppImage( baseSrc, baseDst, srcStride, dstStride, startX, startY, stopX, stopY, top, bottom );
                     }
                 }
             }
@@ -340,7 +387,7 @@ namespace AForge.Imaging.Filters
         // Process 8 bpp grayscale images
         private unsafe void Process8bppImage( byte* src, byte* dst,
                                               int srcStride, int dstStride, int srcOffset, int dstOffset,
-                                              int startX, int startY, int stopX, int stopY )
+                                              int startX, int startY, int stopX, int stopY, int top, int bottom )
         {
             // loop and array indexes
             int i, j, t, k, ir, jr;
@@ -369,10 +416,10 @@ namespace AForge.Imaging.Filters
                         t = y + ir;
 
                         // skip row
-                        if ( t < startY )
+                        if ( t < top )
                             continue;
                         // break
-                        if ( t >= stopY )
+                        if ( t >= bottom )
                             break;
 
                         // for each kernel column
@@ -428,7 +475,7 @@ namespace AForge.Imaging.Filters
         // Process 24 bpp images or 32 bpp images with copying alpha channel
         private unsafe void Process24bppImage( byte* src, byte* dst,
                                                int srcStride, int dstStride, int srcOffset, int dstOffset,
-                                               int startX, int startY, int stopX, int stopY, int pixelSize )
+                                               int startX, int startY, int stopX, int stopY, int top, int bottom, int pixelSize )
         {
             // loop and array indexes
             int i, j, t, k, ir, jr;
@@ -459,10 +506,10 @@ namespace AForge.Imaging.Filters
                         t = y + ir;
 
                         // skip row
-                        if ( t < startY )
+                        if ( t < top )
                             continue;
                         // break
-                        if ( t >= stopY )
+                        if ( t >= bottom )
                             break;
 
                         // for each kernel column
@@ -534,7 +581,7 @@ namespace AForge.Imaging.Filters
         // Process 32 bpp images including alpha channel
         private unsafe void Process32bppImage( byte* src, byte* dst,
                                                int srcStride, int dstStride, int srcOffset, int dstOffset,
-                                               int startX, int startY, int stopX, int stopY )
+                                               int startX, int startY, int stopX, int stopY, int top, int bottom )
         {
             // loop and array indexes
             int i, j, t, k, ir, jr;
@@ -565,10 +612,10 @@ namespace AForge.Imaging.Filters
                         t = y + ir;
 
                         // skip row
-                        if ( t < startY )
+                        if ( t < top )
                             continue;
                         // break
-                        if ( t >= stopY )
+                        if ( t >= bottom )
                             break;
 
                         // for each kernel column
@@ -639,7 +686,7 @@ namespace AForge.Imaging.Filters
 
         // Process 16 bpp grayscale images
         private unsafe void Process16bppImage( ushort* baseSrc, ushort* baseDst, int srcStride, int dstStride,
-                                               int startX, int startY, int stopX, int stopY )
+                                               int startX, int startY, int stopX, int stopY, int top, int bottom )
         {
             // loop and array indexes
             int i, j, t, k, ir, jr;
@@ -671,10 +718,10 @@ namespace AForge.Imaging.Filters
                         t = y + ir;
 
                         // skip row
-                        if ( t < startY )
+                        if ( t < top )
                             continue;
                         // break
-                        if ( t >= stopY )
+                        if ( t >= bottom )
                             break;
 
                         // for each kernel column
@@ -727,7 +774,7 @@ namespace AForge.Imaging.Filters
 
         // Process 48 bpp images or 64 bpp images with copying alpha channel
         private unsafe void Process48bppImage( ushort* baseSrc, ushort* baseDst, int srcStride, int dstStride,
-                                               int startX, int startY, int stopX, int stopY, int pixelSize )
+                                               int startX, int startY, int stopX, int stopY, int top, int bottom, int pixelSize )
         {
             // loop and array indexes
             int i, j, t, k, ir, jr;
@@ -761,10 +808,10 @@ namespace AForge.Imaging.Filters
                         t = y + ir;
 
                         // skip row
-                        if ( t < startY )
+                        if ( t < top )
                             continue;
                         // break
-                        if ( t >= stopY )
+                        if ( t >= bottom )
                             break;
 
                         // for each kernel column
@@ -833,7 +880,7 @@ namespace AForge.Imaging.Filters
 
         // Process 64 bpp images including alpha channel
         private unsafe void Process64bppImage( ushort* baseSrc, ushort* baseDst, int srcStride, int dstStride,
-                                               int startX, int startY, int stopX, int stopY )
+                                               int startX, int startY, int stopX, int stopY, int top, int bottom )
         {
             // loop and array indexes
             int i, j, t, k, ir, jr;
@@ -867,10 +914,10 @@ namespace AForge.Imaging.Filters
                         t = y + ir;
 
                         // skip row
-                        if ( t < startY )
+                        if ( t < top )
                             continue;
                         // break
-                        if ( t >= stopY )
+                        if ( t >= bottom )
                             break;
 
                         // for each kernel column
@@ -936,5 +983,42 @@ namespace AForge.Imaging.Filters
                 }
             }
         }
+
+        // Decomposition of kernel into 1D kernels (see SeparableConvolution.Decompose) together with copy of
+        // the kernel it was done for, which allows to notice changes of kernel's elements
+        private class KernelDecomposition
+        {
+            public readonly int[,] Kernel;
+            public readonly bool IsSeparable;
+            public readonly int[] HorizontalKernel;
+            public readonly int[] VerticalKernel;
+
+            public KernelDecomposition( int[,] kernel )
+            {
+                Kernel      = (int[,]) kernel.Clone( );
+                IsSeparable = SeparableConvolution.Decompose( kernel, out HorizontalKernel, out VerticalKernel );
+            }
+
+            // Check if the decomposition was done for the same kernel
+            public bool IsSuitable( int[,] kernel )
+            {
+                int rows = kernel.GetLength( 0 );
+                int cols = kernel.GetLength( 1 );
+
+                if ( ( rows != Kernel.GetLength( 0 ) ) || ( cols != Kernel.GetLength( 1 ) ) )
+                    return false;
+
+                for ( int i = 0; i < rows; i++ )
+                {
+                    for ( int j = 0; j < cols; j++ )
+                    {
+                        if ( kernel[i, j] != Kernel[i, j] )
+                            return false;
+                    }
+                }
+
+                return true;
+            }
+        }
     }
 }
@@ -17,9 +17,10 @@ namespace AForge.Imaging.Filters
     /// </summary>
     /// 
     /// <remarks><para>The filter performs <see cref="Convolution">convolution filter</see> using
-    /// the kernel, which is calculate with the help of <see cref="AForge.Math.Gaussian.Kernel2D"/>
-    /// method and then converted to integer kernel by dividing all elements by the element with the
-    /// smallest value. Using the kernel the convolution filter is known as Gaussian blur.</para>
+    /// the kernel, which is calculated as outer product of 1D Gaussian kernel (see <see cref="AForge.Math.Gaussian.Kernel"/>
+    /// method) with itself. The 1D kernel is converted to integer kernel scaling it so its central element
+    /// equals to 128. Using the kernel the convolution filter is known as Gaussian blur. Since the kernel is
+    /// separable, images with 8 bpp channels are blurred in two 1D passes (see <see cref="SeparableConvolution"/>).</para>
     /// 
     /// <para>Using <see cref="Sigma"/> property it is possible to configure
     /// <see cref="AForge.Math.Gaussian.Sigma">sigma value of Gaussian function</see>.</para>
@@ -138,33 +139,34 @@ namespace AForge.Imaging.Filters
         {
             // create Gaussian function
             AForge.Math.Gaussian gaus = new AForge.Math.Gaussian( sigma );
-            // create kernel
-            double[,] kernel = gaus.Kernel2D( size );
-            double min = kernel[0, 0];
-            // integer kernel
+            // create 1D kernel
+            double[] kernel = gaus.Kernel( size );
+            double max = kernel[size >> 1];
+            // integer 1D kernel, which central element equals to 128, so products of 2D kernel's
+            // elements and 16 bpp pixel values do not overflow 32 bit integer
+            int[] intKernel1D = new int[size];
+            int sum = 0;
+
+            for ( int i = 0; i < size; i++ )
+            {
+                intKernel1D[i] = (int) ( kernel[i] / max * 128 + 0.5 );
+                sum += intKernel1D[i];
+            }
+
+            // integer 2D kernel is outer product of 1D kernels, so it is separable
             int[,] intKernel = new int[size, size];
-            int divisor = 0;
 
             for ( int i = 0; i < size; i++ )
             {
                 for ( int j = 0; j < size; j++ )
                 {
-                    double v = kernel[i, j] / min;
-
-                    if ( v > ushort.MaxValue )
-                    {
-                        v = ushort.MaxValue;
-                    }
-                    intKernel[i, j] = (int) v;
-
-                    // collect divisor
-                    divisor += intKernel[i, j];
+                    intKernel[i, j] = intKernel1D[i] * intKernel1D[j];
                 }
             }
 
             // update filter
             this.Kernel = intKernel;
-            this.Divisor = divisor;
+            this.Divisor = sum * sum;
         }
         #endregion
     }
@@ -0,0 +1,526 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging.Filters
+{
+    using System;
+    using System.Collections.Generic;
+    using System.Drawing;
+    using System.Drawing.Imaging;
+
+    /// <summary>
+    /// Separable convolution filter.
+    /// </summary>
+    ///
+    /// <remarks><para>The filter performs convolution with a kernel, which is the outer product of
+    /// <see cref="VerticalKernel">vertical</see> and <see cref="HorizontalKernel">horizontal</see> 1D kernels
+    /// (<b>kernel[i, j] = verticalKernel[i] * horizontalKernel[j]</b>). The result is exactly the same as the
+    /// result of <see cref="Convolution"/> filter with such kernel, including processing of edges, but
+    /// the filter does not calculate weighted sum of all k<sup>2</sup> pixels for each pixel. Instead it
+    /// does two 1D passes - the vertical pass calculates weighted sums of pixels in columns for a row of the
+    /// image keeping them in a row buffer, and the horizontal pass calculates weighted sums of the buffer's
+    /// values. So processing of each pixel's channel takes 2k multiplications instead of k<sup>2</sup>
+    /// (18 instead of 81 for 9x9 kernel). All calculations are done using integer arithmetic.</para>
+    ///
+    /// <para><note><see cref="Convolution"/> filter (and so all filters inherited from it) checks if its kernel
+    /// can be represented as outer product of two integer 1D kernels and processes images the same way as
+    /// this filter does in that case. So there is no need to use this filter explicitly for filters like
+    /// <see cref="GaussianBlur"/> or <see cref="Mean"/>.</note></para>
+    ///
+    /// <para>The filter accepts 8 bpp grayscale images and 24 and 32 bpp color images for processing.
+    /// Note: depending on the value of <see cref="ProcessAlpha"/> property, the alpha channel is either copied as is
+    /// or processed with the kernel.</para>
+    ///
+    /// <para>Sample usage:</para>
+    /// <code>
+    /// // create filter, which is the same as convolution with 5x5 kernel
+    /// // { 1,  4,  6,  4, 1 }
+    /// // { 4, 16, 24, 16, 4 }
+    /// // ...
+    /// SeparableConvolution filter = new SeparableConvolution(
+    ///     new int[] { 1, 4, 6, 4, 1 }, new int[] { 1, 4, 6, 4, 1 } );
+    /// // apply the filter
+    /// filter.ApplyInPlace( image );
+    /// </code>
+    /// </remarks>
+    ///
+    /// <seealso cref="Convolution"/>
+    ///
+    public class SeparableConvolution : BaseUsingCopyPartialFilter
+    {
+        // 1D kernels
+        private int[] horizontalKernel;
+        private int[] verticalKernel;
+        // division factor
+        private int divisor = 1;
+        // threshold to add to weighted sum
+        private int threshold = 0;
+        // use dynamic divisor for edges
+        private bool dynamicDivisorForEdges = true;
+        // specifies if alpha channel must be processed or just copied
+        private bool processAlpha = false;
+        // working memory kept between calls
+        private readonly ScratchArrays<long> scratch = new ScratchArrays<long>( );
+
+        // private format translation dictionary
+        private Dictionary<PixelFormat, PixelFormat> formatTranslations = new Dictionary<PixelFormat, PixelFormat>( );
+
+        /// <summary>
+        /// Format translations dictionary.
+        /// </summary>
+        public override Dictionary<PixelFormat, PixelFormat> FormatTranslations
+        {
+            get { return formatTranslations; }
+        }
+
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
+        /// <summary>
+        /// Horizontal 1D kernel.
+        /// </summary>
+        ///
+        /// <remarks><para>The kernel is applied to rows of image - its elements are columns of the 2D kernel.</para>
+        ///
+        /// <para><note>Length of the kernel should be odd and should be in the [1, 99] range.</note></para>
+        ///
+        /// <para><note>Setting kernel through this property does not affect <see cref="Divisor"/> - it is
+        /// not recalculated automatically.</note></para>
+        /// </remarks>
+        ///
+        /// <exception cref="ArgumentException">Invalid kernel size is specified.</exception>
+        ///
+        public int[] HorizontalKernel
+        {
+            get { return horizontalKernel; }
+            set
+            {
+                CheckKernel( value );
+                horizontalKernel = value;
+            }
+        }
+
+        /// <summary>
+        /// Vertical 1D kernel.
+        /// </summary>
+        ///
+        /// <remarks><para>The kernel is applied to columns of image - its elements are rows of the 2D kernel.</para>
+        ///
+        /// <para><note>Length of the kernel should be odd and should be in the [1, 99] range.</note></para>
+        ///
+        /// <para><note>Setting kernel through this property does not affect <see cref="Divisor"/> - it is
+        /// not recalculated automatically.</note></para>
+        /// </remarks>
+        ///
+        /// <exception cref="ArgumentException">Invalid kernel size is specified.</exception>
+        ///
+        public int[] VerticalKernel
+        {
+            get { return verticalKernel; }
+            set
+            {
+                CheckKernel( value );
+                verticalKernel = value;
+            }
+        }
+
+        /// <summary>
+        /// Division factor.
+        /// </summary>
+        ///
+        /// <remarks><para>The value is used to divide convolution - weighted sum
+        /// of pixels is divided by this value.</para>
+        ///
+        /// <para><note>The value may be calculated automatically in the case if constructor
+        /// with two parameters is used (<see cref="SeparableConvolution( int[], int[] )"/>).</note></para>
+        /// </remarks>
+        ///
+        /// <exception cref="ArgumentException">Divisor can not be equal to zero.</exception>
+        ///
+        public int Divisor
+        {
+            get { return divisor; }
+            set
+            {
+                if ( value == 0 )
+                    throw new ArgumentException( "Divisor can not be equal to zero." );
+                divisor = value;
+            }
+        }
+
+        /// <summary>
+        /// Threshold to add to weighted sum.
+        /// </summary>
+        ///
+        /// <remarks><para>The property specifies threshold value, which is added to each weighted
+        /// sum of pixels. The value is added right after division was done by <see cref="Divisor"/>
+        /// value.</para>
+        ///
+        /// <para>Default value is set to <b>0</b>.</para>
+        /// </remarks>
+        ///
+        public int Threshold
+        {
+            get { return threshold; }
+            set { threshold = value; }
+        }
+
+        /// <summary>
+        /// Use dynamic divisor for edges or not.
+        /// </summary>
+        ///
+        /// <remarks><para>The property specifies how to handle edges the same way as
+        /// <see cref="Convolution.DynamicDivisorForEdges"/> property of <see cref="Convolution"/> filter.
+        /// If it is set to <see langword="true"/>, then dynamically calculated divisor will be used for edge
+        /// regions, which is sum of those 2D kernel's elements, which are not outside image.</para>
+        ///
+        /// <para>Default value is set to <see langword="true"/>.</para>
+        /// </remarks>
+        ///
+        public bool DynamicDivisorForEdges
+        {
+            get { return dynamicDivisorForEdges; }
+            set { dynamicDivisorForEdges = value; }
+        }
+
+        /// <summary>
+        /// Specifies if alpha channel must be processed or just copied.
+        /// </summary>
+        ///
+        /// <remarks><para>The property specifies the way how alpha channel is handled for 32 bpp
+        /// images. If the property is set to <see langword="false"/>, then alpha
+        /// channel's values are just copied as is. If the property is set to <see langword="true"/>
+        /// then alpha channel is convolved using the specified kernel same way as RGB channels.</para>
+        ///
+        /// <para>Default value is set to <see langword="false"/>.</para>
+        /// </remarks>
+        ///
+        public bool ProcessAlpha
+        {
+            get { return processAlpha; }
+            set { processAlpha = value; }
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="SeparableConvolution"/> class.
+        /// </summary>
+        protected SeparableConvolution( )
+        {
+            formatTranslations[PixelFormat.Format8bppIndexed] = PixelFormat.Format8bppIndexed;
+            formatTranslations[PixelFormat.Format24bppRgb]    = PixelFormat.Format24bppRgb;
+            formatTranslations[PixelFormat.Format32bppRgb]    = PixelFormat.Format32bppRgb;
+            formatTranslations[PixelFormat.Format32bppArgb]   = PixelFormat.Format32bppArgb;
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="SeparableConvolution"/> class.
+        /// </summary>
+        ///
+        /// <param name="horizontalKernel">Horizontal 1D kernel.</param>
+        /// <param name="verticalKernel">Vertical 1D kernel.</param>
+        ///
+        /// <remarks><para>Using this constructor (specifying only kernels),
+        /// <see cref="Divisor">division factor</see> will be calculated automatically
+        /// as sum of all elements of 2D kernel (product of 1D kernels' sums). In the case if
+        /// the sum equals to zero, division factor will be assigned to 1.</para></remarks>
+        ///
+        /// <exception cref="ArgumentException">Invalid kernel size is specified. Kernels' length should be
+        /// odd and should be in the [1, 99] range.</exception>
+        ///
+        public SeparableConvolution( int[] horizontalKernel, int[] verticalKernel ) : this( )
+        {
+            HorizontalKernel = horizontalKernel;
+            VerticalKernel   = verticalKernel;
+
+            int horizontalSum = 0;
+            int verticalSum   = 0;
+
+            foreach ( int k in horizontalKernel )
+                horizontalSum += k;
+            foreach ( int k in verticalKernel )
+                verticalSum += k;
+
+            divisor = horizontalSum * verticalSum;
+
+            if ( divisor == 0 )
+                divisor = 1;
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="SeparableConvolution"/> class.
+        /// </summary>
+        ///
+        /// <param name="horizontalKernel">Horizontal 1D kernel.</param>
+        /// <param name="verticalKernel">Vertical 1D kernel.</param>
+        /// <param name="divisor">Divisor, used used to divide weighted sum.</param>
+        ///
+        /// <exception cref="ArgumentException">Invalid kernel size is specified. Kernels' length should be
+        /// odd and should be in the [1, 99] range.</exception>
+        /// <exception cref="ArgumentException">Divisor can not be equal to zero.</exception>
+        ///
+        public SeparableConvolution( int[] horizontalKernel, int[] verticalKernel, int divisor ) : this( )
+        {
+            HorizontalKernel = horizontalKernel;
+            VerticalKernel   = verticalKernel;
+            Divisor          = divisor;
+        }
+
+        /// <summary>
+        /// Process the filter on the specified image.
+        /// </summary>
+        ///
+        /// <param name="source">Source image data.</param>
+        /// <param name="destination">Destination image data.</param>
+        /// <param name="rect">Image rectangle for processing by the filter.</param>
+        ///
+        protected override void ProcessFilter( UnmanagedImage source, UnmanagedImage destination, Rectangle rect )
+        {
+            Process( source, destination, rect, rect.Top, rect.Bottom, horizontalKernel, verticalKernel,
+                divisor, threshold, dynamicDivisorForEdges, processAlpha, scratch );
+        }
+
+        /// <summary>
+        /// Process the filter on the specified rows of image's rectangle.
+        /// </summary>
+        ///
+        /// <param name="source">Source image data.</param>
+        /// <param name="destination">Destination image data.</param>
+        /// <param name="rect">Image rectangle for processing by the filter.</param>
+        /// <param name="startY">First row of the rectangle to process.</param>
+        /// <param name="stopY">Row following the last row of the rectangle to process.</param>
+        ///
+        protected override void ProcessFilter( UnmanagedImage source, UnmanagedImage destination, Rectangle rect, int startY, int stopY )
+        {
+            Process( source, destination, rect, startY, stopY, horizontalKernel, verticalKernel,
+                divisor, threshold, dynamicDivisorForEdges, processAlpha, scratch );
+        }
+
+        // Check size of 1D kernel
+        private static void CheckKernel( int[] kernel )
+        {
+            if ( ( kernel.Length < 1 ) || ( kernel.Length > 99 ) || ( kernel.Length % 2 == 0 ) )
+                throw new ArgumentException( "Invalid kernel size." );
+        }
+
+        // Find out if the 2D kernel is outer product of two integer 1D kernels and get them.
+        // Kernels with elements big enough to overflow 32 bit product with pixel value are not
+        // decomposed, since the convolution filter does not calculate them using 64 bit arithmetic.
+        internal static bool Decompose( int[,] kernel, out int[] horizontalKernel, out int[] verticalKernel )
+        {
+            int rows = kernel.GetLength( 0 );
+            int cols = kernel.GetLength( 1 );
+            int maxValue = int.MaxValue / 255;
+            int baseRow = -1, baseCol = -1;
+
+            horizontalKernel = null;
+            verticalKernel   = null;
+
+            for ( int i = 0; i < rows; i++ )
+            {
+                for ( int j = 0; j < cols; j++ )
+                {
+                    int k = kernel[i, j];
+
+                    if ( ( k > maxValue ) || ( k < -maxValue ) )
+                        return false;
+
+                    if ( ( k != 0 ) && ( baseRow == -1 ) )
+                    {
+                        baseRow = i;
+                        baseCol = j;
+                    }
+                }
+            }
+
+            // zero kernel
+            if ( baseRow == -1 )
+                return false;
+
+            // horizontal kernel is the first non zero row divided by greatest common divisor of its elements,
+            // so all other rows must be its integer multiples
+            int gcd = 0;
+
+            for ( int j = 0; j < cols; j++ )
+            {
+                gcd = GreatestCommonDivisor( gcd, Math.Abs( kernel[baseRow, j] ) );
+            }
+
+            int[] hKernel = new int[cols];
+            int[] vKernel = new int[rows];
+
+            for ( int j = 0; j < cols; j++ )
+            {
+                hKernel[j] = kernel[baseRow, j] / gcd;
+            }
+
+            int baseValue = hKernel[baseCol];
+
+            for ( int i = 0; i < rows; i++ )
+            {
+                if ( kernel[i, baseCol] % baseValue != 0 )
+                    return false;
+
+                vKernel[i] = kernel[i, baseCol] / baseValue;
+
+                for ( int j = 0; j < cols; j++ )
+                {
+                    if ( (long) vKernel[i] * hKernel[j] != kernel[i, j] )
+                        return false;
+                }
+            }
+
+            horizontalKernel = hKernel;
+            verticalKernel   = vKernel;
+
+            return true;
+        }
+
+        private static int GreatestCommonDivisor( int a, int b )
+        {
+            while ( b != 0 )
+            {
+                int t = a % b;
+                a = b;
+                b = t;
+            }
+            return a;
+        }
+
+        // Process 8 bpp grayscale, 24 and 32 bpp color images doing vertical and horizontal passes.
+        // Results are exactly the same as results of convolution with 2D kernel, since weighted sum
+        // of rows' weighted sums is the same integer value and edges are handled the same way.
+        // Only rows in the [startY, stopY) range are produced, but all rows of the rectangle are used.
+        // Working memory is taken from the filter's scratch arrays.
+        internal static unsafe void Process( UnmanagedImage source, UnmanagedImage destination, Rectangle rect,
+            int startY, int stopY, int[] horizontalKernel, int[] verticalKernel, int divisor, int threshold, bool dynamicDivisorForEdges, bool processAlpha,
+            ScratchArrays<long> scratch )
+        {
+            int pixelSize = Image.GetPixelFormatSize( source.PixelFormat ) / 8;
+            // number of channels processed with the kernel
+            int channels  = ( ( pixelSize == 4 ) && ( !processAlpha ) ) ? 3 : pixelSize;
+
+            int top      = rect.Top;
+            int bottom   = rect.Bottom;
+            int width    = rect.Width;
+            int lineSize = width * pixelSize;
+
+            int hSize   = horizontalKernel.Length;
+            int vSize   = verticalKernel.Length;
+            int hRadius = hSize >> 1;
+            int vRadius = vSize >> 1;
+
+            int srcStride = source.Stride;
+            int dstStride = destination.Stride;
+
+            // allign pointers to the first pixel to process
+            byte* baseSrc = (byte*) source.ImageData.ToPointer( ) + rect.Left * pixelSize;
+            byte* baseDst = (byte*) destination.ImageData.ToPointer( ) + rect.Left * pixelSize;
+
+            // weighted sums of columns for the current row followed by sums of horizontal kernel's elements
+            // preceding each element, which give sum of the kernel's part falling into image for dynamic divisor
+            long[] memory = scratch.Take( lineSize + hSize + 1 );
+
+            fixed ( long* sums = memory )
+            fixed ( int* hKernel = horizontalKernel )
+            {
+                long* hPartialSums = sums + lineSize;
+
+                hPartialSums[0] = 0;
+                for ( int j = 0; j < hSize; j++ )
+                {
+                    hPartialSums[j + 1] = hPartialSums[j] + hKernel[j];
+                }
+
+                for ( int y = startY; y < stopY; y++ )
+                {
+                    // elements of vertical kernel falling into image
+                    int iStart = Math.Max( 0, vRadius - ( y - top ) );
+                    int iStop  = Math.Min( vSize, vRadius + bottom - y );
+                    long vSum  = 0;
+
+                    // vertical pass
+                    for ( int n = 0; n < lineSize; n++ )
+                    {
+                        sums[n] = 0;
+                    }
+
+                    for ( int i = iStart; i < iStop; i++ )
+                    {
+                        int k = verticalKernel[i];
+
+                        vSum += k;
+
+                        if ( k == 0 )
+                            continue;
+
+                        byte* src = baseSrc + (long) ( y + i - vRadius ) * srcStride;
+
+                        for ( int n = 0; n < lineSize; n++ )
+                        {
+                            sums[n] += k * src[n];
+                        }
+                    }
+
+                    // horizontal pass
+                    byte* srcRow = baseSrc + (long) y * srcStride;
+                    byte* dst    = baseDst + (long) y * dstStride;
+
+                    for ( int x = 0; x < width; x++, dst += pixelSize )
+                    {
+                        // elements of horizontal kernel falling into image
+                        int jStart = Math.Max( 0, hRadius - x );
+                        int jStop  = Math.Min( hSize, hRadius + width - x );
+                        long div;
+
+                        if ( ( iStart == 0 ) && ( iStop == vSize ) && ( jStart == 0 ) && ( jStop == hSize ) )
+                        {
+                            // all kernel elements are processed - we are not on the edge
+                            div = divisor;
+                        }
+                        else
+                        {
+                            // we are on edge. do we need to use dynamic divisor or not?
+                            div = ( dynamicDivisorForEdges ) ?
+                                vSum * ( hPartialSums[jStop] - hPartialSums[jStart] ) : divisor;
+                        }
+
+                        long* p = sums + ( x - hRadius ) * pixelSize;
+
+                        for ( int c = 0; c < channels; c++ )
+                        {
+                            long v = 0;
+
+                            for ( int j = jStart; j < jStop; j++ )
+                            {
+                                v += hKernel[j] * p[j * pixelSize + c];
+                            }
+
+                            // check divider
+                            if ( div != 0 )
+                            {
+                                v /= div;
+                            }
+                            v += threshold;
+
+                            dst[c] = (byte) ( ( v > 255 ) ? 255 : ( ( v < 0 ) ? 0 : v ) );
+                        }
+
+                        // take care of alpha channel
+                        if ( channels < pixelSize )
+                            dst[RGB.A] = srcRow[x * pixelSize + RGB.A];
+                    }
+                }
+            }
+
+            scratch.Return( memory );
+        }
+    }
+}
@@ -64,6 +64,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>
         /// Initializes a new instance of the <see cref="DifferenceEdgeDetector"/> class.
         /// </summary>
@@ -84,11 +90,27 @@ namespace AForge.Imaging.Filters
         /// 
         protected override unsafe void ProcessFilter( UnmanagedImage source, UnmanagedImage destination, Rectangle rect )
         {
-            // processing start and stop X,Y positions
+            ProcessFilter( source, destination, rect, rect.Top, rect.Bottom );
+        }
+
+        /// <summary>
+        /// Process the filter on the specified rows of image's rectangle.
+        /// </summary>
+        /// 
+        /// <param name="source">Source image data.</param>
+        /// <param name="destination">Destination image data.</param>
+        /// <param name="rect">Image rectangle for processing by the filter.</param>
+        /// <param name="startY">First row of the rectangle to process.</param>
+        /// <param name="stopY">Row following the last row of the rectangle to process.</param>
+        /// 
+        protected override unsafe void ProcessFilter( UnmanagedImage source, UnmanagedImage destination, Rectangle rect, int startY, int stopY )
+        {
+            // processing start and stop X positions
             int startX  = rect.Left + 1;
-            int startY  = rect.Top + 1;
             int stopX   = startX + rect.Width - 2;
-            int stopY   = startY + rect.Height - 2;
+            // processing start and stop Y positions skipping the first and the last lines of the rectangle
+            int startLine = Math.Max( startY, rect.Top + 1 );
+            int stopLine  = Math.Min( stopY, rect.Bottom - 1 );
 
             int dstStride = destination.Stride;
             int srcStride = source.Stride;
@@ -103,11 +125,11 @@ namespace AForge.Imaging.Filters
             byte* dst = (byte*) destination.ImageData.ToPointer( );
 
             // allign pointers
-            src += srcStride * startY + startX;
-            dst += dstStride * startY + startX;
+            src += srcStride * startLine + startX;
+            dst += dstStride * startLine + startX;
 
             // for each line
-            for ( int y = startY; y < stopY; y++ )
+            for ( int y = startLine; y < stopLine; y++ )
             {
                 // for each pixel
                 for ( int x = startX; x < stopX; x++, src++, dst++ )
@@ -145,7 +167,7 @@ namespace AForge.Imaging.Filters
             // draw black rectangle to remove those pixels, which were not processed
             // (this needs to be done for those cases, when filter is applied "in place" -
             // source image is modified instead of creating new copy)
-            Drawing.Rectangle( destination, rect, Color.Black );
+            FilterParallelism.ClearBorder( destination, rect, startY, stopY );
         }
     }
 }
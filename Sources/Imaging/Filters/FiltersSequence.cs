@@ -25,6 +25,21 @@ namespace AForge.Imaging.Filters
     /// image and which pixel formats may be produced by the filter. Format of acceptable source
     /// and possible output is defined by filters, which added to the sequence.</para>
     /// 
+    /// <para>Adjacent filters of the sequence, which map pixels' values using lookup tables
+    /// (see <see cref="ILookupTableFilter"/>), are not applied one by one. Instead their lookup
+    /// tables are composed into a single set of tables, which is applied to an image in a single pass.
+    /// For example, a sequence of brightness, contrast and gamma correction filters costs as much
+    /// as a single filter.</para>
+    /// 
+    /// <para>By default each filter of the sequence allocates new image for its result. For processing
+    /// video streams, where all frames have the same size and pixel format, the <see cref="ReuseBuffers"/>
+    /// property may be set. In this mode the sequence is planned once for the size and pixel format of
+    /// source image and intermediate results are kept in two preallocated buffers, which are reused for
+    /// all following images. Filters, which can process images in place, are applied in place to
+    /// intermediate results, while other filters take their source from one buffer and put result into
+    /// another. So applying the sequence with <see cref="Apply(UnmanagedImage, UnmanagedImage)"/> method
+    /// does not allocate any memory for images, once the sequence is planned.</para>
+    /// 
     /// <para>Sample usage:</para>
     /// <code>
     /// // create filter, which is binarization sequence
@@ -41,6 +56,57 @@ namespace AForge.Imaging.Filters
 	{
 	    private readonly List<IFilter> InnerList = new List<IFilter>();
 
+        private bool reuseBuffers = false;
+
+        // execution plan, which is kept while buffers are reused
+        private List<IFilter> plannedSteps = null;
+        // intermediate images produced by planned steps, which are views of reusable buffers
+        private UnmanagedImage[] plannedImages = null;
+        // specifies if planned step is applied in place to result of the previous step
+        private bool[] plannedInPlace = null;
+        // source image's properties the plan was done for
+        private int plannedWidth;
+        private int plannedHeight;
+        private PixelFormat plannedPixelFormat;
+        // properties of image produced by the last step
+        private int resultWidth;
+        private int resultHeight;
+        private PixelFormat resultPixelFormat;
+        // reusable buffers intermediate images are kept in
+        private UnmanagedImage[] buffers = null;
+
+        /// <summary>
+        /// Reuse buffers for intermediate images or not.
+        /// </summary>
+        /// 
+        /// <remarks><para>The property specifies if intermediate results of the sequence should be kept in
+        /// buffers, which are allocated once and then reused for all images of the same size and pixel format
+        /// (see class description). If an image of another size or pixel format is processed, the sequence
+        /// is planned again.</para>
+        /// 
+        /// <para><note>The execution plan takes a snapshot of filters' lookup tables (see <see cref="ILookupTableFilter"/>),
+        /// so properties of filters in the sequence must not be changed while the plan is in use. If they
+        /// are changed, the <see cref="Reset"/> method must be called to plan the sequence again.</note></para>
+        /// 
+        /// <para><note>Since buffers are shared by all calls, the sequence must not be applied to several
+        /// images concurrently in this mode. Filters, which need working memory to process pixels' neighbourhoods
+        /// (median, erosion, dilatation, convolution, box blur), keep it between calls themselves. So nothing is
+        /// allocated on each call, if parallel processing of filters is disabled as well (see <see cref="FilterParallelism"/>),
+        /// since it needs to allocate objects for scheduling work.</note></para>
+        /// 
+        /// <para>Default value is set to <see langword="false"/>.</para>
+        /// </remarks>
+        /// 
+        public bool ReuseBuffers
+        {
+            get { return reuseBuffers; }
+            set
+            {
+                reuseBuffers = value;
+                Reset( );
+            }
+        }
+
         /// <summary>
         /// Initializes a new instance of the <see cref="FiltersSequence"/> class.
         /// </summary>
@@ -80,8 +146,34 @@ namespace AForge.Imaging.Filters
 		public void Add( IFilter filter )
 		{
 			InnerList.Add( filter );
+            Reset( );
 		}
 
+        /// <summary>
+        /// Reset execution plan of the sequence.
+        /// </summary>
+        /// 
+        /// <remarks><para>The method frees buffers, which are reused for intermediate images, if
+        /// <see cref="ReuseBuffers"/> is set to <see langword="true"/>. The sequence is planned again
+        /// on the next call of its <b>Apply</b> method.</para></remarks>
+        /// 
+        public void Reset( )
+        {
+            if ( buffers != null )
+            {
+                foreach ( UnmanagedImage buffer in buffers )
+                {
+                    if ( buffer != null )
+                        buffer.Dispose( );
+                }
+            }
+
+            plannedSteps   = null;
+            plannedImages  = null;
+            plannedInPlace = null;
+            buffers        = null;
+        }
+
         /// <summary>
         /// Apply filter to an image.
         /// </summary>
@@ -171,21 +263,19 @@ namespace AForge.Imaging.Filters
             if ( n == 0 )
                 throw new ApplicationException( "No filters in the sequence." );
 
-            UnmanagedImage dstImg = null;
-            UnmanagedImage tmpImg = null;
-
-            // apply the first filter
-            dstImg = ( (IFilter) InnerList[0] ).Apply( image );
-
-            // apply other filters
-            for ( int i = 1; i < n; i++ )
+            if ( reuseBuffers )
             {
-                tmpImg = dstImg;
-                dstImg = ( (IFilter) InnerList[i] ).Apply( tmpImg );
-                tmpImg.Dispose( );
+                Plan( image );
+
+                UnmanagedImage dstImage = UnmanagedImage.Create( resultWidth, resultHeight, resultPixelFormat );
+                ApplyPlanned( image, dstImage );
+                return dstImage;
             }
 
-            return dstImg;
+            List<bool> fused = new List<bool>( );
+            List<IFilter> steps = PlanSteps( image.PixelFormat, fused );
+
+            return ApplySteps( image, steps, fused, steps.Count );
         }
 
         /// <summary>
@@ -200,6 +290,9 @@ namespace AForge.Imaging.Filters
         /// 
         /// <para><note>The destination image must have width, height and pixel format as it is expected by
         /// the final filter in the sequence.</note></para>
+        /// 
+        /// <para>If <see cref="ReuseBuffers"/> is set to <see langword="true"/>, the method does not allocate
+        /// any images, once the sequence is planned for the size and pixel format of the source image.</para>
         /// </remarks>
         /// 
         /// <exception cref="ApplicationException">No filters were added into the filters' sequence.</exception>
@@ -212,29 +305,244 @@ namespace AForge.Imaging.Filters
             if ( n == 0 )
                 throw new ApplicationException( "No filters in the sequence." );
 
+            if ( reuseBuffers )
+            {
+                Plan( sourceImage );
+                ApplyPlanned( sourceImage, destinationImage );
+                return;
+            }
+
+            List<bool> fused = new List<bool>( );
+            List<IFilter> steps = PlanSteps( sourceImage.PixelFormat, fused );
+            n = steps.Count;
+
             if ( n == 1 )
             {
-                ( (IFilter) InnerList[0] ).Apply( sourceImage, destinationImage );
+                steps[0].Apply( sourceImage, destinationImage );
             }
             else
             {
-                UnmanagedImage tmpImg1 = null;
-                UnmanagedImage tmpImg2 = null;
+                // apply all steps, except the last one
+                UnmanagedImage tmpImg = ApplySteps( sourceImage, steps, fused, n - 1 );
+
+                steps[n - 1].Apply( tmpImg, destinationImage );
+                tmpImg.Dispose( );
+            }
+        }
 
-                // apply the first filter
-                tmpImg1 = ( (IFilter) InnerList[0] ).Apply( sourceImage );
+        // Apply the specified number of steps to the source image, which is kept unchanged
+        private UnmanagedImage ApplySteps( UnmanagedImage image, List<IFilter> steps, List<bool> fused, int count )
+        {
+            UnmanagedImage dstImg = null;
+            UnmanagedImage tmpImg = null;
 
-                // apply other filters, except the last one
-                n--;
-                for ( int i = 1; i < n; i++ )
+            for ( int i = 0; i < count; i++ )
+            {
+                if ( ( dstImg != null ) && ( fused[i] ) )
                 {
-                    tmpImg2 = tmpImg1;
-                    tmpImg1 = ( (IFilter) InnerList[i] ).Apply( tmpImg2 );
-                    tmpImg2.Dispose( );
+                    // fused lookup tables are applied in place to intermediate image
+                    ( (ColorRemapping) steps[i] ).ApplyInPlace( dstImg );
                 }
+                else
+                {
+                    tmpImg = dstImg;
+                    dstImg = steps[i].Apply( ( tmpImg == null ) ? image : tmpImg );
 
-                ( (IFilter) InnerList[n] ).Apply( tmpImg1, destinationImage );
+                    if ( tmpImg != null )
+                        tmpImg.Dispose( );
+                }
             }
+
+            return dstImg;
+        }
+
+        // Apply planned steps using reusable buffers for intermediate images
+        private void ApplyPlanned( UnmanagedImage sourceImage, UnmanagedImage destinationImage )
+        {
+            UnmanagedImage image = sourceImage;
+            int last = plannedSteps.Count - 1;
+
+            for ( int i = 0; i < last; i++ )
+            {
+                if ( plannedInPlace[i] )
+                {
+                    ( (IInPlaceFilter) plannedSteps[i] ).ApplyInPlace( image );
+                }
+                else
+                {
+                    plannedSteps[i].Apply( image, plannedImages[i] );
+                }
+                image = plannedImages[i];
+            }
+
+            plannedSteps[last].Apply( image, destinationImage );
+        }
+
+        // Plan the sequence for the size and pixel format of the specified image, allocating reusable
+        // buffers for intermediate images. The sequence is applied once to find out size and pixel format
+        // of each intermediate image, since there is no other way to get them for arbitrary filter.
+        private void Plan( UnmanagedImage image )
+        {
+            if ( ( plannedSteps != null ) && ( image.Width == plannedWidth ) &&
+                 ( image.Height == plannedHeight ) && ( image.PixelFormat == plannedPixelFormat ) )
+            {
+                return;
+            }
+
+            Reset( );
+
+            List<IFilter> steps = PlanSteps( image.PixelFormat, new List<bool>( ) );
+            int n = steps.Count;
+
+            UnmanagedImage[] images = new UnmanagedImage[n];
+            bool[] inPlace = new bool[n];
+            // properties of intermediate images and index of buffer each of them is kept in
+            int[] widths  = new int[n];
+            int[] heights = new int[n];
+            int[] strides = new int[n];
+            PixelFormat[] pixelFormats = new PixelFormat[n];
+            int[] bufferIndex = new int[n];
+            long[] bufferSize = new long[2];
+
+            UnmanagedImage currentImage = image;
+            int currentBuffer = -1;
+
+            for ( int i = 0; i < n; i++ )
+            {
+                IFilter step = steps[i];
+                UnmanagedImage result = step.Apply( currentImage );
+
+                if ( i < n - 1 )
+                {
+                    // filters using copy of source image would make the copy in place, so they
+                    // are better applied between buffers
+                    inPlace[i] = ( currentBuffer != -1 ) && ( step is IInPlaceFilter ) &&
+                        ( !( step is BaseUsingCopyPartialFilter ) ) &&
+                        ( result.Width == currentImage.Width ) && ( result.Height == currentImage.Height ) &&
+                        ( result.PixelFormat == currentImage.PixelFormat );
+
+                    if ( !inPlace[i] )
+                    {
+                        currentBuffer = ( currentBuffer == 0 ) ? 1 : 0;
+                    }
+
+                    widths[i]       = result.Width;
+                    heights[i]      = result.Height;
+                    strides[i]      = result.Stride;
+                    pixelFormats[i] = result.PixelFormat;
+                    bufferIndex[i]  = currentBuffer;
+                    bufferSize[currentBuffer] = Math.Max( bufferSize[currentBuffer], (long) result.Stride * result.Height );
+                }
+                else
+                {
+                    resultWidth       = result.Width;
+                    resultHeight      = result.Height;
+                    resultPixelFormat = result.PixelFormat;
+                }
+
+                if ( currentImage != image )
+                    currentImage.Dispose( );
+                currentImage = result;
+            }
+            currentImage.Dispose( );
+
+            // allocate buffers as raw memory blocks
+            buffers = new UnmanagedImage[2];
+
+            for ( int i = 0; i < 2; i++ )
+            {
+                if ( bufferSize[i] != 0 )
+                {
+                    buffers[i] = UnmanagedImage.Create( (int) bufferSize[i], 1, PixelFormat.Format8bppIndexed );
+                }
+            }
+
+            // create views of buffers for intermediate images
+            for ( int i = 0; i < n - 1; i++ )
+            {
+                images[i] = new UnmanagedImage( buffers[bufferIndex[i]].ImageData,
+                    widths[i], heights[i], strides[i], pixelFormats[i] );
+            }
+
+            plannedSteps       = steps;
+            plannedImages      = images;
+            plannedInPlace     = inPlace;
+            plannedWidth       = image.Width;
+            plannedHeight      = image.Height;
+            plannedPixelFormat = image.PixelFormat;
+        }
+
+        // Plan steps for applying the sequence to an image of the specified pixel format. Adjacent filters
+        // providing lookup tables (see ILookupTableFilter) are fused into single color remapping filter.
+        private List<IFilter> PlanSteps( PixelFormat pixelFormat, List<bool> fused )
+        {
+            List<IFilter> steps = new List<IFilter>( );
+            // pixel format of image processed by current step is known
+            bool formatKnown = true;
+            int n = InnerList.Count;
+
+            for ( int i = 0; i < n; )
+            {
+                IFilter filter = InnerList[i];
+                byte[][] tables = ( formatKnown ) ? GetLookupTables( filter, pixelFormat ) : null;
+                byte[][] nextTables;
+                int next = i + 1;
+
+                if ( tables != null )
+                {
+                    // compose tables with tables of following filters
+                    while ( ( next < n ) && ( ( nextTables = GetLookupTables( InnerList[next], pixelFormat ) ) != null ) )
+                    {
+                        for ( int c = 0; c < tables.Length; c++ )
+                        {
+                            byte[] table     = tables[c];
+                            byte[] nextTable = nextTables[c];
+
+                            for ( int j = 0; j < 256; j++ )
+                            {
+                                table[j] = nextTable[table[j]];
+                            }
+                        }
+                        next++;
+                    }
+                }
+
+                if ( next - i > 1 )
+                {
+                    steps.Add( ( tables.Length == 1 ) ? new ColorRemapping( tables[0] ) :
+                        new ColorRemapping( tables[RGB.R], tables[RGB.G], tables[RGB.B] ) );
+                    fused.Add( true );
+                }
+                else
+                {
+                    steps.Add( filter );
+                    fused.Add( false );
+
+                    // get pixel format of the filter's result
+                    IFilterInformation info = filter as IFilterInformation;
+
+                    if ( ( formatKnown ) && ( info != null ) && ( info.FormatTranslations.ContainsKey( pixelFormat ) ) )
+                    {
+                        pixelFormat = info.FormatTranslations[pixelFormat];
+                    }
+                    else
+                    {
+                        formatKnown = false;
+                    }
+                }
+
+                i = next;
+            }
+
+            return steps;
+        }
+
+        // Get lookup tables of the filter, if it provides them for the pixel format
+        private static byte[][] GetLookupTables( IFilter filter, PixelFormat pixelFormat )
+        {
+            ILookupTableFilter lookupTableFilter = filter as ILookupTableFilter;
+
+            return ( lookupTableFilter != null ) ? lookupTableFilter.GetLookupTables( pixelFormat ) : null;
         }
 	}
 }
@@ -52,6 +52,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
         
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>
         /// Hue value to set, [0, 359].
         /// </summary>
@@ -0,0 +1,54 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging.Filters
+{
+    using System;
+    using System.Drawing;
+    using System.Drawing.Imaging;
+
+    /// <summary>
+    /// Interface of point filters, which map values of pixels' channels using lookup tables.
+    /// </summary>
+    ///
+    /// <remarks><para>The interface is implemented by filters, which replace value of each channel of
+    /// every pixel by a value taken from a 256 entries table (one table per channel), so the new value
+    /// depends only on the old value of the same channel. Result of applying several such filters one
+    /// after another can be represented by a single set of lookup tables, which allows
+    /// <see cref="FiltersSequence"/> to apply a chain of such filters in a single pass
+    /// (see <see cref="ColorRemapping"/>).</para>
+    ///
+    /// <para>Sample usage:</para>
+    /// <code>
+    /// // create filter
+    /// GammaCorrection filter = new GammaCorrection( 0.5 );
+    /// // get its lookup tables for color images
+    /// byte[][] tables = filter.GetLookupTables( PixelFormat.Format24bppRgb );
+    /// // get new value of red channel for the value 100
+    /// byte newRed = tables[RGB.R][100];
+    /// </code>
+    /// </remarks>
+    ///
+    public interface ILookupTableFilter
+    {
+        /// <summary>
+        /// Get lookup tables, which are used by the filter for images of the specified pixel format.
+        /// </summary>
+        ///
+        /// <param name="pixelFormat">Pixel format of image to get lookup tables for.</param>
+        ///
+        /// <returns>Returns array of lookup tables, 256 entries each, or <see langword="null"/> if
+        /// the filter can not process images of the specified pixel format using lookup tables. For 8 bpp
+        /// grayscale images the array contains single table. For color images it contains three
+        /// tables indexed by <see cref="RGB.R"/>, <see cref="RGB.G"/> and <see cref="RGB.B"/> (alpha channel is
+        /// never changed). Returned tables are copies, so they are not affected by further changes of the
+        /// filter's properties.</returns>
+        ///
+        byte[][] GetLookupTables( PixelFormat pixelFormat );
+    }
+}
@@ -28,6 +28,9 @@ namespace AForge.Imaging.Filters
     /// <para>For processing image with 3x3 structuring element, there are different optimizations
     /// available, like <see cref="Erosion3x3"/> and <see cref="BinaryErosion3x3"/>.</para>
     /// 
+    /// <para>Rectangular structuring elements of at least 5 cells are processed in time, which does not
+    /// depend on their size (van Herk/Gil-Werman algorithm).</para>
+    /// 
     /// <para>The filter accepts 8 and 16 bpp grayscale images and 24 and 48 bpp
     /// color images for processing.</para>
     /// 
@@ -57,6 +60,9 @@ namespace AForge.Imaging.Filters
         private short[,] se = new short[3, 3] { { 1, 1, 1 }, { 1, 1, 1 }, { 1, 1, 1 } };
         private int size = 3;
 
+        // working memory of separable processing kept between calls
+        private readonly ScratchArrays<ushort> scratch = new ScratchArrays<ushort>( );
+
         // private format translation dictionary
         private Dictionary<PixelFormat, PixelFormat> formatTranslations = new Dictionary<PixelFormat, PixelFormat>( );
 
@@ -68,6 +74,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>
         /// Initializes a new instance of the <see cref="Erosion"/> class.
         /// </summary>
@@ -118,18 +130,45 @@ namespace AForge.Imaging.Filters
         /// <param name="rect">Image rectangle for processing by the filter.</param>
         /// 
         protected override unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect )
+        {
+            ProcessFilter( sourceData, destinationData, rect, rect.Top, rect.Bottom );
+        }
+
+        /// <summary>
+        /// Process the filter on the specified rows of image's rectangle.
+        /// </summary>
+        /// 
+        /// <param name="sourceData">Source image data.</param>
+        /// <param name="destinationData">Destination image data.</param>
+        /// <param name="rect">Image rectangle for processing by the filter.</param>
+        /// <param name="startY">First row of the rectangle to process.</param>
+        /// <param name="stopY">Row following the last row of the rectangle to process.</param>
+        /// 
+        protected override unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect, int startY, int stopY )
         {
             PixelFormat pixelFormat = sourceData.PixelFormat;
 
-            // processing start and stop X,Y positions
+            // processing start and stop X positions
             int startX  = rect.Left;
-            int startY  = rect.Top;
             int stopX   = startX + rect.Width;
-            int stopY   = startY + rect.Height;
+            // rows of the rectangle, which can be used as neighbours
+            int top     = rect.Top;
+            int bottom  = rect.Bottom;
 
             // structuring element's radius
             int r = size >> 1;
 
+            // big rectangular structuring elements are processed by separable passes
+            Rectangle seRectangle;
+
+            if ( ( SeparableMorphology.GetRectangle( se, out seRectangle ) ) &&
+                 ( ( seRectangle.Width >= SeparableMorphology.MinElementSize ) ||
+                   ( seRectangle.Height >= SeparableMorphology.MinElementSize ) ) )
+            {
+                SeparableMorphology.Process( sourceData, destinationData, rect, startY, stopY, seRectangle, r, false, scratch );
+                return;
+            }
+
             // flag to indicate if at least one pixel for the given structuring element was found
             bool foundSomething;
 
@@ -176,10 +215,10 @@ namespace AForge.Imaging.Filters
                                 t = y + ir;
 
                                 // skip row
-                                if ( t < startY )
+                                if ( t < top )
                                     continue;
                                 // break
-                                if ( t >= stopY )
+                                if ( t >= bottom )
                                     break;
 
                                 // for each structuring element's column
@@ -238,10 +277,10 @@ namespace AForge.Imaging.Filters
                                 t = y + ir;
 
                                 // skip row
-                                if ( t < startY )
+                                if ( t < top )
                                     continue;
                                 // break
-                                if ( t >= stopY )
+                                if ( t >= bottom )
                                     break;
 
                                 // for each structuring element's column
@@ -339,10 +378,10 @@ namespace AForge.Imaging.Filters
                                 t = y + ir;
 
                                 // skip row
-                                if ( t < startY )
+                                if ( t < top )
                                     continue;
                                 // break
-                                if ( t >= stopY )
+                                if ( t >= bottom )
                                     break;
 
                                 // for each structuring element's column
@@ -402,10 +441,10 @@ namespace AForge.Imaging.Filters
                                 t = y + ir;
 
                                 // skip row
-                                if ( t < startY )
+                                if ( t < top )
                                     continue;
                                 // break
-                                if ( t >= stopY )
+                                if ( t >= bottom )
                                     break;
 
                                 // for each structuring element's column
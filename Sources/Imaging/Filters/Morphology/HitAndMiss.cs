@@ -105,6 +105,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>
         /// Operation mode.
         /// </summary>
@@ -169,11 +175,27 @@ namespace AForge.Imaging.Filters
         /// 
         protected override unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect )
         {
-            // processing start and stop X,Y positions
+            ProcessFilter( sourceData, destinationData, rect, rect.Top, rect.Bottom );
+        }
+
+        /// <summary>
+        /// Process the filter on the specified rows of image's rectangle.
+        /// </summary>
+        /// 
+        /// <param name="sourceData">Source image data.</param>
+        /// <param name="destinationData">Destination image data.</param>
+        /// <param name="rect">Image rectangle for processing by the filter.</param>
+        /// <param name="startY">First row of the rectangle to process.</param>
+        /// <param name="stopY">Row following the last row of the rectangle to process.</param>
+        /// 
+        protected override unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect, int startY, int stopY )
+        {
+            // processing start and stop X positions
             int startX  = rect.Left;
-            int startY  = rect.Top;
             int stopX   = startX + rect.Width;
-            int stopY   = startY + rect.Height;
+            // rows of the rectangle, which can be used as neighbours
+            int top     = rect.Top;
+            int bottom  = rect.Bottom;
 
             int srcStride = sourceData.Stride;
             int dstStride = destinationData.Stride;
@@ -230,7 +252,7 @@ namespace AForge.Imaging.Filters
 
                             // check, if we outside
                             if (
-                                ( y + ir < startY ) || ( y + ir >= stopY ) ||
+                                ( y + ir < top ) || ( y + ir >= bottom ) ||
                                 ( x + jr < startX ) || ( x + jr >= stopX )
                                 )
                             {
@@ -0,0 +1,316 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging.Filters
+{
+    using System;
+    using System.Drawing;
+    using System.Drawing.Imaging;
+
+    /// <summary>
+    /// Erosion and dilatation with rectangular structuring elements.
+    /// </summary>
+    ///
+    /// <remarks><para>Minimum (maximum) over a rectangle is minimum (maximum) over its columns of minimums
+    /// (maximums) over its rows, so the rectangle is processed in two 1D passes - horizontal and vertical. Each pass
+    /// uses van Herk/Gil-Werman algorithm: the line is split into blocks of the window's length, for each
+    /// element prefix minimum (from start of its block) and suffix minimum (to end of its block) are calculated,
+    /// and then minimum of a window is minimum of the suffix minimum of its first element and the prefix
+    /// minimum of its last element. So each pass takes 3 comparisons per pixel regardless of the window's
+    /// length.</para>
+    ///
+    /// <para>Dilatation is done as erosion of inverted values. Edges are handled the same way as
+    /// <see cref="Erosion"/> and <see cref="Dilatation"/> filters do it - only pixels inside processing rectangle
+    /// are taken into account and the source pixel is kept if none of them is covered by the structuring
+    /// element.</para>
+    /// </remarks>
+    ///
+    internal static class SeparableMorphology
+    {
+        /// <summary>
+        /// Minimum width or height of structuring element, starting from which the separable processing
+        /// is faster than direct one.
+        /// </summary>
+        public const int MinElementSize = 5;
+
+        /// <summary>
+        /// Get rectangle formed by the structuring element.
+        /// </summary>
+        ///
+        /// <param name="se">Structuring element.</param>
+        /// <param name="rectangle">Rectangle of structuring element's cells set to 1 (in coordinates of
+        /// structuring element's columns and rows).</param>
+        ///
+        /// <returns>Returns <see langword="true"/> if cells of the structuring element set to 1 form a
+        /// rectangle (or a horizontal/vertical line) or <see langword="false"/> otherwise.</returns>
+        ///
+        public static bool GetRectangle( short[,] se, out Rectangle rectangle )
+        {
+            int rows = se.GetLength( 0 );
+            int cols = se.GetLength( 1 );
+            int minRow = rows, maxRow = -1;
+            int minCol = cols, maxCol = -1;
+            int count = 0;
+
+            rectangle = Rectangle.Empty;
+
+            for ( int i = 0; i < rows; i++ )
+            {
+                for ( int j = 0; j < cols; j++ )
+                {
+                    if ( se[i, j] == 1 )
+                    {
+                        count++;
+
+                        if ( i < minRow )
+                            minRow = i;
+                        if ( i > maxRow )
+                            maxRow = i;
+                        if ( j < minCol )
+                            minCol = j;
+                        if ( j > maxCol )
+                            maxCol = j;
+                    }
+                }
+            }
+
+            // all cells of bounding rectangle must be set
+            if ( ( count == 0 ) || ( count != ( maxRow - minRow + 1 ) * ( maxCol - minCol + 1 ) ) )
+                return false;
+
+            rectangle = new Rectangle( minCol, minRow, maxCol - minCol + 1, maxRow - minRow + 1 );
+            return true;
+        }
+
+        /// <summary>
+        /// Process erosion or dilatation with rectangular structuring element.
+        /// </summary>
+        ///
+        /// <param name="source">Source image data.</param>
+        /// <param name="destination">Destination image data.</param>
+        /// <param name="rect">Image rectangle for processing.</param>
+        /// <param name="startY">First row of the rectangle to process.</param>
+        /// <param name="stopY">Row following the last row of the rectangle to process.</param>
+        /// <param name="seRectangle">Rectangle of structuring element (see <see cref="GetRectangle"/>).</param>
+        /// <param name="radius">Radius of structuring element.</param>
+        /// <param name="dilatation">Process dilatation or erosion.</param>
+        /// <param name="scratch">Filter's arrays to use as working memory.</param>
+        ///
+        /// <remarks><para>The method accepts 8 and 16 bpp grayscale images and 24 and 48 bpp color images.</para></remarks>
+        ///
+        public static unsafe void Process( UnmanagedImage source, UnmanagedImage destination, Rectangle rect,
+                                           int startY, int stopY, Rectangle seRectangle, int radius, bool dilatation,
+                                           ScratchArrays<ushort> scratch )
+        {
+            PixelFormat pixelFormat = source.PixelFormat;
+            bool is16bpp = ( pixelFormat == PixelFormat.Format16bppGrayScale ) || ( pixelFormat == PixelFormat.Format48bppRgb );
+            int channels = ( ( pixelFormat == PixelFormat.Format8bppIndexed ) || ( pixelFormat == PixelFormat.Format16bppGrayScale ) ) ? 1 : 3;
+            int maxValue = ( is16bpp ) ? 65535 : 255;
+
+            int width      = rect.Width;
+            int height     = rect.Height;
+            int lineLength = width * channels;
+            int sampleSize = ( is16bpp ) ? 2 : 1;
+
+            // window of structuring element relatively to the processed pixel
+            int left   = seRectangle.Left - radius;
+            int right  = seRectangle.Right - 1 - radius;
+            int top    = seRectangle.Top - radius;
+            int bottom = seRectangle.Bottom - 1 - radius;
+            int windowWidth  = seRectangle.Width;
+            int windowHeight = seRectangle.Height;
+
+            int srcStride = source.Stride;
+            int dstStride = destination.Stride;
+
+            // rows to produce and rows of horizontal pass required for them (relatively to the rectangle)
+            int startRow = startY - rect.Top;
+            int stopRow  = stopY - rect.Top;
+            int rowsBase = Math.Max( 0, startRow + top );
+            int rowsStop = Math.Min( height, stopRow + bottom );
+
+            // allign pointers to the first pixel to process
+            byte* baseSrc = (byte*) source.ImageData.ToPointer( ) + rect.Top * srcStride + rect.Left * channels * sampleSize;
+            byte* baseDst = (byte*) destination.ImageData.ToPointer( ) + rect.Top * dstStride + rect.Left * channels * sampleSize;
+
+            // all working arrays are parts of single array, which is written before it is read
+            int rowsLength    = lineLength * Math.Max( 0, rowsStop - rowsBase );
+            int extendedWidth = width + windowWidth - 1;
+            ushort[] memory   = scratch.Take( rowsLength + 3 * extendedWidth + ( windowHeight + 2 ) * lineLength );
+
+            fixed ( ushort* memoryPtr = memory )
+            {
+                // result of horizontal pass (values are inverted for dilatation, so both operations look for minimum)
+                ushort* rowsPtr = memoryPtr;
+                // extended line of a channel with its prefix and suffix minimums
+                ushort* linePtr   = rowsPtr + rowsLength;
+                ushort* prefixPtr = linePtr + extendedWidth;
+                ushort* suffixPtr = prefixPtr + extendedWidth;
+                // suffix minimums of block's rows, prefix minimum of the next block's rows and row of identity values
+                ushort* blockSuffixPtr = suffixPtr + extendedWidth;
+                ushort* nextPrefixPtr  = blockSuffixPtr + windowHeight * lineLength;
+                ushort* identityPtr    = nextPrefixPtr + lineLength;
+
+                for ( int i = 0; i < lineLength; i++ )
+                {
+                    identityPtr[i] = (ushort) maxValue;
+                }
+
+                // horizontal pass
+                for ( int y = rowsBase; y < rowsStop; y++ )
+                {
+                    byte* src = baseSrc + y * srcStride;
+                    ushort* row = rowsPtr + ( y - rowsBase ) * lineLength;
+
+                    for ( int c = 0; c < channels; c++ )
+                    {
+                        // channel's values extended by identity values to the size of all windows
+                        for ( int q = 0; q < extendedWidth; q++ )
+                        {
+                            int x = q + left;
+
+                            if ( ( x < 0 ) || ( x >= width ) )
+                            {
+                                linePtr[q] = (ushort) maxValue;
+                            }
+                            else
+                            {
+                                int v = ( is16bpp ) ? ( (ushort*) src )[x * channels + c] : src[x * channels + c];
+                                linePtr[q] = (ushort) ( ( dilatation ) ? maxValue - v : v );
+                            }
+                        }
+
+                        MinimumOfWindows( linePtr, prefixPtr, suffixPtr, extendedWidth, windowWidth );
+
+                        for ( int x = 0; x < width; x++ )
+                        {
+                            ushort p = prefixPtr[x + windowWidth - 1];
+                            ushort s = suffixPtr[x];
+
+                            row[x * channels + c] = ( s < p ) ? s : p;
+                        }
+                    }
+                }
+
+                // vertical pass - the same is done for all columns at once processing blocks of rows
+                // (result of each row does not depend on blocks' alignment, so blocks start from the first row)
+                ushort* rowsOrigin = rowsPtr - rowsBase * lineLength;
+                int extendedHeight = height + windowHeight - 1;
+
+                for ( int blockStart = startRow; blockStart < stopRow; blockStart += windowHeight )
+                {
+                    int blockLength = Math.Min( windowHeight, extendedHeight - blockStart );
+
+                    // suffix minimums of the block's rows
+                    for ( int i = blockLength - 1; i >= 0; i-- )
+                    {
+                        ushort* e = GetExtendedRow( rowsOrigin, identityPtr, blockStart + i + top, height, lineLength );
+                        ushort* s = blockSuffixPtr + i * lineLength;
+
+                        if ( i == blockLength - 1 )
+                        {
+                            for ( int k = 0; k < lineLength; k++ )
+                                s[k] = e[k];
+                        }
+                        else
+                        {
+                            ushort* next = s + lineLength;
+
+                            for ( int k = 0; k < lineLength; k++ )
+                                s[k] = ( e[k] < next[k] ) ? e[k] : next[k];
+                        }
+                    }
+
+                    for ( int i = 0, y = blockStart; ( i < blockLength ) && ( y < stopRow ); i++, y++ )
+                    {
+                        ushort* s = blockSuffixPtr + i * lineLength;
+                        ushort* result = s;
+
+                        if ( i != 0 )
+                        {
+                            // prefix minimum of the next block up to the window's last row
+                            ushort* e = GetExtendedRow( rowsOrigin, identityPtr, blockStart + windowHeight + i - 1 + top, height, lineLength );
+
+                            if ( i == 1 )
+                            {
+                                for ( int k = 0; k < lineLength; k++ )
+                                    nextPrefixPtr[k] = e[k];
+                            }
+                            else
+                            {
+                                for ( int k = 0; k < lineLength; k++ )
+                                    nextPrefixPtr[k] = ( e[k] < nextPrefixPtr[k] ) ? e[k] : nextPrefixPtr[k];
+                            }
+
+                            // result is kept in the suffix row, which is not needed any more
+                            for ( int k = 0; k < lineLength; k++ )
+                                s[k] = ( s[k] < nextPrefixPtr[k] ) ? s[k] : nextPrefixPtr[k];
+                        }
+
+                        WriteRow( result, baseSrc + y * srcStride, baseDst + y * dstStride, width, channels, is16bpp,
+                            dilatation, maxValue, ( y + bottom < 0 ) || ( y + top >= height ), left, right );
+                    }
+                }
+            }
+
+            scratch.Return( memory );
+        }
+
+        // Calculate prefix and suffix minimums of the line's blocks
+        private static unsafe void MinimumOfWindows( ushort* line, ushort* prefix, ushort* suffix, int length, int windowLength )
+        {
+            for ( int blockStart = 0; blockStart < length; blockStart += windowLength )
+            {
+                int blockEnd = Math.Min( blockStart + windowLength, length );
+
+                prefix[blockStart] = line[blockStart];
+                for ( int q = blockStart + 1; q < blockEnd; q++ )
+                {
+                    prefix[q] = ( line[q] < prefix[q - 1] ) ? line[q] : prefix[q - 1];
+                }
+
+                suffix[blockEnd - 1] = line[blockEnd - 1];
+                for ( int q = blockEnd - 2; q >= blockStart; q-- )
+                {
+                    suffix[q] = ( line[q] < suffix[q + 1] ) ? line[q] : suffix[q + 1];
+                }
+            }
+        }
+
+        // Get row of horizontal pass extended by identity rows above and below image
+        private static unsafe ushort* GetExtendedRow( ushort* rows, ushort* identity, int y, int height, int lineLength )
+        {
+            return ( ( y < 0 ) || ( y >= height ) ) ? identity : rows + y * lineLength;
+        }
+
+        // Write result row into destination image. Source pixels are kept, where structuring element
+        // does not cover any pixel inside processing rectangle.
+        private static unsafe void WriteRow( ushort* result, byte* src, byte* dst, int width, int channels, bool is16bpp,
+                                             bool dilatation, int maxValue, bool emptyRow, int left, int right )
+        {
+            for ( int x = 0; x < width; x++ )
+            {
+                bool empty = ( emptyRow ) || ( x + right < 0 ) || ( x + left >= width );
+
+                for ( int c = 0, k = x * channels; c < channels; c++, k++ )
+                {
+                    if ( is16bpp )
+                    {
+                        ( (ushort*) dst )[k] = ( empty ) ? ( (ushort*) src )[k] :
+                            (ushort) ( ( dilatation ) ? maxValue - result[k] : result[k] );
+                    }
+                    else
+                    {
+                        dst[k] = ( empty ) ? src[k] :
+                            (byte) ( ( dilatation ) ? maxValue - result[k] : result[k] );
+                    }
+                }
+            }
+        }
+    }
+}
@@ -45,6 +45,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>
         /// Initializes a new instance of the <see cref="BinaryDilatation3x3"/> class.
         /// </summary>
@@ -63,20 +69,36 @@ namespace AForge.Imaging.Filters
         /// <param name="destinationData">Destination image data.</param>
         /// <param name="rect">Image rectangle for processing by the filter.</param>
         /// 
+        protected override unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect )
+        {
+            ProcessFilter( sourceData, destinationData, rect, rect.Top, rect.Bottom );
+        }
+
+        /// <summary>
+        /// Process the filter on the specified rows of image's rectangle.
+        /// </summary>
+        /// 
+        /// <param name="sourceData">Source image data.</param>
+        /// <param name="destinationData">Destination image data.</param>
+        /// <param name="rect">Image rectangle for processing by the filter.</param>
+        /// <param name="startY">First row of the rectangle to process.</param>
+        /// <param name="stopY">Row following the last row of the rectangle to process.</param>
+        /// 
         /// <exception cref="InvalidImagePropertiesException">Processing rectangle mast be at least 3x3 in size.</exception>
         /// 
-        protected override unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect )
+        protected override unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect, int startY, int stopY )
         {
             if ( ( rect.Width < 3 ) || ( rect.Height < 3 ) )
             {
                 throw new InvalidImagePropertiesException( "Processing rectangle mast be at least 3x3 in size." );
             }
 
-            // processing start and stop X,Y positions
+            // processing start and stop X positions
             int startX  = rect.Left + 1;
-            int startY  = rect.Top + 1;
             int stopX   = rect.Right - 1;
-            int stopY   = rect.Bottom - 1;
+            // lines between the first and the last lines of the rectangle
+            int startLine = Math.Max( startY, rect.Top + 1 );
+            int stopLine  = Math.Min( stopY, rect.Bottom - 1 );
 
             int dstStride = destinationData.Stride;
             int srcStride = sourceData.Stride;
@@ -89,29 +111,32 @@ namespace AForge.Imaging.Filters
             byte* dst = (byte*) destinationData.ImageData.ToPointer( );
 
             // allign pointers by X and Y
-            src += ( startX - 1 ) + ( startY - 1 ) * srcStride;
-            dst += ( startX - 1 ) + ( startY - 1 ) * dstStride;
+            src += ( startX - 1 ) + startY * srcStride;
+            dst += ( startX - 1 ) + startY * dstStride;
 
             // --- process the first line
-            *dst = (byte) ( *src | src[1] | src[srcStride] | src[srcStride + 1] );
+            if ( startY == rect.Top )
+            {
+                *dst = (byte) ( *src | src[1] | src[srcStride] | src[srcStride + 1] );
 
-            src++;
-            dst++;
+                src++;
+                dst++;
 
-            // for each pixel
-            for ( int x = startX; x < stopX; x++, src++, dst++ )
-            {
-                *dst = (byte) ( *src | src[-1] | src[1] |
-                    src[srcStride] | src[srcStride - 1] | src[srcStride + 1] );
-            }
+                // for each pixel
+                for ( int x = startX; x < stopX; x++, src++, dst++ )
+                {
+                    *dst = (byte) ( *src | src[-1] | src[1] |
+                        src[srcStride] | src[srcStride - 1] | src[srcStride + 1] );
+                }
 
-            *dst = (byte) ( *src | src[-1] | src[srcStride] | src[srcStride - 1] );
+                *dst = (byte) ( *src | src[-1] | src[srcStride] | src[srcStride - 1] );
 
-            src += srcOffset;
-            dst += dstOffset;
+                src += srcOffset;
+                dst += dstOffset;
+            }
 
             // --- process all lines except the last one
-            for ( int y = startY; y < stopY; y++ )
+            for ( int y = startLine; y < stopLine; y++ )
             {
                 *dst = (byte) ( *src | src[1] |
                     src[-srcStride] | src[-srcStride + 1] |
@@ -137,19 +162,22 @@ namespace AForge.Imaging.Filters
             }
 
             // --- process the last line
-            *dst = (byte) ( *src | src[1] | src[-srcStride] | src[-srcStride + 1] );
+            if ( stopY == rect.Bottom )
+            {
+                *dst = (byte) ( *src | src[1] | src[-srcStride] | src[-srcStride + 1] );
 
-            src++;
-            dst++;
+                src++;
+                dst++;
 
-            // for each pixel
-            for ( int x = startX; x < stopX; x++, src++, dst++ )
-            {
-                *dst = (byte) ( *src | src[-1] | src[1] |
-                    src[-srcStride] | src[-srcStride - 1] | src[-srcStride + 1] );
-            }
+                // for each pixel
+                for ( int x = startX; x < stopX; x++, src++, dst++ )
+                {
+                    *dst = (byte) ( *src | src[-1] | src[1] |
+                        src[-srcStride] | src[-srcStride - 1] | src[-srcStride + 1] );
+                }
 
-            *dst = (byte) ( *src | src[-1] | src[-srcStride] | src[-srcStride - 1] );
+                *dst = (byte) ( *src | src[-1] | src[-srcStride] | src[-srcStride - 1] );
+            }
         }
     }
 }
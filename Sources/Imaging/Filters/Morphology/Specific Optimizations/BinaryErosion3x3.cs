@@ -44,6 +44,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>
         /// Initializes a new instance of the <see cref="BinaryErosion3x3"/> class.
         /// </summary>
@@ -62,20 +68,36 @@ namespace AForge.Imaging.Filters
         /// <param name="destinationData">Destination image data.</param>
         /// <param name="rect">Image rectangle for processing by the filter.</param>
         /// 
+        protected override unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect )
+        {
+            ProcessFilter( sourceData, destinationData, rect, rect.Top, rect.Bottom );
+        }
+
+        /// <summary>
+        /// Process the filter on the specified rows of image's rectangle.
+        /// </summary>
+        /// 
+        /// <param name="sourceData">Source image data.</param>
+        /// <param name="destinationData">Destination image data.</param>
+        /// <param name="rect">Image rectangle for processing by the filter.</param>
+        /// <param name="startY">First row of the rectangle to process.</param>
+        /// <param name="stopY">Row following the last row of the rectangle to process.</param>
+        /// 
         /// <exception cref="InvalidImagePropertiesException">Processing rectangle mast be at least 3x3 in size.</exception>
         /// 
-        protected override unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect )
+        protected override unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect, int startY, int stopY )
         {
             if ( ( rect.Width < 3 ) || ( rect.Height < 3 ) )
             {
                 throw new InvalidImagePropertiesException( "Processing rectangle mast be at least 3x3 in size." );
             }
 
-            // processing start and stop X,Y positions
+            // processing start and stop X positions
             int startX  = rect.Left + 1;
-            int startY  = rect.Top + 1;
             int stopX   = rect.Right - 1;
-            int stopY   = rect.Bottom - 1;
+            // lines between the first and the last lines of the rectangle
+            int startLine = Math.Max( startY, rect.Top + 1 );
+            int stopLine  = Math.Min( stopY, rect.Bottom - 1 );
 
             int dstStride = destinationData.Stride;
             int srcStride = sourceData.Stride;
@@ -88,21 +110,24 @@ namespace AForge.Imaging.Filters
             byte* dst = (byte*) destinationData.ImageData.ToPointer( );
 
             // allign pointers by X and Y
-            src += ( startX - 1 ) + ( startY - 1 ) * srcStride;
-            dst += ( startX - 1 ) + ( startY - 1 ) * dstStride;
+            src += ( startX - 1 ) + startY * srcStride;
+            dst += ( startX - 1 ) + startY * dstStride;
 
             // --- process the first line setting all to black
-            for ( int x = startX - 1; x < stopX; x++, src++, dst++ )
+            if ( startY == rect.Top )
             {
+                for ( int x = startX - 1; x < stopX; x++, src++, dst++ )
+                {
+                    *dst = 0;
+                }
                 *dst = 0;
-            }
-            *dst = 0;
 
-            src += srcOffset;
-            dst += dstOffset;
+                src += srcOffset;
+                dst += dstOffset;
+            }
 
             // --- process all lines except the last one
-            for ( int y = startY; y < stopY; y++ )
+            for ( int y = startLine; y < stopLine; y++ )
             {
                 // set edge pixel to black
                 *dst = 0;
@@ -126,13 +151,15 @@ namespace AForge.Imaging.Filters
             }
 
             // --- process the last line setting all to black
-
-            // for each pixel
-            for ( int x = startX - 1; x < stopX; x++, src++, dst++ )
+            if ( stopY == rect.Bottom )
             {
+                // for each pixel
+                for ( int x = startX - 1; x < stopX; x++, src++, dst++ )
+                {
+                    *dst = 0;
+                }
                 *dst = 0;
             }
-            *dst = 0;
         }
     }
 }
\ No newline at end of file
@@ -42,6 +42,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>
         /// Initializes a new instance of the <see cref="Erosion3x3"/> class.
         /// </summary>
@@ -60,20 +66,36 @@ namespace AForge.Imaging.Filters
         /// <param name="destinationData">Destination image data.</param>
         /// <param name="rect">Image rectangle for processing by the filter.</param>
         /// 
+        protected override unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect )
+        {
+            ProcessFilter( sourceData, destinationData, rect, rect.Top, rect.Bottom );
+        }
+
+        /// <summary>
+        /// Process the filter on the specified rows of image's rectangle.
+        /// </summary>
+        /// 
+        /// <param name="sourceData">Source image data.</param>
+        /// <param name="destinationData">Destination image data.</param>
+        /// <param name="rect">Image rectangle for processing by the filter.</param>
+        /// <param name="startY">First row of the rectangle to process.</param>
+        /// <param name="stopY">Row following the last row of the rectangle to process.</param>
+        /// 
         /// <exception cref="InvalidImagePropertiesException">Processing rectangle mast be at least 3x3 in size.</exception>
         /// 
-        protected override unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect )
+        protected override unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData, Rectangle rect, int startY, int stopY )
         {
             if ( ( rect.Width < 3 ) || ( rect.Height < 3 ) )
             {
                 throw new InvalidImagePropertiesException( "Processing rectangle mast be at least 3x3 in size." );
             }
 
-            // processing start and stop X,Y positions
+            // processing start and stop X positions
             int startX  = rect.Left + 1;
-            int startY  = rect.Top + 1;
             int stopX   = rect.Right - 1;
-            int stopY   = rect.Bottom - 1;
+            // lines between the first and the last lines of the rectangle
+            int startLine = Math.Max( startY, rect.Top + 1 );
+            int stopLine  = Math.Min( stopY, rect.Bottom - 1 );
 
             int dstStride = destinationData.Stride;
             int srcStride = sourceData.Stride;
@@ -88,59 +110,62 @@ namespace AForge.Imaging.Filters
             byte min;
 
             // allign pointers by X and Y
-            src += ( startX - 1 ) + ( startY - 1 ) * srcStride;
-            dst += ( startX - 1 ) + ( startY - 1 ) * dstStride;
+            src += ( startX - 1 ) + startY * srcStride;
+            dst += ( startX - 1 ) + startY * dstStride;
 
             // --- process the first line
-            min = *src;
-
-            if ( src[1] < min )
-                min = src[1];
-            if ( src[srcStride] < min )
-                min = src[srcStride];
-            if ( src[srcStride + 1] < min )
-                min = src[srcStride + 1];
-
-            *dst = min;
-
-            src++;
-            dst++;
-
-            // for each pixel
-            for ( int x = startX; x < stopX; x++, src++, dst++ )
+            if ( startY == rect.Top )
             {
                 min = *src;
 
-                if ( src[-1] < min )
-                    min = src[-1];
                 if ( src[1] < min )
                     min = src[1];
-                if ( src[srcStride - 1] < min )
-                    min = src[srcStride - 1];
                 if ( src[srcStride] < min )
                     min = src[srcStride];
                 if ( src[srcStride + 1] < min )
                     min = src[srcStride + 1];
 
                 *dst = min;
-            }
 
-            min = *src;
+                src++;
+                dst++;
+
+                // for each pixel
+                for ( int x = startX; x < stopX; x++, src++, dst++ )
+                {
+                    min = *src;
 
-            if ( src[-1] < min )
-                min = src[-1];
-            if ( src[srcStride - 1] < min )
-                min = src[srcStride - 1];
-            if ( src[srcStride] < min )
-                min = src[srcStride];
+                    if ( src[-1] < min )
+                        min = src[-1];
+                    if ( src[1] < min )
+                        min = src[1];
+                    if ( src[srcStride - 1] < min )
+                        min = src[srcStride - 1];
+                    if ( src[srcStride] < min )
+                        min = src[srcStride];
+                    if ( src[srcStride + 1] < min )
+                        min = src[srcStride + 1];
 
-            *dst = min;
+                    *dst = min;
+                }
 
-            src += srcOffset;
-            dst += dstOffset;
+                min = *src;
+
+                if ( src[-1] < min )
+                    min = src[-1];
+                if ( src[srcStride - 1] < min )
+                    min = src[srcStride - 1];
+                if ( src[srcStride] < min )
+                    min = src[srcStride];
+
+                *dst = min;
+
+                src += srcOffset;
+                dst += dstOffset;
+            }
 
             // --- process all lines except the last one
-            for ( int y = startY; y < stopY; y++ )
+            for ( int y = startLine; y < stopLine; y++ )
             {
                 min = *src;
 
@@ -205,51 +230,54 @@ namespace AForge.Imaging.Filters
             }
 
             // --- process the last line
-            *dst = (byte) ( *src | src[1] | src[-srcStride] | src[-srcStride + 1] );
+            if ( stopY == rect.Bottom )
+            {
+                *dst = (byte) ( *src | src[1] | src[-srcStride] | src[-srcStride + 1] );
 
-            min = *src;
+                min = *src;
 
-            if ( src[1] < min )
-                min = src[1];
-            if ( src[-srcStride] < min )
-                min = src[-srcStride];
-            if ( src[-srcStride + 1] < min )
-                min = src[-srcStride + 1];
+                if ( src[1] < min )
+                    min = src[1];
+                if ( src[-srcStride] < min )
+                    min = src[-srcStride];
+                if ( src[-srcStride + 1] < min )
+                    min = src[-srcStride + 1];
 
-            *dst = min;
+                *dst = min;
 
-            src++;
-            dst++;
+                src++;
+                dst++;
+
+                // for each pixel
+                for ( int x = startX; x < stopX; x++, src++, dst++ )
+                {
+                    min = *src;
+
+                    if ( src[-1] < min )
+                        min = src[-1];
+                    if ( src[1] < min )
+                        min = src[1];
+                    if ( src[-srcStride - 1] < min )
+                        min = src[-srcStride - 1];
+                    if ( src[-srcStride] < min )
+                        min = src[-srcStride];
+                    if ( src[-srcStride + 1] < min )
+                        min = src[-srcStride + 1];
+
+                    *dst = min;
+                }
 
-            // for each pixel
-            for ( int x = startX; x < stopX; x++, src++, dst++ )
-            {
                 min = *src;
 
                 if ( src[-1] < min )
                     min = src[-1];
-                if ( src[1] < min )
-                    min = src[1];
                 if ( src[-srcStride - 1] < min )
                     min = src[-srcStride - 1];
                 if ( src[-srcStride] < min )
                     min = src[-srcStride];
-                if ( src[-srcStride + 1] < min )
-                    min = src[-srcStride + 1];
 
                 *dst = min;
             }
-
-            min = *src;
-
-            if ( src[-1] < min )
-                min = src[-1];
-            if ( src[-srcStride - 1] < min )
-                min = src[-srcStride - 1];
-            if ( src[-srcStride] < min )
-                min = src[-srcStride];
-
-            *dst = min;
         }
     }
 }
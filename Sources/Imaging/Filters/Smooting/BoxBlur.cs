@@ -0,0 +1,247 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging.Filters
+{
+    using System;
+    using System.Collections.Generic;
+    using System.Drawing;
+    using System.Drawing.Imaging;
+
+    /// <summary>
+    /// Box blur filter.
+    /// </summary>
+    ///
+    /// <remarks><para>The filter calculates each pixel of the result image as average value of pixels in the square
+    /// window of the specified <see cref="KernelSize">size</see> around the corresponding pixel of the source image.
+    /// Near image's edges only those pixels of the window are averaged, which are inside image. The result is
+    /// exactly the same as the result of <see cref="Convolution"/> filter with kernel of the same size filled
+    /// with ones (for example, <see cref="Mean"/> filter in the case of 3x3 window).</para>
+    ///
+    /// <para>Unlike convolution, the filter takes constant time per pixel regardless of window's size. It keeps sums
+    /// of pixels' values in columns of the window, which are updated by adding new row entering the window and
+    /// subtracting the row leaving it, when the window moves to the next row. Sums of windows are calculated from the
+    /// column sums the same way moving along the row. So the filter is suitable for big windows, like
+    /// calculating local mean for background subtraction or adaptive thresholding.</para>
+    ///
+    /// <para>The filter accepts 8 bpp grayscale images and 24/32 bpp color images for processing.
+    /// Alpha channel of 32 bpp images is copied as is.</para>
+    ///
+    /// <para>Sample usage:</para>
+    /// <code>
+    /// // create filter
+    /// BoxBlur filter = new BoxBlur( 31 );
+    /// // apply the filter
+    /// filter.ApplyInPlace( image );
+    /// </code>
+    /// </remarks>
+    ///
+    /// <seealso cref="Mean"/>
+    ///
+    public class BoxBlur : BaseUsingCopyPartialFilter
+    {
+        private int size = 3;
+
+        // sums of columns kept between calls as working memory
+        private readonly ScratchArrays<int> sumsArrays = new ScratchArrays<int>( );
+
+        // private format translation dictionary
+        private Dictionary<PixelFormat, PixelFormat> formatTranslations = new Dictionary<PixelFormat, PixelFormat>( );
+
+        /// <summary>
+        /// Format translations dictionary.
+        /// </summary>
+        public override Dictionary<PixelFormat, PixelFormat> FormatTranslations
+        {
+            get { return formatTranslations; }
+        }
+
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
+        /// <summary>
+        /// Kernel size, [3, 1001].
+        /// </summary>
+        ///
+        /// <remarks><para>Determines the size of pixel's square window used for averaging.</para>
+        ///
+        /// <para>Default value is set to <b>3</b>.</para>
+        ///
+        /// <para><note>The value should be odd.</note></para>
+        /// </remarks>
+        ///
+        public int KernelSize
+        {
+            get { return size; }
+            set { size = Math.Max( 3, Math.Min( 1001, value | 1 ) ); }
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="BoxBlur"/> class.
+        /// </summary>
+        ///
+        public BoxBlur( )
+        {
+            formatTranslations[PixelFormat.Format8bppIndexed] = PixelFormat.Format8bppIndexed;
+            formatTranslations[PixelFormat.Format24bppRgb]    = PixelFormat.Format24bppRgb;
+            formatTranslations[PixelFormat.Format32bppRgb]    = PixelFormat.Format32bppRgb;
+            formatTranslations[PixelFormat.Format32bppArgb]   = PixelFormat.Format32bppArgb;
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="BoxBlur"/> class.
+        /// </summary>
+        ///
+        /// <param name="size">Kernel size.</param>
+        ///
+        public BoxBlur( int size ) : this( )
+        {
+            KernelSize = size;
+        }
+
+        /// <summary>
+        /// Process the filter on the specified image.
+        /// </summary>
+        ///
+        /// <param name="source">Source image data.</param>
+        /// <param name="destination">Destination image data.</param>
+        /// <param name="rect">Image rectangle for processing by the filter.</param>
+        ///
+        protected override unsafe void ProcessFilter( UnmanagedImage source, UnmanagedImage destination, Rectangle rect )
+        {
+            ProcessFilter( source, destination, rect, rect.Top, rect.Bottom );
+        }
+
+        /// <summary>
+        /// Process the filter on the specified rows of image's rectangle.
+        /// </summary>
+        ///
+        /// <param name="source">Source image data.</param>
+        /// <param name="destination">Destination image data.</param>
+        /// <param name="rect">Image rectangle for processing by the filter.</param>
+        /// <param name="startY">First row of the rectangle to process.</param>
+        /// <param name="stopY">Row following the last row of the rectangle to process.</param>
+        ///
+        protected override unsafe void ProcessFilter( UnmanagedImage source, UnmanagedImage destination, Rectangle rect, int startY, int stopY )
+        {
+            int pixelSize = Image.GetPixelFormatSize( source.PixelFormat ) / 8;
+            // number of averaged channels
+            int channels  = ( pixelSize == 1 ) ? 1 : 3;
+
+            // rows of the rectangle, which can be used as neighbours
+            int top    = rect.Top;
+            int bottom = rect.Bottom;
+            int width  = rect.Width;
+            int radius = size >> 1;
+
+            int srcStride = source.Stride;
+            int dstStride = destination.Stride;
+            int lineSize  = width * pixelSize;
+
+            // allign pointers to the first pixel to process
+            byte* baseSrc = (byte*) source.ImageData.ToPointer( ) + rect.Left * pixelSize;
+            byte* baseDst = (byte*) destination.ImageData.ToPointer( ) + rect.Left * pixelSize;
+
+            // number of pixels in the window, which is not on the edge
+            int fullCount = size * size;
+            // sum of a window not on the edge is divided multiplying it by fixed point reciprocal of
+            // the pixels' count, which is exact for sums up to 255 * count with the allowed kernel sizes
+            ulong reciprocal = ( ( 1UL << 48 ) + (ulong) fullCount - 1 ) / (ulong) fullCount;
+
+            // sums of pixels' values in columns of the window
+            int[] columnSums = sumsArrays.Take( lineSize );
+
+            Array.Clear( columnSums, 0, lineSize );
+
+            fixed ( int* sums = columnSums )
+            {
+                // add rows of the window for the first row
+                for ( int y = Math.Max( top, startY - radius ), stop = Math.Min( bottom, startY + radius + 1 ); y < stop; y++ )
+                {
+                    byte* src = baseSrc + (long) y * srcStride;
+
+                    for ( int i = 0; i < lineSize; i++ )
+                    {
+                        sums[i] += src[i];
+                    }
+                }
+
+                for ( int y = startY; y < stopY; y++ )
+                {
+                    // number of window's rows inside image
+                    int rows = Math.Min( bottom, y + radius + 1 ) - Math.Max( top, y - radius );
+
+                    byte* srcRow = baseSrc + (long) y * srcStride;
+                    byte* dst    = baseDst + (long) y * dstStride;
+
+                    for ( int c = 0; c < channels; c++ )
+                    {
+                        int* column = sums + c;
+                        int sum = 0;
+
+                        // sum of the window for the first pixel
+                        for ( int x = 0, stop = Math.Min( width, radius + 1 ); x < stop; x++ )
+                        {
+                            sum += column[x * pixelSize];
+                        }
+
+                        for ( int x = 0; x < width; x++ )
+                        {
+                            // number of window's columns inside image
+                            int count = ( Math.Min( width, x + radius + 1 ) - Math.Max( 0, x - radius ) ) * rows;
+
+                            dst[x * pixelSize + c] = ( count == fullCount ) ?
+                                (byte) ( ( (ulong) sum * reciprocal ) >> 48 ) :
+                                (byte) ( sum / count );
+
+                            // move the window to the next pixel
+                            if ( x + radius + 1 < width )
+                                sum += column[( x + radius + 1 ) * pixelSize];
+                            if ( x - radius >= 0 )
+                                sum -= column[( x - radius ) * pixelSize];
+                        }
+                    }
+
+                    // take care of alpha channel
+                    if ( pixelSize == 4 )
+                    {
+                        for ( int x = 0; x < width; x++ )
+                        {
+                            dst[x * pixelSize + RGB.A] = srcRow[x * pixelSize + RGB.A];
+                        }
+                    }
+
+                    // move the window to the next row
+                    if ( y + radius + 1 < bottom )
+                    {
+                        byte* src = baseSrc + (long) ( y + radius + 1 ) * srcStride;
+
+                        for ( int i = 0; i < lineSize; i++ )
+                        {
+                            sums[i] += src[i];
+                        }
+                    }
+                    if ( y - radius >= top )
+                    {
+                        byte* src = baseSrc + (long) ( y - radius ) * srcStride;
+
+                        for ( int i = 0; i < lineSize; i++ )
+                        {
+                            sums[i] -= src[i];
+                        }
+                    }
+                }
+            }
+
+            sumsArrays.Return( columnSums );
+        }
+    }
+}
@@ -63,6 +63,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>
         /// Kernel size, [3, 25].
         /// </summary>
@@ -112,14 +118,30 @@ namespace AForge.Imaging.Filters
         /// <param name="rect">Image rectangle for processing by the filter.</param>
         /// 
         protected override unsafe void ProcessFilter( UnmanagedImage source, UnmanagedImage destination, Rectangle rect )
+        {
+            ProcessFilter( source, destination, rect, rect.Top, rect.Bottom );
+        }
+
+        /// <summary>
+        /// Process the filter on the specified rows of image's rectangle.
+        /// </summary>
+        /// 
+        /// <param name="source">Source image data.</param>
+        /// <param name="destination">Destination image data.</param>
+        /// <param name="rect">Image rectangle for processing by the filter.</param>
+        /// <param name="startY">First row of the rectangle to process.</param>
+        /// <param name="stopY">Row following the last row of the rectangle to process.</param>
+        /// 
+        protected override unsafe void ProcessFilter( UnmanagedImage source, UnmanagedImage destination, Rectangle rect, int startY, int stopY )
         {
             int pixelSize = Image.GetPixelFormatSize( source.PixelFormat ) / 8;
 
-            // processing start and stop X,Y positions
+            // processing start and stop X positions
             int startX  = rect.Left;
-            int startY  = rect.Top;
             int stopX   = startX + rect.Width;
-            int stopY   = startY + rect.Height;
+            // rows of the rectangle, which can be used as neighbours
+            int top     = rect.Top;
+            int bottom  = rect.Bottom;
 
             int srcStride = source.Stride;
             int dstStride = destination.Stride;
@@ -160,10 +182,10 @@ namespace AForge.Imaging.Filters
                             t = y + i;
 
                             // skip row
-                            if ( t < startY )
+                            if ( t < top )
                                 continue;
                             // break
-                            if ( t >= stopY )
+                            if ( t >= bottom )
                                 break;
 
                             // for each kernel column
@@ -214,10 +236,10 @@ namespace AForge.Imaging.Filters
                             t = y + i;
 
                             // skip row
-                            if ( t < startY )
+                            if ( t < top )
                                 continue;
                             // break
-                            if ( t >= stopY )
+                            if ( t >= bottom )
                                 break;
 
                             // for each kernel column
@@ -26,6 +26,14 @@ namespace AForge.Imaging.Filters
     /// neighborhood into numerical order and then replacing the pixel being considered with the
     /// middle pixel value.</para>
     /// 
+    /// <para>For small processing squares the filter sorts values of neighboring pixels. For bigger squares
+    /// (starting from size 5) it keeps histograms of pixels' values in columns of the processing square,
+    /// which are updated by adding the row entering the square and removing the row leaving it, when the square
+    /// moves to the next row. Histogram of the square is updated the same way from the column histograms,
+    /// when the square moves along the row, and the median is found from the histogram (the algorithm was
+    /// proposed by S. Perreault and P. Hbert). So processing time per pixel does not depend on the size of the
+    /// processing square in this case. Both algorithms give exactly the same result.</para>
+    /// 
     /// <para>The filter accepts 8 bpp grayscale images and 24/32 bpp
     /// color images for processing.</para>
     /// 
@@ -45,8 +53,15 @@ namespace AForge.Imaging.Filters
     /// 
     public class Median : BaseUsingCopyPartialFilter
     {
+        // minimum processing square size, starting from which histograms are used
+        private const int MinHistogramSize = 5;
+
         private int size = 3;
 
+        // working memory kept between calls - pixels' values of processing square and histograms
+        private readonly ScratchArrays<byte> valuesArrays = new ScratchArrays<byte>( );
+        private readonly ScratchArrays<ushort> histogramsArrays = new ScratchArrays<ushort>( );
+
         // private format translation dictionary
         private Dictionary<PixelFormat, PixelFormat> formatTranslations = new Dictionary<PixelFormat, PixelFormat>( );
 
@@ -58,6 +73,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
         /// <summary>
         /// Processing square size for the median filter, [3, 25].
         /// </summary>
@@ -105,13 +126,35 @@ namespace AForge.Imaging.Filters
         /// 
         protected override unsafe void ProcessFilter( UnmanagedImage source, UnmanagedImage destination, Rectangle rect )
         {
+            ProcessFilter( source, destination, rect, rect.Top, rect.Bottom );
+        }
+
+        /// <summary>
+        /// Process the filter on the specified rows of image's rectangle.
+        /// </summary>
+        /// 
+        /// <param name="source">Source image data.</param>
+        /// <param name="destination">Destination image data.</param>
+        /// <param name="rect">Image rectangle for processing by the filter.</param>
+        /// <param name="startY">First row of the rectangle to process.</param>
+        /// <param name="stopY">Row following the last row of the rectangle to process.</param>
+        /// 
+        protected override unsafe void ProcessFilter( UnmanagedImage source, UnmanagedImage destination, Rectangle rect, int startY, int stopY )
+        {
+            if ( size >= MinHistogramSize )
+            {
+                ProcessFilterUsingHistograms( source, destination, rect, startY, stopY );
+                return;
+            }
+
             int pixelSize = Image.GetPixelFormatSize( source.PixelFormat ) / 8;
 
-            // processing start and stop X,Y positions
+            // processing start and stop X positions
             int startX  = rect.Left;
-            int startY  = rect.Top;
             int stopX   = startX + rect.Width;
-            int stopY   = startY + rect.Height;
+            // rows of the rectangle, which can be used as neighbours
+            int top     = rect.Top;
+            int bottom  = rect.Bottom;
 
             int srcStride = source.Stride;
             int dstStride = destination.Stride;
@@ -125,10 +168,10 @@ namespace AForge.Imaging.Filters
             // number of elements
             int c;
 
-            // array to hold pixel values (R, G, B)
-            byte[] r = new byte[size * size];
-            byte[] g = new byte[size * size];
-            byte[] b = new byte[size * size];
+            // array to hold pixel values (R, G, B parts of it start from the rOffset, gOffset and bOffset)
+            int n = size * size;
+            int rOffset = 0, gOffset = n, bOffset = 2 * n;
+            byte[] values = valuesArrays.Take( 3 * n );
 
             byte* src = (byte*) source.ImageData.ToPointer( );
             byte* dst = (byte*) destination.ImageData.ToPointer( );
@@ -157,10 +200,10 @@ namespace AForge.Imaging.Filters
                             t = y + i;
 
                             // skip row
-                            if ( t < startY )
+                            if ( t < top )
                                 continue;
                             // break
-                            if ( t >= stopY )
+                            if ( t >= bottom )
                                 break;
 
                             // for each kernel column
@@ -174,14 +217,14 @@ namespace AForge.Imaging.Filters
 
                                 if ( t < stopX )
                                 {
-                                    g[c++] = src[i * srcStride + j];
+                                    values[gOffset + c++] = src[i * srcStride + j];
                                 }
                             }
                         }
                         // sort elements
-                        Array.Sort( g, 0, c );
+                        Array.Sort( values, gOffset, c );
                         // get the median
-                        *dst = g[c >> 1];
+                        *dst = values[gOffset + ( c >> 1 )];
                     }
                     src += srcOffset;
                     dst += dstOffset;
@@ -205,10 +248,10 @@ namespace AForge.Imaging.Filters
                             t = y + i;
 
                             // skip row
-                            if ( t < startY )
+                            if ( t < top )
                                 continue;
                             // break
-                            if ( t >= stopY )
+                            if ( t >= bottom )
                                 break;
 
                             // for each kernel column
@@ -224,28 +267,193 @@ namespace AForge.Imaging.Filters
                                 {
                                     p = &src[i * srcStride + j * pixelSize];
 
-                                    r[c] = p[RGB.R];
-                                    g[c] = p[RGB.G];
-                                    b[c] = p[RGB.B];
+                                    values[rOffset + c] = p[RGB.R];
+                                    values[gOffset + c] = p[RGB.G];
+                                    values[bOffset + c] = p[RGB.B];
                                     c++;
                                 }
                             }
                         }
 
                         // sort elements
-                        Array.Sort( r, 0, c );
-                        Array.Sort( g, 0, c );
-                        Array.Sort( b, 0, c );
+                        Array.Sort( values, rOffset, c );
+                        Array.Sort( values, gOffset, c );
+                        Array.Sort( values, bOffset, c );
                         // get the median
                         t = c >> 1;
-                        dst[RGB.R] = r[t];
-                        dst[RGB.G] = g[t];
-                        dst[RGB.B] = b[t];
+                        dst[RGB.R] = values[rOffset + t];
+                        dst[RGB.G] = values[gOffset + t];
+                        dst[RGB.B] = values[bOffset + t];
                     }
                     src += srcOffset;
                     dst += dstOffset;
                 }
             }
+
+            valuesArrays.Return( values );
+        }
+
+        // Process the filter using histograms of processing square's columns, which takes constant time per pixel
+        private unsafe void ProcessFilterUsingHistograms( UnmanagedImage source, UnmanagedImage destination, Rectangle rect, int startY, int stopY )
+        {
+            int pixelSize = Image.GetPixelFormatSize( source.PixelFormat ) / 8;
+            // number of processed channels
+            int channels  = ( pixelSize == 1 ) ? 1 : 3;
+
+            // rows of the rectangle, which can be used as neighbours
+            int top    = rect.Top;
+            int bottom = rect.Bottom;
+            int width  = rect.Width;
+            int radius = size >> 1;
+
+            int srcStride = source.Stride;
+            int dstStride = destination.Stride;
+
+            // allign pointers to the first pixel to process
+            byte* baseSrc = (byte*) source.ImageData.ToPointer( ) + rect.Left * pixelSize;
+            byte* baseDst = (byte*) destination.ImageData.ToPointer( ) + rect.Left * pixelSize;
+
+            // fine (256 bins) and coarse (16 bins) histograms of the processing square followed by
+            // such histograms of each column for each channel (counts never exceed 25 * 25)
+            int length = ( width * channels + 1 ) * ( 256 + 16 );
+            ushort[] histograms = histogramsArrays.Take( length );
+
+            Array.Clear( histograms, 0, length );
+
+            fixed ( ushort* sqFine = histograms )
+            {
+                ushort* sqCoarse  = sqFine + 256;
+                ushort* colFine   = sqCoarse + 16;
+                ushort* colCoarse = colFine + width * channels * 256;
+
+                // add rows of the processing square for the first row
+                for ( int y = Math.Max( top, startY - radius ), stop = Math.Min( bottom, startY + radius + 1 ); y < stop; y++ )
+                {
+                    UpdateColumnHistograms( baseSrc + (long) y * srcStride, width, pixelSize, channels, colFine, colCoarse, 1 );
+                }
+
+                for ( int y = startY; y < stopY; y++ )
+                {
+                    // number of processing square's rows inside image
+                    int rows = Math.Min( bottom, y + radius + 1 ) - Math.Max( top, y - radius );
+
+                    byte* dst = baseDst + (long) y * dstStride;
+
+                    for ( int c = 0; c < channels; c++ )
+                    {
+                        // histogram of the processing square for the first pixel
+                        for ( int i = 0; i < 256; i++ )
+                            sqFine[i] = 0;
+                        for ( int i = 0; i < 16; i++ )
+                            sqCoarse[i] = 0;
+
+                        for ( int x = 0, stop = Math.Min( width, radius + 1 ); x < stop; x++ )
+                        {
+                            AddHistogram( sqFine, sqCoarse, colFine, colCoarse, x * channels + c );
+                        }
+
+                        for ( int x = 0; x < width; x++ )
+                        {
+                            // number of values in the processing square
+                            int count = ( Math.Min( width, x + radius + 1 ) - Math.Max( 0, x - radius ) ) * rows;
+
+                            dst[x * pixelSize + c] = FindMedian( sqFine, sqCoarse, count >> 1 );
+
+                            // move the processing square to the next pixel
+                            if ( x + radius + 1 < width )
+                                AddHistogram( sqFine, sqCoarse, colFine, colCoarse, ( x + radius + 1 ) * channels + c );
+                            if ( x - radius >= 0 )
+                                SubtractHistogram( sqFine, sqCoarse, colFine, colCoarse, ( x - radius ) * channels + c );
+                        }
+                    }
+
+                    // move the processing square to the next row
+                    if ( y + radius + 1 < bottom )
+                        UpdateColumnHistograms( baseSrc + (long) ( y + radius + 1 ) * srcStride, width, pixelSize, channels, colFine, colCoarse, 1 );
+                    if ( y - radius >= top )
+                        UpdateColumnHistograms( baseSrc + (long) ( y - radius ) * srcStride, width, pixelSize, channels, colFine, colCoarse, -1 );
+                }
+            }
+
+            histogramsArrays.Return( histograms );
+        }
+
+        // Add/remove pixels of the row to/from histograms of columns
+        private static unsafe void UpdateColumnHistograms( byte* src, int width, int pixelSize, int channels,
+                                                           ushort* colFine, ushort* colCoarse, int delta )
+        {
+            for ( int x = 0, h = 0; x < width; x++, src += pixelSize )
+            {
+                for ( int c = 0; c < channels; c++, h++ )
+                {
+                    int v = src[c];
+
+                    colFine[( h << 8 ) + v]          = (ushort) ( colFine[( h << 8 ) + v] + delta );
+                    colCoarse[( h << 4 ) + ( v >> 4 )] = (ushort) ( colCoarse[( h << 4 ) + ( v >> 4 )] + delta );
+                }
+            }
+        }
+
+        // Add histogram of the column to histogram of the processing square. Four 16 bit counters are added
+        // at once as 64 bit integer, since none of them overflows.
+        private static unsafe void AddHistogram( ushort* sqFine, ushort* sqCoarse, ushort* colFine, ushort* colCoarse, int column )
+        {
+            ulong* dst = (ulong*) sqFine;
+            ulong* src = (ulong*) ( colFine + ( column << 8 ) );
+
+            for ( int i = 0; i < 64; i++ )
+                dst[i] += src[i];
+
+            dst = (ulong*) sqCoarse;
+            src = (ulong*) ( colCoarse + ( column << 4 ) );
+
+            dst[0] += src[0];
+            dst[1] += src[1];
+            dst[2] += src[2];
+            dst[3] += src[3];
+        }
+
+        // Subtract histogram of the column from histogram of the processing square. Four 16 bit counters are
+        // subtracted at once as 64 bit integer, since none of them becomes negative.
+        private static unsafe void SubtractHistogram( ushort* sqFine, ushort* sqCoarse, ushort* colFine, ushort* colCoarse, int column )
+        {
+            ulong* dst = (ulong*) sqFine;
+            ulong* src = (ulong*) ( colFine + ( column << 8 ) );
+
+            for ( int i = 0; i < 64; i++ )
+                dst[i] -= src[i];
+
+            dst = (ulong*) sqCoarse;
+            src = (ulong*) ( colCoarse + ( column << 4 ) );
+
+            dst[0] -= src[0];
+            dst[1] -= src[1];
+            dst[2] -= src[2];
+            dst[3] -= src[3];
+        }
+
+        // Find value, which has the specified index in sorted array of histogram's values
+        private static unsafe byte FindMedian( ushort* fine, ushort* coarse, int index )
+        {
+            int sum = 0;
+            int i = 0;
+
+            // find coarse bin first and then the value in it
+            while ( sum + coarse[i] <= index )
+            {
+                sum += coarse[i];
+                i++;
+            }
+
+            i <<= 4;
+
+            while ( sum + fine[i] <= index )
+            {
+                sum += fine[i];
+                i++;
+            }
+
+            return (byte) i;
         }
     }
 }
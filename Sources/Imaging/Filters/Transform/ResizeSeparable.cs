@@ -0,0 +1,487 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging.Filters
+{
+    using System;
+    using System.Collections.Generic;
+    using System.Drawing;
+    using System.Drawing.Imaging;
+
+    /// <summary>
+    /// Resize image using separable interpolation with precalculated coefficients.
+    /// </summary>
+    ///
+    /// <remarks><para>The class implements image resizing filter, which does interpolation in two passes -
+    /// horizontal pass resizes each required row of source image and vertical pass combines resized rows
+    /// to get rows of the destination image. Interpolation coefficients for each column and row of
+    /// the destination image are calculated only once for each pair of source/destination sizes and
+    /// are reused while the filter is applied to images of the same size (video frames, for example).
+    /// Both passes use integer arithmetic with 14 bits coefficients, and horizontal stripes of the destination
+    /// image are processed in parallel (see <see cref="FilterParallelism"/>).</para>
+    ///
+    /// <para>The filter supports three interpolation methods (see <see cref="Method"/>):
+    /// <list type="bullet">
+    /// <item><see cref="InterpolationMethod.Bilinear"/> - linear interpolation of 2x2 pixels neighbourhood;</item>
+    /// <item><see cref="InterpolationMethod.Bicubic"/> - bicubic interpolation of 4x4 pixels neighbourhood using the
+    /// same kernel as <see cref="ResizeBicubic"/> filter (see <see cref="Interpolation.BiCubicKernel"/>);</item>
+    /// <item><see cref="InterpolationMethod.Area"/> - each destination pixel is set to average value of source
+    /// pixels covered by it (weighted by covered area). The method should be used for big downscales, since
+    /// interpolation methods take into account only few source pixels around each destination pixel and
+    /// so produce aliasing artifacts.</item>
+    /// </list></para>
+    ///
+    /// <para><note>Unlike <see cref="ResizeBilinear"/> and <see cref="ResizeBicubic"/> filters, the filter
+    /// aligns centers of source and destination images' pixels, so the result image is not shifted
+    /// relatively to the source image.</note></para>
+    ///
+    /// <para>The filter accepts 8 bpp grayscale images and 24/32 bpp
+    /// color images for processing.</para>
+    ///
+    /// <para>Sample usage:</para>
+    /// <code>
+    /// // create filter
+    /// ResizeSeparable filter = new ResizeSeparable( 160, 120, ResizeSeparable.InterpolationMethod.Area );
+    /// // apply the filter to each video frame - coefficients are calculated only once
+    /// Bitmap newImage = filter.Apply( frame );
+    /// </code>
+    /// </remarks>
+    ///
+    /// <seealso cref="ResizeBilinear"/>
+    /// <seealso cref="ResizeBicubic"/>
+    ///
+    public class ResizeSeparable : BaseResizeFilter
+    {
+        /// <summary>
+        /// Enumeration of interpolation methods supported by the filter.
+        /// </summary>
+        public enum InterpolationMethod
+        {
+            /// <summary>
+            /// Bilinear interpolation.
+            /// </summary>
+            Bilinear,
+            /// <summary>
+            /// Bicubic interpolation.
+            /// </summary>
+            Bicubic,
+            /// <summary>
+            /// Averaging of source pixels covered by destination pixel.
+            /// </summary>
+            Area
+        }
+
+        // number of fractional bits of interpolation coefficients
+        private const int CoefficientBits = 14;
+        // number of fractional bits kept in result of horizontal pass
+        private const int IntermediateBits = 7;
+
+        private InterpolationMethod method = InterpolationMethod.Bilinear;
+
+        // cached coefficients of horizontal and vertical passes
+        private Coefficients horizontalCoefficients = null;
+        private Coefficients verticalCoefficients = null;
+
+        // format translation dictionary
+        private Dictionary<PixelFormat, PixelFormat> formatTranslations = new Dictionary<PixelFormat, PixelFormat>( );
+
+        /// <summary>
+        /// Format translations dictionary.
+        /// </summary>
+        public override Dictionary<PixelFormat, PixelFormat> FormatTranslations
+        {
+            get { return formatTranslations; }
+        }
+
+        /// <summary>
+        /// Interpolation method used to resize images.
+        /// </summary>
+        ///
+        /// <remarks><para>Default value is set to <see cref="InterpolationMethod.Bilinear"/>.</para></remarks>
+        ///
+        public InterpolationMethod Method
+        {
+            get { return method; }
+            set { method = value; }
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="ResizeSeparable"/> class.
+        /// </summary>
+        ///
+        /// <param name="newWidth">Width of the new image.</param>
+        /// <param name="newHeight">Height of the new image.</param>
+        ///
+        public ResizeSeparable( int newWidth, int newHeight ) :
+            this( newWidth, newHeight, InterpolationMethod.Bilinear )
+        {
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="ResizeSeparable"/> class.
+        /// </summary>
+        ///
+        /// <param name="newWidth">Width of the new image.</param>
+        /// <param name="newHeight">Height of the new image.</param>
+        /// <param name="method">Interpolation method used to resize images.</param>
+        ///
+        public ResizeSeparable( int newWidth, int newHeight, InterpolationMethod method ) :
+            base( newWidth, newHeight )
+        {
+            this.method = method;
+
+            formatTranslations[PixelFormat.Format8bppIndexed] = PixelFormat.Format8bppIndexed;
+            formatTranslations[PixelFormat.Format24bppRgb]    = PixelFormat.Format24bppRgb;
+            formatTranslations[PixelFormat.Format32bppRgb]    = PixelFormat.Format32bppRgb;
+            formatTranslations[PixelFormat.Format32bppArgb]   = PixelFormat.Format32bppArgb;
+        }
+
+        /// <summary>
+        /// Process the filter on the specified image.
+        /// </summary>
+        ///
+        /// <param name="sourceData">Source image data.</param>
+        /// <param name="destinationData">Destination image data.</param>
+        ///
+        protected override unsafe void ProcessFilter( UnmanagedImage sourceData, UnmanagedImage destinationData )
+        {
+            int width     = sourceData.Width;
+            int height    = sourceData.Height;
+            int dstWidth  = destinationData.Width;
+            int dstHeight = destinationData.Height;
+
+            // get coefficients calculating them only if geometry or method was changed
+            Coefficients hc = horizontalCoefficients;
+            Coefficients vc = verticalCoefficients;
+
+            if ( ( hc == null ) || ( !hc.IsSuitable( width, dstWidth, method ) ) )
+            {
+                hc = new Coefficients( width, dstWidth, method );
+                horizontalCoefficients = hc;
+            }
+            if ( ( vc == null ) || ( !vc.IsSuitable( height, dstHeight, method ) ) )
+            {
+                vc = new Coefficients( height, dstHeight, method );
+                verticalCoefficients = vc;
+            }
+
+            // split destination image into stripes taking into account amount of processed source pixels
+            Rectangle rect = new Rectangle( 0, 0, dstWidth, dstHeight );
+            Rectangle workRect = new Rectangle( 0, 0, Math.Max( width, dstWidth ), Math.Max( height, dstHeight ) );
+            int stripesCount = Math.Min( FilterParallelism.GetStripesCount( workRect, 0 ), dstHeight );
+
+            FilterParallelism.ProcessStripes( sourceData, destinationData, rect, stripesCount,
+                delegate( UnmanagedImage source, UnmanagedImage destination, Rectangle stripesRect, int startY, int stopY )
+                {
+                    ProcessStripe( source, destination, startY, stopY, hc, vc );
+                } );
+        }
+
+        // Resize rows of destination image in the [startY, stopY) range
+        private static unsafe void ProcessStripe( UnmanagedImage source, UnmanagedImage destination,
+            int startY, int stopY, Coefficients hc, Coefficients vc )
+        {
+            int pixelSize = Bitmap.GetPixelFormatSize( source.PixelFormat ) / 8;
+            int srcStride = source.Stride;
+            int dstStride = destination.Stride;
+            int lineSize  = destination.Width * pixelSize;
+            int taps      = vc.TapsCount;
+
+            // rows of horizontal pass are kept in ring buffer - source row r is kept in ( r % taps ) slot
+            int[] rows = new int[taps * lineSize];
+            int[] rowsIndexes = new int[taps];
+            int[] line = new int[lineSize];
+
+            for ( int i = 0; i < taps; i++ )
+            {
+                rowsIndexes[i] = -1;
+            }
+
+            byte* src = (byte*) source.ImageData.ToPointer( );
+            byte* dst = (byte*) destination.ImageData.ToPointer( ) + (long) startY * dstStride;
+
+            int round = 1 << ( 2 * CoefficientBits - IntermediateBits - 1 );
+            int shift = 2 * CoefficientBits - IntermediateBits;
+
+            fixed ( int* rowsPtr = rows, linePtr = line, vWeights = vc.Weights )
+            {
+                for ( int y = startY; y < stopY; y++, dst += dstStride )
+                {
+                    int firstRow = vc.Start[y];
+
+                    // do horizontal pass for source rows, which are not available yet
+                    for ( int k = 0; k < taps; k++ )
+                    {
+                        int r = firstRow + k;
+                        int slot = r % taps;
+
+                        if ( rowsIndexes[slot] != r )
+                        {
+                            ResizeRow( src + (long) r * srcStride, rowsPtr + slot * lineSize, pixelSize, hc );
+                            rowsIndexes[slot] = r;
+                        }
+                    }
+
+                    // vertical pass
+                    int* w = vWeights + y * taps;
+
+                    if ( taps == 2 )
+                    {
+                        int  w0 = w[0], w1 = w[1];
+                        int* p0 = rowsPtr + ( firstRow % 2 ) * lineSize;
+                        int* p1 = rowsPtr + ( ( firstRow + 1 ) % 2 ) * lineSize;
+
+                        for ( int i = 0; i < lineSize; i++ )
+                        {
+                            int v = ( w0 * p0[i] + w1 * p1[i] + round ) >> shift;
+                            dst[i] = (byte) ( ( v < 0 ) ? 0 : ( ( v > 255 ) ? 255 : v ) );
+                        }
+                    }
+                    else if ( taps == 4 )
+                    {
+                        int  w0 = w[0], w1 = w[1], w2 = w[2], w3 = w[3];
+                        int* p0 = rowsPtr + ( firstRow % 4 ) * lineSize;
+                        int* p1 = rowsPtr + ( ( firstRow + 1 ) % 4 ) * lineSize;
+                        int* p2 = rowsPtr + ( ( firstRow + 2 ) % 4 ) * lineSize;
+                        int* p3 = rowsPtr + ( ( firstRow + 3 ) % 4 ) * lineSize;
+
+                        for ( int i = 0; i < lineSize; i++ )
+                        {
+                            int v = ( w0 * p0[i] + w1 * p1[i] + w2 * p2[i] + w3 * p3[i] + round ) >> shift;
+                            dst[i] = (byte) ( ( v < 0 ) ? 0 : ( ( v > 255 ) ? 255 : v ) );
+                        }
+                    }
+                    else
+                    {
+                        // accumulate weighted rows in temporary line
+                        int w0 = w[0];
+                        int* p = rowsPtr + ( firstRow % taps ) * lineSize;
+
+                        for ( int i = 0; i < lineSize; i++ )
+                        {
+                            linePtr[i] = w0 * p[i];
+                        }
+
+                        for ( int k = 1; k < taps; k++ )
+                        {
+                            int wk = w[k];
+
+                            if ( wk == 0 )
+                                continue;
+
+                            p = rowsPtr + ( ( firstRow + k ) % taps ) * lineSize;
+
+                            for ( int i = 0; i < lineSize; i++ )
+                            {
+                                linePtr[i] += wk * p[i];
+                            }
+                        }
+
+                        for ( int i = 0; i < lineSize; i++ )
+                        {
+                            int v = ( linePtr[i] + round ) >> shift;
+                            dst[i] = (byte) ( ( v < 0 ) ? 0 : ( ( v > 255 ) ? 255 : v ) );
+                        }
+                    }
+                }
+            }
+        }
+
+        // Resize single row of source image (horizontal pass)
+        private static unsafe void ResizeRow( byte* src, int* dst, int pixelSize, Coefficients hc )
+        {
+            int dstWidth = hc.DestinationSize;
+            int taps     = hc.TapsCount;
+            int round    = 1 << ( CoefficientBits - IntermediateBits - 1 );
+            int shift    = CoefficientBits - IntermediateBits;
+
+            fixed ( int* start = hc.Start, weights = hc.Weights )
+            {
+                int* w = weights;
+
+                if ( taps == 2 )
+                {
+                    for ( int x = 0; x < dstWidth; x++, w += 2 )
+                    {
+                        byte* p  = src + start[x] * pixelSize;
+                        int   w0 = w[0], w1 = w[1];
+
+                        for ( int c = 0; c < pixelSize; c++, p++ )
+                        {
+                            *dst++ = ( w0 * p[0] + w1 * p[pixelSize] + round ) >> shift;
+                        }
+                    }
+                }
+                else if ( taps == 4 )
+                {
+                    int ps2 = pixelSize * 2;
+                    int ps3 = pixelSize * 3;
+
+                    for ( int x = 0; x < dstWidth; x++, w += 4 )
+                    {
+                        byte* p  = src + start[x] * pixelSize;
+                        int   w0 = w[0], w1 = w[1], w2 = w[2], w3 = w[3];
+
+                        for ( int c = 0; c < pixelSize; c++, p++ )
+                        {
+                            *dst++ = ( w0 * p[0] + w1 * p[pixelSize] + w2 * p[ps2] + w3 * p[ps3] + round ) >> shift;
+                        }
+                    }
+                }
+                else
+                {
+                    for ( int x = 0; x < dstWidth; x++, w += taps )
+                    {
+                        byte* p = src + start[x] * pixelSize;
+
+                        for ( int c = 0; c < pixelSize; c++, p++ )
+                        {
+                            int sum = 0;
+
+                            for ( int k = 0, offset = 0; k < taps; k++, offset += pixelSize )
+                            {
+                                sum += w[k] * p[offset];
+                            }
+                            *dst++ = ( sum + round ) >> shift;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Interpolation coefficients of one dimension - for each destination pixel it keeps index of
+        // the first source pixel and weights of TapsCount source pixels starting from it
+        private class Coefficients
+        {
+            public readonly int SourceSize;
+            public readonly int DestinationSize;
+            public readonly InterpolationMethod Method;
+            public readonly int TapsCount;
+            public readonly int[] Start;
+            public readonly int[] Weights;
+
+            public Coefficients( int sourceSize, int destinationSize, InterpolationMethod method )
+            {
+                SourceSize      = sourceSize;
+                DestinationSize = destinationSize;
+                Method          = method;
+
+                double factor = (double) sourceSize / destinationSize;
+                int taps;
+
+                switch ( method )
+                {
+                    case InterpolationMethod.Bicubic:
+                        taps = 4;
+                        break;
+                    case InterpolationMethod.Area:
+                        taps = (int) Math.Ceiling( factor ) + 1;
+                        break;
+                    default:
+                        taps = 2;
+                        break;
+                }
+
+                TapsCount = taps = Math.Min( taps, sourceSize );
+                Start     = new int[destinationSize];
+                Weights   = new int[destinationSize * taps];
+
+                double[] weights = new double[taps];
+
+                for ( int x = 0; x < destinationSize; x++ )
+                {
+                    Array.Clear( weights, 0, taps );
+
+                    int first, count;
+                    double[] values;
+
+                    if ( method == InterpolationMethod.Area )
+                    {
+                        // source interval covered by destination pixel
+                        double x1 = x * factor;
+                        double x2 = Math.Min( ( x + 1 ) * factor, sourceSize );
+
+                        // (small epsilon protects from rounding errors giving pixels with zero coverage)
+                        first = (int) ( x1 + 1e-9 );
+                        count = Math.Max( 1, (int) Math.Ceiling( x2 - 1e-9 ) - first );
+                        values = new double[count];
+
+                        for ( int k = 0; k < count; k++ )
+                        {
+                            values[k] = Math.Min( x2, first + k + 1 ) - Math.Max( x1, first + k );
+                        }
+                    }
+                    else
+                    {
+                        // position of destination pixel's center in source image
+                        double center = ( x + 0.5 ) * factor - 0.5;
+                        int    floor  = (int) Math.Floor( center );
+                        double t      = center - floor;
+
+                        if ( method == InterpolationMethod.Bicubic )
+                        {
+                            first  = floor - 1;
+                            count  = 4;
+                            values = new double[] {
+                                Interpolation.BiCubicKernel( t + 1 ), Interpolation.BiCubicKernel( t ),
+                                Interpolation.BiCubicKernel( 1 - t ), Interpolation.BiCubicKernel( 2 - t ) };
+                        }
+                        else
+                        {
+                            first  = floor;
+                            count  = 2;
+                            values = new double[] { 1 - t, t };
+                        }
+                    }
+
+                    // window of source pixels, which is kept inside of source image
+                    int windowStart = Math.Max( 0, Math.Min( first, sourceSize - taps ) );
+                    double sum = 0;
+
+                    // pixels outside of image are replaced with border pixels
+                    for ( int k = 0; k < count; k++ )
+                    {
+                        int i = Math.Max( 0, Math.Min( first + k, sourceSize - 1 ) );
+
+                        weights[i - windowStart] += values[k];
+                        sum += values[k];
+                    }
+
+                    Start[x] = windowStart;
+                    Quantize( weights, sum, Weights, x * taps );
+                }
+            }
+
+            // Check if the coefficients can be used for the specified geometry
+            public bool IsSuitable( int sourceSize, int destinationSize, InterpolationMethod method )
+            {
+                return ( SourceSize == sourceSize ) && ( DestinationSize == destinationSize ) && ( Method == method );
+            }
+
+            // Convert weights to fixed point numbers making sure their sum is exactly 1
+            private static void Quantize( double[] weights, double sum, int[] dst, int offset )
+            {
+                int one = 1 << CoefficientBits;
+                int total = 0, maxIndex = 0;
+
+                for ( int k = 0; k < weights.Length; k++ )
+                {
+                    int w = (int) Math.Round( weights[k] / sum * one );
+
+                    dst[offset + k] = w;
+                    total += w;
+
+                    if ( w > dst[offset + maxIndex] )
+                        maxIndex = k;
+                }
+
+                dst[offset + maxIndex] += one - total;
+            }
+        }
+    }
+}
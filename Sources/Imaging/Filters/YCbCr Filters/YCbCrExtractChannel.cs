@@ -48,6 +48,12 @@ namespace AForge.Imaging.Filters
             get { return formatTranslations; }
         }
 
+        /// <inheritdoc/>
+        protected override bool IsRowIndependent
+        {
+            get { return true; }
+        }
+
 		/// <summary>
 		/// YCbCr channel to extract.
 		/// </summary>
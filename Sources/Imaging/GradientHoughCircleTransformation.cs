@@ -0,0 +1,630 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging
+{
+    using System;
+    using System.Collections.Generic;
+    using System.Drawing;
+    using System.Drawing.Imaging;
+    using System.Threading.Tasks;
+    using AForge.Imaging.Filters;
+
+    /// <summary>
+    /// Hough circle transformation directed by edges' gradient.
+    /// </summary>
+    ///
+    /// <remarks><para>The class detects circles with radiuses in the specified range doing it in two steps.
+    /// First, gradient of the source image is calculated using Sobel operator and each pixel with gradient's
+    /// magnitude not less than <see cref="GradientThreshold"/> votes for possible circles' centers. Since
+    /// gradient of circle's edge is directed to (or from) circle's center, a pixel votes only for points
+    /// along the gradient line in both directions from the pixel at distances from <see cref="MinRadius"/> to
+    /// <see cref="MaxRadius"/>. Then for each local maximum of the centers' map a histogram of distances to
+    /// edge pixels is built and the most frequent distance is taken as circle's radius. Circles, which edge
+    /// pixels cover less than <see cref="MinCircleCoverage"/> of their circumference, are skipped, and
+    /// so are circles, which are weaker than a found circle differing by not more than
+    /// <see cref="LocalPeakRadius"/> in center's coordinates and radius.</para>
+    ///
+    /// <para>Comparing to <see cref="HoughCircleTransformation"/>, which votes for all points of a circle of
+    /// a single radius, an edge pixel makes only 2 * (<see cref="MaxRadius"/> - <see cref="MinRadius"/> + 1)
+    /// votes here, and all radiuses of the range are searched in one pass. Centers' map is accumulated in
+    /// parallel for large images (each thread accumulates stripes of rows into its own map, which
+    /// are summed at the end).</para>
+    ///
+    /// <para><see cref="HoughCircle.Intensity">Intensity</see> of found circles is the number of edge pixels
+    /// at circle's radius from its center.</para>
+    ///
+    /// <para>The class accepts 8 bpp grayscale images for processing (not edges, but the source image
+    /// itself, since gradient's direction is required). Gradient's direction is not precise on sharp
+    /// pixelated edges, so it is recommended to smooth the image before (with <see cref="Filters.GaussianBlur"/>,
+    /// for example).</para>
+    ///
+    /// <para>Sample usage:</para>
+    /// <code>
+    /// // detect circles with radius from 10 to 50 pixels
+    /// GradientHoughCircleTransformation circleTransform = new GradientHoughCircleTransformation( 10, 50 );
+    /// circleTransform.GradientThreshold = 150;
+    /// // apply Hough circle transform to smoothed image
+    /// circleTransform.ProcessImage( new GaussianBlur( 1.5, 7 ).Apply( grayscaleImage ) );
+    /// // get circles using relative intensity
+    /// HoughCircle[] circles = circleTransform.GetCirclesByRelativeIntensity( 0.5 );
+    ///
+    /// foreach ( HoughCircle circle in circles )
+    /// {
+    ///     // ...
+    /// }
+    /// </code>
+    /// </remarks>
+    ///
+    /// <seealso cref="HoughCircleTransformation"/>
+    ///
+    public class GradientHoughCircleTransformation
+    {
+        // range of radiuses to detect
+        private int minRadius;
+        private int maxRadius;
+
+        private int gradientThreshold = 100;
+
+        // map of circles' centers
+        private short[,] houghMap;
+        private short maxMapIntensity = 0;
+
+        // map of edge pixels
+        private byte[] edges;
+
+        // Hough map's width and height
+        private int width;
+        private int height;
+
+        private int localPeakRadius = 4;
+        private short minCircleIntensity = 10;
+        private double minCircleCoverage = 0.6;
+        private List<HoughCircle> circles = new List<HoughCircle>( );
+
+        /// <summary>
+        /// Minimum radius of circles to detect.
+        /// </summary>
+        ///
+        /// <remarks><para>Minimum value is <b>1</b>.</para></remarks>
+        ///
+        public int MinRadius
+        {
+            get { return minRadius; }
+            set
+            {
+                minRadius = Math.Max( 1, value );
+                maxRadius = Math.Max( minRadius, maxRadius );
+            }
+        }
+
+        /// <summary>
+        /// Maximum radius of circles to detect.
+        /// </summary>
+        ///
+        /// <remarks><para>The value can not be less than <see cref="MinRadius"/>.</para></remarks>
+        ///
+        public int MaxRadius
+        {
+            get { return maxRadius; }
+            set { maxRadius = Math.Max( minRadius, value ); }
+        }
+
+        /// <summary>
+        /// Minimum gradient's magnitude of edge pixels.
+        /// </summary>
+        ///
+        /// <remarks><para>Pixels, which gradient's magnitude calculated with Sobel operator is less than
+        /// the specified value, do not vote for circles' centers. Note that for an edge with a step of <b>N</b>
+        /// intensity levels the magnitude is about <b>4N</b>.</para>
+        ///
+        /// <para>Default value is set to <b>100</b>. Minimum value is <b>1</b>.</para></remarks>
+        ///
+        public int GradientThreshold
+        {
+            get { return gradientThreshold; }
+            set { gradientThreshold = Math.Max( 1, value ); }
+        }
+
+        /// <summary>
+        /// Minimum circle's intensity in Hough map to recognize a circle.
+        /// </summary>
+        ///
+        /// <remarks><para>The value sets minimum number of votes for circle's center and minimum number of
+        /// edge pixels at circle's radius from its center to recognize the circle.</para>
+        ///
+        /// <para>Default value is set to <b>10</b>.</para></remarks>
+        ///
+        public short MinCircleIntensity
+        {
+            get { return minCircleIntensity; }
+            set { minCircleIntensity = value; }
+        }
+
+        /// <summary>
+        /// Minimum part of circle's circumference covered by edge pixels to recognize a circle.
+        /// </summary>
+        ///
+        /// <remarks><para>The value sets minimum ratio of circle's <see cref="HoughCircle.Intensity">intensity</see>
+        /// to its circumference. Edge pixels of other objects may be at the same distance from a local maximum of
+        /// the centers' map, but they cover only small part of the circumference. Note that circles, which are
+        /// partially out of the image, may have lower coverage.</para>
+        ///
+        /// <para>Default value is set to <b>0.6</b>. Minimum value is <b>0</b>. Maximum value is <b>1</b>.</para></remarks>
+        ///
+        public double MinCircleCoverage
+        {
+            get { return minCircleCoverage; }
+            set { minCircleCoverage = Math.Max( 0, Math.Min( 1, value ) ); }
+        }
+
+        /// <summary>
+        /// Radius for searching local peak value.
+        /// </summary>
+        ///
+        /// <remarks><para>The value determines radius around a map's value, which is analyzed to determine
+        /// if the map's value is a local maximum in specified area. Found circles, which differ from a stronger
+        /// circle by not more than the value in center's coordinates and radius, are skipped as well.</para>
+        ///
+        /// <para>Default value is set to <b>4</b>. Minimum value is <b>1</b>. Maximum value is <b>10</b>.</para></remarks>
+        ///
+        public int LocalPeakRadius
+        {
+            get { return localPeakRadius; }
+            set { localPeakRadius = Math.Max( 1, Math.Min( 10, value ) ); }
+        }
+
+        /// <summary>
+        /// Maximum found intensity in Hough map of circles' centers.
+        /// </summary>
+        ///
+        public short MaxIntensity
+        {
+            get { return maxMapIntensity; }
+        }
+
+        /// <summary>
+        /// Found circles count.
+        /// </summary>
+        ///
+        public int CirclesCount
+        {
+            get { return circles.Count; }
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="GradientHoughCircleTransformation"/> class.
+        /// </summary>
+        ///
+        /// <param name="minRadius">Minimum radius of circles to detect.</param>
+        /// <param name="maxRadius">Maximum radius of circles to detect.</param>
+        ///
+        public GradientHoughCircleTransformation( int minRadius, int maxRadius )
+        {
+            MinRadius = minRadius;
+            MaxRadius = maxRadius;
+        }
+
+        /// <summary>
+        /// Process an image building Hough map.
+        /// </summary>
+        ///
+        /// <param name="image">Source image to process.</param>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">Unsupported pixel format of the source image.</exception>
+        ///
+        public void ProcessImage( Bitmap image )
+        {
+            // check image format
+            if ( image.PixelFormat != PixelFormat.Format8bppIndexed )
+            {
+                throw new UnsupportedImageFormatException( "Unsupported pixel format of the source image." );
+            }
+
+            // lock source image
+            BitmapData imageData = image.LockBits(
+                new Rectangle( 0, 0, image.Width, image.Height ),
+                ImageLockMode.ReadOnly, PixelFormat.Format8bppIndexed );
+
+            try
+            {
+                // process the image
+                ProcessImage( new UnmanagedImage( imageData ) );
+            }
+            finally
+            {
+                // unlock image
+                image.UnlockBits( imageData );
+            }
+        }
+
+        /// <summary>
+        /// Process an image building Hough map.
+        /// </summary>
+        ///
+        /// <param name="imageData">Source image data to process.</param>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">Unsupported pixel format of the source image.</exception>
+        ///
+        public void ProcessImage( BitmapData imageData )
+        {
+            ProcessImage( new UnmanagedImage( imageData ) );
+        }
+
+        /// <summary>
+        /// Process an image building Hough map.
+        /// </summary>
+        ///
+        /// <param name="image">Source unmanaged image to process.</param>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">Unsupported pixel format of the source image.</exception>
+        ///
+        public void ProcessImage( UnmanagedImage image )
+        {
+            if ( image.PixelFormat != PixelFormat.Format8bppIndexed )
+            {
+                throw new UnsupportedImageFormatException( "Unsupported pixel format of the source image." );
+            }
+
+            // get source image size
+            width  = image.Width;
+            height = image.Height;
+
+            houghMap = new short[height, width];
+            edges    = new byte[width * height];
+
+            // do the job
+            unsafe
+            {
+                byte* src = (byte*) image.ImageData.ToPointer( );
+                int stride = image.Stride;
+
+                // gradient is not calculated for image's edges
+                int stripesCount = FilterParallelism.GetStripesCount( new Rectangle( 0, 1, width, height - 2 ), 0 );
+
+                if ( stripesCount > 1 )
+                {
+                    // each thread accumulates stripes of rows into its own Hough map, which is added
+                    // to the resulting map when the thread completes, so there are not more maps than stripes
+                    Parallel.For<short[,]>( 0, stripesCount,
+                        delegate { return new short[height, width]; },
+                        delegate( int stripe, ParallelLoopState state, short[,] localMap )
+                        {
+                            int stripeStartY = 1 + (int) ( (long) ( height - 2 ) * stripe / stripesCount );
+                            int stripeStopY  = 1 + (int) ( (long) ( height - 2 ) * ( stripe + 1 ) / stripesCount );
+
+                            AccumulateRows( src, stride, stripeStartY, stripeStopY, localMap );
+                            return localMap;
+                        },
+                        delegate( short[,] localMap )
+                        {
+                            lock ( houghMap )
+                            {
+                                AddMap( houghMap, localMap );
+                            }
+                        } );
+                }
+                else
+                {
+                    AccumulateRows( src, stride, 1, height - 1, houghMap );
+                }
+            }
+
+            // find max value in Hough map
+            maxMapIntensity = 0;
+            for ( int i = 0; i < height; i++ )
+            {
+                for ( int j = 0; j < width; j++ )
+                {
+                    if ( houghMap[i, j] > maxMapIntensity )
+                    {
+                        maxMapIntensity = houghMap[i, j];
+                    }
+                }
+            }
+
+            CollectCircles( );
+        }
+
+        /// <summary>
+        /// Convert Hough map of circles' centers to bitmap.
+        /// </summary>
+        ///
+        /// <returns>Returns 8 bppp grayscale bitmap, which shows Hough map.</returns>
+        ///
+        /// <exception cref="ApplicationException">Hough transformation was not yet done by calling
+        /// ProcessImage() method.</exception>
+        ///
+        public Bitmap ToBitmap( )
+        {
+            // check if Hough transformation was made already
+            if ( houghMap == null )
+            {
+                throw new ApplicationException( "Hough transformation was not done yet." );
+            }
+
+            // create new image
+            Bitmap image = AForge.Imaging.Image.CreateGrayscaleImage( width, height );
+
+            // lock destination bitmap data
+            BitmapData imageData = image.LockBits(
+                new Rectangle( 0, 0, width, height ),
+                ImageLockMode.ReadWrite, PixelFormat.Format8bppIndexed );
+
+            int offset = imageData.Stride - width;
+            float scale = 255.0f / maxMapIntensity;
+
+            // do the job
+            unsafe
+            {
+                byte* dst = (byte*) imageData.Scan0.ToPointer( );
+
+                for ( int y = 0; y < height; y++ )
+                {
+                    for ( int x = 0; x < width; x++, dst++ )
+                    {
+                        *dst = (byte) System.Math.Min( 255, (int) ( scale * houghMap[y, x] ) );
+                    }
+                    dst += offset;
+                }
+            }
+
+            // unlock destination images
+            image.UnlockBits( imageData );
+
+            return image;
+        }
+
+        /// <summary>
+        /// Get specified amount of circles with highest <see cref="HoughCircle.Intensity">intensity</see>.
+        /// </summary>
+        ///
+        /// <param name="count">Amount of circles to get.</param>
+        ///
+        /// <returns>Returns array of most intesive circles. If there are no circles detected,
+        /// the returned array has zero length.</returns>
+        ///
+        public HoughCircle[] GetMostIntensiveCircles( int count )
+        {
+            // circles count
+            int n = Math.Min( count, circles.Count );
+
+            // result array
+            HoughCircle[] dst = new HoughCircle[n];
+            circles.CopyTo( 0, dst, 0, n );
+
+            return dst;
+        }
+
+        /// <summary>
+        /// Get circles with <see cref="HoughCircle.RelativeIntensity">relative intensity</see> higher then specified value.
+        /// </summary>
+        ///
+        /// <param name="minRelativeIntensity">Minimum relative intesity of circles.</param>
+        ///
+        /// <returns>Returns array of circles. If there are no circles detected,
+        /// the returned array has zero length.</returns>
+        ///
+        public HoughCircle[] GetCirclesByRelativeIntensity( double minRelativeIntensity )
+        {
+            int count = 0, n = circles.Count;
+
+            while ( ( count < n ) && ( circles[count].RelativeIntensity >= minRelativeIntensity ) )
+                count++;
+
+            return GetMostIntensiveCircles( count );
+        }
+
+        // Find edge pixels in the specified rows of the image and accumulate their votes for circles' centers
+        private unsafe void AccumulateRows( byte* src, int stride, int startY, int stopY, short[,] map )
+        {
+            int threshold = gradientThreshold * gradientThreshold;
+
+            fixed ( short* mapPtr = map )
+            {
+                for ( int y = startY; y < stopY; y++ )
+                {
+                    byte* p = src + y * stride;
+
+                    for ( int x = 1; x < width - 1; x++ )
+                    {
+                        // Sobel gradient
+                        int gx = p[x - stride + 1] + 2 * p[x + 1] + p[x + stride + 1] -
+                                 p[x - stride - 1] - 2 * p[x - 1] - p[x + stride - 1];
+                        int gy = p[x + stride - 1] + 2 * p[x + stride] + p[x + stride + 1] -
+                                 p[x - stride - 1] - 2 * p[x - stride] - p[x - stride + 1];
+                        int magnitude = gx * gx + gy * gy;
+
+                        if ( magnitude < threshold )
+                            continue;
+
+                        edges[y * width + x] = 1;
+
+                        // step along the gradient line in 16.16 fixed point format
+                        double scale = 65536.0 / Math.Sqrt( magnitude );
+                        int dx = (int) ( gx * scale );
+                        int dy = (int) ( gy * scale );
+
+                        // vote in both directions of the gradient, since a circle may be
+                        // brighter or darker than background
+                        for ( int direction = 0; direction < 2; direction++, dx = -dx, dy = -dy )
+                        {
+                            int cx = ( x << 16 ) + dx * minRadius + 0x8000;
+                            int cy = ( y << 16 ) + dy * minRadius + 0x8000;
+
+                            for ( int r = minRadius; r <= maxRadius; r++, cx += dx, cy += dy )
+                            {
+                                int tx = cx >> 16;
+                                int ty = cy >> 16;
+
+                                if ( ( tx < 0 ) || ( ty < 0 ) || ( tx >= width ) || ( ty >= height ) )
+                                    break;
+
+                                mapPtr[ty * width + tx]++;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // Add Hough map accumulated by a thread to the resulting map
+        private static void AddMap( short[,] map, short[,] localMap )
+        {
+            int height = map.GetLength( 0 );
+            int width  = map.GetLength( 1 );
+
+            for ( int i = 0; i < height; i++ )
+            {
+                for ( int j = 0; j < width; j++ )
+                {
+                    map[i, j] += localMap[i, j];
+                }
+            }
+        }
+
+        // Collect circles, which centers are local maximums of Hough map, estimating their radiuses
+        private void CollectCircles( )
+        {
+            short intensity;
+            bool foundGreater;
+
+            // histogram of distances from circle's center to edge pixels
+            int[] histogram = new int[maxRadius + 1];
+            int maxIntensity = 0;
+
+            // clean circles collection
+            circles.Clear( );
+
+            List<HoughCircle> candidates = new List<HoughCircle>( );
+
+            // for each Y coordinate
+            for ( int y = 0; y < height; y++ )
+            {
+                // for each X coordinate
+                for ( int x = 0; x < width; x++ )
+                {
+                    // get current value
+                    intensity = houghMap[y, x];
+
+                    if ( intensity < minCircleIntensity )
+                        continue;
+
+                    foundGreater = false;
+
+                    // check neighboors
+                    for ( int ty = y - localPeakRadius, tyMax = y + localPeakRadius; ty <= tyMax; ty++ )
+                    {
+                        // continue if the coordinate is out of map
+                        if ( ty < 0 )
+                            continue;
+                        // break if it is not local maximum or coordinate is out of map
+                        if ( ( foundGreater == true ) || ( ty >= height ) )
+                            break;
+
+                        for ( int tx = x - localPeakRadius, txMax = x + localPeakRadius; tx <= txMax; tx++ )
+                        {
+                            // continue or break if the coordinate is out of map
+                            if ( tx < 0 )
+                                continue;
+                            if ( tx >= width )
+                                break;
+
+                            // compare the neighboor with current value
+                            if ( houghMap[ty, tx] > intensity )
+                            {
+                                foundGreater = true;
+                                break;
+                            }
+                        }
+                    }
+
+                    if ( foundGreater )
+                        continue;
+
+                    // build histogram of distances to edge pixels around the center
+                    Array.Clear( histogram, 0, histogram.Length );
+
+                    int minRadius2 = minRadius * minRadius;
+                    int maxRadius2 = ( maxRadius + 1 ) * ( maxRadius + 1 );
+
+                    for ( int ty = Math.Max( 0, y - maxRadius ), tyMax = Math.Min( height - 1, y + maxRadius ); ty <= tyMax; ty++ )
+                    {
+                        int dy2 = ( ty - y ) * ( ty - y );
+
+                        for ( int tx = Math.Max( 0, x - maxRadius ), txMax = Math.Min( width - 1, x + maxRadius ); tx <= txMax; tx++ )
+                        {
+                            if ( edges[ty * width + tx] == 0 )
+                                continue;
+
+                            int distance2 = ( tx - x ) * ( tx - x ) + dy2;
+
+                            if ( ( distance2 < minRadius2 ) || ( distance2 >= maxRadius2 ) )
+                                continue;
+
+                            int distance = (int) ( Math.Sqrt( distance2 ) + 0.5 );
+
+                            if ( distance <= maxRadius )
+                                histogram[distance]++;
+                        }
+                    }
+
+                    // the most frequent distance is circle's radius
+                    int radius = minRadius;
+
+                    for ( int r = minRadius + 1; r <= maxRadius; r++ )
+                    {
+                        if ( histogram[r] > histogram[radius] )
+                            radius = r;
+                    }
+
+                    int support = Math.Min( histogram[radius], short.MaxValue );
+
+                    if ( ( support >= minCircleIntensity ) && ( support >= minCircleCoverage * 2 * Math.PI * radius ) )
+                    {
+                        candidates.Add( new HoughCircle( x, y, radius, (short) support, 0 ) );
+                    }
+                }
+            }
+
+            // skip candidates, which are close to stronger ones (equal local maximums of the
+            // centers' map or neighbour maximums, which found the same circle)
+            candidates.Sort( );
+
+            List<HoughCircle> found = new List<HoughCircle>( );
+
+            foreach ( HoughCircle candidate in candidates )
+            {
+                bool isDuplicate = false;
+
+                foreach ( HoughCircle circle in found )
+                {
+                    if ( ( Math.Abs( candidate.X - circle.X ) <= localPeakRadius ) &&
+                         ( Math.Abs( candidate.Y - circle.Y ) <= localPeakRadius ) &&
+                         ( Math.Abs( candidate.Radius - circle.Radius ) <= localPeakRadius ) )
+                    {
+                        isDuplicate = true;
+                        break;
+                    }
+                }
+
+                if ( !isDuplicate )
+                {
+                    found.Add( candidate );
+                    maxIntensity = Math.Max( maxIntensity, candidate.Intensity );
+                }
+            }
+
+            foreach ( HoughCircle circle in found )
+            {
+                circles.Add( new HoughCircle( circle.X, circle.Y, circle.Radius, circle.Intensity,
+                    (double) circle.Intensity / maxIntensity ) );
+            }
+        }
+    }
+}
@@ -12,6 +12,9 @@ namespace AForge.Imaging
     using System.Collections.Generic;
     using System.Drawing;
     using System.Drawing.Imaging;
+    using System.Threading.Tasks;
+    using AForge.Imaging.Filters;
+    using AForge.Math.Geometry;
 
     /// <summary>
     /// Hough line.
@@ -224,6 +227,15 @@ namespace AForge.Imaging
     /// <para>See also documentation to <see cref="HoughLine"/> class for additional information
     /// about Hough Lines.</para>
     /// 
+    /// <para>Radiuses of lines are calculated using fixed point Sine and Cosine tables. Only when the
+    /// fixed point radius is too close to a half to know how it is rounded, it is recalculated
+    /// in floating point, so Hough map is exactly the same as if it would be calculated in floating
+    /// point for each pixel and angle.</para>
+    /// 
+    /// <para>Besides the standard transformation, the class provides probabilistic Hough transformation
+    /// (see <see cref="FindLineSegments(UnmanagedImage, Rectangle)"/>), which finds line segments
+    /// voting with only part of edge pixels.</para>
+    /// 
     /// <para>Sample usage:</para>
     /// <code>
     /// HoughLineTransformation lineTransform = new HoughLineTransformation( );
@@ -257,6 +269,9 @@ namespace AForge.Imaging
         // precalculated Sine and Cosine values
         private double[]	sinMap;
         private double[]	cosMap;
+        // precalculated Sine and Cosine values in fixed point format
+        private long[]      sinMapFixed;
+        private long[]      cosMapFixed;
         // Hough map
         private short[,]	houghMap;
         private short		maxMapIntensity = 0;
@@ -265,6 +280,19 @@ namespace AForge.Imaging
         private short       minLineIntensity = 10;
         private List<HoughLine> lines = new List<HoughLine>();
 
+        // number of fractional bits in fixed point values
+        private const int  FixedShift = 32;
+        private const long FractionMask = ( 1L << FixedShift ) - 1;
+        // fixed point radiuses closer than this to a half are recalculated in floating point
+        // (the margin is much bigger than errors of the fixed point tables for coordinates up to 2^20)
+        private const long RoundingMargin = 1L << 20;
+
+        // probabilistic transformation settings
+        private int     minLineLength = 30;
+        private int     maxLineGap = 5;
+        private int     randomSeed = Environment.TickCount;
+        private Random  random;
+
         /// <summary>
         /// Steps per degree.
         /// </summary>
@@ -286,11 +314,16 @@ namespace AForge.Imaging
                 // precalculate Sine and Cosine values
                 sinMap = new double[houghHeight];
                 cosMap = new double[houghHeight];
+                sinMapFixed = new long[houghHeight];
+                cosMapFixed = new long[houghHeight];
 
                 for ( int i = 0; i < houghHeight; i++ )
                 {
                     sinMap[i] = Math.Sin( i * thetaStep );
                     cosMap[i] = Math.Cos( i * thetaStep );
+
+                    sinMapFixed[i] = (long) Math.Round( sinMap[i] * ( 1L << FixedShift ) );
+                    cosMapFixed[i] = (long) Math.Round( cosMap[i] * ( 1L << FixedShift ) );
                 }
             }
         }
@@ -325,6 +358,58 @@ namespace AForge.Imaging
             set { localPeakRadius = Math.Max( 1, Math.Min( 10, value ) ); }
         }
 
+        /// <summary>
+        /// Minimum length of line segments found by probabilistic transformation.
+        /// </summary>
+        /// 
+        /// <remarks><para>The property is used by <see cref="FindLineSegments(UnmanagedImage, Rectangle)"/>
+        /// method - shorter line segments are skipped.</para>
+        /// 
+        /// <para>Default value is set to <b>30</b>. Minimum value is <b>1</b>.</para></remarks>
+        /// 
+        public int MinLineLength
+        {
+            get { return minLineLength; }
+            set { minLineLength = Math.Max( 1, value ); }
+        }
+
+        /// <summary>
+        /// Maximum gap between pixels of line segments found by probabilistic transformation.
+        /// </summary>
+        /// 
+        /// <remarks><para>The property is used by <see cref="FindLineSegments(UnmanagedImage, Rectangle)"/>
+        /// method - if there are more than the specified number of missing pixels in a row, a line
+        /// segment ends.</para>
+        /// 
+        /// <para>Default value is set to <b>5</b>. Minimum value is <b>0</b>.</para></remarks>
+        /// 
+        public int MaxLineGap
+        {
+            get { return maxLineGap; }
+            set { maxLineGap = Math.Max( 0, value ); }
+        }
+
+        /// <summary>
+        /// Seed of random numbers generator used by probabilistic transformation.
+        /// </summary>
+        /// 
+        /// <remarks><para>The property is used by <see cref="FindLineSegments(UnmanagedImage, Rectangle)"/>
+        /// method to shuffle edge pixels. Setting the property restarts the generator, so the same sequence
+        /// of calls on the same images finds the same line segments.</para>
+        /// 
+        /// <para>Default value is set to <see cref="Environment.TickCount"/> at the moment
+        /// of the object's creation.</para></remarks>
+        /// 
+        public int RandomSeed
+        {
+            get { return randomSeed; }
+            set
+            {
+                randomSeed = value;
+                random = new Random( randomSeed );
+            }
+        }
+
         /// <summary>
         /// Maximum found <see cref="HoughLine.Intensity">intensity</see> in Hough map.
         /// </summary>
@@ -355,6 +440,7 @@ namespace AForge.Imaging
         public HoughLineTransformation( )
         {
             StepsPerDegree = 1;
+            random = new Random( randomSeed );
         }
 
         /// <summary>
@@ -475,8 +561,6 @@ namespace AForge.Imaging
             int stopX  = width  - halfWidth  - ( width  - rect.Right );
             int stopY  = height - halfHeight - ( height - rect.Bottom );
 
-            int offset = image.Stride - rect.Width;
-
             // calculate Hough map's width
             int halfHoughWidth = (int) Math.Sqrt( halfWidth * halfWidth + halfHeight * halfHeight );
             int houghWidth = halfHoughWidth * 2;
@@ -488,28 +572,36 @@ namespace AForge.Imaging
             {
                 byte* src = (byte*) image.ImageData.ToPointer( ) +
                     rect.Top * image.Stride + rect.Left;
+                int stride = image.Stride;
 
-                // for each row
-                for ( int y = startY; y < stopY; y++ )
+                int stripesCount = FilterParallelism.GetStripesCount( rect, 0 );
+
+                if ( stripesCount > 1 )
                 {
-                    // for each pixel
-                    for ( int x = startX; x < stopX; x++, src++ )
-                    {
-                        if ( *src != 0 )
+                    // each thread accumulates stripes of rows into its own Hough map, which is added
+                    // to the resulting map when the thread completes, so there are not more maps than stripes
+                    Parallel.For<short[,]>( 0, stripesCount,
+                        delegate { return new short[houghHeight, houghWidth]; },
+                        delegate( int stripe, ParallelLoopState state, short[,] localMap )
                         {
-                            // for each Theta value
-                            for ( int theta = 0; theta < houghHeight; theta++ )
+                            int stripeStartY = startY + (int) ( (long) rect.Height * stripe / stripesCount );
+                            int stripeStopY  = startY + (int) ( (long) rect.Height * ( stripe + 1 ) / stripesCount );
+
+                            AccumulateRows( src + ( stripeStartY - startY ) * stride, stride, startX, stopX,
+                                stripeStartY, stripeStopY, localMap );
+                            return localMap;
+                        },
+                        delegate( short[,] localMap )
+                        {
+                            lock ( houghMap )
                             {
-                                int radius = (int) Math.Round( cosMap[theta] * x - sinMap[theta] * y ) + halfHoughWidth;
-
-                                if ( ( radius < 0 ) || ( radius >= houghWidth ) )
-                                    continue;
-
-                                houghMap[theta, radius]++;
+                                AddMap( houghMap, localMap );
                             }
-                        }
-                    }
-                    src += offset;
+                        } );
+                }
+                else
+                {
+                    AccumulateRows( src, stride, startX, stopX, startY, stopY, houghMap );
                 }
             }
 
@@ -529,6 +621,264 @@ namespace AForge.Imaging
             CollectLines( );
         }
 
+        /// <summary>
+        /// Find line segments using probabilistic Hough line transformation.
+        /// </summary>
+        /// 
+        /// <param name="image">Source image to process.</param>
+        /// 
+        /// <returns>Returns array of found line segments in image's coordinates.</returns>
+        /// 
+        /// <remarks><para>See <see cref="FindLineSegments(UnmanagedImage, Rectangle)"/> for details.</para></remarks>
+        /// 
+        /// <exception cref="UnsupportedImageFormatException">Unsupported pixel format of the source image.</exception>
+        /// 
+        public LineSegment[] FindLineSegments( Bitmap image )
+        {
+            // check image format
+            if ( image.PixelFormat != PixelFormat.Format8bppIndexed )
+            {
+                throw new UnsupportedImageFormatException( "Unsupported pixel format of the source image." );
+            }
+
+            // lock source image
+            BitmapData imageData = image.LockBits(
+                new Rectangle( 0, 0, image.Width, image.Height ),
+                ImageLockMode.ReadOnly, PixelFormat.Format8bppIndexed );
+
+            try
+            {
+                // process the image
+                return FindLineSegments( new UnmanagedImage( imageData ) );
+            }
+            finally
+            {
+                // unlock image
+                image.UnlockBits( imageData );
+            }
+        }
+
+        /// <summary>
+        /// Find line segments using probabilistic Hough line transformation.
+        /// </summary>
+        /// 
+        /// <param name="image">Source unmanaged image to process.</param>
+        /// 
+        /// <returns>Returns array of found line segments in image's coordinates.</returns>
+        /// 
+        /// <remarks><para>See <see cref="FindLineSegments(UnmanagedImage, Rectangle)"/> for details.</para></remarks>
+        /// 
+        /// <exception cref="UnsupportedImageFormatException">Unsupported pixel format of the source image.</exception>
+        /// 
+        public LineSegment[] FindLineSegments( UnmanagedImage image )
+        {
+            return FindLineSegments( image, new Rectangle( 0, 0, image.Width, image.Height ) );
+        }
+
+        /// <summary>
+        /// Find line segments using probabilistic Hough line transformation.
+        /// </summary>
+        /// 
+        /// <param name="image">Source unmanaged image to process.</param>
+        /// <param name="rect">Image's rectangle to process.</param>
+        /// 
+        /// <returns>Returns array of found line segments in image's coordinates.</returns>
+        /// 
+        /// <remarks><para>The method implements progressive probabilistic Hough transformation. Edge pixels
+        /// vote into Hough map one by one in random order. As soon as a value of Hough map reaches
+        /// <see cref="MinLineIntensity"/>, the image is scanned along the corresponding line starting from the
+        /// last voted pixel to find the line segment (the segment ends, when more than <see cref="MaxLineGap"/>
+        /// pixels in a row are missing). If the segment is not shorter than <see cref="MinLineLength"/>, it is
+        /// added to the result, and its pixels are removed from the image and their votes are removed from the map.
+        /// Since pixels of found lines do not vote, only small part of edge pixels votes on images with long lines,
+        /// which makes the transformation faster than the standard one with the same
+        /// <see cref="StepsPerDegree"/>.</para>
+        /// 
+        /// <para><note>The method does not change Hough map and lines found by <see cref="ProcessImage(UnmanagedImage, Rectangle)"/>.
+        /// Since pixels vote in random order, the result may slightly differ from call to call, unless
+        /// <see cref="RandomSeed"/> is set before the call.</note></para>
+        /// 
+        /// <para>Sample usage:</para>
+        /// <code>
+        /// HoughLineTransformation lineTransform = new HoughLineTransformation( );
+        /// lineTransform.MinLineIntensity = 50;
+        /// lineTransform.MinLineLength = 40;
+        /// // find line segments
+        /// LineSegment[] segments = lineTransform.FindLineSegments( edgesImage );
+        /// 
+        /// foreach ( LineSegment segment in segments )
+        /// {
+        ///     Drawing.Line( sourceImage, segment.Start.Round( ), segment.End.Round( ), Color.Red );
+        /// }
+        /// </code>
+        /// </remarks>
+        /// 
+        /// <exception cref="UnsupportedImageFormatException">Unsupported pixel format of the source image.</exception>
+        /// 
+        public LineSegment[] FindLineSegments( UnmanagedImage image, Rectangle rect )
+        {
+            if ( image.PixelFormat != PixelFormat.Format8bppIndexed )
+            {
+                throw new UnsupportedImageFormatException( "Unsupported pixel format of the source image." );
+            }
+
+            // get source image size
+            int width       = image.Width;
+            int height      = image.Height;
+            int halfWidth   = width / 2;
+            int halfHeight  = height / 2;
+
+            // make sure the specified rectangle recides with the source image
+            rect.Intersect( new Rectangle( 0, 0, width, height ) );
+
+            int rectWidth  = rect.Width;
+            int rectHeight = rect.Height;
+
+            // calculate Hough map's width
+            int halfHoughWidth = (int) Math.Sqrt( halfWidth * halfWidth + halfHeight * halfHeight );
+            int houghWidth = halfHoughWidth * 2;
+
+            // state of the rectangle's pixels: 0 - background or removed pixel, 1 - edge pixel,
+            // 2 - edge pixel, which voted into Hough map
+            byte[] mask = new byte[rectWidth * rectHeight];
+            List<int> points = new List<int>( );
+
+            unsafe
+            {
+                for ( int y = 0; y < rectHeight; y++ )
+                {
+                    byte* src = (byte*) image.ImageData.ToPointer( ) + ( rect.Top + y ) * image.Stride + rect.Left;
+
+                    for ( int x = 0; x < rectWidth; x++ )
+                    {
+                        if ( src[x] != 0 )
+                        {
+                            mask[y * rectWidth + x] = 1;
+                            points.Add( y * rectWidth + x );
+                        }
+                    }
+                }
+            }
+
+            // shuffle points to vote in random order
+            for ( int i = points.Count - 1; i > 0; i-- )
+            {
+                int j = random.Next( i + 1 );
+                int t = points[i];
+                points[i] = points[j];
+                points[j] = t;
+            }
+
+            short[] map = new short[houghHeight * houghWidth];
+            int[] stepsCount = new int[2];
+            List<LineSegment> segments = new List<LineSegment>( );
+
+            // offsets of coordinates in the rectangle from coordinates relative to image's center
+            int offsetX = rect.Left - halfWidth;
+            int offsetY = rect.Top - halfHeight;
+
+            foreach ( int point in points )
+            {
+                // skip pixels removed with found lines
+                if ( mask[point] == 0 )
+                    continue;
+
+                int px = point % rectWidth;
+                int py = point / rectWidth;
+
+                int theta = Vote( map, houghWidth, px + offsetX, py + offsetY, 1 );
+                mask[point] = 2;
+
+                if ( theta == -1 )
+                    continue;
+
+                // direction of the line in image's coordinates
+                double angle = theta * thetaStep;
+                double dx = Math.Sin( angle );
+                double dy = Math.Cos( angle );
+
+                // step along the line by one pixel of its longer projection
+                double scale = 1.0 / Math.Max( Math.Abs( dx ), Math.Abs( dy ) );
+                dx *= scale;
+                dy *= scale;
+
+                // find ends of the segment going from the point in both directions
+                for ( int direction = 0; direction < 2; direction++ )
+                {
+                    double sign = ( direction == 0 ) ? 1 : -1;
+                    int gap = 0;
+
+                    stepsCount[direction] = 0;
+
+                    for ( int step = 1; gap <= maxLineGap; step++ )
+                    {
+                        int x = (int) Math.Round( px + sign * step * dx );
+                        int y = (int) Math.Round( py + sign * step * dy );
+
+                        if ( ( x < 0 ) || ( y < 0 ) || ( x >= rectWidth ) || ( y >= rectHeight ) )
+                            break;
+
+                        if ( mask[y * rectWidth + x] != 0 )
+                        {
+                            stepsCount[direction] = step;
+                            gap = 0;
+                        }
+                        else
+                        {
+                            gap++;
+                        }
+                    }
+                }
+
+                double x1 = Math.Round( px + stepsCount[0] * dx );
+                double y1 = Math.Round( py + stepsCount[0] * dy );
+                double x2 = Math.Round( px - stepsCount[1] * dx );
+                double y2 = Math.Round( py - stepsCount[1] * dy );
+
+                if ( Math.Sqrt( ( x1 - x2 ) * ( x1 - x2 ) + ( y1 - y2 ) * ( y1 - y2 ) ) < minLineLength )
+                    continue;
+
+                // remove pixels of the segment and their votes - pixels next to the scanned ones across
+                // the line are removed as well, since the found line's angle may slightly differ from the actual one
+                int acrossX = ( Math.Abs( dx ) == 1 ) ? 0 : 1;
+                int acrossY = 1 - acrossX;
+
+                for ( int direction = 0; direction < 2; direction++ )
+                {
+                    double sign = ( direction == 0 ) ? 1 : -1;
+
+                    for ( int step = direction; step <= stepsCount[direction]; step++ )
+                    {
+                        int lineX = (int) Math.Round( px + sign * step * dx );
+                        int lineY = (int) Math.Round( py + sign * step * dy );
+
+                        for ( int k = -1; k <= 1; k++ )
+                        {
+                            int x = lineX + k * acrossX;
+                            int y = lineY + k * acrossY;
+
+                            if ( ( x < 0 ) || ( y < 0 ) || ( x >= rectWidth ) || ( y >= rectHeight ) )
+                                continue;
+
+                            int i = y * rectWidth + x;
+
+                            if ( mask[i] == 2 )
+                            {
+                                Vote( map, houghWidth, x + offsetX, y + offsetY, -1 );
+                            }
+                            mask[i] = 0;
+                        }
+                    }
+                }
+
+                segments.Add( new LineSegment(
+                    new AForge.Point( (float) x2 + rect.Left, (float) y2 + rect.Top ),
+                    new AForge.Point( (float) x1 + rect.Left, (float) y1 + rect.Top ) ) );
+            }
+
+            return segments.ToArray( );
+        }
+
         /// <summary>
         /// Convert Hough map to bitmap. 
         /// </summary>
@@ -622,6 +972,113 @@ namespace AForge.Imaging
         }
 
 
+        // Accumulate Hough map for the specified rows of the image, where coordinates are relative to image's center
+        private unsafe void AccumulateRows( byte* src, int stride, int startX, int stopX, int startY, int stopY, short[,] map )
+        {
+            int houghWidth = map.GetLength( 1 );
+            int halfHoughWidth = houghWidth / 2;
+            int offset = stride - ( stopX - startX );
+
+            // parts of radiuses depending on Y coordinate, which include offset to map's center and a half for rounding
+            long center = ( (long) halfHoughWidth << FixedShift ) + ( 1L << ( FixedShift - 1 ) );
+            long[] rowTerms = new long[houghHeight];
+
+            fixed ( short* mapPtr = map )
+            fixed ( long* sinPtr = sinMapFixed, cosPtr = cosMapFixed, rowTermsPtr = rowTerms )
+            {
+                for ( int theta = 0; theta < houghHeight; theta++ )
+                {
+                    rowTermsPtr[theta] = center - sinPtr[theta] * startY;
+                }
+
+                // for each row
+                for ( int y = startY; y < stopY; y++ )
+                {
+                    // for each pixel
+                    for ( int x = startX; x < stopX; x++, src++ )
+                    {
+                        if ( *src != 0 )
+                        {
+                            short* row = mapPtr;
+
+                            // for each Theta value
+                            for ( int theta = 0; theta < houghHeight; theta++, row += houghWidth )
+                            {
+                                long value = cosPtr[theta] * x + rowTermsPtr[theta];
+                                int radius = (int) ( value >> FixedShift );
+
+                                if ( ( ( value + RoundingMargin ) & FractionMask ) < 2 * RoundingMargin )
+                                {
+                                    // the radius is too close to a half, so round it in floating point
+                                    radius = (int) Math.Round( cosMap[theta] * x - sinMap[theta] * y ) + halfHoughWidth;
+                                }
+
+                                if ( ( radius < 0 ) || ( radius >= houghWidth ) )
+                                    continue;
+
+                                row[radius]++;
+                            }
+                        }
+                    }
+                    src += offset;
+
+                    // move to the next row (fixed point values are exact, so it is the same as multiplying)
+                    for ( int theta = 0; theta < houghHeight; theta++ )
+                    {
+                        rowTermsPtr[theta] -= sinPtr[theta];
+                    }
+                }
+            }
+        }
+
+        // Add (or remove) votes of a pixel to Hough map of the probabilistic transformation, where coordinates
+        // are relative to image's center. Returns theta of the most intensive line reaching minimum intensity or -1.
+        private unsafe int Vote( short[] map, int houghWidth, int x, int y, int delta )
+        {
+            int lineTheta = -1;
+            int maxIntensity = minLineIntensity - 1;
+            long center = ( (long) ( houghWidth / 2 ) << FixedShift ) + ( 1L << ( FixedShift - 1 ) );
+
+            fixed ( short* mapPtr = map )
+            fixed ( long* sinPtr = sinMapFixed, cosPtr = cosMapFixed )
+            {
+                short* row = mapPtr;
+
+                for ( int theta = 0; theta < houghHeight; theta++, row += houghWidth )
+                {
+                    int radius = (int) ( ( cosPtr[theta] * x - sinPtr[theta] * y + center ) >> FixedShift );
+
+                    if ( ( radius < 0 ) || ( radius >= houghWidth ) )
+                        continue;
+
+                    int intensity = ( row[radius] += (short) delta );
+
+                    if ( intensity > maxIntensity )
+                    {
+                        maxIntensity = intensity;
+                        lineTheta = theta;
+                    }
+                }
+            }
+
+            return lineTheta;
+        }
+
+        // Add Hough map accumulated by a thread to the resulting map
+        private static void AddMap( short[,] map, short[,] localMap )
+        {
+            int height = map.GetLength( 0 );
+            int width  = map.GetLength( 1 );
+
+            for ( int i = 0; i < height; i++ )
+            {
+                for ( int j = 0; j < width; j++ )
+                {
+                    map[i, j] += localMap[i, j];
+                }
+            }
+        }
+
         // Collect lines with intesities greater or equal then specified
         private void CollectLines( )
         {
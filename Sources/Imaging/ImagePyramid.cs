@@ -0,0 +1,317 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging
+{
+    using System;
+    using System.Drawing;
+    using System.Drawing.Imaging;
+    using System.Threading.Tasks;
+
+    /// <summary>
+    /// Gaussian image pyramid.
+    /// </summary>
+    ///
+    /// <remarks><para>The class keeps a set of images (levels), where the first level is a copy of source image
+    /// and each next level is twice smaller than previous one. To build next level, previous one is smoothed
+    /// by separable 5x5 Gaussian kernel with { 1, 4, 6, 4, 1 } / 16 coefficients and every second pixel of every
+    /// second row is taken. Size of the next level is calculated as ( size + 1 ) / 2, so all pixels
+    /// of previous level contribute to it. Rows of each level are calculated in parallel on multi-core systems.</para>
+    ///
+    /// <para>Memory of levels is allocated on the first <see cref="Build(UnmanagedImage)"/> call and is reused
+    /// by next calls, if source image has the same size and pixel format. So the same pyramid's instance may be
+    /// used to process video frames without memory reallocation. Levels are provided as <see cref="UnmanagedImage"/>
+    /// without copying, so one pyramid built for a frame can be shared by different algorithms, which
+    /// need downscaled versions of the frame.</para>
+    ///
+    /// <para>The class processes grayscale (8 bpp indexed) and color (24 and 32 bpp) images.</para>
+    ///
+    /// <para>Sample usage:</para>
+    /// <code>
+    /// // create pyramid with 4 levels
+    /// ImagePyramid pyramid = new ImagePyramid( 4 );
+    /// // build it for each new video frame
+    /// pyramid.Build( frame );
+    /// // get image, which is 8 times smaller than the frame
+    /// UnmanagedImage smallImage = pyramid.GetLevel( 3 );
+    /// // ...
+    /// // release memory when the pyramid is not required any more
+    /// pyramid.Dispose( );
+    /// </code>
+    /// </remarks>
+    ///
+    public class ImagePyramid : IDisposable
+    {
+        // levels of the pyramid
+        private UnmanagedImage[] levels;
+        // specifies if the pyramid was built
+        private bool isBuilt = false;
+
+        // minimum number of pixels in source image to process it in parallel
+        private const int MinPixelsForParallelProcessing = 256 * 256;
+
+        /// <summary>
+        /// Number of pyramid's levels.
+        /// </summary>
+        ///
+        /// <remarks><para>The value includes the first level, which is a copy of source image.</para></remarks>
+        ///
+        public int LevelsCount
+        {
+            get { return levels.Length; }
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="ImagePyramid"/> class.
+        /// </summary>
+        ///
+        /// <param name="levelsCount">Number of pyramid's levels (including source image), [1, 16].</param>
+        ///
+        /// <exception cref="ArgumentOutOfRangeException">Invalid number of levels was specified.</exception>
+        ///
+        public ImagePyramid( int levelsCount )
+        {
+            if ( ( levelsCount < 1 ) || ( levelsCount > 16 ) )
+                throw new ArgumentOutOfRangeException( "levelsCount", "Number of levels must be in the [1, 16] range." );
+
+            levels = new UnmanagedImage[levelsCount];
+        }
+
+        /// <summary>
+        /// Get pyramid's level.
+        /// </summary>
+        ///
+        /// <param name="level">Level to get, [0, <see cref="LevelsCount"/> - 1]. Level 0 is a copy of source image.</param>
+        ///
+        /// <returns>Returns image of the specified level, which width and height are 2<sup>level</sup> times
+        /// smaller than source image's size (rounded up).</returns>
+        ///
+        /// <remarks><para><note>The returned image is owned by the pyramid and is overwritten by the next
+        /// <see cref="Build(UnmanagedImage)"/> call. It must not be disposed by user.</note></para></remarks>
+        ///
+        /// <exception cref="ArgumentOutOfRangeException">Invalid level was specified.</exception>
+        /// <exception cref="ApplicationException">The pyramid was not built yet.</exception>
+        ///
+        public UnmanagedImage GetLevel( int level )
+        {
+            if ( ( level < 0 ) || ( level >= levels.Length ) )
+                throw new ArgumentOutOfRangeException( "level", "Invalid level was specified." );
+            if ( !isBuilt )
+                throw new ApplicationException( "Image pyramid was not built yet." );
+
+            return levels[level];
+        }
+
+        /// <summary>
+        /// Build pyramid for the specified image.
+        /// </summary>
+        ///
+        /// <param name="image">Source image to build pyramid for.</param>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">Unsupported pixel format of the source image.</exception>
+        ///
+        public void Build( Bitmap image )
+        {
+            // lock source image
+            BitmapData imageData = image.LockBits(
+                new Rectangle( 0, 0, image.Width, image.Height ),
+                ImageLockMode.ReadOnly, image.PixelFormat );
+
+            try
+            {
+                // process the image
+                Build( new UnmanagedImage( imageData ) );
+            }
+            finally
+            {
+                // unlock image
+                image.UnlockBits( imageData );
+            }
+        }
+
+        /// <summary>
+        /// Build pyramid for the specified image.
+        /// </summary>
+        ///
+        /// <param name="imageData">Source image data to build pyramid for.</param>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">Unsupported pixel format of the source image.</exception>
+        ///
+        public void Build( BitmapData imageData )
+        {
+            Build( new UnmanagedImage( imageData ) );
+        }
+
+        /// <summary>
+        /// Build pyramid for the specified image.
+        /// </summary>
+        ///
+        /// <param name="image">Unmanaged source image to build pyramid for.</param>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">Unsupported pixel format of the source image.</exception>
+        ///
+        public void Build( UnmanagedImage image )
+        {
+            if ( ( image.PixelFormat != PixelFormat.Format8bppIndexed ) &&
+                 ( image.PixelFormat != PixelFormat.Format24bppRgb ) &&
+                 ( image.PixelFormat != PixelFormat.Format32bppRgb ) &&
+                 ( image.PixelFormat != PixelFormat.Format32bppArgb ) )
+            {
+                throw new UnsupportedImageFormatException( "Unsupported pixel format of the source image." );
+            }
+
+            // allocate levels if the image differs from the previous one
+            if ( ( levels[0] == null ) || ( levels[0].Width != image.Width ) ||
+                 ( levels[0].Height != image.Height ) || ( levels[0].PixelFormat != image.PixelFormat ) )
+            {
+                FreeLevels( );
+
+                int width  = image.Width;
+                int height = image.Height;
+
+                for ( int i = 0; i < levels.Length; i++ )
+                {
+                    levels[i] = UnmanagedImage.Create( width, height, image.PixelFormat );
+
+                    width  = ( width + 1 ) / 2;
+                    height = ( height + 1 ) / 2;
+                }
+            }
+
+            image.Copy( levels[0] );
+
+            for ( int i = 1; i < levels.Length; i++ )
+            {
+                Reduce( levels[i - 1], levels[i] );
+            }
+
+            isBuilt = true;
+        }
+
+        /// <summary>
+        /// Dispose the object.
+        /// </summary>
+        ///
+        /// <remarks><para>Frees unmanaged memory of pyramid's levels.</para></remarks>
+        ///
+        public void Dispose( )
+        {
+            FreeLevels( );
+        }
+
+        // Free memory of all levels
+        private void FreeLevels( )
+        {
+            for ( int i = 0; i < levels.Length; i++ )
+            {
+                if ( levels[i] != null )
+                {
+                    levels[i].Dispose( );
+                    levels[i] = null;
+                }
+            }
+            isBuilt = false;
+        }
+
+        // Smooth source image with 5x5 Gaussian kernel and take every second pixel of every second row
+        private static unsafe void Reduce( UnmanagedImage source, UnmanagedImage destination )
+        {
+            int pixelSize  = Bitmap.GetPixelFormatSize( source.PixelFormat ) / 8;
+            int width      = source.Width;
+            int height     = source.Height;
+            int srcStride  = source.Stride;
+            int dstStride  = destination.Stride;
+            int dstWidth   = destination.Width;
+            int dstHeight  = destination.Height;
+            int lineSize   = width * pixelSize;
+
+            byte* src = (byte*) source.ImageData.ToPointer( );
+            byte* dst = (byte*) destination.ImageData.ToPointer( );
+
+            if ( ( Environment.ProcessorCount > 1 ) && ( width * height >= MinPixelsForParallelProcessing ) )
+            {
+                // each thread uses its own buffer for vertically smoothed row
+                Parallel.For<int[]>( 0, dstHeight,
+                    delegate { return new int[lineSize]; },
+                    delegate( int y, ParallelLoopState state, int[] buffer )
+                    {
+                        ReduceRow( src, srcStride, width, height, pixelSize, dst + y * dstStride, dstWidth, y, buffer );
+                        return buffer;
+                    },
+                    delegate( int[] buffer ) { } );
+            }
+            else
+            {
+                int[] buffer = new int[lineSize];
+
+                for ( int y = 0; y < dstHeight; y++ )
+                {
+                    ReduceRow( src, srcStride, width, height, pixelSize, dst + y * dstStride, dstWidth, y, buffer );
+                }
+            }
+        }
+
+        // Calculate single row of reduced image
+        private static unsafe void ReduceRow( byte* src, int stride, int width, int height, int pixelSize,
+            byte* dst, int dstWidth, int y, int[] buffer )
+        {
+            int lineSize = width * pixelSize;
+            int sy = y * 2;
+
+            // source rows to smooth (border rows are repeated)
+            byte* row0 = src + Math.Max( sy - 2, 0 ) * stride;
+            byte* row1 = src + Math.Max( sy - 1, 0 ) * stride;
+            byte* row2 = src + sy * stride;
+            byte* row3 = src + Math.Min( sy + 1, height - 1 ) * stride;
+            byte* row4 = src + Math.Min( sy + 2, height - 1 ) * stride;
+
+            fixed ( int* buf = buffer )
+            {
+                // vertical pass
+                for ( int i = 0; i < lineSize; i++ )
+                {
+                    buf[i] = row0[i] + row4[i] + ( ( row1[i] + row3[i] ) << 2 ) + row2[i] * 6;
+                }
+
+                int ps2 = pixelSize * 2;
+                int ps3 = pixelSize * 3;
+                int ps4 = pixelSize * 4;
+
+                // horizontal pass for every second pixel
+                for ( int x = 0; x < dstWidth; x++ )
+                {
+                    int sx = x * 2;
+
+                    if ( ( sx >= 2 ) && ( sx + 2 < width ) )
+                    {
+                        int* p = buf + ( sx - 2 ) * pixelSize;
+
+                        for ( int c = 0; c < pixelSize; c++, p++, dst++ )
+                        {
+                            *dst = (byte) ( ( p[0] + p[ps4] + ( ( p[pixelSize] + p[ps3] ) << 2 ) + p[ps2] * 6 + 128 ) >> 8 );
+                        }
+                    }
+                    else
+                    {
+                        // border pixels are repeated
+                        int* p0 = buf + Math.Max( sx - 2, 0 ) * pixelSize;
+                        int* p1 = buf + Math.Max( sx - 1, 0 ) * pixelSize;
+                        int* p2 = buf + sx * pixelSize;
+                        int* p3 = buf + Math.Min( sx + 1, width - 1 ) * pixelSize;
+                        int* p4 = buf + Math.Min( sx + 2, width - 1 ) * pixelSize;
+
+                        for ( int c = 0; c < pixelSize; c++, dst++ )
+                        {
+                            *dst = (byte) ( ( p0[c] + p4[c] + ( ( p1[c] + p3[c] ) << 2 ) + p2[c] * 6 + 128 ) >> 8 );
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
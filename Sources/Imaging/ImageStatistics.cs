@@ -11,7 +11,9 @@ namespace AForge.Imaging
     using System;
     using System.Drawing;
     using System.Drawing.Imaging;
+    using System.Threading.Tasks;
     using AForge.Math;
+    using AForge.Imaging.Filters;
 
     /// <summary>
     /// Gather statistics about image in RGB color space.
@@ -23,6 +25,10 @@ namespace AForge.Imaging
     /// 
     /// <para>The class accepts 8 bpp grayscale and 24/32 bpp color images for processing.</para>
     /// 
+    /// <para>Statistics of big images are gathered splitting them into horizontal stripes, which are processed
+    /// in parallel. Number of stripes processed simultaneously is limited by
+    /// <see cref="FilterParallelism.MaxDegreeOfParallelism"/>.</para>
+    /// 
     /// <para>Sample usage:</para>
     /// <code>
     /// // gather statistics
@@ -453,30 +459,93 @@ namespace AForge.Imaging
             int width  = image.Width;
             int height = image.Height;
 
-            pixels = pixelsWithoutBlack = 0;
-
             red = green = blue = gray = null;
             redWithoutBlack = greenWithoutBlack = blueWithoutBlack = grayWithoutBlack = null;
 
+            bool isGrayscale = ( image.PixelFormat == PixelFormat.Format8bppIndexed );
+            RowsStatistics statistics = new RowsStatistics( isGrayscale );
+            int stripesCount = FilterParallelism.GetStripesCount( new Rectangle( 0, 0, width, height ), 0 );
+
+            if ( stripesCount > 1 )
+            {
+                // each thread accumulates statistics of its stripes into its own histograms,
+                // which are summed when the thread completes
+                Parallel.For<RowsStatistics>( 0, stripesCount,
+                    delegate { return new RowsStatistics( isGrayscale ); },
+                    delegate( int stripe, ParallelLoopState state, RowsStatistics localStatistics )
+                    {
+                        int startY = (int) ( (long) height * stripe / stripesCount );
+                        int stopY  = (int) ( (long) height * ( stripe + 1 ) / stripesCount );
+
+                        ProcessRows( image, mask, maskLineSize, startY, stopY, localStatistics );
+                        return localStatistics;
+                    },
+                    delegate( RowsStatistics localStatistics )
+                    {
+                        lock ( statistics )
+                        {
+                            statistics.Add( localStatistics );
+                        }
+                    } );
+            }
+            else
+            {
+                ProcessRows( image, mask, maskLineSize, 0, height, statistics );
+            }
+
+            pixels = statistics.Pixels;
+            pixelsWithoutBlack = statistics.PixelsWithoutBlack;
+
+            if ( isGrayscale )
+            {
+                // create historgram for gray level
+                gray = new Histogram( statistics.Gray );
+                grayWithoutBlack = new Histogram( statistics.GrayWithoutBlack );
+            }
+            else
+            {
+                // create histograms
+                red   = new Histogram( statistics.Red );
+                green = new Histogram( statistics.Green );
+                blue  = new Histogram( statistics.Blue );
+
+                redWithoutBlack   = new Histogram( statistics.RedWithoutBlack );
+                greenWithoutBlack = new Histogram( statistics.GreenWithoutBlack );
+                blueWithoutBlack  = new Histogram( statistics.BlueWithoutBlack );
+            }
+        }
+
+        // Gather statistics for the specified range of image's rows
+        private static unsafe void ProcessRows( UnmanagedImage image, byte* mask, int maskLineSize,
+            int startY, int stopY, RowsStatistics statistics )
+        {
+            int width      = image.Width;
             int maskOffset = maskLineSize - width;
 
+            int pixels = 0;
+            int pixelsWithoutBlack = 0;
+
+            // allign pointers to the first row to process
+            byte* p = (byte*) image.ImageData.ToPointer( ) + startY * image.Stride;
+
+            if ( mask != null )
+            {
+                mask += startY * maskLineSize;
+            }
+
             // check pixel format
             if ( image.PixelFormat == PixelFormat.Format8bppIndexed )
             {
-                // alloc arrays
-                int[] g   = new int[256];
-                int[] gwb = new int[256];
+                int[] g   = statistics.Gray;
+                int[] gwb = statistics.GrayWithoutBlack;
 
                 byte value;
                 int  offset = image.Stride - width;
 
-                // do the job
-                byte * p = (byte*) image.ImageData.ToPointer( );
-
                 if ( mask == null )
                 {
                     // for each pixel
-                    for ( int y = 0; y < height; y++ )
+                    for ( int y = startY; y < stopY; y++ )
                     {
                         // for each pixel
                         for ( int x = 0; x < width; x++, p++ )
@@ -499,7 +568,7 @@ namespace AForge.Imaging
                 else
                 {
                     // for each pixel
-                    for ( int y = 0; y < height; y++ )
+                    for ( int y = startY; y < stopY; y++ )
                     {
                         // for each pixel
                         for ( int x = 0; x < width; x++, p++, mask++ )
@@ -523,33 +592,25 @@ namespace AForge.Imaging
                         mask += maskOffset;
                     }
                 }
-
-                // create historgram for gray level
-                gray = new Histogram( g );
-                grayWithoutBlack = new Histogram( gwb );
             }
             else
             {
-                // alloc arrays
-                int[]	r = new int[256];
-                int[]	g = new int[256];
-                int[]	b = new int[256];
+                int[]	r = statistics.Red;
+                int[]	g = statistics.Green;
+                int[]	b = statistics.Blue;
 
-                int[]	rwb = new int[256];
-                int[]	gwb = new int[256];
-                int[]	bwb = new int[256];
+                int[]	rwb = statistics.RedWithoutBlack;
+                int[]	gwb = statistics.GreenWithoutBlack;
+                int[]	bwb = statistics.BlueWithoutBlack;
 
                 byte rValue, gValue, bValue;
                 int  pixelSize = ( image.PixelFormat == PixelFormat.Format24bppRgb ) ? 3 : 4;
                 int  offset = image.Stride - width * pixelSize;
 
-                // do the job
-                byte * p = (byte*) image.ImageData.ToPointer( );
-
                 if ( mask == null )
                 {
                     // for each line
-                    for ( int y = 0; y < height; y++ )
+                    for ( int y = startY; y < stopY; y++ )
                     {
                         // for each pixel
                         for ( int x = 0; x < width; x++, p += pixelSize )
@@ -578,7 +639,7 @@ namespace AForge.Imaging
                 else
                 {
                     // for each line
-                    for ( int y = 0; y < height; y++ )
+                    for ( int y = startY; y < stopY; y++ )
                     {
                         // for each pixel
                         for ( int x = 0; x < width; x++, p += pixelSize, mask++ )
@@ -608,15 +669,70 @@ namespace AForge.Imaging
                         mask += maskOffset;
                     }
                 }
+            }
 
-                // create histograms
-                red   = new Histogram( r );
-                green = new Histogram( g );
-                blue  = new Histogram( b );
+            statistics.Pixels += pixels;
+            statistics.PixelsWithoutBlack += pixelsWithoutBlack;
+        }
+
+        // Histograms and pixels' counters gathered for a range of image's rows
+        private class RowsStatistics
+        {
+            public int[] Gray, GrayWithoutBlack;
+            public int[] Red, Green, Blue;
+            public int[] RedWithoutBlack, GreenWithoutBlack, BlueWithoutBlack;
 
-                redWithoutBlack   = new Histogram( rwb );
-                greenWithoutBlack = new Histogram( gwb );
-                blueWithoutBlack  = new Histogram( bwb );
+            public int Pixels = 0;
+            public int PixelsWithoutBlack = 0;
+
+            public RowsStatistics( bool isGrayscale )
+            {
+                if ( isGrayscale )
+                {
+                    Gray = new int[256];
+                    GrayWithoutBlack = new int[256];
+                }
+                else
+                {
+                    Red   = new int[256];
+                    Green = new int[256];
+                    Blue  = new int[256];
+
+                    RedWithoutBlack   = new int[256];
+                    GreenWithoutBlack = new int[256];
+                    BlueWithoutBlack  = new int[256];
+                }
+            }
+
+            // Add statistics of other rows
+            public void Add( RowsStatistics statistics )
+            {
+                if ( Gray != null )
+                {
+                    AddHistogram( Gray, statistics.Gray );
+                    AddHistogram( GrayWithoutBlack, statistics.GrayWithoutBlack );
+                }
+                else
+                {
+                    AddHistogram( Red, statistics.Red );
+                    AddHistogram( Green, statistics.Green );
+                    AddHistogram( Blue, statistics.Blue );
+
+                    AddHistogram( RedWithoutBlack, statistics.RedWithoutBlack );
+                    AddHistogram( GreenWithoutBlack, statistics.GreenWithoutBlack );
+                    AddHistogram( BlueWithoutBlack, statistics.BlueWithoutBlack );
+                }
+
+                Pixels += statistics.Pixels;
+                PixelsWithoutBlack += statistics.PixelsWithoutBlack;
+            }
+
+            private static void AddHistogram( int[] histogram, int[] other )
+            {
+                for ( int i = 0; i < 256; i++ )
+                {
+                    histogram[i] += other[i];
+                }
             }
         }
 
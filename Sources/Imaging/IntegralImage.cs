@@ -11,6 +11,7 @@ namespace AForge.Imaging
     using System;
     using System.Drawing;
     using System.Drawing.Imaging;
+    using System.Threading.Tasks;
 
     /// <summary>
     /// Integral image.
@@ -31,7 +32,9 @@ namespace AForge.Imaging
     ///          i=0  j=0
     /// </code>
     /// 
-    /// <para><note>The class uses 32-bit integers to represent integral image.</note></para>
+    /// <para><note>The class uses 32-bit integers to represent integral image, so sums may overflow
+    /// for images with more than 16 millions of pixels. <see cref="IntegralImage64"/> should be used
+    /// for such images or when variance of pixels' values is required.</note></para>
     /// 
     /// <para><note>The class processes only grayscale (8 bpp indexed) images.</note></para>
     /// 
@@ -63,6 +66,11 @@ namespace AForge.Imaging
         private int width;
         private int height;
 
+        // minimum number of pixels in image to build integral image in parallel
+        private const int MinPixelsForParallelProcessing = 256 * 256;
+        // number of columns processed by one thread when sums are accumulated along columns
+        private const int ColumnsPerStripe = 256;
+
         /// <summary>
         /// Width of the source image the integral image was constructed for.
         /// </summary>
@@ -192,20 +200,56 @@ namespace AForge.Imaging
             unsafe
             {
                 byte* src = (byte*) image.ImageData.ToPointer( );
+                int stride = image.Stride;
 
-                // for each line
-                for ( int y = 1; y <= height; y++ )
+                if ( ( Environment.ProcessorCount > 1 ) && ( width * height >= MinPixelsForParallelProcessing ) )
                 {
-                    uint rowSum = 0;
+                    // sums of each line are calculated first and then they are accumulated
+                    // along columns, so both passes can be done in parallel
+                    Parallel.For( 1, height + 1, delegate( int y )
+                    {
+                        byte* ptr = src + ( y - 1 ) * stride;
+                        uint rowSum = 0;
+
+                        for ( int x = 1; x <= width; x++, ptr++ )
+                        {
+                            rowSum += *ptr;
+                            integralImage[y, x] = rowSum;
+                        }
+                    } );
+
+                    int stripesCount = ( width + ColumnsPerStripe - 1 ) / ColumnsPerStripe;
 
-                    // for each pixel
-                    for ( int x = 1; x <= width; x++, src++ )
+                    Parallel.For( 0, stripesCount, delegate( int stripe )
                     {
-                        rowSum += *src;
+                        int startX = stripe * ColumnsPerStripe + 1;
+                        int stopX  = Math.Min( width, startX + ColumnsPerStripe - 1 );
+
+                        for ( int y = 2; y <= height; y++ )
+                        {
+                            for ( int x = startX; x <= stopX; x++ )
+                            {
+                                integralImage[y, x] += integralImage[y - 1, x];
+                            }
+                        }
+                    } );
+                }
+                else
+                {
+                    // for each line
+                    for ( int y = 1; y <= height; y++ )
+                    {
+                        uint rowSum = 0;
+
+                        // for each pixel
+                        for ( int x = 1; x <= width; x++, src++ )
+                        {
+                            rowSum += *src;
 
-                        integralImage[y, x] = rowSum + integralImage[y - 1, x];
+                            integralImage[y, x] = rowSum + integralImage[y - 1, x];
+                        }
+                        src += offset;
                     }
-                    src += offset;
                 }
             }
 
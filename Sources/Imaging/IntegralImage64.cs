@@ -0,0 +1,605 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging
+{
+    using System;
+    using System.Drawing;
+    using System.Drawing.Imaging;
+    using System.Threading.Tasks;
+
+    /// <summary>
+    /// Integral image with 64-bit sums and optional sums of squares.
+    /// </summary>
+    ///
+    /// <remarks><para>The class implements the same concept as <see cref="IntegralImage"/>, but keeps
+    /// sums as 64-bit integers, so they do not overflow on images of any size (<see cref="IntegralImage"/> may
+    /// overflow for images with more than 16 millions of pixels). Optionally the class also keeps integral image
+    /// of squared pixels' values, which allows to calculate <see cref="GetRectangleVariance(int, int, int, int)">variance</see>
+    /// of pixels in any rectangle in constant time - this is required by local thresholding methods like
+    /// Sauvola's one, normalized cross correlation, etc.</para>
+    ///
+    /// <para>Integral image is built in two passes - sums of each row are calculated first and then they are
+    /// accumulated along columns. Both passes are done in parallel on multi-core systems. Memory is reused by
+    /// <see cref="Update(UnmanagedImage)"/> method if it is called for image of the same size,
+    /// so the same instance may be used to process video frames.</para>
+    ///
+    /// <para><note>The class processes only grayscale (8 bpp indexed) images.</note></para>
+    ///
+    /// <para>Sample usage:</para>
+    /// <code>
+    /// // create integral image keeping sums of squares as well
+    /// IntegralImage64 im = IntegralImage64.FromBitmap( image, true );
+    /// // get mean value and standard deviation of pixels in 15x15 window around (100, 100) point
+    /// double mean = im.GetRectangleMean( 100, 100, 7 );
+    /// double stdDev = Math.Sqrt( im.GetRectangleVariance( 100, 100, 7 ) );
+    /// // ...
+    /// // update integral image for new video frame
+    /// im.Update( nextImage );
+    /// </code>
+    /// </remarks>
+    ///
+    public class IntegralImage64
+    {
+        // integral images of pixels' values and of their squares
+        private long[,] integralImage = null;
+        private long[,] squaredIntegralImage = null;
+        private bool hasSquaredSums;
+
+        // image's width and height
+        private int width;
+        private int height;
+
+        // minimum number of pixels in image to process it in parallel
+        private const int MinPixelsForParallelProcessing = 256 * 256;
+        // number of columns processed by one thread when sums are accumulated along columns
+        private const int ColumnsPerStripe = 256;
+
+        /// <summary>
+        /// Width of the source image the integral image was constructed for.
+        /// </summary>
+        public int Width
+        {
+            get { return width; }
+        }
+
+        /// <summary>
+        /// Height of the source image the integral image was constructed for.
+        /// </summary>
+        public int Height
+        {
+            get { return height; }
+        }
+
+        /// <summary>
+        /// Specifies if the integral image keeps sums of squared pixels' values.
+        /// </summary>
+        ///
+        /// <remarks><para>Methods calculating variance can be used only if the property is set
+        /// to <see langword="true"/>.</para></remarks>
+        ///
+        public bool HasSquaredSums
+        {
+            get { return hasSquaredSums; }
+        }
+
+        /// <summary>
+        /// Provides access to internal array keeping integral image data.
+        /// </summary>
+        ///
+        /// <remarks>
+        /// <para><note>The array should be accessed by [y, x] indexing.</note></para>
+        ///
+        /// <para><note>The array's size is [<see cref="Height"/>+1, <see cref="Width"/>+1]. The first
+        /// row and column are filled with zeros, what is done for more efficient calculation of
+        /// rectangles' sums.</note></para>
+        /// </remarks>
+        ///
+        public long[,] InternalData
+        {
+            get { return integralImage; }
+        }
+
+        /// <summary>
+        /// Provides access to internal array keeping integral image of squared pixels' values.
+        /// </summary>
+        ///
+        /// <remarks><para>The array has the same layout as <see cref="InternalData"/>. The property
+        /// is set to <see langword="null"/> if <see cref="HasSquaredSums"/> is <see langword="false"/>.</para>
+        /// </remarks>
+        ///
+        public long[,] InternalSquaredData
+        {
+            get { return squaredIntegralImage; }
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="IntegralImage64"/> class.
+        /// </summary>
+        ///
+        /// <param name="hasSquaredSums">Specifies if the integral image should keep sums of squared pixels' values.</param>
+        ///
+        /// <remarks><para>The constructor creates empty integral image. <see cref="Update(UnmanagedImage)"/>
+        /// method should be called to build it for some image.</para></remarks>
+        ///
+        public IntegralImage64( bool hasSquaredSums )
+        {
+            this.hasSquaredSums = hasSquaredSums;
+        }
+
+        /// <summary>
+        /// Construct integral image from source grayscale image.
+        /// </summary>
+        ///
+        /// <param name="image">Source grayscale image.</param>
+        /// <param name="hasSquaredSums">Specifies if the integral image should keep sums of squared pixels' values.</param>
+        ///
+        /// <returns>Returns integral image.</returns>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        ///
+        public static IntegralImage64 FromBitmap( Bitmap image, bool hasSquaredSums )
+        {
+            IntegralImage64 im = new IntegralImage64( hasSquaredSums );
+            im.Update( image );
+            return im;
+        }
+
+        /// <summary>
+        /// Construct integral image from source grayscale image.
+        /// </summary>
+        ///
+        /// <param name="imageData">Source image data.</param>
+        /// <param name="hasSquaredSums">Specifies if the integral image should keep sums of squared pixels' values.</param>
+        ///
+        /// <returns>Returns integral image.</returns>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        ///
+        public static IntegralImage64 FromBitmap( BitmapData imageData, bool hasSquaredSums )
+        {
+            return FromBitmap( new UnmanagedImage( imageData ), hasSquaredSums );
+        }
+
+        /// <summary>
+        /// Construct integral image from source grayscale image.
+        /// </summary>
+        ///
+        /// <param name="image">Source unmanaged image.</param>
+        /// <param name="hasSquaredSums">Specifies if the integral image should keep sums of squared pixels' values.</param>
+        ///
+        /// <returns>Returns integral image.</returns>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        ///
+        public static IntegralImage64 FromBitmap( UnmanagedImage image, bool hasSquaredSums )
+        {
+            IntegralImage64 im = new IntegralImage64( hasSquaredSums );
+            im.Update( image );
+            return im;
+        }
+
+        /// <summary>
+        /// Rebuild integral image for the specified image.
+        /// </summary>
+        ///
+        /// <param name="image">Source grayscale image.</param>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        ///
+        public void Update( Bitmap image )
+        {
+            // check image format
+            if ( image.PixelFormat != PixelFormat.Format8bppIndexed )
+            {
+                throw new UnsupportedImageFormatException( "Source image can be graysclae (8 bpp indexed) image only." );
+            }
+
+            // lock source image
+            BitmapData imageData = image.LockBits(
+                new Rectangle( 0, 0, image.Width, image.Height ),
+                ImageLockMode.ReadOnly, PixelFormat.Format8bppIndexed );
+
+            try
+            {
+                // process the image
+                Update( new UnmanagedImage( imageData ) );
+            }
+            finally
+            {
+                // unlock image
+                image.UnlockBits( imageData );
+            }
+        }
+
+        /// <summary>
+        /// Rebuild integral image for the specified image.
+        /// </summary>
+        ///
+        /// <param name="imageData">Source image data.</param>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        ///
+        public void Update( BitmapData imageData )
+        {
+            Update( new UnmanagedImage( imageData ) );
+        }
+
+        /// <summary>
+        /// Rebuild integral image for the specified image.
+        /// </summary>
+        ///
+        /// <param name="image">Source unmanaged image.</param>
+        ///
+        /// <remarks><para>The method reuses memory allocated for the integral image if size of the
+        /// specified image is the same as size of the image the integral image was built for before.</para></remarks>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">The source image has incorrect pixel format.</exception>
+        ///
+        public void Update( UnmanagedImage image )
+        {
+            // check image format
+            if ( image.PixelFormat != PixelFormat.Format8bppIndexed )
+            {
+                throw new UnsupportedImageFormatException( "Source image can be graysclae (8 bpp indexed) image only." );
+            }
+
+            // allocate memory if image's size has changed
+            if ( ( integralImage == null ) || ( image.Width != width ) || ( image.Height != height ) )
+            {
+                width  = image.Width;
+                height = image.Height;
+
+                integralImage = new long[height + 1, width + 1];
+                squaredIntegralImage = ( hasSquaredSums ) ? new long[height + 1, width + 1] : null;
+            }
+
+            int stride = image.Stride;
+            int integralWidth = width + 1;
+            bool parallel = ( Environment.ProcessorCount > 1 ) && ( width * height >= MinPixelsForParallelProcessing );
+
+            unsafe
+            {
+                byte* src = (byte*) image.ImageData.ToPointer( );
+
+                // first pass - sums of each row's pixels
+                if ( parallel )
+                {
+                    Parallel.For( 0, height, delegate( int y )
+                    {
+                        CalculateRowSums( src + y * stride, y + 1 );
+                    } );
+                }
+                else
+                {
+                    for ( int y = 0; y < height; y++ )
+                    {
+                        CalculateRowSums( src + y * stride, y + 1 );
+                    }
+                }
+
+                // second pass - accumulate row sums along columns
+                int stripesCount = ( integralWidth + ColumnsPerStripe - 1 ) / ColumnsPerStripe;
+
+                if ( parallel )
+                {
+                    Parallel.For( 0, stripesCount, delegate( int stripe )
+                    {
+                        AccumulateColumns( stripe * ColumnsPerStripe, Math.Min( integralWidth, ( stripe + 1 ) * ColumnsPerStripe ) );
+                    } );
+                }
+                else
+                {
+                    AccumulateColumns( 0, integralWidth );
+                }
+            }
+        }
+
+        // Calculate sums of pixels' values (and their squares) in the specified row
+        private unsafe void CalculateRowSums( byte* src, int y )
+        {
+            fixed ( long* sums = &integralImage[y, 0] )
+            {
+                long rowSum = 0;
+
+                for ( int x = 0; x < width; x++ )
+                {
+                    rowSum += src[x];
+                    sums[x + 1] = rowSum;
+                }
+            }
+
+            if ( hasSquaredSums )
+            {
+                fixed ( long* sums = &squaredIntegralImage[y, 0] )
+                {
+                    long rowSum = 0;
+
+                    for ( int x = 0; x < width; x++ )
+                    {
+                        int v = src[x];
+
+                        rowSum += v * v;
+                        sums[x + 1] = rowSum;
+                    }
+                }
+            }
+        }
+
+        // Accumulate row sums along the specified columns
+        private unsafe void AccumulateColumns( int startX, int stopX )
+        {
+            int integralWidth = width + 1;
+
+            fixed ( long* sums = integralImage )
+            {
+                AccumulateColumns( sums, integralWidth, startX, stopX );
+            }
+
+            if ( hasSquaredSums )
+            {
+                fixed ( long* sums = squaredIntegralImage )
+                {
+                    AccumulateColumns( sums, integralWidth, startX, stopX );
+                }
+            }
+        }
+
+        private unsafe void AccumulateColumns( long* sums, int integralWidth, int startX, int stopX )
+        {
+            for ( int y = 2; y <= height; y++ )
+            {
+                long* row  = sums + y * integralWidth;
+                long* prev = row - integralWidth;
+
+                for ( int x = startX; x < stopX; x++ )
+                {
+                    row[x] += prev[x];
+                }
+            }
+        }
+
+        /// <summary>
+        /// Calculate sum of pixels in the specified rectangle.
+        /// </summary>
+        ///
+        /// <param name="x1">X coordinate of left-top rectangle's corner.</param>
+        /// <param name="y1">Y coordinate of left-top rectangle's corner.</param>
+        /// <param name="x2">X coordinate of right-bottom rectangle's corner.</param>
+        /// <param name="y2">Y coordinate of right-bottom rectangle's corner.</param>
+        ///
+        /// <returns>Returns sum of pixels in the specified rectangle.</returns>
+        ///
+        /// <remarks><para>Both specified points are included into the calculation rectangle.</para></remarks>
+        ///
+        public long GetRectangleSum( int x1, int y1, int x2, int y2 )
+        {
+            if ( !ClipRectangle( ref x1, ref y1, ref x2, ref y2 ) )
+                return 0;
+
+            return Sum( integralImage, x1, y1, x2, y2 );
+        }
+
+        /// <summary>
+        /// Calculate sum of pixels in the specified rectangle.
+        /// </summary>
+        ///
+        /// <param name="x">X coordinate of central point of the rectangle.</param>
+        /// <param name="y">Y coordinate of central point of the rectangle.</param>
+        /// <param name="radius">Radius of the rectangle.</param>
+        ///
+        /// <returns>Returns sum of pixels in the specified rectangle.</returns>
+        ///
+        /// <remarks><para>The method calculates sum of pixels in square rectangle with
+        /// odd width and height. In the case if it is required to calculate sum of
+        /// 3x3 rectangle, then it is required to specify its center and radius equal to 1.</para>
+        /// </remarks>
+        ///
+        public long GetRectangleSum( int x, int y, int radius )
+        {
+            return GetRectangleSum( x - radius, y - radius, x + radius, y + radius );
+        }
+
+        /// <summary>
+        /// Calculate sum of pixels in the specified rectangle without checking it's coordinates.
+        /// </summary>
+        ///
+        /// <param name="x1">X coordinate of left-top rectangle's corner.</param>
+        /// <param name="y1">Y coordinate of left-top rectangle's corner.</param>
+        /// <param name="x2">X coordinate of right-bottom rectangle's corner.</param>
+        /// <param name="y2">Y coordinate of right-bottom rectangle's corner.</param>
+        ///
+        /// <returns>Returns sum of pixels in the specified rectangle.</returns>
+        ///
+        /// <remarks><para>Both specified points are included into the calculation rectangle.</para></remarks>
+        ///
+        public long GetRectangleSumUnsafe( int x1, int y1, int x2, int y2 )
+        {
+            return Sum( integralImage, x1, y1, x2 + 1, y2 + 1 );
+        }
+
+        /// <summary>
+        /// Calculate sum of squared pixels' values in the specified rectangle.
+        /// </summary>
+        ///
+        /// <param name="x1">X coordinate of left-top rectangle's corner.</param>
+        /// <param name="y1">Y coordinate of left-top rectangle's corner.</param>
+        /// <param name="x2">X coordinate of right-bottom rectangle's corner.</param>
+        /// <param name="y2">Y coordinate of right-bottom rectangle's corner.</param>
+        ///
+        /// <returns>Returns sum of squared pixels' values in the specified rectangle.</returns>
+        ///
+        /// <remarks><para>Both specified points are included into the calculation rectangle.</para></remarks>
+        ///
+        /// <exception cref="InvalidOperationException">The integral image does not keep sums of squares.</exception>
+        ///
+        public long GetRectangleSquaredSum( int x1, int y1, int x2, int y2 )
+        {
+            CheckSquaredSums( );
+
+            if ( !ClipRectangle( ref x1, ref y1, ref x2, ref y2 ) )
+                return 0;
+
+            return Sum( squaredIntegralImage, x1, y1, x2, y2 );
+        }
+
+        /// <summary>
+        /// Calculate mean value of pixels in the specified rectangle.
+        /// </summary>
+        ///
+        /// <param name="x1">X coordinate of left-top rectangle's corner.</param>
+        /// <param name="y1">Y coordinate of left-top rectangle's corner.</param>
+        /// <param name="x2">X coordinate of right-bottom rectangle's corner.</param>
+        /// <param name="y2">Y coordinate of right-bottom rectangle's corner.</param>
+        ///
+        /// <returns>Returns mean value of pixels in the specified rectangle.</returns>
+        ///
+        /// <remarks>Both specified points are included into the calculation rectangle.</remarks>
+        ///
+        public double GetRectangleMean( int x1, int y1, int x2, int y2 )
+        {
+            if ( !ClipRectangle( ref x1, ref y1, ref x2, ref y2 ) )
+                return 0;
+
+            // return sum divided by actual rectangles size
+            return (double) Sum( integralImage, x1, y1, x2, y2 ) / ( (long) ( x2 - x1 ) * ( y2 - y1 ) );
+        }
+
+        /// <summary>
+        /// Calculate mean value of pixels in the specified rectangle.
+        /// </summary>
+        ///
+        /// <param name="x">X coordinate of central point of the rectangle.</param>
+        /// <param name="y">Y coordinate of central point of the rectangle.</param>
+        /// <param name="radius">Radius of the rectangle.</param>
+        ///
+        /// <returns>Returns mean value of pixels in the specified rectangle.</returns>
+        ///
+        /// <remarks>The method calculates mean value of pixels in square rectangle with
+        /// odd width and height. In the case if it is required to calculate mean value of
+        /// 3x3 rectangle, then it is required to specify its center and radius equal to 1.
+        /// </remarks>
+        ///
+        public double GetRectangleMean( int x, int y, int radius )
+        {
+            return GetRectangleMean( x - radius, y - radius, x + radius, y + radius );
+        }
+
+        /// <summary>
+        /// Calculate variance of pixels' values in the specified rectangle.
+        /// </summary>
+        ///
+        /// <param name="x1">X coordinate of left-top rectangle's corner.</param>
+        /// <param name="y1">Y coordinate of left-top rectangle's corner.</param>
+        /// <param name="x2">X coordinate of right-bottom rectangle's corner.</param>
+        /// <param name="y2">Y coordinate of right-bottom rectangle's corner.</param>
+        ///
+        /// <returns>Returns variance of pixels' values in the specified rectangle.</returns>
+        ///
+        /// <remarks><para>Both specified points are included into the calculation rectangle. Only part
+        /// of the rectangle, which is inside of the image, is taken into account.</para></remarks>
+        ///
+        /// <exception cref="InvalidOperationException">The integral image does not keep sums of squares.</exception>
+        ///
+        public double GetRectangleVariance( int x1, int y1, int x2, int y2 )
+        {
+            CheckSquaredSums( );
+
+            if ( !ClipRectangle( ref x1, ref y1, ref x2, ref y2 ) )
+                return 0;
+
+            return Variance( x1, y1, x2, y2 );
+        }
+
+        /// <summary>
+        /// Calculate variance of pixels' values in the specified rectangle.
+        /// </summary>
+        ///
+        /// <param name="x">X coordinate of central point of the rectangle.</param>
+        /// <param name="y">Y coordinate of central point of the rectangle.</param>
+        /// <param name="radius">Radius of the rectangle.</param>
+        ///
+        /// <returns>Returns variance of pixels' values in the specified rectangle.</returns>
+        ///
+        /// <remarks>The method calculates variance of pixels' values in square rectangle with
+        /// odd width and height. In the case if it is required to calculate variance of
+        /// 3x3 rectangle, then it is required to specify its center and radius equal to 1.
+        /// </remarks>
+        ///
+        /// <exception cref="InvalidOperationException">The integral image does not keep sums of squares.</exception>
+        ///
+        public double GetRectangleVariance( int x, int y, int radius )
+        {
+            return GetRectangleVariance( x - radius, y - radius, x + radius, y + radius );
+        }
+
+        /// <summary>
+        /// Calculate variance of pixels' values in the specified rectangle without checking it's coordinates.
+        /// </summary>
+        ///
+        /// <param name="x1">X coordinate of left-top rectangle's corner.</param>
+        /// <param name="y1">Y coordinate of left-top rectangle's corner.</param>
+        /// <param name="x2">X coordinate of right-bottom rectangle's corner.</param>
+        /// <param name="y2">Y coordinate of right-bottom rectangle's corner.</param>
+        ///
+        /// <returns>Returns variance of pixels' values in the specified rectangle.</returns>
+        ///
+        /// <remarks><para>Both specified points are included into the calculation rectangle. The method
+        /// also does not check if the integral image keeps sums of squares.</para></remarks>
+        ///
+        public double GetRectangleVarianceUnsafe( int x1, int y1, int x2, int y2 )
+        {
+            return Variance( x1, y1, x2 + 1, y2 + 1 );
+        }
+
+        // Clip rectangle to the image converting its right-bottom corner to exclusive coordinates
+        private bool ClipRectangle( ref int x1, ref int y1, ref int x2, ref int y2 )
+        {
+            // check if requested rectangle is out of the image
+            if ( ( x2 < 0 ) || ( y2 < 0 ) || ( x1 >= width ) || ( y1 >= height ) )
+                return false;
+
+            if ( x1 < 0 ) x1 = 0;
+            if ( y1 < 0 ) y1 = 0;
+
+            x2++;
+            y2++;
+
+            if ( x2 > width )  x2 = width;
+            if ( y2 > height ) y2 = height;
+
+            return true;
+        }
+
+        // Sum of the rectangle, which right-bottom corner is exclusive
+        private static long Sum( long[,] data, int x1, int y1, int x2, int y2 )
+        {
+            return data[y2, x2] + data[y1, x1] - data[y2, x1] - data[y1, x2];
+        }
+
+        // Variance of the rectangle, which right-bottom corner is exclusive
+        private double Variance( int x1, int y1, int x2, int y2 )
+        {
+            long count = (long) ( x2 - x1 ) * ( y2 - y1 );
+            long sum = Sum( integralImage, x1, y1, x2, y2 );
+            long squaredSum = Sum( squaredIntegralImage, x1, y1, x2, y2 );
+
+            // count * squaredSum - sum * sum is calculated in double, since it may not fit into 64 bits
+            double variance = ( (double) squaredSum - (double) sum * sum / count ) / count;
+
+            return ( variance > 0 ) ? variance : 0;
+        }
+
+        // Make sure sums of squares are available
+        private void CheckSquaredSums( )
+        {
+            if ( !hasSquaredSums )
+                throw new InvalidOperationException( "The integral image does not keep sums of squared values." );
+        }
+    }
+}
@@ -0,0 +1,295 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging
+{
+    using System;
+
+    /// <summary>
+    /// Vectorized processing routines for rows of 8 bit per channel images.
+    /// </summary>
+    ///
+    /// <remarks><para>The routines process 8 bytes at once packing them into 64 bit integer
+    /// (SIMD within a register), so all byte lanes are processed by a single arithmetic operation
+    /// without carries/borrows crossing lanes. Each routine processes the biggest part of a row,
+    /// which is multiple of 8 bytes, and returns number of processed bytes, so the caller finishes
+    /// the remaining bytes with its regular per byte code. Results are bit exact with the per byte code.</para>
+    ///
+    /// <para>The routines must be used only if <see cref="IsEnabled"/> is set to <see langword="true"/>.</para>
+    /// </remarks>
+    ///
+    internal static unsafe class PixelKernels
+    {
+        // high bit of each byte lane
+        private const ulong High = 0x8080808080808080UL;
+        // all bits of each byte lane, except the high bit
+        private const ulong Low7 = 0x7F7F7F7F7F7F7F7FUL;
+        // lowest bit of each byte lane
+        private const ulong Ones = 0x0101010101010101UL;
+
+        /// <summary>
+        /// Specifies if vectorized routines may be used.
+        /// </summary>
+        ///
+        /// <remarks><para>The routines are used in 64 bit processes only, where 64 bit arithmetic is native and
+        /// CPUs do not fault on unaligned memory access.</para></remarks>
+        ///
+        public static readonly bool IsEnabled = ( IntPtr.Size == 8 );
+
+        // Get mask of byte lanes, where x >= y - high bit of each lane is set if the condition is true
+        private static ulong GreaterOrEqualHigh( ulong x, ulong y )
+        {
+            // compare lanes without their high bits (subtraction never borrows from the next lane)
+            ulong lowGreaterOrEqual = ( x | High ) - ( y & Low7 );
+            // lanes' high bits decide, if they differ
+            return ( ( x & ~y ) | ( ~( x ^ y ) & lowGreaterOrEqual ) ) & High;
+        }
+
+        // Expand high bit of each byte lane to all bits of the lane
+        private static ulong ExpandHigh( ulong highBits )
+        {
+            return ( highBits >> 7 ) * 0xFF;
+        }
+
+        /// <summary>
+        /// Invert bytes: <b>ptr[i] = 255 - ptr[i]</b>.
+        /// </summary>
+        ///
+        /// <param name="ptr">Pointer to bytes to process.</param>
+        /// <param name="count">Number of bytes available for processing.</param>
+        ///
+        /// <returns>Returns number of processed bytes.</returns>
+        ///
+        public static int Invert( byte* ptr, int count )
+        {
+            int n = count >> 3;
+            ulong* p = (ulong*) ptr;
+
+            for ( int i = 0; i < n; i++, p++ )
+            {
+                *p = ~*p;
+            }
+
+            return n << 3;
+        }
+
+        /// <summary>
+        /// Threshold bytes: <b>ptr[i] = ( ptr[i] &gt;= threshold ) ? 255 : 0</b>.
+        /// </summary>
+        ///
+        /// <param name="ptr">Pointer to bytes to process.</param>
+        /// <param name="count">Number of bytes available for processing.</param>
+        /// <param name="threshold">Threshold value.</param>
+        ///
+        /// <returns>Returns number of processed bytes.</returns>
+        ///
+        public static int Threshold( byte* ptr, int count, byte threshold )
+        {
+            int n = count >> 3;
+            ulong* p = (ulong*) ptr;
+            ulong t = Ones * threshold;
+
+            for ( int i = 0; i < n; i++, p++ )
+            {
+                *p = ExpandHigh( GreaterOrEqualHigh( *p, t ) );
+            }
+
+            return n << 3;
+        }
+
+        /// <summary>
+        /// Add bytes with saturation: <b>ptr[i] = min( ptr[i] + ovr[i], 255 )</b>.
+        /// </summary>
+        ///
+        /// <param name="ptr">Pointer to bytes to process (and to store result to).</param>
+        /// <param name="ovr">Pointer to overlay bytes.</param>
+        /// <param name="count">Number of bytes available for processing.</param>
+        ///
+        /// <returns>Returns number of processed bytes.</returns>
+        ///
+        public static int Add( byte* ptr, byte* ovr, int count )
+        {
+            int n = count >> 3;
+            ulong* p = (ulong*) ptr;
+            ulong* o = (ulong*) ovr;
+
+            for ( int i = 0; i < n; i++, p++, o++ )
+            {
+                ulong x = *p;
+                ulong y = *o;
+                // sum of lanes without their high bits (never carries to the next lane)
+                ulong low = ( x & Low7 ) + ( y & Low7 );
+                // carry out of each lane
+                ulong carry = ( ( x & y ) | ( ( x | y ) & low ) ) & High;
+
+                *p = ( low ^ ( ( x ^ y ) & High ) ) | ExpandHigh( carry );
+            }
+
+            return n << 3;
+        }
+
+        /// <summary>
+        /// Subtract bytes with saturation: <b>ptr[i] = max( ptr[i] - ovr[i], 0 )</b>.
+        /// </summary>
+        ///
+        /// <param name="ptr">Pointer to bytes to process (and to store result to).</param>
+        /// <param name="ovr">Pointer to overlay bytes.</param>
+        /// <param name="count">Number of bytes available for processing.</param>
+        ///
+        /// <returns>Returns number of processed bytes.</returns>
+        ///
+        public static int Subtract( byte* ptr, byte* ovr, int count )
+        {
+            int n = count >> 3;
+            ulong* p = (ulong*) ptr;
+            ulong* o = (ulong*) ovr;
+
+            for ( int i = 0; i < n; i++, p++, o++ )
+            {
+                ulong x = *p;
+                ulong y = *o;
+                // difference of lanes without their high bits (never borrows from the next lane)
+                ulong low = ( x | High ) - ( y & Low7 );
+                ulong difference = low ^ ( ~( x ^ y ) & High );
+
+                *p = difference & ExpandHigh( ( ( x & ~y ) | ( ~( x ^ y ) & low ) ) & High );
+            }
+
+            return n << 3;
+        }
+
+        /// <summary>
+        /// Absolute difference of bytes: <b>ptr[i] = abs( ptr[i] - ovr[i] )</b>.
+        /// </summary>
+        ///
+        /// <param name="ptr">Pointer to bytes to process (and to store result to).</param>
+        /// <param name="ovr">Pointer to overlay bytes.</param>
+        /// <param name="count">Number of bytes available for processing.</param>
+        ///
+        /// <returns>Returns number of processed bytes.</returns>
+        ///
+        public static int Difference( byte* ptr, byte* ovr, int count )
+        {
+            int n = count >> 3;
+            ulong* p = (ulong*) ptr;
+            ulong* o = (ulong*) ovr;
+
+            for ( int i = 0; i < n; i++, p++, o++ )
+            {
+                *p = AbsoluteDifference( *p, *o );
+            }
+
+            return n << 3;
+        }
+
+        /// <summary>
+        /// Minimum of bytes: <b>ptr[i] = min( ptr[i], ovr[i] )</b>.
+        /// </summary>
+        ///
+        /// <param name="ptr">Pointer to bytes to process (and to store result to).</param>
+        /// <param name="ovr">Pointer to overlay bytes.</param>
+        /// <param name="count">Number of bytes available for processing.</param>
+        ///
+        /// <returns>Returns number of processed bytes.</returns>
+        ///
+        public static int Min( byte* ptr, byte* ovr, int count )
+        {
+            int n = count >> 3;
+            ulong* p = (ulong*) ptr;
+            ulong* o = (ulong*) ovr;
+
+            for ( int i = 0; i < n; i++, p++, o++ )
+            {
+                ulong x = *p;
+                ulong y = *o;
+                ulong mask = ExpandHigh( GreaterOrEqualHigh( x, y ) );
+
+                *p = ( y & mask ) | ( x & ~mask );
+            }
+
+            return n << 3;
+        }
+
+        /// <summary>
+        /// Maximum of bytes: <b>ptr[i] = max( ptr[i], ovr[i] )</b>.
+        /// </summary>
+        ///
+        /// <param name="ptr">Pointer to bytes to process (and to store result to).</param>
+        /// <param name="ovr">Pointer to overlay bytes.</param>
+        /// <param name="count">Number of bytes available for processing.</param>
+        ///
+        /// <returns>Returns number of processed bytes.</returns>
+        ///
+        public static int Max( byte* ptr, byte* ovr, int count )
+        {
+            int n = count >> 3;
+            ulong* p = (ulong*) ptr;
+            ulong* o = (ulong*) ovr;
+
+            for ( int i = 0; i < n; i++, p++, o++ )
+            {
+                ulong x = *p;
+                ulong y = *o;
+                ulong mask = ExpandHigh( GreaterOrEqualHigh( x, y ) );
+
+                *p = ( x & mask ) | ( y & ~mask );
+            }
+
+            return n << 3;
+        }
+
+        /// <summary>
+        /// Thresholded absolute difference of bytes: <b>dst[i] = ( abs( src[i] - ovr[i] ) &gt; threshold ) ? 255 : 0</b>.
+        /// </summary>
+        ///
+        /// <param name="src">Pointer to source bytes.</param>
+        /// <param name="ovr">Pointer to overlay bytes.</param>
+        /// <param name="dst">Pointer to destination bytes.</param>
+        /// <param name="count">Number of bytes available for processing.</param>
+        /// <param name="threshold">Threshold value.</param>
+        /// <param name="whiteCount">Number of bytes set to 255, which is incremented by the routine.</param>
+        ///
+        /// <returns>Returns number of processed bytes.</returns>
+        ///
+        public static int ThresholdedDifference( byte* src, byte* ovr, byte* dst, int count, byte threshold, ref int whiteCount )
+        {
+            // difference > threshold is the same as difference >= threshold + 1,
+            // which is never true for threshold 255
+            if ( threshold == 255 )
+                return 0;
+
+            int n = count >> 3;
+            ulong* s = (ulong*) src;
+            ulong* o = (ulong*) ovr;
+            ulong* d = (ulong*) dst;
+            ulong t = Ones * (byte) ( threshold + 1 );
+            int white = 0;
+
+            for ( int i = 0; i < n; i++, s++, o++, d++ )
+            {
+                ulong high = GreaterOrEqualHigh( AbsoluteDifference( *s, *o ), t );
+
+                // count set lanes summing all of them into the highest lane
+                white += (int) ( ( ( high >> 7 ) * Ones ) >> 56 );
+                *d = ExpandHigh( high );
+            }
+
+            whiteCount += white;
+
+            return n << 3;
+        }
+
+        // Absolute difference of byte lanes
+        private static ulong AbsoluteDifference( ulong x, ulong y )
+        {
+            ulong mask = ExpandHigh( GreaterOrEqualHigh( x, y ) );
+            // maximum - minimum of each lane never borrows from the next lane
+            return ( ( x & mask ) | ( y & ~mask ) ) - ( ( y & mask ) | ( x & ~mask ) );
+        }
+    }
+}
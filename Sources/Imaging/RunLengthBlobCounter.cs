@@ -0,0 +1,958 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging
+{
+    using System;
+    using System.Collections.Generic;
+    using System.Drawing;
+    using System.Drawing.Imaging;
+    using System.Threading.Tasks;
+    using AForge.Imaging.Filters;
+
+    /// <summary>
+    /// Blob counter based on run-length encoding and union-find.
+    /// </summary>
+    ///
+    /// <remarks><para>The class finds the same blobs (8-connected objects) as <see cref="BlobCounter"/> does,
+    /// but instead of labeling image pixel by pixel it works with runs - horizontal segments of object's pixels
+    /// in a row. Each run is connected to the runs of the previous row it touches, joining their sets using union-find.
+    /// Area, bounding rectangle, center of gravity and color statistics of each run are accumulated while
+    /// the run is found, so objects' information is gathered from runs without additional pass through image.</para>
+    ///
+    /// <para><note>Only partitioning of image's pixels into blobs and blobs' information are the same as found by
+    /// <see cref="BlobCounter"/>. Blobs' IDs (and so values of <see cref="BlobCounterBase.ObjectLabels">objects' labels</see>)
+    /// may differ, since <see cref="BlobCounter"/> numbers blobs in the order of labels, which happened to be roots of
+    /// its labels' equivalence sets. Set <see cref="BlobCounterBase.ObjectsOrder"/> if the same order of blobs is required.</note></para>
+    ///
+    /// <para>The image is split into horizontal stripes, which are labeled in parallel (see <see cref="MaxDegreeOfParallelism"/>).
+    /// Then the runs touching stripes' seams are joined. Blobs are numbered in the order of their top left pixel
+    /// (first pixel met when scanning image row by row), so the result does not depend on the number of stripes.</para>
+    ///
+    /// <para>Arrays used for labeling, including <see cref="BlobCounterBase.ObjectLabels">objects' labels</see>,
+    /// are kept and reused by next calls of <see cref="BlobCounterBase.ProcessImage(UnmanagedImage)"/> method
+    /// for images of the same size, so processing video frames does not allocate memory for each frame. Arrays
+    /// of runs are sized for few runs per row first and grow only when a row with more runs is met.
+    /// <note>Because of this the array returned by <see cref="BlobCounterBase.ObjectLabels"/> property is
+    /// overwritten, when next image is processed.</note></para>
+    ///
+    /// <para>The class supports the same image formats and <see cref="BackgroundThreshold">background
+    /// threshold</see> as <see cref="BlobCounter"/>.</para>
+    ///
+    /// <para>Sample usage:</para>
+    /// <code>
+    /// // create an instance of blob counter algorithm
+    /// RunLengthBlobCounter bc = new RunLengthBlobCounter( );
+    /// // process video frames
+    /// foreach ( UnmanagedImage frame in motionMasks )
+    /// {
+    ///     bc.ProcessImage( frame );
+    ///     Blob[] blobs = bc.GetObjectsInformation( );
+    ///     // process blobs
+    ///     // ...
+    /// }
+    /// </code>
+    /// </remarks>
+    ///
+    /// <seealso cref="BlobCounter"/>
+    ///
+    public class RunLengthBlobCounter : BlobCounterBase
+    {
+        private byte backgroundThresholdR = 0;
+        private byte backgroundThresholdG = 0;
+        private byte backgroundThresholdB = 0;
+
+        private int maxDegreeOfParallelism = 0;
+
+        // size of image the buffers were allocated for
+        private int buffersWidth  = 0;
+        private int buffersHeight = 0;
+        // pixel format of the last processed image
+        private PixelFormat processedPixelFormat;
+        // maximum number of runs in a row, which can be kept in runs' arrays
+        private int maxRunsInRow;
+
+        // runs' start and end (inclusive) X coordinates
+        private int[] runStart;
+        private int[] runEnd;
+        // parent runs in union-find forest
+        private int[] runParent;
+        // labels of objects the runs belong to
+        private int[] runLabel;
+        // sums of runs' pixels' values and their squares
+        private int[]  runSumR;
+        private int[]  runSumG;
+        private int[]  runSumB;
+        private long[] runSquaresSumR;
+        private long[] runSquaresSumG;
+        private long[] runSquaresSumB;
+        // number of runs in each row (runs of row y start from index y * maxRunsInRow)
+        private int[] rowRunsCount;
+
+        // information about objects collected from runs
+        private int[]  objectX1;
+        private int[]  objectY1;
+        private int[]  objectX2;
+        private int[]  objectY2;
+        private int[]  objectArea;
+        private long[] objectXc;
+        private long[] objectYc;
+        private long[] objectSumR;
+        private long[] objectSumG;
+        private long[] objectSumB;
+        private long[] objectSquaresSumR;
+        private long[] objectSquaresSumG;
+        private long[] objectSquaresSumB;
+
+        // rectangles of objects removed by blobs' filtering
+        private List<Rectangle> filteredRectangles = new List<Rectangle>( );
+
+        /// <summary>
+        /// Background threshold's value.
+        /// </summary>
+        ///
+        /// <remarks><para>The property sets threshold value for distinguishing between background
+        /// pixel and objects' pixels. All pixel with values less or equal to this property are
+        /// treated as background, but pixels with higher values are treated as objects' pixels.</para>
+        ///
+        /// <para><note>In the case of colour images a pixel is treated as objects' pixel if <b>any</b> of its
+        /// RGB values are higher than corresponding values of this threshold.</note></para>
+        ///
+        /// <para><note>For processing grayscale image, set the property with all RGB components eqaul.</note></para>
+        ///
+        /// <para>Default value is set to <b>(0, 0, 0)</b> - black color.</para></remarks>
+        ///
+        public Color BackgroundThreshold
+        {
+            get { return Color.FromArgb( backgroundThresholdR, backgroundThresholdG, backgroundThresholdB ); }
+            set
+            {
+                backgroundThresholdR = value.R;
+                backgroundThresholdG = value.G;
+                backgroundThresholdB = value.B;
+            }
+        }
+
+        /// <summary>
+        /// Maximum number of image's stripes labeled in parallel.
+        /// </summary>
+        ///
+        /// <remarks><para>Value <b>0</b> means that the limit is set by <see cref="FilterParallelism.MaxDegreeOfParallelism"/>,
+        /// value <b>1</b> disables parallel processing.</para>
+        ///
+        /// <para>Default value is set to <b>0</b>.</para>
+        /// </remarks>
+        ///
+        public int MaxDegreeOfParallelism
+        {
+            get { return maxDegreeOfParallelism; }
+            set { maxDegreeOfParallelism = Math.Max( 0, value ); }
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="RunLengthBlobCounter"/> class.
+        /// </summary>
+        ///
+        /// <remarks>Creates new instance of the <see cref="RunLengthBlobCounter"/> class with
+        /// an empty objects map. Before using methods, which provide information about blobs
+        /// or extract them, the <see cref="BlobCounterBase.ProcessImage(Bitmap)"/>,
+        /// <see cref="BlobCounterBase.ProcessImage(BitmapData)"/> or <see cref="BlobCounterBase.ProcessImage(UnmanagedImage)"/>
+        /// method should be called to collect objects map.</remarks>
+        ///
+        public RunLengthBlobCounter( ) { }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="RunLengthBlobCounter"/> class.
+        /// </summary>
+        ///
+        /// <param name="image">Image to look for objects in.</param>
+        ///
+        public RunLengthBlobCounter( Bitmap image ) : base( image ) { }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="RunLengthBlobCounter"/> class.
+        /// </summary>
+        ///
+        /// <param name="imageData">Image data to look for objects in.</param>
+        ///
+        public RunLengthBlobCounter( BitmapData imageData ) : base( imageData ) { }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="RunLengthBlobCounter"/> class.
+        /// </summary>
+        ///
+        /// <param name="image">Unmanaged image to look for objects in.</param>
+        ///
+        public RunLengthBlobCounter( UnmanagedImage image ) : base( image ) { }
+
+        /// <summary>
+        /// Update objects map processing only the specified regions of image.
+        /// </summary>
+        ///
+        /// <param name="image">Unmanaged image to process.</param>
+        /// <param name="regions">Regions of the image, which may differ from the previously processed image.</param>
+        /// <param name="margin">Margin to extend the regions by on each side.</param>
+        ///
+        /// <remarks><para>The method is aimed for processing video frames, when it is known where objects may
+        /// change since the previous frame - for example, from objects' positions known to a tracker or from
+        /// motion detection. The image must be the same as the previously processed image outside of the specified
+        /// regions extended by the margin.</para>
+        ///
+        /// <para>Blobs of the previous image, which touch the regions, are removed and the regions are extended
+        /// to cover them (as well as objects of the previous image removed by blobs' filtering). Then only the extended
+        /// regions are labeled and the found blobs are added to blobs of the previous image. Blobs outside of the regions are not touched and keep their IDs. So processing time mostly depends
+        /// on size of the regions and blobs around them, but not on size of the image (for images with many closely placed blobs
+        /// the extended regions may grow up to the whole image though). The result is the same set of blobs
+        /// (with the same <see cref="BlobCounterBase.ObjectLabels">objects map</see>) as after processing the whole
+        /// image, but blobs' IDs may differ: new blobs get IDs of removed blobs first, and if there are less new blobs
+        /// than removed ones, blobs with the highest IDs get the free IDs, so IDs are still in the [1, <see cref="BlobCounterBase.ObjectsCount"/>] range.
+        /// Blobs' filtering and ordering settings are applied the same way as by
+        /// <see cref="BlobCounterBase.ProcessImage(UnmanagedImage)"/> (if no order is set, blobs are ordered by their IDs).</para>
+        ///
+        /// <para><note>Blobs' filtering and background threshold settings must not be changed between processing
+        /// the previous image and calling this method.</note></para>
+        ///
+        /// <para>If no image of the same size and pixel format was processed before, the method processes the whole image.</para>
+        ///
+        /// <para>Sample usage:</para>
+        /// <code>
+        /// RunLengthBlobCounter bc = new RunLengthBlobCounter( );
+        /// // process the first frame completely
+        /// bc.ProcessImage( frame );
+        /// // ...
+        /// // process only regions of the next frame, where objects were moving
+        /// bc.ProcessRegions( nextFrame, motionRectangles, 5 );
+        /// Blob[] blobs = bc.GetObjectsInformation( );
+        /// </code>
+        /// </remarks>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">Unsupported pixel format of the source image.</exception>
+        ///
+        public void ProcessRegions( UnmanagedImage image, Rectangle[] regions, int margin )
+        {
+            if ( ( objectLabels == null ) || ( image.Width != buffersWidth ) || ( image.Height != buffersHeight ) ||
+                 ( image.PixelFormat != processedPixelFormat ) )
+            {
+                ProcessImage( image );
+                return;
+            }
+
+            Rectangle imageRect = new Rectangle( 0, 0, imageWidth, imageHeight );
+            List<Rectangle> areas = new List<Rectangle>( );
+
+            foreach ( Rectangle region in regions )
+            {
+                Rectangle area = region;
+
+                area.Inflate( margin, margin );
+                area.Intersect( imageRect );
+
+                if ( ( area.Width > 0 ) && ( area.Height > 0 ) )
+                {
+                    areas.Add( area );
+                }
+            }
+
+            // blobs indexed by their IDs
+            List<Blob> blobsByID = new List<Blob>( objectsCount + 1 );
+
+            blobsByID.Add( null );
+            for ( int i = 0; i < objectsCount; i++ )
+            {
+                blobsByID.Add( null );
+            }
+            foreach ( Blob blob in blobs )
+            {
+                blobsByID[blob.ID] = blob;
+            }
+
+            while ( areas.Count != 0 )
+            {
+                ExtendAreas( areas, blobsByID );
+
+                // label the last area
+                Rectangle area = areas[areas.Count - 1];
+
+                areas.RemoveAt( areas.Count - 1 );
+                while ( !LabelRows( image, area.Left, area.Right, area.Top, area.Bottom ) )
+                {
+                    GrowRuns( );
+                }
+                UpdateArea( area, blobsByID );
+            }
+
+            blobs.Clear( );
+            for ( int i = 1; i <= objectsCount; i++ )
+            {
+                blobs.Add( blobsByID[i] );
+            }
+
+            SortBlobs( );
+        }
+
+        /// <summary>
+        /// Actual objects map building.
+        /// </summary>
+        ///
+        /// <param name="image">Unmanaged image to process.</param>
+        ///
+        /// <remarks>The method supports 8 bpp indexed grayscale images and 24/32 bpp color images.</remarks>
+        ///
+        /// <exception cref="UnsupportedImageFormatException">Unsupported pixel format of the source image.</exception>
+        ///
+        protected override void BuildObjectsMap( UnmanagedImage image )
+        {
+            // check pixel format
+            if ( ( image.PixelFormat != PixelFormat.Format8bppIndexed ) &&
+                 ( image.PixelFormat != PixelFormat.Format24bppRgb ) &&
+                 ( image.PixelFormat != PixelFormat.Format32bppRgb ) &&
+                 ( image.PixelFormat != PixelFormat.Format32bppArgb ) &&
+                 ( image.PixelFormat != PixelFormat.Format32bppPArgb ) )
+            {
+                throw new UnsupportedImageFormatException( "Unsupported pixel format of the source image." );
+            }
+
+            AllocateBuffers( );
+            processedPixelFormat = image.PixelFormat;
+
+            int stripesCount = FilterParallelism.GetStripesCount(
+                new Rectangle( 0, 0, imageWidth, imageHeight ), maxDegreeOfParallelism );
+            int[] stripesStartY = new int[stripesCount + 1];
+
+            for ( int i = 0; i <= stripesCount; i++ )
+            {
+                stripesStartY[i] = (int) ( (long) imageHeight * i / stripesCount );
+            }
+
+            // 1 - label stripes (from the start if runs' arrays had to grow)
+            while ( !LabelStripes( image, stripesStartY ) )
+            {
+                GrowRuns( );
+            }
+
+            // 2 - join runs touching stripes' seams
+            for ( int i = 1; i < stripesCount; i++ )
+            {
+                JoinRows( stripesStartY[i] - 1 );
+            }
+
+            // 3 - assign labels to objects and collect their information
+            objectsCount = CollectRuns( 0, imageHeight );
+
+            // 4 - build objects' labels map
+            if ( stripesCount == 1 )
+            {
+                FillLabels( 0, imageHeight );
+            }
+            else
+            {
+                Parallel.For( 0, stripesCount, delegate( int stripe )
+                {
+                    FillLabels( stripesStartY[stripe], stripesStartY[stripe + 1] );
+                } );
+            }
+        }
+
+        /// <summary>
+        /// Collect information about found objects.
+        /// </summary>
+        ///
+        /// <param name="image">Unmanaged image to process.</param>
+        ///
+        /// <remarks><para>The information is already collected from runs while building objects map,
+        /// so the method only creates blobs.</para></remarks>
+        ///
+        protected override void CollectObjectsInfo( UnmanagedImage image )
+        {
+            CreateBlobs( objectX1, objectY1, objectX2, objectY2, objectArea, objectXc, objectYc,
+                objectSumR, objectSumG, objectSumB, objectSquaresSumR, objectSquaresSumG, objectSquaresSumB );
+
+            // remember objects, which will be removed by filtering, since they are not
+            // present in objects' labels, but regions' processing must extend over them
+            filteredRectangles.Clear( );
+
+            foreach ( Blob blob in blobs )
+            {
+                if ( !IsBlobAccepted( blob ) )
+                {
+                    filteredRectangles.Add( blob.Rectangle );
+                }
+            }
+        }
+
+        // Allocate arrays for runs and labels if image size has changed
+        private void AllocateBuffers( )
+        {
+            if ( ( buffersWidth == imageWidth ) && ( buffersHeight == imageHeight ) && ( objectLabels != null ) )
+                return;
+
+            rowRunsCount = new int[imageHeight];
+            objectLabels = new int[imageWidth * imageHeight];
+
+            buffersWidth  = imageWidth;
+            buffersHeight = imageHeight;
+
+            // most rows of usual images have few runs, so arrays of runs grow only when needed
+            maxRunsInRow = 0;
+            GrowRuns( );
+        }
+
+        // Allocate larger arrays for runs, which can keep more runs per row (previous runs are not kept)
+        private void GrowRuns( )
+        {
+            // a row can not have more runs than half of its pixels
+            maxRunsInRow = Math.Min( Math.Max( 16, maxRunsInRow * 2 ), ( imageWidth + 1 ) / 2 );
+
+            int maxRuns = maxRunsInRow * imageHeight;
+
+            runStart       = new int[maxRuns];
+            runEnd         = new int[maxRuns];
+            runParent      = new int[maxRuns];
+            runLabel       = new int[maxRuns];
+            runSumR        = new int[maxRuns];
+            runSumG        = new int[maxRuns];
+            runSumB        = new int[maxRuns];
+            runSquaresSumR = new long[maxRuns];
+            runSquaresSumG = new long[maxRuns];
+            runSquaresSumB = new long[maxRuns];
+        }
+
+        // Label all stripes of image, returning false if some row has more runs than runs' arrays can keep
+        private bool LabelStripes( UnmanagedImage image, int[] stripesStartY )
+        {
+            int stripesCount = stripesStartY.Length - 1;
+
+            if ( stripesCount == 1 )
+            {
+                return LabelRows( image, 0, imageWidth, 0, imageHeight );
+            }
+
+            bool labeled = true;
+
+            Parallel.For( 0, stripesCount, delegate( int stripe )
+            {
+                if ( !LabelRows( image, 0, imageWidth, stripesStartY[stripe], stripesStartY[stripe + 1] ) )
+                {
+                    labeled = false;
+                }
+            } );
+
+            return labeled;
+        }
+
+        // Find runs in the specified rows and columns of image and join connected runs, returning
+        // false if some row has more runs than runs' arrays can keep
+        private unsafe bool LabelRows( UnmanagedImage image, int startX, int stopX, int startY, int stopY )
+        {
+            int pixelSize = Bitmap.GetPixelFormatSize( image.PixelFormat ) / 8;
+
+            byte thresholdR = backgroundThresholdR;
+            byte thresholdG = backgroundThresholdG;
+            byte thresholdB = backgroundThresholdB;
+
+            for ( int y = startY; y < stopY; y++ )
+            {
+                byte* src = (byte*) image.ImageData.ToPointer( ) + (long) y * image.Stride;
+                int runIndex = y * maxRunsInRow;
+                int runsCount = 0;
+                int x = startX;
+
+                if ( pixelSize == 1 )
+                {
+                    // grayscale image
+                    while ( x < stopX )
+                    {
+                        // skip background
+                        while ( ( x < stopX ) && ( src[x] <= thresholdG ) )
+                            x++;
+
+                        if ( x == stopX )
+                            break;
+
+                        if ( runsCount == maxRunsInRow )
+                            return false;
+
+                        int start = x;
+                        int sum = 0;
+                        long squaresSum = 0;
+
+                        for ( ; ( x < stopX ) && ( src[x] > thresholdG ); x++ )
+                        {
+                            int g = src[x];
+
+                            sum += g;
+                            squaresSum += g * g;
+                        }
+
+                        int k = runIndex + runsCount;
+
+                        runStart[k]  = start;
+                        runEnd[k]    = x - 1;
+                        runParent[k] = k;
+                        runSumR[k]   = runSumG[k] = runSumB[k] = sum;
+                        runSquaresSumR[k] = runSquaresSumG[k] = runSquaresSumB[k] = squaresSum;
+                        runsCount++;
+                    }
+                }
+                else
+                {
+                    // color image
+                    while ( x < stopX )
+                    {
+                        byte* p = src + x * pixelSize;
+
+                        // skip background
+                        while ( ( x < stopX ) &&
+                                ( p[RGB.R] <= thresholdR ) && ( p[RGB.G] <= thresholdG ) && ( p[RGB.B] <= thresholdB ) )
+                        {
+                            x++;
+                            p += pixelSize;
+                        }
+
+                        if ( x == stopX )
+                            break;
+
+                        if ( runsCount == maxRunsInRow )
+                            return false;
+
+                        int start = x;
+                        int sumR = 0, sumG = 0, sumB = 0;
+                        long squaresSumR = 0, squaresSumG = 0, squaresSumB = 0;
+
+                        for ( ; ( x < stopX ) &&
+                                ( ( p[RGB.R] > thresholdR ) || ( p[RGB.G] > thresholdG ) || ( p[RGB.B] > thresholdB ) );
+                                x++, p += pixelSize )
+                        {
+                            int r = p[RGB.R];
+                            int g = p[RGB.G];
+                            int b = p[RGB.B];
+
+                            sumR += r;
+                            sumG += g;
+                            sumB += b;
+                            squaresSumR += r * r;
+                            squaresSumG += g * g;
+                            squaresSumB += b * b;
+                        }
+
+                        int k = runIndex + runsCount;
+
+                        runStart[k]  = start;
+                        runEnd[k]    = x - 1;
+                        runParent[k] = k;
+                        runSumR[k] = sumR;
+                        runSumG[k] = sumG;
+                        runSumB[k] = sumB;
+                        runSquaresSumR[k] = squaresSumR;
+                        runSquaresSumG[k] = squaresSumG;
+                        runSquaresSumB[k] = squaresSumB;
+                        runsCount++;
+                    }
+                }
+
+                rowRunsCount[y] = runsCount;
+
+                // join runs with runs of the previous row
+                if ( y > startY )
+                {
+                    JoinRows( y - 1 );
+                }
+            }
+
+            return true;
+        }
+
+        // Join runs of the specified row with 8-connected runs of the next row
+        private void JoinRows( int y )
+        {
+            int i     = y * maxRunsInRow;
+            int iStop = i + rowRunsCount[y];
+            int j     = ( y + 1 ) * maxRunsInRow;
+            int jStop = j + rowRunsCount[y + 1];
+
+            while ( ( i < iStop ) && ( j < jStop ) )
+            {
+                // runs are connected if they overlap or touch diagonally
+                if ( ( runStart[i] <= runEnd[j] + 1 ) && ( runStart[j] <= runEnd[i] + 1 ) )
+                {
+                    Union( i, j );
+                }
+
+                // move to the next run of the row, which current run ends first
+                if ( runEnd[i] <= runEnd[j] )
+                    i++;
+                else
+                    j++;
+            }
+        }
+
+        // Find root of the run's set
+        private int Find( int k )
+        {
+            while ( runParent[k] != k )
+            {
+                // path halving
+                runParent[k] = runParent[runParent[k]];
+                k = runParent[k];
+            }
+            return k;
+        }
+
+        // Join sets of two runs - root of the joined set is the run, which goes first in the image
+        private void Union( int a, int b )
+        {
+            a = Find( a );
+            b = Find( b );
+
+            if ( a < b )
+                runParent[b] = a;
+            else if ( b < a )
+                runParent[a] = b;
+        }
+
+        // Assign labels to objects found in the specified rows and collect their information from runs,
+        // returning number of objects
+        private int CollectRuns( int startY, int stopY )
+        {
+            // number runs' sets in the order of their first runs (roots)
+            int labelsCount = 0;
+
+            for ( int y = startY; y < stopY; y++ )
+            {
+                for ( int k = y * maxRunsInRow, stop = k + rowRunsCount[y]; k < stop; k++ )
+                {
+                    int root = Find( k );
+
+                    // root goes before other runs of its set, so it is already labeled
+                    runLabel[k] = ( root == k ) ? ++labelsCount : runLabel[root];
+                }
+            }
+
+            AllocateObjectsInfo( labelsCount + 1 );
+
+            for ( int j = 1; j <= labelsCount; j++ )
+            {
+                objectX1[j] = imageWidth;
+                objectY1[j] = imageHeight;
+            }
+
+            for ( int y = startY; y < stopY; y++ )
+            {
+                for ( int k = y * maxRunsInRow, stop = k + rowRunsCount[y]; k < stop; k++ )
+                {
+                    int label = runLabel[k];
+                    int start = runStart[k];
+                    int end   = runEnd[k];
+                    int length = end - start + 1;
+
+                    if ( start < objectX1[label] )
+                        objectX1[label] = start;
+                    if ( end > objectX2[label] )
+                        objectX2[label] = end;
+                    if ( y < objectY1[label] )
+                        objectY1[label] = y;
+                    if ( y > objectY2[label] )
+                        objectY2[label] = y;
+
+                    objectArea[label] += length;
+                    objectXc[label]   += (long) ( start + end ) * length / 2;
+                    objectYc[label]   += (long) y * length;
+
+                    objectSumR[label] += runSumR[k];
+                    objectSumG[label] += runSumG[k];
+                    objectSumB[label] += runSumB[k];
+                    objectSquaresSumR[label] += runSquaresSumR[k];
+                    objectSquaresSumG[label] += runSquaresSumG[k];
+                    objectSquaresSumB[label] += runSquaresSumB[k];
+                }
+            }
+
+            return labelsCount;
+        }
+
+        // Fill objects' labels map for the specified rows
+        private unsafe void FillLabels( int startY, int stopY )
+        {
+            fixed ( int* labels = objectLabels )
+            {
+                for ( int y = startY; y < stopY; y++ )
+                {
+                    int* dst = labels + y * imageWidth;
+                    int x = 0;
+
+                    for ( int k = y * maxRunsInRow, stop = k + rowRunsCount[y]; k < stop; k++ )
+                    {
+                        int label = runLabel[k];
+
+                        for ( int end = runStart[k]; x < end; x++ )
+                            dst[x] = 0;
+                        for ( int end = runEnd[k]; x <= end; x++ )
+                            dst[x] = label;
+                    }
+
+                    for ( ; x < imageWidth; x++ )
+                        dst[x] = 0;
+                }
+            }
+        }
+
+        // Merge touching areas and extend areas to cover blobs they touch
+        private void ExtendAreas( List<Rectangle> areas, List<Blob> blobsByID )
+        {
+            bool changed = true;
+
+            while ( changed )
+            {
+                changed = false;
+
+                // extend areas to cover blobs touching them
+                for ( int i = 0; i < areas.Count; i++ )
+                {
+                    Rectangle area = ExtendArea( areas[i], blobsByID );
+
+                    if ( area != areas[i] )
+                    {
+                        areas[i] = area;
+                        changed = true;
+                    }
+                }
+
+                // merge areas touching each other
+                for ( int i = 0; i < areas.Count; i++ )
+                {
+                    for ( int j = areas.Count - 1; j > i; j-- )
+                    {
+                        if ( AreTouching( areas[i], areas[j] ) )
+                        {
+                            areas[i] = Rectangle.Union( areas[i], areas[j] );
+                            areas.RemoveAt( j );
+                            changed = true;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Extend area to cover blobs, which have pixels next to area's edges, and filtered out objects touching it
+        private unsafe Rectangle ExtendArea( Rectangle area, List<Blob> blobsByID )
+        {
+            Rectangle imageRect = new Rectangle( 0, 0, imageWidth, imageHeight );
+            Rectangle previousArea;
+
+            fixed ( int* labels = objectLabels )
+            {
+                do
+                {
+                    previousArea = area;
+
+                    // check pixels around the area
+                    Rectangle ring = area;
+
+                    ring.Inflate( 1, 1 );
+                    ring.Intersect( imageRect );
+
+                    for ( int y = ring.Top; y < ring.Bottom; y++ )
+                    {
+                        int* row = labels + y * imageWidth;
+                        bool inside = ( y >= previousArea.Top ) && ( y < previousArea.Bottom );
+                        int step = ( inside ) ? Math.Max( 1, ring.Width - 1 ) : 1;
+
+                        for ( int x = ring.Left; x < ring.Right; x += step )
+                        {
+                            int label = row[x];
+
+                            if ( ( label != 0 ) && ( !previousArea.Contains( x, y ) ) )
+                            {
+                                area = Rectangle.Union( area, blobsByID[label].Rectangle );
+                            }
+                        }
+                    }
+
+                    // objects removed by filtering are not labeled, so check their rectangles
+                    foreach ( Rectangle rect in filteredRectangles )
+                    {
+                        if ( ( AreTouching( previousArea, rect ) ) && ( !area.Contains( rect ) ) )
+                        {
+                            area = Rectangle.Union( area, rect );
+                        }
+                    }
+                }
+                while ( area != previousArea );
+            }
+
+            return area;
+        }
+
+        // Check if two rectangles overlap or touch each other (including diagonal touch)
+        private static bool AreTouching( Rectangle a, Rectangle b )
+        {
+            return ( a.Left <= b.Right ) && ( b.Left <= a.Right ) && ( a.Top <= b.Bottom ) && ( b.Top <= a.Bottom );
+        }
+
+        // Replace blobs of the labeled area by new blobs found in it
+        private unsafe void UpdateArea( Rectangle area, List<Blob> blobsByID )
+        {
+            // IDs of old blobs of the area, which can be given to new blobs
+            List<int> freeIDs = new List<int>( );
+
+            fixed ( int* labels = objectLabels )
+            {
+                for ( int y = area.Top; y < area.Bottom; y++ )
+                {
+                    int* row = labels + y * imageWidth;
+
+                    for ( int x = area.Left; x < area.Right; x++ )
+                    {
+                        int label = row[x];
+
+                        if ( ( label != 0 ) && ( blobsByID[label] != null ) )
+                        {
+                            freeIDs.Add( label );
+                            blobsByID[label] = null;
+                        }
+                    }
+                }
+            }
+            freeIDs.Sort( );
+
+            // objects removed by filtering, which touch the area, are covered by it now
+            filteredRectangles.RemoveAll( delegate( Rectangle rect ) { return area.Contains( rect ); } );
+
+            // create new blobs
+            int newObjectsCount = CollectRuns( area.Top, area.Bottom );
+            int[] newIDs = new int[newObjectsCount + 1];
+            int freeIndex = 0;
+
+            for ( int j = 1; j <= newObjectsCount; j++ )
+            {
+                Blob blob = CreateBlob( j, objectX1, objectY1, objectX2, objectY2, objectArea, objectXc, objectYc,
+                    objectSumR, objectSumG, objectSumB, objectSquaresSumR, objectSquaresSumG, objectSquaresSumB );
+
+                if ( IsBlobAccepted( blob ) )
+                {
+                    if ( freeIndex < freeIDs.Count )
+                    {
+                        blob.ID = freeIDs[freeIndex++];
+                        blobsByID[blob.ID] = blob;
+                    }
+                    else
+                    {
+                        blob.ID = ++objectsCount;
+                        blobsByID.Add( blob );
+                    }
+                    newIDs[j] = blob.ID;
+                }
+                else
+                {
+                    filteredRectangles.Add( blob.Rectangle );
+                }
+            }
+
+            // update objects' labels of the area
+            fixed ( int* labels = objectLabels )
+            {
+                for ( int y = area.Top; y < area.Bottom; y++ )
+                {
+                    int* dst = labels + y * imageWidth;
+                    int x = area.Left;
+
+                    for ( int k = y * maxRunsInRow, stop = k + rowRunsCount[y]; k < stop; k++ )
+                    {
+                        int label = newIDs[runLabel[k]];
+
+                        for ( int end = runStart[k]; x < end; x++ )
+                            dst[x] = 0;
+                        for ( int end = runEnd[k]; x <= end; x++ )
+                            dst[x] = label;
+                    }
+
+                    for ( ; x < area.Right; x++ )
+                        dst[x] = 0;
+                }
+            }
+
+            // give the rest of free IDs to blobs with the highest IDs
+            for ( int i = freeIDs.Count - 1; i >= freeIndex; i-- )
+            {
+                int freeID = freeIDs[i];
+
+                if ( freeID != objectsCount )
+                {
+                    Blob blob = blobsByID[objectsCount];
+
+                    RelabelBlob( blob, freeID );
+                    blobsByID[freeID] = blob;
+                }
+
+                blobsByID.RemoveAt( objectsCount );
+                objectsCount--;
+            }
+        }
+
+        // Change ID of the blob updating objects' labels
+        private unsafe void RelabelBlob( Blob blob, int newID )
+        {
+            Rectangle rect = blob.Rectangle;
+            int oldID = blob.ID;
+
+            fixed ( int* labels = objectLabels )
+            {
+                for ( int y = rect.Top; y < rect.Bottom; y++ )
+                {
+                    int* dst = labels + y * imageWidth;
+
+                    for ( int x = rect.Left; x < rect.Right; x++ )
+                    {
+                        if ( dst[x] == oldID )
+                            dst[x] = newID;
+                    }
+                }
+            }
+
+            blob.ID = newID;
+        }
+
+        // Allocate (or clear) arrays for objects' information
+        private void AllocateObjectsInfo( int size )
+        {
+            if ( ( objectArea == null ) || ( objectArea.Length < size ) )
+            {
+                // allocate a bit more, so the arrays are not reallocated for small changes of objects' count
+                int length = size + size / 2 + 16;
+
+                objectX1   = new int[length];
+                objectY1   = new int[length];
+                objectX2   = new int[length];
+                objectY2   = new int[length];
+                objectArea = new int[length];
+                objectXc   = new long[length];
+                objectYc   = new long[length];
+                objectSumR = new long[length];
+                objectSumG = new long[length];
+                objectSumB = new long[length];
+                objectSquaresSumR = new long[length];
+                objectSquaresSumG = new long[length];
+                objectSquaresSumB = new long[length];
+            }
+            else
+            {
+                Array.Clear( objectX2, 0, size );
+                Array.Clear( objectY2, 0, size );
+                Array.Clear( objectArea, 0, size );
+                Array.Clear( objectXc, 0, size );
+                Array.Clear( objectYc, 0, size );
+                Array.Clear( objectSumR, 0, size );
+                Array.Clear( objectSumG, 0, size );
+                Array.Clear( objectSumB, 0, size );
+                Array.Clear( objectSquaresSumR, 0, size );
+                Array.Clear( objectSquaresSumG, 0, size );
+                Array.Clear( objectSquaresSumB, 0, size );
+            }
+        }
+    }
+}
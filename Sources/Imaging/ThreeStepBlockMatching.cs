@@ -0,0 +1,119 @@
+﻿// AForge Image Processing Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2005-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Imaging
+{
+    using System;
+
+    /// <summary>
+    /// Block matching implementation with the three step search algorithm.
+    /// </summary>
+    ///
+    /// <remarks><para>The class implements three step search block matching algorithm
+    /// (see documentation for <see cref="IBlockMatching"/> for information about
+    /// block matching algorithms). The algorithm checks block's original location and 8 locations
+    /// around it at a distance of half of the search radius, then moves to the best of them and
+    /// repeats the check halving the distance until it becomes 1. So only about 8 * log2( SearchRadius )
+    /// locations are checked instead of all ( 2 * SearchRadius + 1 )<sup>2</sup> locations checked by
+    /// <see cref="ExhaustiveBlockMatching"/>.</para>
+    ///
+    /// <para><note>The algorithm assumes that difference of blocks grows monotonically with the distance
+    /// from the best match, so it may stop at a local minimum in the case of repetitive textures or
+    /// big displacements.</note></para>
+    ///
+    /// <para><note>The class processes only grayscale (8 bpp indexed) and color (24 bpp) images.</note></para>
+    ///
+    /// <para>Sample usage:</para>
+    /// <code>
+    /// // collect reference points using corners detector (for example)
+    /// SusanCornersDetector scd = new SusanCornersDetector( 30, 18 );
+    /// List&lt;IntPoint&gt; points = scd.ProcessImage( sourceImage );
+    ///
+    /// // create block matching algorithm's instance
+    /// ThreeStepBlockMatching bm = new ThreeStepBlockMatching( 8, 7 );
+    /// // process images searching for block matchings
+    /// List&lt;BlockMatch&gt; matches = bm.ProcessImage( sourceImage, points, searchImage );
+    /// </code>
+    /// </remarks>
+    ///
+    /// <seealso cref="ExhaustiveBlockMatching"/>
+    /// <seealso cref="DiamondBlockMatching"/>
+    ///
+    public class ThreeStepBlockMatching : BlockMatchingBase
+    {
+        /// <summary>
+        /// Initializes a new instance of the <see cref="ThreeStepBlockMatching"/> class.
+        /// </summary>
+        public ThreeStepBlockMatching( ) { }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="ThreeStepBlockMatching"/> class.
+        /// </summary>
+        ///
+        /// <param name="blockSize">Block size to search for.</param>
+        /// <param name="searchRadius">Search radius.</param>
+        ///
+        public ThreeStepBlockMatching( int blockSize, int searchRadius )
+            : base( blockSize, searchRadius ) { }
+
+        /// <summary>
+        /// Search for block's location with minimal difference within search window.
+        /// </summary>
+        ///
+        /// <param name="difference">Method to calculate difference of blocks for the specified displacement.</param>
+        /// <param name="sufficientDifference">Difference, which is small enough to stop search.</param>
+        /// <param name="minDifference">Difference of the best found location.</param>
+        ///
+        /// <returns>Returns displacement of the best found location of block in search image.</returns>
+        ///
+        protected override IntPoint SearchBlock( BlockDifference difference, int sufficientDifference, out int minDifference )
+        {
+            // initial step - the biggest power of 2, which is not greater than search radius
+            int step = 1;
+
+            while ( step * 2 <= SearchRadius )
+            {
+                step *= 2;
+            }
+
+            int centerX = 0, centerY = 0;
+            minDifference = difference( 0, 0, int.MaxValue );
+
+            for ( ; ( step >= 1 ) && ( minDifference > sufficientDifference ); step /= 2 )
+            {
+                int bestX = centerX, bestY = centerY;
+
+                // check 8 locations around the center
+                for ( int i = -1; i <= 1; i++ )
+                {
+                    for ( int j = -1; j <= 1; j++ )
+                    {
+                        if ( ( i == 0 ) && ( j == 0 ) )
+                            continue;
+
+                        int dx = centerX + j * step;
+                        int dy = centerY + i * step;
+                        int error = difference( dx, dy, minDifference );
+
+                        if ( error < minDifference )
+                        {
+                            minDifference = error;
+                            bestX = dx;
+                            bestY = dy;
+                        }
+                    }
+                }
+
+                centerX = bestX;
+                centerY = bestY;
+            }
+
+            return new IntPoint( centerX, centerY );
+        }
+    }
+}
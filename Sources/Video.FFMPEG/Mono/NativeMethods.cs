@@ -0,0 +1,126 @@
+﻿// AForge FFMPEG Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2009-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Video.FFMPEG
+{
+    using System;
+    using System.IO;
+    using System.Runtime.InteropServices;
+    using System.Text;
+
+    /// <summary>
+    /// P/Invoke declarations of native core of the library (aforge_ffmpeg).
+    /// </summary>
+    ///
+    /// <remarks><para>See <b>Native/aforge_ffmpeg.h</b> for description of the functions.</para></remarks>
+    ///
+    internal static class NativeMethods
+    {
+        private const string NativeLibrary = "aforge_ffmpeg";
+
+        // status codes, which need special handling
+        public const int Ok          = 0;
+        public const int EndOfStream = 1;
+        public const int ErrorOpenFile = -3;
+
+        // pixel formats of images
+        public const int PixelFormatBgr24 = 0;
+        public const int PixelFormatGray8 = 1;
+
+        // sizes of statistics' arrays
+        public const int StagesCount   = 6;
+        public const int HistogramBins = 20;
+
+        [StructLayout( LayoutKind.Sequential )]
+        public struct Statistics
+        {
+            [MarshalAs( UnmanagedType.ByValArray, SizeConst = StagesCount )]
+            public long[] Counts;
+            [MarshalAs( UnmanagedType.ByValArray, SizeConst = StagesCount )]
+            public long[] Times;
+            [MarshalAs( UnmanagedType.ByValArray, SizeConst = StagesCount )]
+            public long[] Bytes;
+            [MarshalAs( UnmanagedType.ByValArray, SizeConst = StagesCount * HistogramBins )]
+            public long[] Histogram;
+            public long LateFrames;
+        }
+
+        [StructLayout( LayoutKind.Sequential )]
+        public struct VideoInfo
+        {
+            public long FramesCount;
+            public int Width;
+            public int Height;
+            public int FrameRate;
+            public int StreamIndex;
+            [MarshalAs( UnmanagedType.ByValArray, SizeConst = 64 )]
+            public byte[] CodecName;
+        }
+
+        [DllImport( NativeLibrary, EntryPoint = "aforge_status_message", CallingConvention = CallingConvention.Cdecl )]
+        public static extern IntPtr StatusMessage( int status );
+
+        [DllImport( NativeLibrary, EntryPoint = "aforge_timestamp", CallingConvention = CallingConvention.Cdecl )]
+        public static extern long Timestamp( );
+
+        [DllImport( NativeLibrary, EntryPoint = "aforge_statistics_add", CallingConvention = CallingConvention.Cdecl )]
+        public static extern long StatisticsAdd( IntPtr statistics, int stage, long startTimestamp, long bytes );
+
+        [DllImport( NativeLibrary, EntryPoint = "aforge_statistics_read", CallingConvention = CallingConvention.Cdecl )]
+        public static extern void StatisticsRead( IntPtr statistics, out Statistics snapshot );
+
+        [DllImport( NativeLibrary, EntryPoint = "aforge_statistics_reset", CallingConvention = CallingConvention.Cdecl )]
+        public static extern void StatisticsReset( IntPtr statistics );
+
+        [DllImport( NativeLibrary, EntryPoint = "aforge_video_codecs_count", CallingConvention = CallingConvention.Cdecl )]
+        public static extern int VideoCodecsCount( );
+
+        [DllImport( NativeLibrary, EntryPoint = "aforge_video_reader_open", CallingConvention = CallingConvention.Cdecl )]
+        public static extern int ReaderOpen( byte[] fileName, IntPtr statistics, out IntPtr reader );
+
+        [DllImport( NativeLibrary, EntryPoint = "aforge_video_reader_get_info", CallingConvention = CallingConvention.Cdecl )]
+        public static extern int ReaderGetInfo( IntPtr reader, out VideoInfo info );
+
+        [DllImport( NativeLibrary, EntryPoint = "aforge_video_reader_read_frame", CallingConvention = CallingConvention.Cdecl )]
+        public static extern int ReaderReadFrame( IntPtr reader, IntPtr buffer, int stride );
+
+        [DllImport( NativeLibrary, EntryPoint = "aforge_video_reader_close", CallingConvention = CallingConvention.Cdecl )]
+        public static extern void ReaderClose( IntPtr reader );
+
+        [DllImport( NativeLibrary, EntryPoint = "aforge_video_writer_open", CallingConvention = CallingConvention.Cdecl )]
+        public static extern int WriterOpen( byte[] fileName, int width, int height, int frameRate, int codec, int bitRate,
+            IntPtr statistics, out IntPtr writer );
+
+        [DllImport( NativeLibrary, EntryPoint = "aforge_video_writer_write_frame", CallingConvention = CallingConvention.Cdecl )]
+        public static extern int WriterWriteFrame( IntPtr writer, IntPtr buffer, int stride, int pixelFormat, long pts );
+
+        [DllImport( NativeLibrary, EntryPoint = "aforge_video_writer_close", CallingConvention = CallingConvention.Cdecl )]
+        public static extern void WriterClose( IntPtr writer );
+
+        // Convert file name to zero terminated UTF-8 string expected by native core
+        public static byte[] ToNativeFileName( string fileName )
+        {
+            return Encoding.UTF8.GetBytes( fileName + '\0' );
+        }
+
+        // Throw exception corresponding to the error status returned by native core
+        public static void CheckStatus( int status )
+        {
+            if ( status < 0 )
+            {
+                string message = Marshal.PtrToStringAnsi( StatusMessage( status ) );
+
+                if ( status == ErrorOpenFile )
+                {
+                    throw new IOException( message );
+                }
+                throw new VideoException( message );
+            }
+        }
+    }
+}
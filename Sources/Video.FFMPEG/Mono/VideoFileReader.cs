@@ -0,0 +1,302 @@
+﻿// AForge FFMPEG Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2009-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Video.FFMPEG
+{
+    using System;
+    using System.Drawing;
+    using System.Drawing.Imaging;
+    using System.IO;
+    using System.Text;
+
+    /// <summary>
+    /// Class for reading video files utilizing FFmpeg library.
+    /// </summary>
+    ///
+    /// <remarks><para>The class is P/Invoke based counterpart of C++/CLI class of the library with the same
+    /// name, which allows reading video files under Mono or .NET on any platform. It requires native
+    /// core of the library (<b>aforge_ffmpeg</b> shared library built with CMake from <b>Native</b> folder)
+    /// and <b>FFmpeg</b> shared libraries to be available for loading.</para>
+    ///
+    /// <para>Sample usage:</para>
+    /// <code>
+    /// // create instance of video reader
+    /// VideoFileReader reader = new VideoFileReader( );
+    /// // open video file
+    /// reader.Open( "test.avi" );
+    /// // read 100 video frames out of it
+    /// for ( int i = 0; i &lt; 100; i++ )
+    /// {
+    ///     Bitmap videoFrame = reader.ReadVideoFrame( );
+    ///     // process the frame somehow
+    ///     // ...
+    ///
+    ///     // dispose the frame when it is no longer required
+    ///     videoFrame.Dispose( );
+    /// }
+    /// reader.Close( );
+    /// </code>
+    /// </remarks>
+    ///
+    public class VideoFileReader : IDisposable
+    {
+        // native reader
+        private IntPtr reader = IntPtr.Zero;
+        // statistics of video reading and if they are used by the native reader
+        private VideoStatistics statistics = new VideoStatistics( );
+        private bool statisticsAcquired = false;
+
+        private int width;
+        private int height;
+        private int frameRate;
+        private string codecName;
+        private long framesCount;
+
+        /// <summary>
+        /// Frame width of the opened video file.
+        /// </summary>
+        ///
+        /// <exception cref="IOException">Thrown if no video file was open.</exception>
+        ///
+        public int Width
+        {
+            get
+            {
+                CheckIfVideoFileIsOpen( );
+                return width;
+            }
+        }
+
+        /// <summary>
+        /// Frame height of the opened video file.
+        /// </summary>
+        ///
+        /// <exception cref="IOException">Thrown if no video file was open.</exception>
+        ///
+        public int Height
+        {
+            get
+            {
+                CheckIfVideoFileIsOpen( );
+                return height;
+            }
+        }
+
+        /// <summary>
+        /// Frame rate of the opened video file.
+        /// </summary>
+        ///
+        /// <exception cref="IOException">Thrown if no video file was open.</exception>
+        ///
+        public int FrameRate
+        {
+            get
+            {
+                CheckIfVideoFileIsOpen( );
+                return frameRate;
+            }
+        }
+
+        /// <summary>
+        /// Number of video frames in the opened video file.
+        /// </summary>
+        ///
+        /// <exception cref="IOException">Thrown if no video file was open.</exception>
+        ///
+        public long FrameCount
+        {
+            get
+            {
+                CheckIfVideoFileIsOpen( );
+                return framesCount;
+            }
+        }
+
+        /// <summary>
+        /// Name of codec used for encoding the opened video file.
+        /// </summary>
+        ///
+        /// <exception cref="IOException">Thrown if no video file was open.</exception>
+        ///
+        public string CodecName
+        {
+            get
+            {
+                CheckIfVideoFileIsOpen( );
+                return codecName;
+            }
+        }
+
+        /// <summary>
+        /// The property specifies if a video file is opened or not by this instance of the class.
+        /// </summary>
+        public bool IsOpen
+        {
+            get { return ( reader != IntPtr.Zero ); }
+        }
+
+        /// <summary>
+        /// Statistics of video reading stages.
+        /// </summary>
+        ///
+        /// <remarks><para>The property provides cumulative statistics of demuxing, decoding, conversion
+        /// and marshalling of video frames read by this instance of the class (see <see cref="VideoStatistics"/>).
+        /// The statistics is not reset on opening another video file.</para></remarks>
+        ///
+        public VideoStatistics Statistics
+        {
+            get { return statistics; }
+        }
+
+        /// <summary>
+        /// Object's finalizer.
+        /// </summary>
+        ///
+        ~VideoFileReader( )
+        {
+            Close( );
+        }
+
+        /// <summary>
+        /// Disposes the object and frees its resources.
+        /// </summary>
+        ///
+        public void Dispose( )
+        {
+            Close( );
+            GC.SuppressFinalize( this );
+        }
+
+        /// <summary>
+        /// Open video file with the specified name.
+        /// </summary>
+        ///
+        /// <param name="fileName">Video file name to open.</param>
+        ///
+        /// <exception cref="IOException">Cannot open video file with the specified name.</exception>
+        /// <exception cref="VideoException">A error occurred while opening the video file. See exception message.</exception>
+        ///
+        public void Open( string fileName )
+        {
+            // close previous file if any was open
+            Close( );
+
+            IntPtr newReader;
+            IntPtr nativeStatistics = statistics.Acquire( );
+            int status = NativeMethods.ReaderOpen( NativeMethods.ToNativeFileName( fileName ), nativeStatistics, out newReader );
+
+            if ( status != NativeMethods.Ok )
+            {
+                if ( nativeStatistics != IntPtr.Zero )
+                {
+                    statistics.Release( );
+                }
+                NativeMethods.CheckStatus( status );
+            }
+
+            reader = newReader;
+            statisticsAcquired = ( nativeStatistics != IntPtr.Zero );
+
+            // get some properties of the video file
+            NativeMethods.VideoInfo info;
+            status = NativeMethods.ReaderGetInfo( reader, out info );
+
+            if ( status != NativeMethods.Ok )
+            {
+                // the file was opened, so it must be closed
+                Close( );
+                NativeMethods.CheckStatus( status );
+            }
+
+            int codecNameLength = Array.IndexOf( info.CodecName, (byte) 0 );
+
+            width       = info.Width;
+            height      = info.Height;
+            frameRate   = info.FrameRate;
+            framesCount = info.FramesCount;
+            codecName   = Encoding.ASCII.GetString( info.CodecName, 0, ( codecNameLength >= 0 ) ? codecNameLength : info.CodecName.Length );
+        }
+
+        /// <summary>
+        /// Read next video frame of the currently opened video file.
+        /// </summary>
+        ///
+        /// <returns>Returns next video frame of the opened file or <see langword="null"/> if end of
+        /// file was reached. The returned video frame has 24 bpp color format.</returns>
+        ///
+        /// <exception cref="IOException">Thrown if no video file was open.</exception>
+        /// <exception cref="VideoException">A error occurred while reading next video frame. See exception message.</exception>
+        ///
+        public Bitmap ReadVideoFrame( )
+        {
+            if ( reader == IntPtr.Zero )
+            {
+                throw new IOException( "Cannot read video frames since video file is not open." );
+            }
+
+            long startTimestamp = NativeMethods.Timestamp( );
+
+            Bitmap bitmap = new Bitmap( width, height, PixelFormat.Format24bppRgb );
+
+            // lock the bitmap and read video frame directly into it
+            BitmapData bitmapData = bitmap.LockBits( new Rectangle( 0, 0, width, height ),
+                ImageLockMode.WriteOnly, PixelFormat.Format24bppRgb );
+
+            // reading is accounted by native core
+            long readingTimestamp = NativeMethods.Timestamp( );
+            int status = NativeMethods.ReaderReadFrame( reader, bitmapData.Scan0, bitmapData.Stride );
+            long readingTime = NativeMethods.Timestamp( ) - readingTimestamp;
+
+            bitmap.UnlockBits( bitmapData );
+
+            // account bitmap's allocation, locking and unlocking, excluding reading time
+            statistics.Add( VideoStage.Marshalling, startTimestamp + readingTime, (long) bitmapData.Stride * height );
+
+            if ( status != NativeMethods.Ok )
+            {
+                bitmap.Dispose( );
+
+                if ( status == NativeMethods.EndOfStream )
+                {
+                    return null;
+                }
+                NativeMethods.CheckStatus( status );
+            }
+
+            return bitmap;
+        }
+
+        /// <summary>
+        /// Close currently opened video file if any.
+        /// </summary>
+        ///
+        public void Close( )
+        {
+            if ( reader != IntPtr.Zero )
+            {
+                NativeMethods.ReaderClose( reader );
+                reader = IntPtr.Zero;
+
+                if ( statisticsAcquired )
+                {
+                    statistics.Release( );
+                    statisticsAcquired = false;
+                }
+            }
+        }
+
+        // Checks if video file was opened
+        private void CheckIfVideoFileIsOpen( )
+        {
+            if ( reader == IntPtr.Zero )
+            {
+                throw new IOException( "Video file is not open, so can not access its properties." );
+            }
+        }
+    }
+}
@@ -0,0 +1,395 @@
+﻿// AForge FFMPEG Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2009-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Video.FFMPEG
+{
+    using System;
+    using System.Drawing;
+    using System.Drawing.Imaging;
+    using System.IO;
+
+    /// <summary>
+    /// Class for writing video files utilizing FFmpeg library.
+    /// </summary>
+    ///
+    /// <remarks><para>The class is P/Invoke based counterpart of C++/CLI class of the library with the same
+    /// name, which allows writing video files under Mono or .NET on any platform. It requires native
+    /// core of the library (<b>aforge_ffmpeg</b> shared library built with CMake from <b>Native</b> folder)
+    /// and <b>FFmpeg</b> shared libraries to be available for loading.</para>
+    ///
+    /// <para>Sample usage:</para>
+    /// <code>
+    /// int width  = 320;
+    /// int height = 240;
+    ///
+    /// // create instance of video writer
+    /// VideoFileWriter writer = new VideoFileWriter( );
+    /// // create new video file
+    /// writer.Open( "test.avi", width, height, 25, VideoCodec.MPEG4 );
+    /// // create a bitmap to save into the video file
+    /// Bitmap image = new Bitmap( width, height, PixelFormat.Format24bppRgb );
+    /// // write 1000 video frames
+    /// for ( int i = 0; i &lt; 1000; i++ )
+    /// {
+    ///     image.SetPixel( i % width, i % height, Color.Red );
+    ///     writer.WriteVideoFrame( image );
+    /// }
+    /// writer.Close( );
+    /// </code>
+    /// </remarks>
+    ///
+    public class VideoFileWriter : IDisposable
+    {
+        // native writer
+        private IntPtr writer = IntPtr.Zero;
+        // statistics of video writing and if they are used by the native writer
+        private VideoStatistics statistics = new VideoStatistics( );
+        private bool statisticsAcquired = false;
+
+        private int width;
+        private int height;
+        private int frameRate;
+        private int bitRate;
+        private VideoCodec codec;
+
+        /// <summary>
+        /// Frame width of the opened video file.
+        /// </summary>
+        ///
+        /// <exception cref="IOException">Thrown if no video file was open.</exception>
+        ///
+        public int Width
+        {
+            get
+            {
+                CheckIfVideoFileIsOpen( );
+                return width;
+            }
+        }
+
+        /// <summary>
+        /// Frame height of the opened video file.
+        /// </summary>
+        ///
+        /// <exception cref="IOException">Thrown if no video file was open.</exception>
+        ///
+        public int Height
+        {
+            get
+            {
+                CheckIfVideoFileIsOpen( );
+                return height;
+            }
+        }
+
+        /// <summary>
+        /// Frame rate of the opened video file.
+        /// </summary>
+        ///
+        /// <exception cref="IOException">Thrown if no video file was open.</exception>
+        ///
+        public int FrameRate
+        {
+            get
+            {
+                CheckIfVideoFileIsOpen( );
+                return frameRate;
+            }
+        }
+
+        /// <summary>
+        /// Bit rate of the video stream.
+        /// </summary>
+        ///
+        /// <exception cref="IOException">Thrown if no video file was open.</exception>
+        ///
+        public int BitRate
+        {
+            get
+            {
+                CheckIfVideoFileIsOpen( );
+                return bitRate;
+            }
+        }
+
+        /// <summary>
+        /// Codec to use for the video file.
+        /// </summary>
+        ///
+        /// <exception cref="IOException">Thrown if no video file was open.</exception>
+        ///
+        public VideoCodec Codec
+        {
+            get
+            {
+                CheckIfVideoFileIsOpen( );
+                return codec;
+            }
+        }
+
+        /// <summary>
+        /// The property specifies if a video file is opened or not by this instance of the class.
+        /// </summary>
+        public bool IsOpen
+        {
+            get { return ( writer != IntPtr.Zero ); }
+        }
+
+        /// <summary>
+        /// Statistics of video writing stages.
+        /// </summary>
+        ///
+        /// <remarks><para>The property provides cumulative statistics of marshalling, conversion, encoding
+        /// and muxing of video frames written by this instance of the class (see <see cref="VideoStatistics"/>).
+        /// The statistics is not reset on opening another video file.</para></remarks>
+        ///
+        public VideoStatistics Statistics
+        {
+            get { return statistics; }
+        }
+
+        /// <summary>
+        /// Object's finalizer.
+        /// </summary>
+        ///
+        ~VideoFileWriter( )
+        {
+            Close( );
+        }
+
+        /// <summary>
+        /// Disposes the object and frees its resources.
+        /// </summary>
+        ///
+        public void Dispose( )
+        {
+            Close( );
+            GC.SuppressFinalize( this );
+        }
+
+        /// <summary>
+        /// Create video file with the specified name and attributes.
+        /// </summary>
+        ///
+        /// <param name="fileName">Video file name to create.</param>
+        /// <param name="width">Frame width of the video file.</param>
+        /// <param name="height">Frame height of the video file.</param>
+        ///
+        /// <remarks><para>See documentation to the <see cref="Open( string, int, int, int, VideoCodec, int )" />
+        /// for more information and the list of possible exceptions.</para></remarks>
+        ///
+        public void Open( string fileName, int width, int height )
+        {
+            Open( fileName, width, height, 25 );
+        }
+
+        /// <summary>
+        /// Create video file with the specified name and attributes.
+        /// </summary>
+        ///
+        /// <param name="fileName">Video file name to create.</param>
+        /// <param name="width">Frame width of the video file.</param>
+        /// <param name="height">Frame height of the video file.</param>
+        /// <param name="frameRate">Frame rate of the video file.</param>
+        ///
+        /// <remarks><para>See documentation to the <see cref="Open( string, int, int, int, VideoCodec, int )" />
+        /// for more information and the list of possible exceptions.</para></remarks>
+        ///
+        public void Open( string fileName, int width, int height, int frameRate )
+        {
+            Open( fileName, width, height, frameRate, VideoCodec.Default );
+        }
+
+        /// <summary>
+        /// Create video file with the specified name and attributes.
+        /// </summary>
+        ///
+        /// <param name="fileName">Video file name to create.</param>
+        /// <param name="width">Frame width of the video file.</param>
+        /// <param name="height">Frame height of the video file.</param>
+        /// <param name="frameRate">Frame rate of the video file.</param>
+        /// <param name="codec">Video codec to use for compression.</param>
+        ///
+        /// <remarks><para>See documentation to the <see cref="Open( string, int, int, int, VideoCodec, int )" />
+        /// for more information and the list of possible exceptions.</para></remarks>
+        ///
+        public void Open( string fileName, int width, int height, int frameRate, VideoCodec codec )
+        {
+            Open( fileName, width, height, frameRate, codec, 400000 );
+        }
+
+        /// <summary>
+        /// Create video file with the specified name and attributes.
+        /// </summary>
+        ///
+        /// <param name="fileName">Video file name to create.</param>
+        /// <param name="width">Frame width of the video file.</param>
+        /// <param name="height">Frame height of the video file.</param>
+        /// <param name="frameRate">Frame rate of the video file.</param>
+        /// <param name="codec">Video codec to use for compression.</param>
+        /// <param name="bitRate">Bit rate of the video stream.</param>
+        ///
+        /// <remarks><para>The methods creates new video file with the specified name.
+        /// If a file with such name already exists in the file system, it will be overwritten.</para></remarks>
+        ///
+        /// <exception cref="ArgumentException">Video file resolution must be a multiple of two.</exception>
+        /// <exception cref="ArgumentException">Invalid video codec is specified.</exception>
+        /// <exception cref="VideoException">A error occurred while creating new video file. See exception message.</exception>
+        /// <exception cref="IOException">Cannot open video file with the specified name.</exception>
+        ///
+        public void Open( string fileName, int width, int height, int frameRate, VideoCodec codec, int bitRate )
+        {
+            // close previous file if any open
+            Close( );
+
+            // check width and height
+            if ( ( ( width & 1 ) != 0 ) || ( ( height & 1 ) != 0 ) )
+            {
+                throw new ArgumentException( "Video file resolution must be a multiple of two." );
+            }
+
+            // check video codec
+            if ( ( (int) codec < -1 ) || ( (int) codec >= NativeMethods.VideoCodecsCount( ) ) )
+            {
+                throw new ArgumentException( "Invalid video codec is specified." );
+            }
+
+            IntPtr newWriter;
+            IntPtr nativeStatistics = statistics.Acquire( );
+            int status = NativeMethods.WriterOpen( NativeMethods.ToNativeFileName( fileName ),
+                width, height, frameRate, (int) codec, bitRate, nativeStatistics, out newWriter );
+
+            if ( status != NativeMethods.Ok )
+            {
+                if ( nativeStatistics != IntPtr.Zero )
+                {
+                    statistics.Release( );
+                }
+                NativeMethods.CheckStatus( status );
+            }
+
+            writer = newWriter;
+            statisticsAcquired = ( nativeStatistics != IntPtr.Zero );
+
+            this.width     = width;
+            this.height    = height;
+            this.frameRate = frameRate;
+            this.codec     = codec;
+            this.bitRate   = bitRate;
+        }
+
+        /// <summary>
+        /// Write new video frame into currently opened video file.
+        /// </summary>
+        ///
+        /// <param name="frame">Bitmap to add as a new video frame.</param>
+        ///
+        /// <remarks><para>The specified bitmap must be either color 24 or 32 bpp image or grayscale 8 bpp (indexed) image.</para>
+        /// </remarks>
+        ///
+        /// <exception cref="IOException">Thrown if no video file was open.</exception>
+        /// <exception cref="ArgumentException">The provided bitmap must be 24 or 32 bpp color image or 8 bpp grayscale image.</exception>
+        /// <exception cref="ArgumentException">Bitmap size must be of the same as video size, which was specified on opening video file.</exception>
+        /// <exception cref="VideoException">A error occurred while writing new video frame. See exception message.</exception>
+        ///
+        public void WriteVideoFrame( Bitmap frame )
+        {
+            WriteVideoFrame( frame, TimeSpan.MinValue );
+        }
+
+        /// <summary>
+        /// Write new video frame with a specific timestamp into currently opened video file.
+        /// </summary>
+        ///
+        /// <param name="frame">Bitmap to add as a new video frame.</param>
+        /// <param name="timestamp">Frame timestamp, total time since recording started.</param>
+        ///
+        /// <remarks><para>The specified bitmap must be either color 24 or 32 bpp image or grayscale 8 bpp (indexed) image.</para>
+        /// </remarks>
+        ///
+        /// <exception cref="IOException">Thrown if no video file was open.</exception>
+        /// <exception cref="ArgumentException">The provided bitmap must be 24 or 32 bpp color image or 8 bpp grayscale image.</exception>
+        /// <exception cref="ArgumentException">Bitmap size must be of the same as video size, which was specified on opening video file.</exception>
+        /// <exception cref="VideoException">A error occurred while writing new video frame. See exception message.</exception>
+        ///
+        public void WriteVideoFrame( Bitmap frame, TimeSpan timestamp )
+        {
+            if ( writer == IntPtr.Zero )
+            {
+                throw new IOException( "A video file was not opened yet." );
+            }
+
+            if ( ( frame.PixelFormat != PixelFormat.Format24bppRgb ) &&
+                 ( frame.PixelFormat != PixelFormat.Format32bppArgb ) &&
+                 ( frame.PixelFormat != PixelFormat.Format32bppPArgb ) &&
+                 ( frame.PixelFormat != PixelFormat.Format32bppRgb ) &&
+                 ( frame.PixelFormat != PixelFormat.Format8bppIndexed ) )
+            {
+                throw new ArgumentException( "The provided bitmap must be 24 or 32 bpp color image or 8 bpp grayscale image." );
+            }
+
+            if ( ( frame.Width != width ) || ( frame.Height != height ) )
+            {
+                throw new ArgumentException( "Bitmap size must be of the same as video size, which was specified on opening video file." );
+            }
+
+            bool isGrayscale = ( frame.PixelFormat == PixelFormat.Format8bppIndexed );
+            long startTimestamp = NativeMethods.Timestamp( );
+
+            // lock the bitmap
+            BitmapData bitmapData = frame.LockBits( new Rectangle( 0, 0, width, height ), ImageLockMode.ReadOnly,
+                ( isGrayscale ) ? PixelFormat.Format8bppIndexed : PixelFormat.Format24bppRgb );
+
+            long pts = ( timestamp.Ticks >= 0 ) ? (long) ( timestamp.TotalSeconds * frameRate ) : -1;
+
+            // writing is accounted by native core
+            long writingTimestamp = NativeMethods.Timestamp( );
+            int status = NativeMethods.WriterWriteFrame( writer, bitmapData.Scan0, bitmapData.Stride,
+                ( isGrayscale ) ? NativeMethods.PixelFormatGray8 : NativeMethods.PixelFormatBgr24, pts );
+            long writingTime = NativeMethods.Timestamp( ) - writingTimestamp;
+
+            frame.UnlockBits( bitmapData );
+
+            // account bitmap's locking and unlocking, excluding writing time
+            statistics.Add( VideoStage.Marshalling, startTimestamp + writingTime, (long) bitmapData.Stride * height );
+
+            NativeMethods.CheckStatus( status );
+        }
+
+        /// <summary>
+        /// Close currently opened video file if any.
+        /// </summary>
+        ///
+        public void Close( )
+        {
+            if ( writer != IntPtr.Zero )
+            {
+                NativeMethods.WriterClose( writer );
+                writer = IntPtr.Zero;
+
+                if ( statisticsAcquired )
+                {
+                    statistics.Release( );
+                    statisticsAcquired = false;
+                }
+            }
+
+            width  = 0;
+            height = 0;
+        }
+
+        // Checks if video file was opened
+        private void CheckIfVideoFileIsOpen( )
+        {
+            if ( writer == IntPtr.Zero )
+            {
+                throw new IOException( "Video file is not open, so can not access its properties." );
+            }
+        }
+    }
+}
@@ -0,0 +1,293 @@
+﻿// AForge FFMPEG Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright © AForge.NET, 2009-2012
+// contacts@aforgenet.com
+//
+
+namespace AForge.Video.FFMPEG
+{
+    using System;
+    using System.Runtime.InteropServices;
+
+    /// <summary>
+    /// Enumeration of video processing stages, which are measured by <see cref="VideoStatistics"/>.
+    /// </summary>
+    public enum VideoStage
+    {
+        /// <summary>
+        /// Reading packets of video stream from video file (<b>av_read_frame</b>).
+        /// </summary>
+        Demuxing = 0,
+        /// <summary>
+        /// Decoding packets into video frames (<b>avcodec_decode_video2</b>).
+        /// </summary>
+        Decoding,
+        /// <summary>
+        /// Conversion of pixel format between video frames and bitmaps (<b>sws_scale</b>).
+        /// </summary>
+        Conversion,
+        /// <summary>
+        /// Allocation, locking and unlocking of managed bitmaps.
+        /// </summary>
+        Marshalling,
+        /// <summary>
+        /// Encoding video frames into packets (<b>avcodec_encode_video</b>).
+        /// </summary>
+        Encoding,
+        /// <summary>
+        /// Writing packets of video stream into video file (<b>av_interleaved_write_frame</b>).
+        /// </summary>
+        Muxing,
+    }
+
+    /// <summary>
+    /// Cumulative statistics of a single video processing stage.
+    /// </summary>
+    ///
+    /// <remarks><para>The structure is a part of <see cref="VideoStatisticsSnapshot"/>.</para></remarks>
+    ///
+    public struct VideoStageStatistics
+    {
+        /// <summary>
+        /// Video processing stage the statistics is collected for.
+        /// </summary>
+        public VideoStage Stage;
+
+        /// <summary>
+        /// Number of times the stage was performed.
+        /// </summary>
+        public long Count;
+
+        /// <summary>
+        /// Total time spent in the stage.
+        /// </summary>
+        public TimeSpan TotalTime;
+
+        /// <summary>
+        /// Total number of bytes processed by the stage.
+        /// </summary>
+        ///
+        /// <remarks><para>For demuxing, decoding, encoding and muxing it is size of video packets. For conversion
+        /// and marshalling it is size of produced/consumed images.</para></remarks>
+        ///
+        public long Bytes;
+
+        /// <summary>
+        /// Histogram of the stage's durations.
+        /// </summary>
+        ///
+        /// <remarks><para>Each bin of the histogram has twice wider range of durations than the previous bin.
+        /// Bin <b>i</b> counts durations, which are less than 2<sup>i</sup> microseconds
+        /// (but not less than 2<sup>i-1</sup> microseconds). The last bin counts all longer durations as well.
+        /// See <see cref="VideoStatistics.HistogramBins"/>.</para></remarks>
+        ///
+        public long[] Histogram;
+
+        /// <summary>
+        /// Average time spent in the stage.
+        /// </summary>
+        public TimeSpan AverageTime
+        {
+            get { return ( Count == 0 ) ? TimeSpan.Zero : new TimeSpan( TotalTime.Ticks / Count ); }
+        }
+    }
+
+    /// <summary>
+    /// Snapshot of video processing statistics.
+    /// </summary>
+    ///
+    /// <remarks><para>The structure is returned by <see cref="VideoStatistics.GetSnapshot"/>.</para></remarks>
+    ///
+    public struct VideoStatisticsSnapshot
+    {
+        /// <summary>
+        /// Statistics of all video processing stages, indexed by <see cref="VideoStage"/>.
+        /// </summary>
+        public VideoStageStatistics[] Stages;
+
+        /// <summary>
+        /// Number of frames provided later than required by real time playing.
+        /// </summary>
+        public long LateFrames;
+    }
+
+    /// <summary>
+    /// Cumulative per stage statistics of video reading and writing.
+    /// </summary>
+    ///
+    /// <remarks><para>The class is P/Invoke based counterpart of C++/CLI class of the library with the same
+    /// name. It collects number of times, total time, number of processed bytes and durations' histogram for
+    /// each <see cref="VideoStage">video processing stage</see> performed by <see cref="VideoFileReader"/>
+    /// and <see cref="VideoFileWriter"/>. The counters are kept in native memory and updated directly by
+    /// the native core of the library.</para>
+    ///
+    /// <para>Native memory of the statistics is freed on disposing the object, but not before all video
+    /// files, which were opened with the statistics, are closed. Video files opened after disposing the
+    /// object do not collect the statistics.</para>
+    /// </remarks>
+    ///
+    public class VideoStatistics : IDisposable
+    {
+        /// <summary>
+        /// Number of bins in stages' durations histograms.
+        /// </summary>
+        public const int HistogramBins = NativeMethods.HistogramBins;
+
+        // native statistics updated by native core of the library
+        private IntPtr statistics;
+        // number of video files, which use native statistics
+        private int references = 0;
+        private bool disposed = false;
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="VideoStatistics"/> class.
+        /// </summary>
+        ///
+        public VideoStatistics( )
+        {
+            statistics = Marshal.AllocHGlobal( Marshal.SizeOf( typeof( NativeMethods.Statistics ) ) );
+            NativeMethods.StatisticsReset( statistics );
+        }
+
+        /// <summary>
+        /// Object's finalizer.
+        /// </summary>
+        ///
+        ~VideoStatistics( )
+        {
+            Free( );
+        }
+
+        /// <summary>
+        /// Disposes the object and frees its resources.
+        /// </summary>
+        ///
+        public void Dispose( )
+        {
+            lock ( this )
+            {
+                disposed = true;
+                FreeIfUnused( );
+            }
+            GC.SuppressFinalize( this );
+        }
+
+        /// <summary>
+        /// Get snapshot of the collected statistics.
+        /// </summary>
+        ///
+        /// <returns>Returns copy of statistics collected since creation of the object or its last reset.</returns>
+        ///
+        /// <exception cref="ObjectDisposedException">The object was already disposed.</exception>
+        ///
+        public VideoStatisticsSnapshot GetSnapshot( )
+        {
+            NativeMethods.Statistics nativeSnapshot;
+
+            lock ( this )
+            {
+                CheckIfDisposed( );
+                NativeMethods.StatisticsRead( statistics, out nativeSnapshot );
+            }
+
+            VideoStatisticsSnapshot snapshot = new VideoStatisticsSnapshot( );
+
+            snapshot.Stages = new VideoStageStatistics[NativeMethods.StagesCount];
+            snapshot.LateFrames = nativeSnapshot.LateFrames;
+
+            for ( int i = 0; i < NativeMethods.StagesCount; i++ )
+            {
+                snapshot.Stages[i].Stage     = (VideoStage) i;
+                snapshot.Stages[i].Count     = nativeSnapshot.Counts[i];
+                snapshot.Stages[i].Bytes     = nativeSnapshot.Bytes[i];
+                // native core measures time in nanoseconds
+                snapshot.Stages[i].TotalTime = new TimeSpan( nativeSnapshot.Times[i] / 100 );
+                snapshot.Stages[i].Histogram = new long[HistogramBins];
+
+                Array.Copy( nativeSnapshot.Histogram, i * HistogramBins, snapshot.Stages[i].Histogram, 0, HistogramBins );
+            }
+
+            return snapshot;
+        }
+
+        /// <summary>
+        /// Reset all collected statistics.
+        /// </summary>
+        ///
+        /// <exception cref="ObjectDisposedException">The object was already disposed.</exception>
+        ///
+        public void Reset( )
+        {
+            lock ( this )
+            {
+                CheckIfDisposed( );
+                NativeMethods.StatisticsReset( statistics );
+            }
+        }
+
+        // Account one execution of the stage started at the specified timestamp (native statistics are
+        // locked, so they are not freed by disposing the object meanwhile; after that nothing is accounted)
+        internal void Add( VideoStage stage, long startTimestamp, long bytes )
+        {
+            lock ( this )
+            {
+                NativeMethods.StatisticsAdd( statistics, (int) stage, startTimestamp, bytes );
+            }
+        }
+
+        // Get native statistics to be updated by native core of the library, which are kept until
+        // the matching Release( ) call (returns IntPtr.Zero if the object was already disposed)
+        internal IntPtr Acquire( )
+        {
+            lock ( this )
+            {
+                if ( disposed )
+                {
+                    return IntPtr.Zero;
+                }
+
+                references++;
+                return statistics;
+            }
+        }
+
+        // Release native statistics, which were acquired for a video file
+        internal void Release( )
+        {
+            lock ( this )
+            {
+                references--;
+                FreeIfUnused( );
+            }
+        }
+
+        // Free native statistics if the object was disposed and no video file uses them
+        private void FreeIfUnused( )
+        {
+            if ( ( disposed ) && ( references <= 0 ) )
+            {
+                Free( );
+            }
+        }
+
+        private void Free( )
+        {
+            if ( statistics != IntPtr.Zero )
+            {
+                Marshal.FreeHGlobal( statistics );
+                statistics = IntPtr.Zero;
+            }
+        }
+
+        // Check if the object was already disposed
+        private void CheckIfDisposed( )
+        {
+            if ( disposed )
+            {
+                throw new ObjectDisposedException( "The object was already disposed." );
+            }
+        }
+    }
+}
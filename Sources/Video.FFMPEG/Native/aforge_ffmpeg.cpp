@@ -0,0 +1,1053 @@
+// AForge FFMPEG Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright  AForge.NET, 2009-2012
+// contacts@aforgenet.com
+//
+
+#include "aforge_ffmpeg.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined( _WIN32 )
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif
+
+extern "C"
+{
+#if defined( _MSC_VER )
+	// disable warnings about badly formed documentation from FFmpeg, which we don't need at all
+	#pragma warning(disable:4635)
+	// disable warning about conversion int64 to int32
+	#pragma warning(disable:4244)
+#endif
+
+	#include "libavformat/avformat.h"
+	#include "libavformat/avio.h"
+	#include "libavcodec/avcodec.h"
+	#include "libswscale/swscale.h"
+}
+
+// Atomic operations on 64 bit counters
+
+#if defined( _WIN32 )
+
+static inline long long atomic_add( volatile long long* value, long long delta )
+{
+	return InterlockedExchangeAdd64( value, delta );
+}
+
+static inline long long atomic_read( volatile long long* value )
+{
+	return InterlockedCompareExchange64( value, 0, 0 );
+}
+
+static inline void atomic_reset( volatile long long* value )
+{
+	InterlockedExchange64( value, 0 );
+}
+
+#else
+
+static inline long long atomic_add( volatile long long* value, long long delta )
+{
+	return __sync_fetch_and_add( value, delta );
+}
+
+static inline long long atomic_read( volatile long long* value )
+{
+	return __sync_val_compare_and_swap( value, 0, 0 );
+}
+
+static inline void atomic_reset( volatile long long* value )
+{
+	__sync_fetch_and_and( value, 0 );
+}
+
+#endif
+
+// Codecs available for writing
+
+// the tables are indexed by values of VideoCodec enumeration
+static const CodecID video_codecs[] =
+{
+	CODEC_ID_MPEG4,
+	CODEC_ID_WMV1,
+	CODEC_ID_WMV2,
+	CODEC_ID_MSMPEG4V2,
+	CODEC_ID_MSMPEG4V3,
+	CODEC_ID_H263P,
+	CODEC_ID_FLV1,
+	CODEC_ID_MPEG2VIDEO,
+	CODEC_ID_RAWVIDEO
+};
+
+static const PixelFormat pixel_formats[] =
+{
+	PIX_FMT_YUV420P,
+	PIX_FMT_YUV420P,
+	PIX_FMT_YUV420P,
+	PIX_FMT_YUV420P,
+	PIX_FMT_YUV420P,
+	PIX_FMT_YUV420P,
+	PIX_FMT_YUV420P,
+	PIX_FMT_YUV420P,
+	PIX_FMT_BGR24,
+};
+
+static const int CODECS_COUNT = sizeof( video_codecs ) / sizeof( video_codecs[0] );
+
+// Number of video codecs available for writing
+int aforge_video_codecs_count( void )
+{
+	return CODECS_COUNT;
+}
+
+// Private data of video file reader
+struct aforge_video_reader
+{
+	AVFormatContext*	FormatContext;
+	AVStream*			VideoStream;
+	AVCodecContext*		CodecContext;
+	AVFrame*			VideoFrame;
+	struct SwsContext*	ConvertContext;
+
+	AVPacket Packet;
+	int BytesRemaining;
+
+	// decoding timestamps of the range set by seeking
+	long long StartTimestamp;
+	long long EndTimestamp;
+	bool EndReached;
+
+	aforge_statistics* Statistics;
+};
+
+// Private data of video file writer
+struct aforge_video_writer
+{
+	AVFormatContext*	FormatContext;
+	AVStream*			VideoStream;
+	AVFrame*			VideoFrame;
+	struct SwsContext*	ConvertContext;
+	struct SwsContext*	ConvertContextGrayscale;
+
+	uint8_t* VideoOutputBuffer;
+	int VideoOutputBufferSize;
+
+	int Width;
+	int Height;
+
+	aforge_statistics* Statistics;
+};
+
+// Status codes and statistics
+
+// Get text description of the specified status code
+const char* aforge_status_message( int status )
+{
+	switch ( status )
+	{
+	case AFORGE_OK:
+		return "Success.";
+	case AFORGE_END_OF_STREAM:
+		return "End of video stream was reached.";
+	case AFORGE_ERROR_INVALID_ARGUMENT:
+		return "Invalid argument.";
+	case AFORGE_ERROR_OUT_OF_MEMORY:
+		return "Out of memory.";
+	case AFORGE_ERROR_OPEN_FILE:
+		return "Cannot open the video file.";
+	case AFORGE_ERROR_STREAM_INFO:
+		return "Cannot find stream information.";
+	case AFORGE_ERROR_NO_VIDEO_STREAM:
+		return "Cannot find video stream in the specified file.";
+	case AFORGE_ERROR_NO_DECODER:
+		return "Cannot find codec to decode the video stream.";
+	case AFORGE_ERROR_NO_ENCODER:
+		return "Cannot find video codec.";
+	case AFORGE_ERROR_OPEN_CODEC:
+		return "Cannot open video codec.";
+	case AFORGE_ERROR_CONVERSION_CONTEXT:
+		return "Cannot initialize frames conversion context.";
+	case AFORGE_ERROR_DECODING:
+		return "Error while decoding frame.";
+	case AFORGE_ERROR_OUTPUT_FORMAT:
+		return "Cannot find suitable output format.";
+	case AFORGE_ERROR_FORMAT_CONTEXT:
+		return "Cannot allocate format context.";
+	case AFORGE_ERROR_NEW_STREAM:
+		return "Failed creating new video stream.";
+	case AFORGE_ERROR_FORMAT_PARAMETERS:
+		return "Failed configuring format context.";
+	case AFORGE_ERROR_ALLOCATE_PICTURE:
+		return "Cannot allocate video picture.";
+	case AFORGE_ERROR_WRITING:
+		return "Error while writing video frame.";
+	case AFORGE_ERROR_SEEKING:
+		return "Cannot seek to the key frame.";
+	}
+	return "Unknown error.";
+}
+
+// Get current monotonic timestamp in nanoseconds
+long long aforge_timestamp( void )
+{
+#if defined( _WIN32 )
+	static LARGE_INTEGER frequency = { 0 };
+	LARGE_INTEGER counter;
+
+	if ( frequency.QuadPart == 0 )
+	{
+		QueryPerformanceFrequency( &frequency );
+	}
+	QueryPerformanceCounter( &counter );
+
+	// split the conversion to avoid overflow
+	return ( counter.QuadPart / frequency.QuadPart ) * 1000000000LL +
+		( counter.QuadPart % frequency.QuadPart ) * 1000000000LL / frequency.QuadPart;
+#else
+	struct timespec time;
+
+	clock_gettime( CLOCK_MONOTONIC, &time );
+
+	return (long long) time.tv_sec * 1000000000LL + time.tv_nsec;
+#endif
+}
+
+// Account one execution of the stage
+long long aforge_statistics_add( aforge_statistics* statistics, int stage, long long startTimestamp, long long bytes )
+{
+	long long endTimestamp = aforge_timestamp( );
+
+	if ( ( statistics != NULL ) && ( stage >= 0 ) && ( stage < AFORGE_STAGES_COUNT ) )
+	{
+		long long elapsed = endTimestamp - startTimestamp;
+
+		// find histogram bin as position of the highest bit of duration in microseconds
+		long long microseconds = elapsed / 1000;
+		int bin = 0;
+
+		while ( ( microseconds > 0 ) && ( bin < AFORGE_HISTOGRAM_BINS - 1 ) )
+		{
+			microseconds >>= 1;
+			bin++;
+		}
+
+		atomic_add( &statistics->counts[stage], 1 );
+		atomic_add( &statistics->times[stage], elapsed );
+		atomic_add( &statistics->bytes[stage], bytes );
+		atomic_add( &statistics->histogram[stage * AFORGE_HISTOGRAM_BINS + bin], 1 );
+	}
+
+	return endTimestamp;
+}
+
+// Account a late video frame
+void aforge_statistics_add_late_frame( aforge_statistics* statistics )
+{
+	if ( statistics != NULL )
+	{
+		atomic_add( &statistics->frames_late, 1 );
+	}
+}
+
+// Atomically copy the statistics
+void aforge_statistics_read( aforge_statistics* statistics, aforge_statistics* snapshot )
+{
+	if ( ( statistics == NULL ) || ( snapshot == NULL ) )
+	{
+		return;
+	}
+
+	for ( int i = 0; i < AFORGE_STAGES_COUNT; i++ )
+	{
+		snapshot->counts[i] = atomic_read( &statistics->counts[i] );
+		snapshot->times[i]  = atomic_read( &statistics->times[i] );
+		snapshot->bytes[i]  = atomic_read( &statistics->bytes[i] );
+	}
+
+	for ( int i = 0; i < AFORGE_STAGES_COUNT * AFORGE_HISTOGRAM_BINS; i++ )
+	{
+		snapshot->histogram[i] = atomic_read( &statistics->histogram[i] );
+	}
+
+	snapshot->frames_late = atomic_read( &statistics->frames_late );
+}
+
+// Atomically reset all values of the statistics
+void aforge_statistics_reset( aforge_statistics* statistics )
+{
+	if ( statistics == NULL )
+	{
+		return;
+	}
+
+	for ( int i = 0; i < AFORGE_STAGES_COUNT; i++ )
+	{
+		atomic_reset( &statistics->counts[i] );
+		atomic_reset( &statistics->times[i] );
+		atomic_reset( &statistics->bytes[i] );
+	}
+
+	for ( int i = 0; i < AFORGE_STAGES_COUNT * AFORGE_HISTOGRAM_BINS; i++ )
+	{
+		atomic_reset( &statistics->histogram[i] );
+	}
+
+	atomic_reset( &statistics->frames_late );
+}
+
+// Video file reader
+
+// Free packet of the reader if it holds any data
+static void free_packet( aforge_video_reader* reader )
+{
+	if ( reader->Packet.data != NULL )
+	{
+		av_free_packet( &reader->Packet );
+		reader->Packet.data = NULL;
+	}
+}
+
+// Get decoding timestamp of the packet, which can be used for seeking
+static long long packet_timestamp( AVPacket* packet )
+{
+	return ( packet->dts != AFORGE_NO_TIMESTAMP ) ? packet->dts : packet->pts;
+}
+
+// Open video file for reading
+int aforge_video_reader_open( const char* fileName, aforge_statistics* statistics, aforge_video_reader** reader )
+{
+	return aforge_video_reader_open_stream( fileName, -1, 0, statistics, reader );
+}
+
+// Open the specified video stream of video file for reading
+int aforge_video_reader_open_stream( const char* fileName, int streamIndex, int threadsCount,
+									 aforge_statistics* statistics, aforge_video_reader** reader )
+{
+	if ( ( fileName == NULL ) || ( reader == NULL ) || ( threadsCount < 0 ) )
+	{
+		return AFORGE_ERROR_INVALID_ARGUMENT;
+	}
+
+	*reader = NULL;
+	av_register_all( );
+
+	aforge_video_reader* data = (aforge_video_reader*) calloc( 1, sizeof( aforge_video_reader ) );
+	if ( data == NULL )
+	{
+		return AFORGE_ERROR_OUT_OF_MEMORY;
+	}
+
+	av_init_packet( &data->Packet );
+	data->Packet.data = NULL;
+	data->Packet.size = 0;
+	data->Statistics  = statistics;
+	data->StartTimestamp = AFORGE_NO_TIMESTAMP;
+	data->EndTimestamp   = AFORGE_NO_TIMESTAMP;
+
+	int status = AFORGE_OK;
+
+	// open the specified video file
+	if ( av_open_input_file( &data->FormatContext, fileName, NULL, 0, NULL ) != 0 )
+	{
+		data->FormatContext = NULL;
+		status = AFORGE_ERROR_OPEN_FILE;
+	}
+	// retrieve stream information
+	else if ( av_find_stream_info( data->FormatContext ) < 0 )
+	{
+		status = AFORGE_ERROR_STREAM_INFO;
+	}
+	else
+	{
+		// search for the required video stream
+		for ( unsigned int i = 0; i < data->FormatContext->nb_streams; i++ )
+		{
+			if ( ( data->FormatContext->streams[i]->codec->codec_type == AVMEDIA_TYPE_VIDEO ) &&
+				 ( ( streamIndex < 0 ) || ( streamIndex == (int) i ) ) )
+			{
+				// get the pointer to the codec context for the video stream
+				data->CodecContext = data->FormatContext->streams[i]->codec;
+				data->VideoStream  = data->FormatContext->streams[i];
+				break;
+			}
+		}
+
+		if ( data->VideoStream == NULL )
+		{
+			status = AFORGE_ERROR_NO_VIDEO_STREAM;
+		}
+		else
+		{
+			// find decoder for the video stream
+			AVCodec* codec = avcodec_find_decoder( data->CodecContext->codec_id );
+
+			if ( codec == NULL )
+			{
+				data->CodecContext = NULL;
+				status = AFORGE_ERROR_NO_DECODER;
+			}
+			else
+			{
+				if ( threadsCount != 0 )
+				{
+					data->CodecContext->thread_count = threadsCount;
+				}
+
+				// open the codec
+				if ( avcodec_open( data->CodecContext, codec ) < 0 )
+				{
+					data->CodecContext = NULL;
+					status = AFORGE_ERROR_OPEN_CODEC;
+				}
+			}
+		}
+	}
+
+	if ( status == AFORGE_OK )
+	{
+		// allocate video frame
+		data->VideoFrame = avcodec_alloc_frame( );
+
+		// prepare scaling context to convert video format to RGB image
+		data->ConvertContext = sws_getContext( data->CodecContext->width, data->CodecContext->height, data->CodecContext->pix_fmt,
+				data->CodecContext->width, data->CodecContext->height, PIX_FMT_BGR24,
+				SWS_BICUBIC, NULL, NULL, NULL );
+
+		if ( data->VideoFrame == NULL )
+		{
+			status = AFORGE_ERROR_OUT_OF_MEMORY;
+		}
+		else if ( data->ConvertContext == NULL )
+		{
+			status = AFORGE_ERROR_CONVERSION_CONTEXT;
+		}
+	}
+
+	if ( status != AFORGE_OK )
+	{
+		aforge_video_reader_close( data );
+		return status;
+	}
+
+	*reader = data;
+	return AFORGE_OK;
+}
+
+// Get properties of the opened video file
+int aforge_video_reader_get_info( aforge_video_reader* reader, aforge_video_info* info )
+{
+	if ( ( reader == NULL ) || ( info == NULL ) )
+	{
+		return AFORGE_ERROR_INVALID_ARGUMENT;
+	}
+
+	info->width  = reader->CodecContext->width;
+	info->height = reader->CodecContext->height;
+	info->frame_rate   = reader->VideoStream->r_frame_rate.num / reader->VideoStream->r_frame_rate.den;
+	info->frames_count = reader->VideoStream->nb_frames;
+	info->stream_index = reader->VideoStream->index;
+
+	strncpy( info->codec_name, reader->CodecContext->codec->name, sizeof( info->codec_name ) - 1 );
+	info->codec_name[sizeof( info->codec_name ) - 1] = '\0';
+
+	return AFORGE_OK;
+}
+
+// Demux and decode next video frame
+int aforge_video_reader_decode_frame( aforge_video_reader* reader )
+{
+	if ( reader == NULL )
+	{
+		return AFORGE_ERROR_INVALID_ARGUMENT;
+	}
+
+	int frameFinished = 0;
+	int bytesDecoded;
+	bool exit = false;
+	long long timestamp;
+
+	while ( true )
+	{
+		// work on the current packet until we have decoded all of it
+		while ( reader->BytesRemaining > 0 )
+		{
+			// decode the next chunk of data
+			timestamp = aforge_timestamp( );
+			bytesDecoded = avcodec_decode_video2( reader->CodecContext, reader->VideoFrame, &frameFinished, &reader->Packet );
+			aforge_statistics_add( reader->Statistics, AFORGE_STAGE_DECODING, timestamp, ( bytesDecoded > 0 ) ? bytesDecoded : 0 );
+
+			// was there an error?
+			if ( bytesDecoded < 0 )
+			{
+				return AFORGE_ERROR_DECODING;
+			}
+
+			reader->BytesRemaining -= bytesDecoded;
+
+			// did we finish the current frame? Then we can return
+			if ( frameFinished )
+			{
+				return AFORGE_OK;
+			}
+		}
+
+		// read the next packet, skipping all packets that aren't
+		// for this stream or for the range set by seeking
+		while ( true )
+		{
+			// free old packet if any
+			free_packet( reader );
+
+			// read new packet
+			timestamp = aforge_timestamp( );
+			if ( ( reader->EndReached ) || ( av_read_frame( reader->FormatContext, &reader->Packet ) < 0 ) )
+			{
+				exit = true;
+				break;
+			}
+			aforge_statistics_add( reader->Statistics, AFORGE_STAGE_DEMUXING, timestamp, reader->Packet.size );
+
+			if ( reader->Packet.stream_index != reader->VideoStream->index )
+				continue;
+
+			long long packetTimestamp = packet_timestamp( &reader->Packet );
+
+			if ( packetTimestamp != AFORGE_NO_TIMESTAMP )
+			{
+				// skip packets preceding the range's key frame, if seeking was not precise
+				if ( ( reader->StartTimestamp != AFORGE_NO_TIMESTAMP ) && ( packetTimestamp < reader->StartTimestamp ) )
+					continue;
+
+				// stop on the range's end
+				if ( ( reader->EndTimestamp != AFORGE_NO_TIMESTAMP ) && ( packetTimestamp >= reader->EndTimestamp ) )
+				{
+					free_packet( reader );
+					reader->EndReached = true;
+					exit = true;
+					break;
+				}
+			}
+
+			// the range has started, so packets with smaller timestamps are not skipped anymore
+			reader->StartTimestamp = AFORGE_NO_TIMESTAMP;
+			break;
+		}
+
+		// exit ?
+		if ( exit )
+			break;
+
+		reader->BytesRemaining = reader->Packet.size;
+	}
+
+	// decode the rest of the last frame
+	timestamp = aforge_timestamp( );
+	avcodec_decode_video2( reader->CodecContext, reader->VideoFrame, &frameFinished, &reader->Packet );
+	aforge_statistics_add( reader->Statistics, AFORGE_STAGE_DECODING, timestamp, 0 );
+
+	// free last packet
+	free_packet( reader );
+
+	return ( frameFinished ) ? AFORGE_OK : AFORGE_END_OF_STREAM;
+}
+
+// Get presentation timestamp of the last decoded video frame
+long long aforge_video_reader_get_frame_timestamp( aforge_video_reader* reader )
+{
+	return ( reader != NULL ) ? reader->VideoFrame->best_effort_timestamp : AFORGE_NO_TIMESTAMP;
+}
+
+// Demux next packet of the video stream without decoding it
+int aforge_video_reader_read_packet( aforge_video_reader* reader, aforge_packet_info* info )
+{
+	if ( ( reader == NULL ) || ( info == NULL ) )
+	{
+		return AFORGE_ERROR_INVALID_ARGUMENT;
+	}
+
+	do
+	{
+		free_packet( reader );
+
+		long long timestamp = aforge_timestamp( );
+		if ( av_read_frame( reader->FormatContext, &reader->Packet ) < 0 )
+		{
+			return AFORGE_END_OF_STREAM;
+		}
+		aforge_statistics_add( reader->Statistics, AFORGE_STAGE_DEMUXING, timestamp, reader->Packet.size );
+	}
+	while ( reader->Packet.stream_index != reader->VideoStream->index );
+
+	info->pts = reader->Packet.pts;
+	info->dts = reader->Packet.dts;
+	info->key_frame = ( ( reader->Packet.flags & AV_PKT_FLAG_KEY ) != 0 ) ? 1 : 0;
+
+	free_packet( reader );
+	reader->BytesRemaining = 0;
+
+	return AFORGE_OK;
+}
+
+// Seek to the key frame with the specified decoding timestamp
+int aforge_video_reader_seek( aforge_video_reader* reader, long long startTimestamp, long long endTimestamp )
+{
+	if ( reader == NULL )
+	{
+		return AFORGE_ERROR_INVALID_ARGUMENT;
+	}
+
+	free_packet( reader );
+	reader->BytesRemaining = 0;
+
+	if ( av_seek_frame( reader->FormatContext, reader->VideoStream->index, startTimestamp, AVSEEK_FLAG_BACKWARD ) < 0 )
+	{
+		return AFORGE_ERROR_SEEKING;
+	}
+	avcodec_flush_buffers( reader->CodecContext );
+
+	reader->StartTimestamp = startTimestamp;
+	reader->EndTimestamp   = endTimestamp;
+	reader->EndReached     = false;
+
+	return AFORGE_OK;
+}
+
+// Convert last decoded video frame into the specified image buffer
+int aforge_video_reader_convert_frame( aforge_video_reader* reader, unsigned char* buffer, int stride )
+{
+	if ( ( reader == NULL ) || ( buffer == NULL ) )
+	{
+		return AFORGE_ERROR_INVALID_ARGUMENT;
+	}
+
+	uint8_t* dstData[4] = { buffer, NULL, NULL, NULL };
+	int dstLinesize[4] = { stride, 0, 0, 0 };
+
+	// convert video frame to the RGB image
+	long long timestamp = aforge_timestamp( );
+	sws_scale( reader->ConvertContext, reader->VideoFrame->data, reader->VideoFrame->linesize, 0,
+		reader->CodecContext->height, dstData, dstLinesize );
+	aforge_statistics_add( reader->Statistics, AFORGE_STAGE_CONVERSION, timestamp, (long long) stride * reader->CodecContext->height );
+
+	return AFORGE_OK;
+}
+
+// Read next video frame into the specified image buffer
+int aforge_video_reader_read_frame( aforge_video_reader* reader, unsigned char* buffer, int stride )
+{
+	int status = aforge_video_reader_decode_frame( reader );
+
+	if ( status == AFORGE_OK )
+	{
+		status = aforge_video_reader_convert_frame( reader, buffer, stride );
+	}
+
+	return status;
+}
+
+// Close video file and free the reader
+void aforge_video_reader_close( aforge_video_reader* reader )
+{
+	if ( reader == NULL )
+	{
+		return;
+	}
+
+	if ( reader->VideoFrame != NULL )
+	{
+		av_free( reader->VideoFrame );
+	}
+
+	if ( reader->CodecContext != NULL )
+	{
+		avcodec_close( reader->CodecContext );
+	}
+
+	if ( reader->FormatContext != NULL )
+	{
+		av_close_input_file( reader->FormatContext );
+	}
+
+	if ( reader->ConvertContext != NULL )
+	{
+		sws_freeContext( reader->ConvertContext );
+	}
+
+	free_packet( reader );
+	free( reader );
+}
+
+// Video file writer
+
+// Allocate picture of the specified format and size
+static AVFrame* alloc_picture( enum PixelFormat pix_fmt, int width, int height )
+{
+	AVFrame* picture;
+	void* picture_buf;
+	int size;
+
+	picture = avcodec_alloc_frame( );
+	if ( !picture )
+	{
+		return NULL;
+	}
+
+	size = avpicture_get_size( pix_fmt, width, height );
+	picture_buf = av_malloc( size );
+	if ( !picture_buf )
+	{
+		av_free( picture );
+		return NULL;
+	}
+
+	avpicture_fill( (AVPicture *) picture, (uint8_t *) picture_buf, pix_fmt, width, height );
+
+	return picture;
+}
+
+// Create new video stream and configure it
+static int add_video_stream( aforge_video_writer* data, int width, int height, int frameRate, int bitRate,
+							 enum CodecID codecId, enum PixelFormat pixelFormat )
+{
+	AVCodecContext* codecContex;
+
+	// create new stream
+	data->VideoStream = av_new_stream( data->FormatContext, 0 );
+	if ( !data->VideoStream )
+	{
+		return AFORGE_ERROR_NEW_STREAM;
+	}
+
+	codecContex = data->VideoStream->codec;
+	codecContex->codec_id   = codecId;
+	codecContex->codec_type = AVMEDIA_TYPE_VIDEO;
+
+	// put sample parameters
+	codecContex->bit_rate = bitRate;
+	codecContex->width    = width;
+	codecContex->height   = height;
+
+	// time base: this is the fundamental unit of time (in seconds) in terms
+	// of which frame timestamps are represented. for fixed-fps content,
+	// timebase should be 1/framerate and timestamp increments should be
+	// identically 1.
+	codecContex->time_base.den = frameRate;
+	codecContex->time_base.num = 1;
+
+	codecContex->gop_size = 12; // emit one intra frame every twelve frames at most
+	codecContex->pix_fmt  = pixelFormat;
+
+	if ( codecContex->codec_id == CODEC_ID_MPEG1VIDEO )
+	{
+		// Needed to avoid using macroblocks in which some coeffs overflow.
+		// This does not happen with normal video, it just happens here as
+		// the motion of the chroma plane does not match the luma plane.
+		codecContex->mb_decision = 2;
+	}
+
+	// some formats want stream headers to be separate
+	if ( data->FormatContext->oformat->flags & AVFMT_GLOBALHEADER )
+	{
+		codecContex->flags |= CODEC_FLAG_GLOBAL_HEADER;
+	}
+
+	return AFORGE_OK;
+}
+
+// Open video codec and prepare out buffer and picture
+static int open_video( aforge_video_writer* data )
+{
+	AVCodecContext* codecContext = data->VideoStream->codec;
+	AVCodec* codec = avcodec_find_encoder( codecContext->codec_id );
+
+	if ( !codec )
+	{
+		return AFORGE_ERROR_NO_ENCODER;
+	}
+
+	// open the codec
+	if ( avcodec_open( codecContext, codec ) < 0 )
+	{
+		return AFORGE_ERROR_OPEN_CODEC;
+	}
+
+	data->VideoOutputBuffer = NULL;
+	if ( !( data->FormatContext->oformat->flags & AVFMT_RAWPICTURE ) )
+	{
+		// allocate output buffer
+		data->VideoOutputBufferSize = 6 * codecContext->width * codecContext->height; // more than enough even for raw video
+		data->VideoOutputBuffer = (uint8_t*) av_malloc( data->VideoOutputBufferSize );
+
+		if ( !data->VideoOutputBuffer )
+		{
+			return AFORGE_ERROR_OUT_OF_MEMORY;
+		}
+	}
+
+	// allocate the encoded raw picture
+	data->VideoFrame = alloc_picture( codecContext->pix_fmt, codecContext->width, codecContext->height );
+
+	if ( !data->VideoFrame )
+	{
+		return AFORGE_ERROR_ALLOCATE_PICTURE;
+	}
+
+	// prepare scaling context to convert RGB image to video format
+	data->ConvertContext = sws_getContext( codecContext->width, codecContext->height, PIX_FMT_BGR24,
+			codecContext->width, codecContext->height, codecContext->pix_fmt,
+			SWS_BICUBIC, NULL, NULL, NULL );
+	// prepare scaling context to convert grayscale image to video format
+	data->ConvertContextGrayscale = sws_getContext( codecContext->width, codecContext->height, PIX_FMT_GRAY8,
+			codecContext->width, codecContext->height, codecContext->pix_fmt,
+			SWS_BICUBIC, NULL, NULL, NULL );
+
+	if ( ( data->ConvertContext == NULL ) || ( data->ConvertContextGrayscale == NULL ) )
+	{
+		return AFORGE_ERROR_CONVERSION_CONTEXT;
+	}
+
+	return AFORGE_OK;
+}
+
+// Create video file with the specified name and properties
+int aforge_video_writer_open( const char* fileName, int width, int height, int frameRate, int codec, int bitRate,
+							  aforge_statistics* statistics, aforge_video_writer** writer )
+{
+	if ( ( fileName == NULL ) || ( writer == NULL ) ||
+		 ( width <= 0 ) || ( height <= 0 ) || ( ( width & 1 ) != 0 ) || ( ( height & 1 ) != 0 ) ||
+		 ( frameRate <= 0 ) || ( codec < -1 ) || ( codec >= CODECS_COUNT ) )
+	{
+		return AFORGE_ERROR_INVALID_ARGUMENT;
+	}
+
+	*writer = NULL;
+	av_register_all( );
+
+	aforge_video_writer* data = (aforge_video_writer*) calloc( 1, sizeof( aforge_video_writer ) );
+	if ( data == NULL )
+	{
+		return AFORGE_ERROR_OUT_OF_MEMORY;
+	}
+
+	data->Width      = width;
+	data->Height     = height;
+	data->Statistics = statistics;
+
+	int status = AFORGE_OK;
+
+	// gues about destination file format from its file name
+	AVOutputFormat* outputFormat = av_guess_format( NULL, fileName, NULL );
+
+	if ( !outputFormat )
+	{
+		// gues about destination file format from its short name
+		outputFormat = av_guess_format( "mpeg", NULL, NULL );
+	}
+
+	if ( !outputFormat )
+	{
+		status = AFORGE_ERROR_OUTPUT_FORMAT;
+	}
+	else
+	{
+		// prepare format context
+		data->FormatContext = avformat_alloc_context( );
+
+		if ( !data->FormatContext )
+		{
+			status = AFORGE_ERROR_FORMAT_CONTEXT;
+		}
+	}
+
+	if ( status == AFORGE_OK )
+	{
+		data->FormatContext->oformat = outputFormat;
+
+		// add video stream using the specified video codec
+		status = add_video_stream( data, width, height, frameRate, bitRate,
+			( codec == -1 ) ? outputFormat->video_codec : video_codecs[codec],
+			( codec == -1 ) ? PIX_FMT_YUV420P : pixel_formats[codec] );
+	}
+
+	if ( status == AFORGE_OK )
+	{
+		// set the output parameters (must be done even if no parameters)
+		if ( av_set_parameters( data->FormatContext, NULL ) < 0 )
+		{
+			status = AFORGE_ERROR_FORMAT_PARAMETERS;
+		}
+		else
+		{
+			status = open_video( data );
+		}
+	}
+
+	if ( status == AFORGE_OK )
+	{
+		// open output file
+		if ( !( outputFormat->flags & AVFMT_NOFILE ) )
+		{
+			if ( avio_open( &data->FormatContext->pb, fileName, AVIO_FLAG_WRITE ) < 0 )
+			{
+				status = AFORGE_ERROR_OPEN_FILE;
+			}
+		}
+	}
+
+	if ( status != AFORGE_OK )
+	{
+		aforge_video_writer_close( data );
+		return status;
+	}
+
+	av_write_header( data->FormatContext );
+
+	*writer = data;
+	return AFORGE_OK;
+}
+
+// Write video frame from the specified image buffer
+int aforge_video_writer_write_frame( aforge_video_writer* writer, const unsigned char* buffer, int stride, int pixelFormat, long long pts )
+{
+	if ( ( writer == NULL ) || ( buffer == NULL ) ||
+		 ( ( pixelFormat != AFORGE_PIXEL_FORMAT_BGR24 ) && ( pixelFormat != AFORGE_PIXEL_FORMAT_GRAY8 ) ) )
+	{
+		return AFORGE_ERROR_INVALID_ARGUMENT;
+	}
+
+	const uint8_t* srcData[4] = { buffer, NULL, NULL, NULL };
+	int srcLinesize[4] = { stride, 0, 0, 0 };
+
+	// convert source image to the format of the video file
+	long long timestamp = aforge_timestamp( );
+
+	sws_scale( ( pixelFormat == AFORGE_PIXEL_FORMAT_GRAY8 ) ? writer->ConvertContextGrayscale : writer->ConvertContext,
+		srcData, srcLinesize, 0, writer->Height, writer->VideoFrame->data, writer->VideoFrame->linesize );
+
+	aforge_statistics_add( writer->Statistics, AFORGE_STAGE_CONVERSION, timestamp, (long long) stride * writer->Height );
+
+	if ( pts >= 0 )
+	{
+		writer->VideoFrame->pts = pts;
+	}
+
+	AVCodecContext* codecContext = writer->VideoStream->codec;
+	int out_size, ret = 0;
+
+	if ( writer->FormatContext->oformat->flags & AVFMT_RAWPICTURE )
+	{
+		// formats of raw pictures take the picture itself instead of encoded data
+		AVPacket packet;
+		av_init_packet( &packet );
+
+		packet.flags        |= AV_PKT_FLAG_KEY;
+		packet.stream_index  = writer->VideoStream->index;
+		packet.data          = (uint8_t*) writer->VideoFrame;
+		packet.size          = sizeof( AVPicture );
+
+		timestamp = aforge_timestamp( );
+		ret = av_interleaved_write_frame( writer->FormatContext, &packet );
+		aforge_statistics_add( writer->Statistics, AFORGE_STAGE_MUXING, timestamp, packet.size );
+	}
+	else
+	{
+		// encode the image
+		timestamp = aforge_timestamp( );
+		out_size = avcodec_encode_video( codecContext, writer->VideoOutputBuffer,
+			writer->VideoOutputBufferSize, writer->VideoFrame );
+		timestamp = aforge_statistics_add( writer->Statistics, AFORGE_STAGE_ENCODING, timestamp, ( out_size > 0 ) ? out_size : 0 );
+
+		// if zero size, it means the image was buffered
+		if ( out_size > 0 )
+		{
+			AVPacket packet;
+			av_init_packet( &packet );
+
+			if ( codecContext->coded_frame->pts != AFORGE_NO_TIMESTAMP )
+			{
+				packet.pts = av_rescale_q( codecContext->coded_frame->pts, codecContext->time_base, writer->VideoStream->time_base );
+			}
+
+			if ( codecContext->coded_frame->key_frame )
+			{
+				packet.flags |= AV_PKT_FLAG_KEY;
+			}
+
+			packet.stream_index = writer->VideoStream->index;
+			packet.data = writer->VideoOutputBuffer;
+			packet.size = out_size;
+
+			// write the compressed frame to the media file
+			ret = av_interleaved_write_frame( writer->FormatContext, &packet );
+			aforge_statistics_add( writer->Statistics, AFORGE_STAGE_MUXING, timestamp, out_size );
+		}
+	}
+
+	return ( ret != 0 ) ? AFORGE_ERROR_WRITING : AFORGE_OK;
+}
+
+// Finish writing video file and free the writer
+void aforge_video_writer_close( aforge_video_writer* writer )
+{
+	if ( writer == NULL )
+	{
+		return;
+	}
+
+	if ( writer->FormatContext )
+	{
+		if ( writer->FormatContext->pb != NULL )
+		{
+			av_write_trailer( writer->FormatContext );
+		}
+
+		if ( writer->VideoStream )
+		{
+			avcodec_close( writer->VideoStream->codec );
+		}
+
+		if ( writer->VideoFrame )
+		{
+			av_free( writer->VideoFrame->data[0] );
+			av_free( writer->VideoFrame );
+		}
+
+		if ( writer->VideoOutputBuffer )
+		{
+			av_free( writer->VideoOutputBuffer );
+		}
+
+		for ( unsigned int i = 0; i < writer->FormatContext->nb_streams; i++ )
+		{
+			av_freep( &writer->FormatContext->streams[i]->codec );
+			av_freep( &writer->FormatContext->streams[i] );
+		}
+
+		if ( writer->FormatContext->pb != NULL )
+		{
+			avio_close( writer->FormatContext->pb );
+		}
+
+		av_free( writer->FormatContext );
+	}
+
+	if ( writer->ConvertContext != NULL )
+	{
+		sws_freeContext( writer->ConvertContext );
+	}
+
+	if ( writer->ConvertContextGrayscale != NULL )
+	{
+		sws_freeContext( writer->ConvertContextGrayscale );
+	}
+
+	free( writer );
+}
+
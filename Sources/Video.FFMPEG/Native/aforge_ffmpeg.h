@@ -0,0 +1,208 @@
+// AForge FFMPEG Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright  AForge.NET, 2009-2012
+// contacts@aforgenet.com
+//
+// Native core of the library, which reads and writes video files utilizing
+// FFmpeg library. The core does not depend on .NET and exposes plain C interface,
+// so it is used by C++/CLI classes of the library on Windows and may be used
+// through P/Invoke (or directly from C/C++) on any platform supported by FFmpeg.
+//
+
+#ifndef AFORGE_FFMPEG_H
+#define AFORGE_FFMPEG_H
+
+#if defined( _WIN32 )
+	#if defined( AFORGE_FFMPEG_EXPORTS )
+		#define AFORGE_FFMPEG_API __declspec( dllexport )
+	#elif defined( AFORGE_FFMPEG_IMPORTS )
+		#define AFORGE_FFMPEG_API __declspec( dllimport )
+	#else
+		#define AFORGE_FFMPEG_API
+	#endif
+	#define AFORGE_FFMPEG_CALL __cdecl
+#else
+	#define AFORGE_FFMPEG_API __attribute__(( visibility( "default" ) ))
+	#define AFORGE_FFMPEG_CALL
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Status codes returned by the functions of the library
+enum aforge_status
+{
+	AFORGE_OK                          = 0,
+	AFORGE_END_OF_STREAM               = 1,
+	AFORGE_ERROR_INVALID_ARGUMENT      = -1,
+	AFORGE_ERROR_OUT_OF_MEMORY         = -2,
+	AFORGE_ERROR_OPEN_FILE             = -3,
+	AFORGE_ERROR_STREAM_INFO           = -4,
+	AFORGE_ERROR_NO_VIDEO_STREAM       = -5,
+	AFORGE_ERROR_NO_DECODER            = -6,
+	AFORGE_ERROR_NO_ENCODER            = -7,
+	AFORGE_ERROR_OPEN_CODEC            = -8,
+	AFORGE_ERROR_CONVERSION_CONTEXT    = -9,
+	AFORGE_ERROR_DECODING              = -10,
+	AFORGE_ERROR_OUTPUT_FORMAT         = -11,
+	AFORGE_ERROR_FORMAT_CONTEXT        = -12,
+	AFORGE_ERROR_NEW_STREAM            = -13,
+	AFORGE_ERROR_FORMAT_PARAMETERS     = -14,
+	AFORGE_ERROR_ALLOCATE_PICTURE      = -15,
+	AFORGE_ERROR_WRITING               = -16,
+	AFORGE_ERROR_SEEKING               = -17
+};
+
+// Pixel formats of images, which are read from or written to video files
+enum aforge_pixel_format
+{
+	// 24 bpp color image, blue-green-red byte order (as 24 bpp RGB image of .NET)
+	AFORGE_PIXEL_FORMAT_BGR24 = 0,
+	// 8 bpp grayscale image
+	AFORGE_PIXEL_FORMAT_GRAY8 = 1
+};
+
+// Video processing stages measured by statistics (same as VideoStage enumeration of the library)
+enum aforge_video_stage
+{
+	AFORGE_STAGE_DEMUXING = 0,
+	AFORGE_STAGE_DECODING,
+	AFORGE_STAGE_CONVERSION,
+	AFORGE_STAGE_MARSHALLING,
+	AFORGE_STAGE_ENCODING,
+	AFORGE_STAGE_MUXING,
+
+	AFORGE_STAGES_COUNT
+};
+
+#define AFORGE_HISTOGRAM_BINS 20
+
+// Value of unknown timestamp (same as AV_NOPTS_VALUE of FFmpeg)
+#define AFORGE_NO_TIMESTAMP ( -9223372036854775807LL - 1 )
+
+// Cumulative per stage statistics of video reading and writing. Times are in nanoseconds,
+// histograms' bin i counts durations less than 2^i microseconds. All fields are updated atomically,
+// so the structure may be shared by several readers/writers.
+typedef struct aforge_statistics
+{
+	long long counts[AFORGE_STAGES_COUNT];
+	long long times[AFORGE_STAGES_COUNT];
+	long long bytes[AFORGE_STAGES_COUNT];
+	long long histogram[AFORGE_STAGES_COUNT * AFORGE_HISTOGRAM_BINS];
+	long long frames_late;
+} aforge_statistics;
+
+// Properties of an opened video file (64 bit field goes first, so the structure has
+// the same layout regardless of alignment of 64 bit values)
+typedef struct aforge_video_info
+{
+	long long frames_count;
+	int width;
+	int height;
+	int frame_rate;
+	int stream_index;
+	char codec_name[64];
+} aforge_video_info;
+
+// Properties of a video packet, which was read without decoding. Timestamps are in units
+// of the video stream's time base (AFORGE_NO_TIMESTAMP if unknown).
+typedef struct aforge_packet_info
+{
+	long long pts;
+	long long dts;
+	int key_frame;
+} aforge_packet_info;
+
+typedef struct aforge_video_reader aforge_video_reader;
+typedef struct aforge_video_writer aforge_video_writer;
+
+// Get text description of the specified status code
+AFORGE_FFMPEG_API const char* AFORGE_FFMPEG_CALL aforge_status_message( int status );
+
+// Get current monotonic timestamp in nanoseconds
+AFORGE_FFMPEG_API long long AFORGE_FFMPEG_CALL aforge_timestamp( void );
+
+// Account one execution of the stage started at the specified timestamp, returning timestamp
+// of the stage's end (statistics may be NULL)
+AFORGE_FFMPEG_API long long AFORGE_FFMPEG_CALL aforge_statistics_add( aforge_statistics* statistics,
+	int stage, long long startTimestamp, long long bytes );
+
+// Account a video frame, which was provided later than required by real time playing
+AFORGE_FFMPEG_API void AFORGE_FFMPEG_CALL aforge_statistics_add_late_frame( aforge_statistics* statistics );
+
+// Atomically copy the statistics
+AFORGE_FFMPEG_API void AFORGE_FFMPEG_CALL aforge_statistics_read( aforge_statistics* statistics, aforge_statistics* snapshot );
+
+// Atomically reset all values of the statistics
+AFORGE_FFMPEG_API void AFORGE_FFMPEG_CALL aforge_statistics_reset( aforge_statistics* statistics );
+
+// Number of video codecs available for writing (values of VideoCodec enumeration of the library)
+AFORGE_FFMPEG_API int AFORGE_FFMPEG_CALL aforge_video_codecs_count( void );
+
+// Open video file with the specified UTF-8 name for reading (statistics may be NULL, but must
+// outlive the reader otherwise)
+AFORGE_FFMPEG_API int AFORGE_FFMPEG_CALL aforge_video_reader_open( const char* fileName,
+	aforge_statistics* statistics, aforge_video_reader** reader );
+
+// Open video stream with the specified index (-1 for the first video stream) of the video file,
+// limiting number of decoder's threads (0 for codec's default)
+AFORGE_FFMPEG_API int AFORGE_FFMPEG_CALL aforge_video_reader_open_stream( const char* fileName,
+	int streamIndex, int threadsCount, aforge_statistics* statistics, aforge_video_reader** reader );
+
+// Get properties of the opened video file
+AFORGE_FFMPEG_API int AFORGE_FFMPEG_CALL aforge_video_reader_get_info( aforge_video_reader* reader, aforge_video_info* info );
+
+// Demux and decode next video frame, keeping it inside of the reader. Returns AFORGE_END_OF_STREAM
+// if there are no more video frames.
+AFORGE_FFMPEG_API int AFORGE_FFMPEG_CALL aforge_video_reader_decode_frame( aforge_video_reader* reader );
+
+// Get presentation timestamp of the last decoded video frame in units of the video stream's
+// time base (AFORGE_NO_TIMESTAMP if unknown)
+AFORGE_FFMPEG_API long long AFORGE_FFMPEG_CALL aforge_video_reader_get_frame_timestamp( aforge_video_reader* reader );
+
+// Demux next packet of the video stream without decoding it. Returns AFORGE_END_OF_STREAM
+// if there are no more video packets.
+AFORGE_FFMPEG_API int AFORGE_FFMPEG_CALL aforge_video_reader_read_packet( aforge_video_reader* reader,
+	aforge_packet_info* info );
+
+// Seek to the key frame with the specified decoding timestamp and reset the decoder. Packets
+// preceding the key frame are skipped and packets starting from the specified end timestamp
+// (AFORGE_NO_TIMESTAMP for no limit) are treated as end of video stream.
+AFORGE_FFMPEG_API int AFORGE_FFMPEG_CALL aforge_video_reader_seek( aforge_video_reader* reader,
+	long long startTimestamp, long long endTimestamp );
+
+// Convert last decoded video frame into the specified 24 bpp BGR image buffer of the video's size
+AFORGE_FFMPEG_API int AFORGE_FFMPEG_CALL aforge_video_reader_convert_frame( aforge_video_reader* reader,
+	unsigned char* buffer, int stride );
+
+// Read next video frame into the specified 24 bpp BGR image buffer of the video's size
+// (decode and convert). Returns AFORGE_END_OF_STREAM if there are no more video frames.
+AFORGE_FFMPEG_API int AFORGE_FFMPEG_CALL aforge_video_reader_read_frame( aforge_video_reader* reader,
+	unsigned char* buffer, int stride );
+
+// Close video file and free the reader
+AFORGE_FFMPEG_API void AFORGE_FFMPEG_CALL aforge_video_reader_close( aforge_video_reader* reader );
+
+// Create video file with the specified UTF-8 name and properties. Codec is a value of
+// VideoCodec enumeration of the library (-1 for default codec of the file format).
+AFORGE_FFMPEG_API int AFORGE_FFMPEG_CALL aforge_video_writer_open( const char* fileName,
+	int width, int height, int frameRate, int codec, int bitRate,
+	aforge_statistics* statistics, aforge_video_writer** writer );
+
+// Write video frame from the specified image buffer of the video's size. Presentation
+// timestamp is set in frames, negative value keeps it as it is.
+AFORGE_FFMPEG_API int AFORGE_FFMPEG_CALL aforge_video_writer_write_frame( aforge_video_writer* writer,
+	const unsigned char* buffer, int stride, int pixelFormat, long long pts );
+
+// Finish writing video file and free the writer
+AFORGE_FFMPEG_API void AFORGE_FFMPEG_CALL aforge_video_writer_close( aforge_video_writer* writer );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AFORGE_FFMPEG_H
@@ -0,0 +1,191 @@
+// AForge FFMPEG Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright  AForge.NET, 2009-2012
+// contacts@aforgenet.com
+//
+// Round trip test of the native core: writes synthetic video file with
+// every available codec, reads it back and checks its properties.
+//
+
+#include "aforge_ffmpeg.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK( condition ) \
+	if ( !( condition ) ) \
+	{ \
+		fprintf( stderr, "%s(%d): check failed: %s\n", __FILE__, __LINE__, #condition ); \
+		failures++; \
+	}
+
+// Fill image with a moving gradient
+static void fill_image( unsigned char* image, int width, int height, int stride, int frame )
+{
+	for ( int y = 0; y < height; y++ )
+	{
+		unsigned char* row = image + y * stride;
+
+		for ( int x = 0; x < width; x++, row += 3 )
+		{
+			row[0] = (unsigned char) ( x + frame );
+			row[1] = (unsigned char) ( y + frame );
+			row[2] = (unsigned char) ( x + y );
+		}
+	}
+}
+
+// Write video file, read it back and check its frames (raw picture formats are not encoded
+// and are not seekable)
+static void test_round_trip( const char* fileName, int codec, bool rawPicture )
+{
+	const int width = 64, height = 48, frameRate = 25, framesCount = 30;
+	const int stride = width * 3;
+
+	unsigned char* image = (unsigned char*) malloc( stride * height );
+	aforge_statistics statistics;
+	memset( &statistics, 0, sizeof( statistics ) );
+
+	// write video file
+	aforge_video_writer* writer = NULL;
+	int status = aforge_video_writer_open( fileName, width, height, frameRate, codec, 400000, &statistics, &writer );
+
+	CHECK( status == AFORGE_OK );
+	if ( status != AFORGE_OK )
+	{
+		fprintf( stderr, "codec %d: %s\n", codec, aforge_status_message( status ) );
+		free( image );
+		return;
+	}
+
+	for ( int i = 0; i < framesCount; i++ )
+	{
+		fill_image( image, width, height, stride, i );
+		CHECK( aforge_video_writer_write_frame( writer, image, stride, AFORGE_PIXEL_FORMAT_BGR24, -1 ) == AFORGE_OK );
+	}
+	aforge_video_writer_close( writer );
+
+	CHECK( statistics.counts[AFORGE_STAGE_CONVERSION] == framesCount );
+	CHECK( statistics.counts[AFORGE_STAGE_ENCODING] == ( ( rawPicture ) ? 0 : framesCount ) );
+	CHECK( statistics.counts[AFORGE_STAGE_MUXING] > 0 );
+
+	// read it back
+	aforge_video_reader* reader = NULL;
+	aforge_video_info info;
+
+	status = aforge_video_reader_open( fileName, &statistics, &reader );
+	CHECK( status == AFORGE_OK );
+	if ( status != AFORGE_OK )
+	{
+		fprintf( stderr, "codec %d: %s\n", codec, aforge_status_message( status ) );
+		free( image );
+		return;
+	}
+
+	CHECK( aforge_video_reader_get_info( reader, &info ) == AFORGE_OK );
+	CHECK( info.width == width );
+	CHECK( info.height == height );
+
+	int framesRead = 0;
+
+	while ( ( status = aforge_video_reader_read_frame( reader, image, stride ) ) == AFORGE_OK )
+	{
+		framesRead++;
+	}
+	aforge_video_reader_close( reader );
+
+	CHECK( status == AFORGE_END_OF_STREAM );
+	CHECK( framesRead == framesCount );
+	CHECK( statistics.counts[AFORGE_STAGE_DECODING] > 0 );
+
+	// read packets without decoding, then seek to the first key frame and decode all frames again
+	status = ( rawPicture ) ? AFORGE_END_OF_STREAM :
+		aforge_video_reader_open_stream( fileName, info.stream_index, 1, NULL, &reader );
+	CHECK( status != AFORGE_ERROR_OPEN_FILE );
+	if ( status == AFORGE_OK )
+	{
+		aforge_packet_info packet;
+		long long firstKeyFrameTimestamp = AFORGE_NO_TIMESTAMP;
+		int packetsRead = 0;
+
+		while ( ( status = aforge_video_reader_read_packet( reader, &packet ) ) == AFORGE_OK )
+		{
+			if ( ( packet.key_frame != 0 ) && ( firstKeyFrameTimestamp == AFORGE_NO_TIMESTAMP ) )
+			{
+				firstKeyFrameTimestamp = ( packet.dts != AFORGE_NO_TIMESTAMP ) ? packet.dts : packet.pts;
+			}
+			packetsRead++;
+		}
+
+		CHECK( status == AFORGE_END_OF_STREAM );
+		CHECK( packetsRead == framesCount );
+		CHECK( firstKeyFrameTimestamp != AFORGE_NO_TIMESTAMP );
+
+		CHECK( aforge_video_reader_seek( reader, firstKeyFrameTimestamp, AFORGE_NO_TIMESTAMP ) == AFORGE_OK );
+
+		framesRead = 0;
+		while ( aforge_video_reader_decode_frame( reader ) == AFORGE_OK )
+		{
+			framesRead++;
+		}
+		CHECK( framesRead == framesCount );
+
+		aforge_video_reader_close( reader );
+	}
+
+	remove( fileName );
+	free( image );
+}
+
+int main( int argc, char* argv[] )
+{
+	const char* folder = ( argc > 1 ) ? argv[1] : ".";
+	char fileName[1024];
+
+	// invalid arguments
+	aforge_video_writer* writer = NULL;
+	aforge_video_reader* reader = NULL;
+
+	CHECK( aforge_video_writer_open( "odd.avi", 63, 48, 25, -1, 400000, NULL, &writer ) == AFORGE_ERROR_INVALID_ARGUMENT );
+	CHECK( aforge_video_writer_open( "codec.avi", 64, 48, 25, aforge_video_codecs_count( ), 400000, NULL, &writer ) == AFORGE_ERROR_INVALID_ARGUMENT );
+	CHECK( aforge_video_reader_open( "no such file.avi", NULL, &reader ) == AFORGE_ERROR_OPEN_FILE );
+	CHECK( reader == NULL );
+
+	// null handles
+	aforge_video_info info;
+	unsigned char pixel[3];
+
+	CHECK( aforge_video_reader_get_info( NULL, &info ) == AFORGE_ERROR_INVALID_ARGUMENT );
+	CHECK( aforge_video_reader_decode_frame( NULL ) == AFORGE_ERROR_INVALID_ARGUMENT );
+	CHECK( aforge_video_reader_read_frame( NULL, pixel, 3 ) == AFORGE_ERROR_INVALID_ARGUMENT );
+	CHECK( aforge_video_reader_seek( NULL, 0, AFORGE_NO_TIMESTAMP ) == AFORGE_ERROR_INVALID_ARGUMENT );
+	CHECK( aforge_video_reader_get_frame_timestamp( NULL ) == AFORGE_NO_TIMESTAMP );
+	CHECK( aforge_video_writer_write_frame( NULL, pixel, 3, AFORGE_PIXEL_FORMAT_BGR24, -1 ) == AFORGE_ERROR_INVALID_ARGUMENT );
+	aforge_video_reader_close( NULL );
+	aforge_video_writer_close( NULL );
+
+	// codecs, which can be stored in AVI container
+	for ( int codec = 0; codec < aforge_video_codecs_count( ); codec++ )
+	{
+		snprintf( fileName, sizeof( fileName ), "%s/aforge_ffmpeg_test_%d.avi", folder, codec );
+		test_round_trip( fileName, codec, false );
+	}
+
+	// YUV4MPEG format stores raw pictures
+	snprintf( fileName, sizeof( fileName ), "%s/aforge_ffmpeg_test.y4m", folder );
+	test_round_trip( fileName, -1, true );
+
+	if ( failures != 0 )
+	{
+		fprintf( stderr, "%d check(s) failed\n", failures );
+		return 1;
+	}
+
+	printf( "all checks passed\n" );
+	return 0;
+}
@@ -10,11 +10,6 @@
 
 using namespace System;
 
-extern int video_codecs[];
-extern int pixel_formats[];
-
-extern int CODECS_COUNT;
-
 namespace AForge { namespace Video { namespace FFMPEG
 {
 	/// <summary>
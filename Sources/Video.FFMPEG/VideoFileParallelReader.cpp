@@ -0,0 +1,350 @@
+// AForge FFMPEG Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright  AForge.NET, 2009-2012
+// contacts@aforgenet.com
+//
+
+#include "StdAfx.h"
+#include "VideoFileParallelReader.h"
+
+#include "Native\aforge_ffmpeg.h"
+
+using namespace System::Collections::Generic;
+
+namespace AForge { namespace Video { namespace FFMPEG
+{
+#pragma region Some private FFmpeg related stuff hidden out of header file
+
+// A structure to encapsulate native reader of a single decoder
+ref struct RangeDecoderData
+{
+public:
+	aforge_video_reader* Reader;
+
+	RangeDecoderData( )
+	{
+		Reader = NULL;
+	}
+};
+
+// Throws exception corresponding to the error status returned by native core
+static void check_status( int status )
+{
+	if ( status == AFORGE_ERROR_OPEN_FILE )
+	{
+		throw gcnew System::IO::IOException( gcnew String( aforge_status_message( status ) ) );
+	}
+	if ( status < 0 )
+	{
+		throw gcnew VideoException( gcnew String( aforge_status_message( status ) ) );
+	}
+}
+
+// Convert managed String to UTF8 unmanaged string, which must be freed with delete []
+static char* to_native_file_name( String^ fileName )
+{
+	IntPtr ptr = System::Runtime::InteropServices::Marshal::StringToHGlobalUni( fileName );
+	wchar_t* nativeFileNameUnicode = (wchar_t*) ptr.ToPointer( );
+	int utf8StringSize = WideCharToMultiByte( CP_UTF8, 0, nativeFileNameUnicode, -1, NULL, 0, NULL, NULL );
+	char* nativeFileName = new char[utf8StringSize];
+	WideCharToMultiByte( CP_UTF8, 0, nativeFileNameUnicode, -1, nativeFileName, utf8StringSize, NULL, NULL );
+	System::Runtime::InteropServices::Marshal::FreeHGlobal( ptr );
+
+	return nativeFileName;
+}
+
+// Convert last decoded video frame into managed Bitmap
+static Bitmap^ convert_video_frame( RangeDecoderData^ data, int width, int height )
+{
+	Bitmap^ bitmap = gcnew Bitmap( width, height, PixelFormat::Format24bppRgb );
+
+	// lock the bitmap
+	BitmapData^ bitmapData = bitmap->LockBits( System::Drawing::Rectangle( 0, 0, width, height ),
+		ImageLockMode::ReadOnly, PixelFormat::Format24bppRgb );
+
+	unsigned char* ptr = reinterpret_cast<unsigned char*>( static_cast<void*>( bitmapData->Scan0 ) );
+
+	// convert video frame to the RGB bitmap
+	int status = aforge_video_reader_convert_frame( data->Reader, ptr, bitmapData->Stride );
+
+	bitmap->UnlockBits( bitmapData );
+
+	if ( status != AFORGE_OK )
+	{
+		delete bitmap;
+		check_status( status );
+	}
+
+	return bitmap;
+}
+#pragma endregion
+
+// Class constructor
+VideoFileParallelReader::VideoFileParallelReader( void ) :
+	m_fileName( nullptr ), disposed( false )
+{
+	m_threadsCount = Environment::ProcessorCount;
+	m_minimumRangeLength = 100;
+}
+
+// Opens the specified video file and builds index of its key frames
+void VideoFileParallelReader::Open( String^ fileName )
+{
+	CheckIfDisposed( );
+
+	// close previous file if any was open
+	Close( );
+
+	char* nativeFileName = to_native_file_name( fileName );
+	RangeDecoderData^ data = gcnew RangeDecoderData( );
+
+	List<Int64>^ keyFrameIndexes    = gcnew List<Int64>( );
+	List<Int64>^ keyFrameTimestamps = gcnew List<Int64>( );
+	List<Int64>^ keyFramePresentationTimestamps = gcnew List<Int64>( );
+	List<Int64>^ frameTimestamps    = gcnew List<Int64>( );
+	bool allTimestampsKnown = true;
+	Int64 packetsCount = 0;
+
+	try
+	{
+		aforge_video_reader* reader = NULL;
+
+		check_status( aforge_video_reader_open_stream( nativeFileName, -1, 1, NULL, &reader ) );
+		data->Reader = reader;
+
+		// get some properties of the video file
+		aforge_video_info info;
+		check_status( aforge_video_reader_get_info( reader, &info ) );
+
+		m_width  = info.width;
+		m_height = info.height;
+		m_frameRate = info.frame_rate;
+		m_codecName = gcnew String( info.codec_name );
+		m_streamIndex = info.stream_index;
+
+		// read all packets of the video stream without decoding them, collecting key frames
+		// and presentation timestamps of all frames
+		aforge_packet_info packet;
+		int status;
+
+		while ( ( status = aforge_video_reader_read_packet( reader, &packet ) ) == AFORGE_OK )
+		{
+			Int64 timestamp = ( packet.dts != AFORGE_NO_TIMESTAMP ) ? packet.dts : packet.pts;
+
+			// only key frames with known and increasing timestamps can be used for seeking
+			if ( ( packet.key_frame != 0 ) && ( timestamp != AFORGE_NO_TIMESTAMP ) &&
+				 ( ( keyFrameTimestamps->Count == 0 ) || ( timestamp > keyFrameTimestamps[keyFrameTimestamps->Count - 1] ) ) )
+			{
+				keyFrameIndexes->Add( packetsCount );
+				keyFrameTimestamps->Add( timestamp );
+				keyFramePresentationTimestamps->Add( packet.pts );
+			}
+
+			if ( packet.pts != AFORGE_NO_TIMESTAMP )
+			{
+				frameTimestamps->Add( packet.pts );
+			}
+			else
+			{
+				allTimestampsKnown = false;
+			}
+
+			packetsCount++;
+		}
+		check_status( status );
+
+		if ( keyFrameIndexes->Count == 0 )
+		{
+			throw gcnew VideoException( "Cannot find key frames in the video stream." );
+		}
+
+		// merge consecutive GOPs into ranges of the minimum required length
+		List<int>^ rangeStarts = gcnew List<int>( );
+		rangeStarts->Add( 0 );
+
+		for ( int i = 1; i < keyFrameIndexes->Count; i++ )
+		{
+			if ( keyFrameIndexes[i] - keyFrameIndexes[rangeStarts[rangeStarts->Count - 1]] >= m_minimumRangeLength )
+			{
+				rangeStarts->Add( i );
+			}
+		}
+
+		// frames' presentation timestamps in display order, so position of a timestamp is index of the frame
+		if ( allTimestampsKnown )
+		{
+			frameTimestamps->Sort( );
+
+			// repeated timestamps don't identify frames, so they are counted instead
+			for ( int i = 1; i < frameTimestamps->Count; i++ )
+			{
+				if ( frameTimestamps[i] == frameTimestamps[i - 1] )
+				{
+					allTimestampsKnown = false;
+					break;
+				}
+			}
+
+			if ( allTimestampsKnown )
+			{
+				m_frameTimestamps = frameTimestamps->ToArray( );
+			}
+		}
+
+		m_framesCount        = packetsCount;
+		m_keyFrameIndexes    = keyFrameIndexes->ToArray( );
+		m_keyFrameTimestamps = keyFrameTimestamps->ToArray( );
+		m_keyFramePresentationTimestamps = keyFramePresentationTimestamps->ToArray( );
+		m_rangeStarts        = rangeStarts->ToArray( );
+		m_fileName           = fileName;
+	}
+	finally
+	{
+		delete [] nativeFileName;
+		aforge_video_reader_close( data->Reader );
+	}
+}
+
+// Close current video file
+void VideoFileParallelReader::Close( )
+{
+	m_fileName           = nullptr;
+	m_keyFrameIndexes    = nullptr;
+	m_keyFrameTimestamps = nullptr;
+	m_keyFramePresentationTimestamps = nullptr;
+	m_frameTimestamps    = nullptr;
+	m_rangeStarts        = nullptr;
+}
+
+// Decode all video frames of the current video file
+void VideoFileParallelReader::ReadAllFrames( IndexedFrameHandler^ frameHandler )
+{
+	CheckIfDisposed( );
+
+	if ( m_fileName == nullptr )
+	{
+		throw gcnew System::IO::IOException( "Cannot read video frames since video file is not open." );
+	}
+
+	if ( frameHandler == nullptr )
+	{
+		throw gcnew ArgumentNullException( "frameHandler" );
+	}
+
+	m_frameHandler    = frameHandler;
+	m_nextRange       = -1;
+	m_workerException = nullptr;
+
+	// no need to have more threads than ranges
+	int threadsCount = Math::Min( m_threadsCount, m_rangeStarts->Length );
+	array<Thread^>^ threads = gcnew array<Thread^>( threadsCount );
+
+	for ( int i = 0; i < threadsCount; i++ )
+	{
+		threads[i] = gcnew Thread( gcnew ThreadStart( this, &VideoFileParallelReader::WorkerThreadHandler ) );
+		threads[i]->Name = "AForge.Video.FFMPEG.VideoFileParallelReader";
+		threads[i]->IsBackground = true;
+		threads[i]->Start( );
+	}
+
+	for ( int i = 0; i < threadsCount; i++ )
+	{
+		threads[i]->Join( );
+	}
+
+	m_frameHandler = nullptr;
+
+	Exception^ exception = Interlocked::Exchange<Exception^>( m_workerException, nullptr );
+
+	if ( exception != nullptr )
+	{
+		throw exception;
+	}
+}
+
+// Worker thread, which takes ranges one by one and decodes them with its own decoder
+void VideoFileParallelReader::WorkerThreadHandler( )
+{
+	char* nativeFileName = to_native_file_name( m_fileName );
+	RangeDecoderData^ decoder = gcnew RangeDecoderData( );
+
+	try
+	{
+		aforge_video_reader* reader = NULL;
+
+		// each range is decoded by its own thread, so codec's own threading is not needed
+		check_status( aforge_video_reader_open_stream( nativeFileName, m_streamIndex, 1, NULL, &reader ) );
+		decoder->Reader = reader;
+
+		// stop taking new ranges as soon as any of the threads fails
+		while ( !IsDecodingFailed( ) )
+		{
+			int range = Interlocked::Increment( m_nextRange );
+
+			if ( range >= m_rangeStarts->Length )
+				break;
+
+			DecodeRange( decoder, range );
+		}
+	}
+	catch ( Exception^ exception )
+	{
+		Interlocked::CompareExchange<Exception^>( m_workerException, exception, nullptr );
+	}
+	finally
+	{
+		delete [] nativeFileName;
+		aforge_video_reader_close( decoder->Reader );
+	}
+}
+
+// Decode all frames of the specified range
+void VideoFileParallelReader::DecodeRange( RangeDecoderData^ data, int range )
+{
+	int   firstKeyFrame = m_rangeStarts[range];
+	bool  isLastRange   = ( range == m_rangeStarts->Length - 1 );
+	Int64 endTimestamp  = ( isLastRange ) ? AFORGE_NO_TIMESTAMP : m_keyFrameTimestamps[m_rangeStarts[range + 1]];
+	Int64 startPts      = m_keyFramePresentationTimestamps[firstKeyFrame];
+	// index of the previously emitted frame, which is used for frames with unknown timestamps
+	Int64 frameIndex    = m_keyFrameIndexes[firstKeyFrame] - 1;
+
+	// seek to the key frame the range starts from, so the reader stops on the key frame of the next range
+	check_status( aforge_video_reader_seek( data->Reader, m_keyFrameTimestamps[firstKeyFrame], endTimestamp ) );
+
+	while ( !IsDecodingFailed( ) )
+	{
+		int status = aforge_video_reader_decode_frame( data->Reader );
+
+		if ( status == AFORGE_END_OF_STREAM )
+			break;
+		check_status( status );
+
+		Int64 timestamp = aforge_video_reader_get_frame_timestamp( data->Reader );
+
+		// frames preceding range's key frame in presentation order (leading frames of open GOP)
+		// reference frames, which were not decoded after seeking, so they are corrupted
+		if ( ( startPts != AFORGE_NO_TIMESTAMP ) && ( timestamp != AFORGE_NO_TIMESTAMP ) && ( timestamp < startPts ) )
+			continue;
+
+		// find frame's index by its presentation timestamp, counting emitted frames if it is unknown
+		int   position  = ( ( m_frameTimestamps == nullptr ) || ( timestamp == AFORGE_NO_TIMESTAMP ) ) ? -1 :
+			Array::BinarySearch( m_frameTimestamps, timestamp );
+
+		frameIndex = ( position >= 0 ) ? position : frameIndex + 1;
+
+		Bitmap^ bitmap = convert_video_frame( data, m_width, m_height );
+
+		try
+		{
+			m_frameHandler( frameIndex, bitmap );
+		}
+		finally
+		{
+			delete bitmap;
+		}
+	}
+}
+
+} } }
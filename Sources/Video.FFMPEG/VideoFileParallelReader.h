@@ -0,0 +1,371 @@
+// AForge FFMPEG Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright  AForge.NET, 2009-2012
+// contacts@aforgenet.com
+//
+
+#pragma once
+
+using namespace System;
+using namespace System::Drawing;
+using namespace System::Drawing::Imaging;
+using namespace System::Threading;
+using namespace AForge::Video;
+
+namespace AForge { namespace Video { namespace FFMPEG
+{
+	ref struct RangeDecoderData;
+
+	/// <summary>
+	/// Delegate for notification about decoded video frame and its index.
+	/// </summary>
+	///
+	/// <param name="frameIndex">Zero based index of the video frame in the video file.</param>
+	/// <param name="frame">Decoded video frame (24 bpp color image).</param>
+	///
+	public delegate void IndexedFrameHandler( Int64 frameIndex, Bitmap^ frame );
+
+	/// <summary>
+	/// Class for decoding a single video file in parallel utilizing FFmpeg library.
+	/// </summary>
+	///
+	/// <remarks><para>The class is aimed for offline processing of long video files, where frames
+	/// may be processed out of their order. On opening a video file the class builds an index of its
+	/// key frames and splits the video stream into ranges, which start at a key frame (GOP aligned ranges).
+	/// Each range is decoded by its own decoder in its own thread, so a single video file can be decoded
+	/// with the speed, which scales with the number of CPU cores.</para>
+	///
+	/// <para>Decoded frames are passed to the provided <see cref="IndexedFrameHandler"/> delegate
+	/// together with their index in the video file. The delegate is invoked from multiple
+	/// threads simultaneously and frames come in arbitrary order (frames of the same range still
+	/// come in their order though). The video frame passed to the delegate is disposed after the delegate
+	/// returns, so clients must clone it if it is needed later.</para>
+	///
+	/// <para><note>Frames' indexes are found by their presentation timestamps among timestamps of all
+	/// video packets collected on opening a video file. If some timestamps are unknown or repeated, frames are
+	/// counted starting from the number of video packets preceding each range's key frame. For video files with
+	/// open GOPs (where frames following a key frame in decoding order, but preceding it in presentation order,
+	/// reference frames of the previous GOP) such frames are decoded corrupted after seeking, so frames with
+	/// presentation timestamp less than the one of range's key frame are dropped and not passed to the
+	/// delegate at all. Frames with unknown timestamps can not be checked this way.</note></para>
+	///
+	/// <para><note>Make sure you have <b>FFmpeg</b> binaries (DLLs) in the output folder of your application in order
+	/// to use this class successfully. <b>FFmpeg</b> binaries can be found in Externals folder provided with AForge.NET
+	/// framework's distribution.</note></para>
+	///
+	/// <para>Sample usage:</para>
+	/// <code>
+	/// // create instance of parallel video reader
+	/// VideoFileParallelReader reader = new VideoFileParallelReader( );
+	/// // open video file and build its key frames index
+	/// reader.Open( "test.mp4" );
+	/// Console.WriteLine( "ranges: " + reader.RangesCount );
+	/// // decode all frames of the file
+	/// reader.ReadAllFrames( delegate( long frameIndex, Bitmap frame )
+	/// {
+	///     // process the frame somehow
+	///     // ...
+	/// } );
+	/// reader.Close( );
+	/// </code>
+	/// </remarks>
+	///
+	public ref class VideoFileParallelReader : IDisposable
+	{
+	public:
+
+		/// <summary>
+		/// Frame width of the opened video file.
+		/// </summary>
+		///
+		/// <exception cref="System::IO::IOException">Thrown if no video file was open.</exception>
+		///
+		property int Width
+		{
+			int get( )
+			{
+				CheckIfVideoFileIsOpen( );
+				return m_width;
+			}
+		}
+
+		/// <summary>
+		/// Frame height of the opened video file.
+		/// </summary>
+		///
+		/// <exception cref="System::IO::IOException">Thrown if no video file was open.</exception>
+		///
+		property int Height
+		{
+			int get( )
+			{
+				CheckIfVideoFileIsOpen( );
+				return m_height;
+			}
+		}
+
+		/// <summary>
+		/// Frame rate of the opened video file.
+		/// </summary>
+		///
+		/// <exception cref="System::IO::IOException">Thrown if no video file was open.</exception>
+		///
+		property int FrameRate
+		{
+			int get( )
+			{
+				CheckIfVideoFileIsOpen( );
+				return m_frameRate;
+			}
+		}
+
+		/// <summary>
+		/// Number of video frames in the opened video file.
+		/// </summary>
+		///
+		/// <remarks><para>Unlike to <see cref="VideoFileReader::FrameCount"/>, the value is calculated by
+		/// counting video packets while building key frames index, so it does not depend on
+		/// information provided by file's header.</para></remarks>
+		///
+		/// <exception cref="System::IO::IOException">Thrown if no video file was open.</exception>
+		///
+		property Int64 FrameCount
+		{
+			Int64 get( )
+			{
+				CheckIfVideoFileIsOpen( );
+				return m_framesCount;
+			}
+		}
+
+		/// <summary>
+		/// Name of codec used for encoding the opened video file.
+		/// </summary>
+		///
+		/// <exception cref="System::IO::IOException">Thrown if no video file was open.</exception>
+		///
+		property String^ CodecName
+		{
+			String^ get( )
+			{
+				CheckIfVideoFileIsOpen( );
+				return m_codecName;
+			}
+		}
+
+		/// <summary>
+		/// Number of key frames found in the opened video file.
+		/// </summary>
+		///
+		/// <exception cref="System::IO::IOException">Thrown if no video file was open.</exception>
+		///
+		property int KeyFramesCount
+		{
+			int get( )
+			{
+				CheckIfVideoFileIsOpen( );
+				return m_keyFrameIndexes->Length;
+			}
+		}
+
+		/// <summary>
+		/// Number of ranges the opened video file is split into for parallel decoding.
+		/// </summary>
+		///
+		/// <exception cref="System::IO::IOException">Thrown if no video file was open.</exception>
+		///
+		property int RangesCount
+		{
+			int get( )
+			{
+				CheckIfVideoFileIsOpen( );
+				return m_rangeStarts->Length;
+			}
+		}
+
+		/// <summary>
+		/// Number of threads used for decoding.
+		/// </summary>
+		///
+		/// <remarks><para>Default value is set to the number of CPUs in the system.</para></remarks>
+		///
+		property int ThreadsCount
+		{
+			int get( )
+			{
+				return m_threadsCount;
+			}
+			void set( int threadsCount )
+			{
+				m_threadsCount = Math::Max( 1, threadsCount );
+			}
+		}
+
+		/// <summary>
+		/// Minimum number of frames in a single range.
+		/// </summary>
+		///
+		/// <remarks><para>Consecutive GOPs are merged into a single range until it has at least the
+		/// specified number of frames. Each range requires seeking in the video file and its decoder warming up,
+		/// so very short ranges decrease performance. The property must be set before opening a video
+		/// file.</para>
+		///
+		/// <para>Default value is set to <b>100</b>.</para>
+		/// </remarks>
+		///
+		property int MinimumRangeLength
+		{
+			int get( )
+			{
+				return m_minimumRangeLength;
+			}
+			void set( int minimumRangeLength )
+			{
+				m_minimumRangeLength = Math::Max( 1, minimumRangeLength );
+			}
+		}
+
+		/// <summary>
+		/// The property specifies if a video file is opened or not by this instance of the class.
+		/// </summary>
+		property bool IsOpen
+		{
+			bool get ( )
+			{
+				return ( m_fileName != nullptr );
+			}
+		}
+
+	protected:
+
+		/// <summary>
+		/// Object's finalizer.
+		/// </summary>
+		///
+		!VideoFileParallelReader( )
+		{
+			Close( );
+		}
+
+	public:
+
+		/// <summary>
+		/// Initializes a new instance of the <see cref="VideoFileParallelReader"/> class.
+		/// </summary>
+		///
+		VideoFileParallelReader( void );
+
+		/// <summary>
+		/// Disposes the object and frees its resources.
+		/// </summary>
+		///
+		~VideoFileParallelReader( )
+		{
+			this->!VideoFileParallelReader( );
+			disposed = true;
+		}
+
+		/// <summary>
+		/// Open video file with the specified name and build index of its key frames.
+		/// </summary>
+		///
+		/// <param name="fileName">Video file name to open.</param>
+		///
+		/// <remarks><para>The method reads all packets of the video file (without decoding them) to
+		/// find key frames, which can be used as starting points of parallel decoding.</para></remarks>
+		///
+		/// <exception cref="System::IO::IOException">Cannot open video file with the specified name.</exception>
+		/// <exception cref="VideoException">A error occurred while opening the video file. See exception message.</exception>
+		///
+		void Open( String^ fileName );
+
+		/// <summary>
+		/// Decode all video frames of the opened video file in parallel.
+		/// </summary>
+		///
+		/// <param name="frameHandler">Delegate to invoke for each decoded video frame.</param>
+		///
+		/// <remarks><para>The method blocks until all ranges of the video file are decoded. The
+		/// <paramref name="frameHandler"/> is invoked from <see cref="ThreadsCount"/> threads simultaneously,
+		/// so it must be thread safe.</para>
+		///
+		/// <para>If decoding of some range fails or the handler throws an exception, remaining ranges are
+		/// not processed and the first caught exception is thrown from the method after all threads finish.</para>
+		/// </remarks>
+		///
+		/// <exception cref="System::IO::IOException">Thrown if no video file was open.</exception>
+		/// <exception cref="ArgumentNullException">Frame handler is not specified.</exception>
+		/// <exception cref="VideoException">A error occurred while decoding video frames. See exception message.</exception>
+		///
+		void ReadAllFrames( IndexedFrameHandler^ frameHandler );
+
+		/// <summary>
+		/// Close currently opened video file if any.
+		/// </summary>
+		///
+		void Close( );
+
+	private:
+
+		int m_width;
+		int m_height;
+		int	m_frameRate;
+		String^ m_codecName;
+		Int64 m_framesCount;
+
+		int m_threadsCount;
+		int m_minimumRangeLength;
+
+		String^ m_fileName;
+		int m_streamIndex;
+
+		// indexes and timestamps of all key frames
+		array<Int64>^ m_keyFrameIndexes;
+		array<Int64>^ m_keyFrameTimestamps;
+		// presentation timestamps of all key frames (AFORGE_NO_TIMESTAMP if unknown)
+		array<Int64>^ m_keyFramePresentationTimestamps;
+		// sorted presentation timestamps of all frames (null if some are unknown or repeated)
+		array<Int64>^ m_frameTimestamps;
+		// index of the first key frame for each range
+		array<int>^ m_rangeStarts;
+
+		// state of the currently running parallel decoding
+		IndexedFrameHandler^ m_frameHandler;
+		int m_nextRange;
+		Exception^ m_workerException;
+
+	private:
+		void WorkerThreadHandler( );
+		void DecodeRange( RangeDecoderData^ decoder, int range );
+
+		// Checks if any of the worker threads failed (the exception is set by other threads)
+		bool IsDecodingFailed( )
+		{
+			return ( Interlocked::CompareExchange<Exception^>( m_workerException, nullptr, nullptr ) != nullptr );
+		}
+
+		// Checks if video file was opened
+		void CheckIfVideoFileIsOpen( )
+		{
+			if ( m_fileName == nullptr )
+			{
+				throw gcnew System::IO::IOException( "Video file is not open, so can not access its properties." );
+			}
+		}
+
+		// Check if the object was already disposed
+		void CheckIfDisposed( )
+		{
+			if ( disposed )
+			{
+				throw gcnew System::ObjectDisposedException( "The object was already disposed." );
+			}
+		}
+
+	private:
+		bool disposed;
+	};
+
+} } }
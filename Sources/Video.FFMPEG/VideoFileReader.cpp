@@ -9,21 +9,7 @@
 #include "StdAfx.h"
 #include "VideoFileReader.h"
 
-namespace libffmpeg
-{
-	extern "C"
-	{
-		// disable warnings about badly formed documentation from FFmpeg, which we don't need at all
-		#pragma warning(disable:4635) 
-		// disable warning about conversion int64 to int32
-		#pragma warning(disable:4244) 
-
-		#include "libavformat\avformat.h"
-		#include "libavformat\avio.h"
-		#include "libavcodec\avcodec.h"
-		#include "libswscale\swscale.h"
-	}
-}
+#include "Native\aforge_ffmpeg.h"
 
 namespace AForge { namespace Video { namespace FFMPEG
 {
@@ -33,48 +19,43 @@ namespace AForge { namespace Video { namespace FFMPEG
 ref struct ReaderPrivateData
 {
 public:
-	libffmpeg::AVFormatContext*		FormatContext;
-	libffmpeg::AVStream*			VideoStream;
-	libffmpeg::AVCodecContext*		CodecContext;
-	libffmpeg::AVFrame*				VideoFrame;
-	struct libffmpeg::SwsContext*	ConvertContext;
-
-	libffmpeg::AVPacket* Packet;
-	int BytesRemaining;
+	aforge_video_reader* Reader;
+	aforge_statistics*   Statistics;
 
 	ReaderPrivateData( )
 	{
-		FormatContext     = NULL;
-		VideoStream       = NULL;
-		CodecContext      = NULL;
-		VideoFrame        = NULL;
-		ConvertContext	  = NULL;
-
-		Packet  = NULL;
-		BytesRemaining = 0;
+		Reader     = NULL;
+		Statistics = NULL;
 	}
 };
+
+// Throws exception corresponding to the error status returned by native core
+static void check_status( int status )
+{
+	if ( status == AFORGE_ERROR_OPEN_FILE )
+	{
+		throw gcnew System::IO::IOException( gcnew String( aforge_status_message( status ) ) );
+	}
+	if ( status < 0 )
+	{
+		throw gcnew VideoException( gcnew String( aforge_status_message( status ) ) );
+	}
+}
 #pragma endregion
 
 // Class constructor
 VideoFileReader::VideoFileReader( void ) :
     data( nullptr ), disposed( false )
-{	
-	libffmpeg::av_register_all( );
+{
+	m_statistics = gcnew VideoStatistics( );
 }
 
-#pragma managed(push, off)
-static libffmpeg::AVFormatContext* open_file( char* fileName )
+// Class constructor, which shares statistics with its owner
+VideoFileReader::VideoFileReader( VideoStatistics^ statistics ) :
+    data( nullptr ), disposed( false )
 {
-	libffmpeg::AVFormatContext* formatContext;
-
-	if ( libffmpeg::av_open_input_file( &formatContext, fileName, NULL, 0, NULL ) !=0 )
-	{
-		return NULL;
-	}
-	return formatContext;
+	m_statistics = statistics;
 }
-#pragma managed(pop)
 
 // Opens the specified video file
 void VideoFileReader::Open( String^ fileName )
@@ -85,8 +66,6 @@ void VideoFileReader::Open( String^ fileName )
 	Close( );
 
 	data = gcnew ReaderPrivateData( );
-	data->Packet = new libffmpeg::AVPacket( );
-	data->Packet->data = NULL;
 
 	bool success = false;
 
@@ -100,66 +79,21 @@ void VideoFileReader::Open( String^ fileName )
 	try
 	{
 		// open the specified video file
-		data->FormatContext = open_file( nativeFileName );
-		if ( data->FormatContext == NULL )
-		{
-			throw gcnew System::IO::IOException( "Cannot open the video file." );
-		}
+		aforge_video_reader* reader = NULL;
 
-		// retrieve stream information
-		if ( libffmpeg::av_find_stream_info( data->FormatContext ) < 0 )
-		{
-			throw gcnew VideoException( "Cannot find stream information." );
-		}
-
-		// search for the first video stream
-		for ( unsigned int i = 0; i < data->FormatContext->nb_streams; i++ )
-		{
-			if( data->FormatContext->streams[i]->codec->codec_type == libffmpeg::AVMEDIA_TYPE_VIDEO )
-			{
-				// get the pointer to the codec context for the video stream
-				data->CodecContext = data->FormatContext->streams[i]->codec;
-				data->VideoStream  = data->FormatContext->streams[i];
-				break;
-			}
-		}
-		if ( data->VideoStream == NULL )
-		{
-			throw gcnew VideoException( "Cannot find video stream in the specified file." );
-		}
-
-		// find decoder for the video stream
-		libffmpeg::AVCodec* codec = libffmpeg::avcodec_find_decoder( data->CodecContext->codec_id );
-		if ( codec == NULL )
-		{
-			throw gcnew VideoException( "Cannot find codec to decode the video stream." );
-		}
-
-		// open the codec
-		if ( libffmpeg::avcodec_open( data->CodecContext, codec ) < 0 )
-		{
-			throw gcnew VideoException( "Cannot open video codec." );
-		}
-
-		// allocate video frame
-		data->VideoFrame = libffmpeg::avcodec_alloc_frame( );
-
-		// prepare scaling context to convert RGB image to video format
-		data->ConvertContext = libffmpeg::sws_getContext( data->CodecContext->width, data->CodecContext->height, data->CodecContext->pix_fmt,
-				data->CodecContext->width, data->CodecContext->height, libffmpeg::PIX_FMT_BGR24,
-				SWS_BICUBIC, NULL, NULL, NULL );
-
-		if ( data->ConvertContext == NULL )
-		{
-			throw gcnew VideoException( "Cannot initialize frames conversion context." );
-		}
+		data->Statistics = m_statistics->Acquire( );
+		check_status( aforge_video_reader_open( nativeFileName, data->Statistics, &reader ) );
+		data->Reader = reader;
 
 		// get some properties of the video file
-		m_width  = data->CodecContext->width;
-		m_height = data->CodecContext->height;
-		m_frameRate = data->VideoStream->r_frame_rate.num / data->VideoStream->r_frame_rate.den;
-		m_codecName = gcnew String( data->CodecContext->codec->name );
-		m_framesCount = data->VideoStream->nb_frames;
+		aforge_video_info info;
+		check_status( aforge_video_reader_get_info( reader, &info ) );
+
+		m_width  = info.width;
+		m_height = info.height;
+		m_frameRate = info.frame_rate;
+		m_codecName = gcnew String( info.codec_name );
+		m_framesCount = info.frames_count;
 
 		success = true;
 	}
@@ -180,31 +114,12 @@ void VideoFileReader::Close(  )
 {
 	if ( data != nullptr )
 	{
-		if ( data->VideoFrame != NULL )
-		{
-			libffmpeg::av_free( data->VideoFrame );
-		}
-
-		if ( data->CodecContext != NULL )
-		{
-			libffmpeg::avcodec_close( data->CodecContext );
-		}
-
-		if ( data->FormatContext != NULL )
-		{
-			libffmpeg::av_close_input_file( data->FormatContext );
-		}
+		aforge_video_reader_close( data->Reader );
 
-		if ( data->ConvertContext != NULL )
+		if ( data->Statistics != NULL )
 		{
-			libffmpeg::sws_freeContext( data->ConvertContext );
+			m_statistics->Release( );
 		}
-
-		if ( data->Packet->data != NULL )
-		{
-			libffmpeg::av_free_packet( data->Packet );
-		}
-
 		data = nullptr;
 	}
 }
@@ -219,103 +134,48 @@ Bitmap^ VideoFileReader::ReadVideoFrame(  )
 		throw gcnew System::IO::IOException( "Cannot read video frames since video file is not open." );
 	}
 
-	int frameFinished;
-	Bitmap^ bitmap = nullptr;
-
-	int bytesDecoded;
-	bool exit = false;
-
-	while ( true )
-	{
-		// work on the current packet until we have decoded all of it
-		while ( data->BytesRemaining > 0 )
-		{
-			// decode the next chunk of data
-			bytesDecoded = libffmpeg::avcodec_decode_video2( data->CodecContext, data->VideoFrame, &frameFinished, data->Packet );
-
-			// was there an error?
-			if ( bytesDecoded < 0 )
-			{
-				throw gcnew VideoException( "Error while decoding frame." );
-			}
-
-			data->BytesRemaining -= bytesDecoded;
-					 
-			// did we finish the current frame? Then we can return
-			if ( frameFinished )
-			{
-				return DecodeVideoFrame( );
-			}
-		}
-
-		// read the next packet, skipping all packets that aren't
-		// for this stream
-		do
-		{
-			// free old packet if any
-			if ( data->Packet->data != NULL )
-			{
-				libffmpeg::av_free_packet( data->Packet );
-				data->Packet->data = NULL;
-			}
-
-			// read new packet
-			if ( libffmpeg::av_read_frame( data->FormatContext, data->Packet ) < 0)
-			{
-				exit = true;
-				break;
-			}
-		}
-		while ( data->Packet->stream_index != data->VideoStream->index );
-
-		// exit ?
-		if ( exit )
-			break;
-
-		data->BytesRemaining = data->Packet->size;
-	}
-
-	// decode the rest of the last frame
-	bytesDecoded = libffmpeg::avcodec_decode_video2(
-		data->CodecContext, data->VideoFrame, &frameFinished, data->Packet );
-
-	// free last packet
-	if ( data->Packet->data != NULL )
-	{
-		libffmpeg::av_free_packet( data->Packet );
-		data->Packet->data = NULL;
-	}
+	int status = aforge_video_reader_decode_frame( data->Reader );
 
-	// is there a frame
-	if ( frameFinished )
+	if ( status == AFORGE_END_OF_STREAM )
 	{
-		bitmap = DecodeVideoFrame( );
+		return nullptr;
 	}
+	check_status( status );
 
-	return bitmap;
+	return DecodeVideoFrame( );
 }
 
 // Decodes video frame into managed Bitmap
 Bitmap^ VideoFileReader::DecodeVideoFrame( )
 {
-	Bitmap^ bitmap = gcnew Bitmap( data->CodecContext->width, data->CodecContext->height, PixelFormat::Format24bppRgb );
-	
+	Int64 startTimestamp = VideoStatistics::GetTimestamp( );
+
+	Bitmap^ bitmap = gcnew Bitmap( m_width, m_height, PixelFormat::Format24bppRgb );
+
 	// lock the bitmap
-	BitmapData^ bitmapData = bitmap->LockBits( System::Drawing::Rectangle( 0, 0, data->CodecContext->width, data->CodecContext->height ),
+	BitmapData^ bitmapData = bitmap->LockBits( System::Drawing::Rectangle( 0, 0, m_width, m_height ),
 		ImageLockMode::ReadOnly, PixelFormat::Format24bppRgb );
 
-	libffmpeg::uint8_t* ptr = reinterpret_cast<libffmpeg::uint8_t*>( static_cast<void*>( bitmapData->Scan0 ) );
-
-	libffmpeg::uint8_t* srcData[4] = { ptr, NULL, NULL, NULL };
-	int srcLinesize[4] = { bitmapData->Stride, 0, 0, 0 };
+	unsigned char* ptr = reinterpret_cast<unsigned char*>( static_cast<void*>( bitmapData->Scan0 ) );
+	Int64 imageSize = (Int64) bitmapData->Stride * m_height;
 
-	// convert video frame to the RGB bitmap
-	libffmpeg::sws_scale( data->ConvertContext, data->VideoFrame->data, data->VideoFrame->linesize, 0,
-		data->CodecContext->height, srcData, srcLinesize );
+	// convert video frame to the RGB bitmap (conversion is accounted by native core)
+	Int64 conversionTimestamp = VideoStatistics::GetTimestamp( );
+	int status = aforge_video_reader_convert_frame( data->Reader, ptr, bitmapData->Stride );
+	Int64 conversionTicks = VideoStatistics::GetTimestamp( ) - conversionTimestamp;
 
 	bitmap->UnlockBits( bitmapData );
 
+	// account bitmap's allocation, locking and unlocking, excluding conversion time
+	m_statistics->Add( VideoStage::Marshalling, startTimestamp + conversionTicks, imageSize );
+
+	if ( status != AFORGE_OK )
+	{
+		delete bitmap;
+		check_status( status );
+	}
+
 	return bitmap;
 }
 
-} } }
\ No newline at end of file
+} } }
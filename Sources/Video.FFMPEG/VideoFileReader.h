@@ -13,6 +13,8 @@ using namespace System::Drawing;
 using namespace System::Drawing::Imaging;
 using namespace AForge::Video;
 
+#include "VideoStatistics.h"
+
 namespace AForge { namespace Video { namespace FFMPEG
 {
 	ref struct ReaderPrivateData;
@@ -146,6 +148,22 @@ namespace AForge { namespace Video { namespace FFMPEG
 			}
 		}
 
+		/// <summary>
+		/// Statistics of video reading stages.
+		/// </summary>
+		///
+		/// <remarks><para>The property provides cumulative statistics of demuxing, decoding, conversion
+		/// and marshalling of video frames read by this instance of the class (see <see cref="VideoStatistics"/>).
+		/// The statistics is not reset on opening another video file.</para></remarks>
+		///
+		property VideoStatistics^ Statistics
+		{
+			VideoStatistics^ get( )
+			{
+				return m_statistics;
+			}
+		}
+
     protected:
 
         /// <summary>
@@ -165,6 +183,13 @@ namespace AForge { namespace Video { namespace FFMPEG
         /// 
 		VideoFileReader( void );
 
+	internal:
+
+		// Initializes a new instance of the class, which collects statistics into the specified object
+		VideoFileReader( VideoStatistics^ statistics );
+
+	public:
+
         /// <summary>
         /// Disposes the object and frees its resources.
         /// </summary>
@@ -236,6 +261,7 @@ namespace AForge { namespace Video { namespace FFMPEG
 	private:
 		// private data of the class
 		ReaderPrivateData^ data;
+		VideoStatistics^ m_statistics;
         bool disposed;
 	};
 
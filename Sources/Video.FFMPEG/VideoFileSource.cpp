@@ -21,6 +21,7 @@ VideoFileSource::VideoFileSource( String^ fileName )
 
 	m_frameIntervalFromSource = true;
 	m_frameInterval = 0;
+	m_statistics = gcnew VideoStatistics( );
 }
 
 void VideoFileSource::Start( )
@@ -87,7 +88,7 @@ void VideoFileSource::Free( )
 void VideoFileSource::WorkerThreadHandler( )
 {
 	ReasonToFinishPlaying reasonToStop = ReasonToFinishPlaying::StoppedByUser;
-	VideoFileReader^ videoReader = gcnew VideoFileReader( );
+	VideoFileReader^ videoReader = gcnew VideoFileReader( m_statistics );
 
 	try
 	{
@@ -131,6 +132,12 @@ void VideoFileSource::WorkerThreadHandler( )
                 // miliseconds to sleep
                 int msec = interval - (int) span->TotalMilliseconds;
 
+				// the frame took longer than frame interval, so it was not provided in time
+				if ( msec < 0 )
+				{
+					m_statistics->AddLateFrame( );
+				}
+
                 if ( ( msec > 0 ) && ( m_needToStop->WaitOne( msec, false ) == true ) )
 					break;
             }
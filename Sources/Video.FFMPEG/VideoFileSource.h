@@ -14,6 +14,8 @@ using namespace System::Drawing::Imaging;
 using namespace System::Threading;
 using namespace AForge::Video;
 
+#include "VideoStatistics.h"
+
 namespace AForge { namespace Video { namespace FFMPEG
 {
     /// <summary>
@@ -214,6 +216,24 @@ namespace AForge { namespace Video { namespace FFMPEG
 			}
         }
 
+		/// <summary>
+		/// Statistics of video playing stages.
+		/// </summary>
+		///
+		/// <remarks><para>The property provides cumulative statistics of video reading stages
+		/// (see <see cref="VideoStatistics"/>) for all runs of the video source. In addition to the
+		/// statistics collected by <see cref="VideoFileReader"/>, the video source counts frames, which
+		/// were provided later than required by the <see cref="FrameInterval">frame interval</see>
+		/// (<see cref="VideoStatisticsSnapshot::LateFrames"/>).</para></remarks>
+		///
+		property VideoStatistics^ Statistics
+		{
+			VideoStatistics^ get( )
+			{
+				return m_statistics;
+			}
+		}
+
 	public:
 
 		/// <summary>
@@ -275,6 +295,7 @@ namespace AForge { namespace Video { namespace FFMPEG
         int  m_bytesReceived;
 		bool m_frameIntervalFromSource;
 		int  m_frameInterval;
+		VideoStatistics^ m_statistics;
 
 
 	private:
@@ -9,61 +9,45 @@
 #include "StdAfx.h"
 #include "VideoFileWriter.h"
 
-namespace libffmpeg
-{
-	extern "C"
-	{
-		// disable warnings about badly formed documentation from FFmpeg, which don't need at all
-		#pragma warning(disable:4635) 
-		// disable warning about conversion int64 to int32
-		#pragma warning(disable:4244) 
-
-		#include "libavformat\avformat.h"
-		#include "libavformat\avio.h"
-		#include "libavcodec\avcodec.h"
-		#include "libswscale\swscale.h"
-	}
-}
+#include "Native\aforge_ffmpeg.h"
 
 namespace AForge { namespace Video { namespace FFMPEG
 {
 #pragma region Some private FFmpeg related stuff hidden out of header file
 
-static void write_video_frame( WriterPrivateData^ data );
-static void open_video( WriterPrivateData^ data );
-static void add_video_stream( WriterPrivateData^ data, int width, int height, int frameRate, int bitRate,
-							  enum libffmpeg::CodecID codec_id, enum libffmpeg::PixelFormat pixelFormat );
-
 // A structure to encapsulate all FFMPEG related private variable
 ref struct WriterPrivateData
 {
 public:
-	libffmpeg::AVFormatContext*		FormatContext;
-	libffmpeg::AVStream*			VideoStream;
-	libffmpeg::AVFrame*				VideoFrame;
-	struct libffmpeg::SwsContext*	ConvertContext;
-	struct libffmpeg::SwsContext*	ConvertContextGrayscale;
-
-	libffmpeg::uint8_t*	VideoOutputBuffer;
-	int VideoOutputBufferSize;
+	aforge_video_writer* Writer;
+	aforge_statistics*   Statistics;
 
 	WriterPrivateData( )
 	{
-		FormatContext     = NULL;
-		VideoStream       = NULL;
-		VideoFrame        = NULL;
-		ConvertContext	  = NULL;
-		ConvertContextGrayscale = NULL;
-		VideoOutputBuffer = NULL;
+		Writer     = NULL;
+		Statistics = NULL;
 	}
 };
+
+// Throws exception corresponding to the error status returned by native core
+static void check_status( int status )
+{
+	if ( status == AFORGE_ERROR_OPEN_FILE )
+	{
+		throw gcnew System::IO::IOException( gcnew String( aforge_status_message( status ) ) );
+	}
+	if ( status < 0 )
+	{
+		throw gcnew VideoException( gcnew String( aforge_status_message( status ) ) );
+	}
+}
 #pragma endregion
 
 // Class constructor
 VideoFileWriter::VideoFileWriter( void ) :
     data( nullptr ), disposed( false )
 {
-	libffmpeg::av_register_all( );
+	m_statistics = gcnew VideoStatistics( );
 }
 
 void VideoFileWriter::Open( String^ fileName, int width, int height )
@@ -99,7 +83,7 @@ void VideoFileWriter::Open( String^ fileName, int width, int height, int frameRa
 	}
 
 	// check video codec
-	if ( ( (int) codec < -1 ) || ( (int) codec >= CODECS_COUNT ) )
+	if ( ( (int) codec < -1 ) || ( (int) codec >= aforge_video_codecs_count( ) ) )
 	{
 		throw gcnew ArgumentException( "Invalid video codec is specified." );
 	}
@@ -109,7 +93,7 @@ void VideoFileWriter::Open( String^ fileName, int width, int height, int frameRa
 	m_codec  = codec;
 	m_frameRate = frameRate;
 	m_bitRate = bitRate;
-	
+
 	// convert specified managed String to unmanaged string
 	IntPtr ptr = System::Runtime::InteropServices::Marshal::StringToHGlobalUni( fileName );
     wchar_t* nativeFileNameUnicode = (wchar_t*) ptr.ToPointer( );
@@ -119,53 +103,13 @@ void VideoFileWriter::Open( String^ fileName, int width, int height, int frameRa
 
 	try
 	{
-		// gues about destination file format from its file name
-		libffmpeg::AVOutputFormat* outputFormat = libffmpeg::av_guess_format( NULL, nativeFileName, NULL );
-
-		if ( !outputFormat )
-		{
-			// gues about destination file format from its short name
-			outputFormat = libffmpeg::av_guess_format( "mpeg", NULL, NULL );
-
-			if ( !outputFormat )
-			{
-				throw gcnew VideoException( "Cannot find suitable output format." );
-			}
-		}
-
-		// prepare format context
-		data->FormatContext = libffmpeg::avformat_alloc_context( );
-
-		if ( !data->FormatContext )
-		{
-			throw gcnew VideoException( "Cannot allocate format context." );
-		}
-		data->FormatContext->oformat = outputFormat;
-
-		// add video stream using the specified video codec
-		add_video_stream( data, width, height, frameRate, bitRate,
-			( codec == VideoCodec::Default ) ? outputFormat->video_codec : (libffmpeg::CodecID) video_codecs[(int) codec],
-			( codec == VideoCodec::Default ) ? libffmpeg::PIX_FMT_YUV420P : (libffmpeg::PixelFormat) pixel_formats[(int) codec] );
-
-		// set the output parameters (must be done even if no parameters)
-		if ( libffmpeg::av_set_parameters( data->FormatContext, NULL ) < 0 )
-		{
-			throw gcnew VideoException( "Failed configuring format context." );
-		}
-
-		open_video( data );
-
-		// open output file
-		if ( !( outputFormat->flags & AVFMT_NOFILE ) )
-		{
-			if ( libffmpeg::avio_open( &data->FormatContext->pb, nativeFileName, AVIO_FLAG_WRITE ) < 0 )
-			{
-				throw gcnew System::IO::IOException( "Cannot open the video file." );
-			}
-		}
+		aforge_video_writer* writer = NULL;
 
-		libffmpeg::av_write_header( data->FormatContext );
+		data->Statistics = m_statistics->Acquire( );
+		check_status( aforge_video_writer_open( nativeFileName, width, height, frameRate, (int) codec, bitRate,
+			data->Statistics, &writer ) );
 
+		data->Writer = writer;
 		success = true;
 	}
 	finally
@@ -185,53 +129,12 @@ void VideoFileWriter::Close( )
 {
 	if ( data != nullptr )
 	{
-		if ( data->FormatContext )
-		{
-			if ( data->FormatContext->pb != NULL )
-			{
-				libffmpeg::av_write_trailer( data->FormatContext );
-			}
-
-			if ( data->VideoStream )
-			{
-				libffmpeg::avcodec_close( data->VideoStream->codec );
-			}
-
-			if ( data->VideoFrame )
-			{
-				libffmpeg::av_free( data->VideoFrame->data[0] );
-				libffmpeg::av_free( data->VideoFrame );
-			}
-
-			if ( data->VideoOutputBuffer )
-			{
-				libffmpeg::av_free( data->VideoOutputBuffer );
-			}
-
-			for ( unsigned int i = 0; i < data->FormatContext->nb_streams; i++ )
-			{
-				libffmpeg::av_freep( &data->FormatContext->streams[i]->codec );
-				libffmpeg::av_freep( &data->FormatContext->streams[i] );
-			}
-
-			if ( data->FormatContext->pb != NULL )
-			{
-				libffmpeg::avio_close( data->FormatContext->pb );
-			}
-			
-			libffmpeg::av_free( data->FormatContext );
-		}
-
-		if ( data->ConvertContext != NULL )
-		{
-			libffmpeg::sws_freeContext( data->ConvertContext );
-		}
+		aforge_video_writer_close( data->Writer );
 
-		if ( data->ConvertContextGrayscale != NULL )
+		if ( data->Statistics != NULL )
 		{
-			libffmpeg::sws_freeContext( data->ConvertContextGrayscale );
+			m_statistics->Release( );
 		}
-
 		data = nullptr;
 	}
 
@@ -269,211 +172,38 @@ void VideoFileWriter::WriteVideoFrame( Bitmap^ frame, TimeSpan timestamp )
 		throw gcnew ArgumentException( "Bitmap size must be of the same as video size, which was specified on opening video file." );
 	}
 
+	bool isGrayscale = ( frame->PixelFormat == PixelFormat::Format8bppIndexed );
+
+	Int64 startTimestamp = VideoStatistics::GetTimestamp( );
+
 	// lock the bitmap
 	BitmapData^ bitmapData = frame->LockBits( System::Drawing::Rectangle( 0, 0, m_width, m_height ),
 		ImageLockMode::ReadOnly,
-		( frame->PixelFormat == PixelFormat::Format8bppIndexed ) ? PixelFormat::Format8bppIndexed : PixelFormat::Format24bppRgb );
-
-	libffmpeg::uint8_t* ptr = reinterpret_cast<libffmpeg::uint8_t*>( static_cast<void*>( bitmapData->Scan0 ) );
+		( isGrayscale ) ? PixelFormat::Format8bppIndexed : PixelFormat::Format24bppRgb );
 
-	libffmpeg::uint8_t* srcData[4] = { ptr, NULL, NULL, NULL };
-	int srcLinesize[4] = { bitmapData->Stride, 0, 0, 0 };
-
-	// convert source image to the format of the video file
-	if ( frame->PixelFormat == PixelFormat::Format8bppIndexed )
-	{
-		libffmpeg::sws_scale( data->ConvertContextGrayscale, srcData, srcLinesize, 0, m_height, data->VideoFrame->data, data->VideoFrame->linesize );
-	}
-	else
-	{
-		libffmpeg::sws_scale( data->ConvertContext, srcData, srcLinesize, 0, m_height, data->VideoFrame->data, data->VideoFrame->linesize );
-	}
+	unsigned char* ptr = reinterpret_cast<unsigned char*>( static_cast<void*>( bitmapData->Scan0 ) );
+	Int64 imageSize = (Int64) bitmapData->Stride * m_height;
 
-	frame->UnlockBits( bitmapData );
+	Int64 pts = -1;
 
 	if ( timestamp.Ticks >= 0 )
 	{
 		const double frameNumber = timestamp.TotalSeconds * m_frameRate;
-		data->VideoFrame->pts = static_cast<libffmpeg::int64_t>( frameNumber );
-	}
-
-	// write the converted frame to the video file
-	write_video_frame( data );
-}
-
-#pragma region Private methods
-// Writes video frame to opened video file
-void write_video_frame( WriterPrivateData^ data )
-{
-	libffmpeg::AVCodecContext* codecContext = data->VideoStream->codec;
-	int out_size, ret = 0;
-
-	if ( data->FormatContext->oformat->flags & AVFMT_RAWPICTURE )
-	{
-		Console::WriteLine( "raw picture must be written" );
+		pts = static_cast<Int64>( frameNumber );
 	}
-	else
-	{
-		// encode the image
-		out_size = libffmpeg::avcodec_encode_video( codecContext, data->VideoOutputBuffer,
-			data->VideoOutputBufferSize, data->VideoFrame );
-
-		// if zero size, it means the image was buffered
-		if ( out_size > 0 )
-		{
-			libffmpeg::AVPacket packet;
-			libffmpeg::av_init_packet( &packet );
-
-			if ( codecContext->coded_frame->pts != AV_NOPTS_VALUE )
-			{
-				packet.pts = libffmpeg::av_rescale_q( codecContext->coded_frame->pts, codecContext->time_base, data->VideoStream->time_base );
-			}
 
-			if ( codecContext->coded_frame->key_frame )
-			{
-				packet.flags |= AV_PKT_FLAG_KEY;
-			}
+	// convert, encode and write the frame to the video file (these stages are accounted by native core)
+	Int64 writingTimestamp = VideoStatistics::GetTimestamp( );
+	int status = aforge_video_writer_write_frame( data->Writer, ptr, bitmapData->Stride,
+		( isGrayscale ) ? AFORGE_PIXEL_FORMAT_GRAY8 : AFORGE_PIXEL_FORMAT_BGR24, pts );
+	Int64 writingTicks = VideoStatistics::GetTimestamp( ) - writingTimestamp;
 
-			packet.stream_index = data->VideoStream->index;
-			packet.data = data->VideoOutputBuffer;
-			packet.size = out_size;
-
-			// write the compressed frame to the media file
-			ret = libffmpeg::av_interleaved_write_frame( data->FormatContext, &packet );
-		}
-		else
-		{
-			// image was buffered
-		}
-	}
-
-	if ( ret != 0 )
-	{
-		throw gcnew VideoException( "Error while writing video frame." );
-	}
-}
-
-// Allocate picture of the specified format and size
-static libffmpeg::AVFrame* alloc_picture( enum libffmpeg::PixelFormat pix_fmt, int width, int height )
-{
-	libffmpeg::AVFrame* picture;
-	void* picture_buf;
-	int size;
-
-	picture = libffmpeg::avcodec_alloc_frame( );
-	if ( !picture )
-	{
-		return NULL;
-	}
-
-	size = libffmpeg::avpicture_get_size( pix_fmt, width, height );
-	picture_buf = libffmpeg::av_malloc( size );
-	if ( !picture_buf )
-	{
-		libffmpeg::av_free( picture );
-		return NULL;
-	}
-
-	libffmpeg::avpicture_fill( (libffmpeg::AVPicture *) picture, (libffmpeg::uint8_t *) picture_buf, pix_fmt, width, height );
-
-	return picture;
-}
-
-// Create new video stream and configure it
-void add_video_stream( WriterPrivateData^ data,  int width, int height, int frameRate, int bitRate,
-					  enum libffmpeg::CodecID codecId, enum libffmpeg::PixelFormat pixelFormat )
-{
-	libffmpeg::AVCodecContext* codecContex;
-
-	// create new stream
-	data->VideoStream = libffmpeg::av_new_stream( data->FormatContext, 0 );
-	if ( !data->VideoStream )
-	{
-		throw gcnew VideoException( "Failed creating new video stream." );
-	}
-
-	codecContex = data->VideoStream->codec;
-	codecContex->codec_id   = codecId;
-	codecContex->codec_type = libffmpeg::AVMEDIA_TYPE_VIDEO;
-
-	// put sample parameters
-	codecContex->bit_rate = bitRate;
-	codecContex->width    = width;
-	codecContex->height   = height;
-
-	// time base: this is the fundamental unit of time (in seconds) in terms
-	// of which frame timestamps are represented. for fixed-fps content,
-	// timebase should be 1/framerate and timestamp increments should be
-	// identically 1.
-	codecContex->time_base.den = frameRate;
-	codecContex->time_base.num = 1;
-
-	codecContex->gop_size = 12; // emit one intra frame every twelve frames at most
-	codecContex->pix_fmt  = pixelFormat;
+	frame->UnlockBits( bitmapData );
 
-	if ( codecContex->codec_id == libffmpeg::CODEC_ID_MPEG1VIDEO )
-	{
-		// Needed to avoid using macroblocks in which some coeffs overflow.
-		// This does not happen with normal video, it just happens here as
-		// the motion of the chroma plane does not match the luma plane.
-		codecContex->mb_decision = 2;
-	}
+	// account bitmap's locking and unlocking, excluding writing time
+	m_statistics->Add( VideoStage::Marshalling, startTimestamp + writingTicks, imageSize );
 
-	// some formats want stream headers to be separate
-	if( data->FormatContext->oformat->flags & AVFMT_GLOBALHEADER )
-	{
-		codecContex->flags |= CODEC_FLAG_GLOBAL_HEADER;
-	}
+	check_status( status );
 }
 
-// Open video codec and prepare out buffer and picture
-void open_video( WriterPrivateData^ data )
-{
-	libffmpeg::AVCodecContext* codecContext = data->VideoStream->codec;
-	libffmpeg::AVCodec* codec = avcodec_find_encoder( codecContext->codec_id );
-
-	if ( !codec )
-	{
-		throw gcnew VideoException( "Cannot find video codec." );
-	}
-
-	// open the codec 
-	if ( avcodec_open( codecContext, codec ) < 0 )
-	{
-		throw gcnew VideoException( "Cannot open video codec." );
-	}
-
-	data->VideoOutputBuffer = NULL;
-	if ( !( data->FormatContext->oformat->flags & AVFMT_RAWPICTURE ) )
-	{
-         // allocate output buffer 
-         data->VideoOutputBufferSize = 6 * codecContext->width * codecContext->height; // more than enough even for raw video
-		 data->VideoOutputBuffer = (libffmpeg::uint8_t*) libffmpeg::av_malloc( data->VideoOutputBufferSize );
-	}
-
-	// allocate the encoded raw picture
-	data->VideoFrame = alloc_picture( codecContext->pix_fmt, codecContext->width, codecContext->height );
-
-	if ( !data->VideoFrame )
-	{
-		throw gcnew VideoException( "Cannot allocate video picture." );
-	}
-
-	// prepare scaling context to convert RGB image to video format
-	data->ConvertContext = libffmpeg::sws_getContext( codecContext->width, codecContext->height, libffmpeg::PIX_FMT_BGR24,
-			codecContext->width, codecContext->height, codecContext->pix_fmt,
-			SWS_BICUBIC, NULL, NULL, NULL );
-	// prepare scaling context to convert grayscale image to video format
-	data->ConvertContextGrayscale = libffmpeg::sws_getContext( codecContext->width, codecContext->height, libffmpeg::PIX_FMT_GRAY8,
-			codecContext->width, codecContext->height, codecContext->pix_fmt,
-			SWS_BICUBIC, NULL, NULL, NULL );
-
-	if ( ( data->ConvertContext == NULL ) || ( data->ConvertContextGrayscale == NULL ) )
-	{
-		throw gcnew VideoException( "Cannot initialize frames conversion context." );
-	}
-}
-#pragma endregion
-		
 } } }
-
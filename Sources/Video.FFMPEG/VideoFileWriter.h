@@ -14,6 +14,7 @@ using namespace System::Drawing::Imaging;
 using namespace AForge::Video;
 
 #include "VideoCodec.h"
+#include "VideoStatistics.h"
 
 namespace AForge { namespace Video { namespace FFMPEG
 {
@@ -140,6 +141,22 @@ namespace AForge { namespace Video { namespace FFMPEG
 			}
 		}
 
+		/// <summary>
+		/// Statistics of video writing stages.
+		/// </summary>
+		///
+		/// <remarks><para>The property provides cumulative statistics of marshalling, conversion, encoding
+		/// and muxing of video frames written by this instance of the class (see <see cref="VideoStatistics"/>).
+		/// The statistics is not reset on opening another video file.</para></remarks>
+		///
+		property VideoStatistics^ Statistics
+		{
+			VideoStatistics^ get( )
+			{
+				return m_statistics;
+			}
+		}
+
     protected:
 
         /// <summary>
@@ -330,6 +347,7 @@ namespace AForge { namespace Video { namespace FFMPEG
 	private:
 		// private data of the class
 		WriterPrivateData^ data;
+		VideoStatistics^ m_statistics;
         bool disposed;
 	};
 
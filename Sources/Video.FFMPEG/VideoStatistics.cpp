@@ -0,0 +1,175 @@
+// AForge FFMPEG Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright  AForge.NET, 2009-2012
+// contacts@aforgenet.com
+//
+
+#include "StdAfx.h"
+#include "VideoStatistics.h"
+
+using namespace System::Threading;
+
+namespace AForge { namespace Video { namespace FFMPEG
+{
+
+// Class constructor
+VideoStatistics::VideoStatistics( ) :
+	m_references( 0 ), disposed( false )
+{
+	m_statistics = new aforge_statistics( );
+}
+
+// Disposes the object, freeing native statistics as soon as they are not used
+VideoStatistics::~VideoStatistics( )
+{
+	Monitor::Enter( this );
+	try
+	{
+		disposed = true;
+		FreeIfUnused( );
+	}
+	finally
+	{
+		Monitor::Exit( this );
+	}
+}
+
+// Class finalizer (native readers/writers using the statistics are not reachable as well)
+VideoStatistics::!VideoStatistics( )
+{
+	delete m_statistics;
+	m_statistics = NULL;
+}
+
+// Get native statistics for a video file
+aforge_statistics* VideoStatistics::Acquire( )
+{
+	Monitor::Enter( this );
+	try
+	{
+		if ( disposed )
+		{
+			return NULL;
+		}
+
+		m_references++;
+		return m_statistics;
+	}
+	finally
+	{
+		Monitor::Exit( this );
+	}
+}
+
+// Release native statistics of a video file
+void VideoStatistics::Release( )
+{
+	Monitor::Enter( this );
+	try
+	{
+		m_references--;
+		FreeIfUnused( );
+	}
+	finally
+	{
+		Monitor::Exit( this );
+	}
+}
+
+// Free native statistics if the object was disposed and no video file uses them
+void VideoStatistics::FreeIfUnused( )
+{
+	if ( ( disposed ) && ( m_references <= 0 ) )
+	{
+		delete m_statistics;
+		m_statistics = NULL;
+	}
+}
+
+// Account one execution of the stage (native statistics are locked, so they are not freed
+// by disposing the object meanwhile; after that they are NULL and nothing is accounted)
+Int64 VideoStatistics::Add( VideoStage stage, Int64 startTimestamp, Int64 bytes )
+{
+	Monitor::Enter( this );
+	try
+	{
+		return aforge_statistics_add( m_statistics, (int) stage, startTimestamp, bytes );
+	}
+	finally
+	{
+		Monitor::Exit( this );
+	}
+}
+
+// Account a late video frame
+void VideoStatistics::AddLateFrame( )
+{
+	Monitor::Enter( this );
+	try
+	{
+		aforge_statistics_add_late_frame( m_statistics );
+	}
+	finally
+	{
+		Monitor::Exit( this );
+	}
+}
+
+// Get snapshot of the collected statistics
+VideoStatisticsSnapshot VideoStatistics::GetSnapshot( )
+{
+	aforge_statistics statistics;
+	VideoStatisticsSnapshot snapshot;
+
+	Monitor::Enter( this );
+	try
+	{
+		CheckIfDisposed( );
+		aforge_statistics_read( m_statistics, &statistics );
+	}
+	finally
+	{
+		Monitor::Exit( this );
+	}
+
+	snapshot.Stages = gcnew array<VideoStageStatistics>( StagesCount );
+	snapshot.LateFrames = statistics.frames_late;
+
+	for ( int i = 0; i < StagesCount; i++ )
+	{
+		VideoStageStatistics% stage = snapshot.Stages[i];
+
+		stage.Stage     = (VideoStage) i;
+		stage.Count     = statistics.counts[i];
+		stage.Bytes     = statistics.bytes[i];
+		// native core measures time in nanoseconds
+		stage.TotalTime = TimeSpan( statistics.times[i] / 100 );
+		stage.Histogram = gcnew array<Int64>( HistogramBins );
+
+		for ( int j = 0; j < HistogramBins; j++ )
+		{
+			stage.Histogram[j] = statistics.histogram[i * HistogramBins + j];
+		}
+	}
+
+	return snapshot;
+}
+
+// Reset all collected statistics
+void VideoStatistics::Reset( )
+{
+	Monitor::Enter( this );
+	try
+	{
+		CheckIfDisposed( );
+		aforge_statistics_reset( m_statistics );
+	}
+	finally
+	{
+		Monitor::Exit( this );
+	}
+}
+
+} } }
@@ -0,0 +1,247 @@
+// AForge FFMPEG Library
+// AForge.NET framework
+// http://www.aforgenet.com/framework/
+//
+// Copyright  AForge.NET, 2009-2012
+// contacts@aforgenet.com
+//
+
+#pragma once
+
+using namespace System;
+
+#include "Native\aforge_ffmpeg.h"
+
+namespace AForge { namespace Video { namespace FFMPEG
+{
+	/// <summary>
+	/// Enumeration of video processing stages, which are measured by <see cref="VideoStatistics"/>.
+	/// </summary>
+	public enum class VideoStage
+	{
+		/// <summary>
+		/// Reading packets of video stream from video file (<b>av_read_frame</b>).
+		/// </summary>
+		Demuxing = 0,
+		/// <summary>
+		/// Decoding packets into video frames (<b>avcodec_decode_video2</b>).
+		/// </summary>
+		Decoding,
+		/// <summary>
+		/// Conversion of pixel format between video frames and bitmaps (<b>sws_scale</b>).
+		/// </summary>
+		Conversion,
+		/// <summary>
+		/// Allocation, locking and unlocking of managed bitmaps.
+		/// </summary>
+		Marshalling,
+		/// <summary>
+		/// Encoding video frames into packets (<b>avcodec_encode_video</b>).
+		/// </summary>
+		Encoding,
+		/// <summary>
+		/// Writing packets of video stream into video file (<b>av_interleaved_write_frame</b>).
+		/// </summary>
+		Muxing,
+	};
+
+	/// <summary>
+	/// Cumulative statistics of a single video processing stage.
+	/// </summary>
+	///
+	/// <remarks><para>The structure is a part of <see cref="VideoStatisticsSnapshot"/>.</para></remarks>
+	///
+	public value struct VideoStageStatistics
+	{
+	public:
+		/// <summary>
+		/// Video processing stage the statistics is collected for.
+		/// </summary>
+		VideoStage Stage;
+
+		/// <summary>
+		/// Number of times the stage was performed.
+		/// </summary>
+		Int64 Count;
+
+		/// <summary>
+		/// Total time spent in the stage.
+		/// </summary>
+		TimeSpan TotalTime;
+
+		/// <summary>
+		/// Total number of bytes processed by the stage.
+		/// </summary>
+		///
+		/// <remarks><para>For demuxing, decoding, encoding and muxing it is size of video packets. For conversion
+		/// and marshalling it is size of produced/consumed images.</para></remarks>
+		///
+		Int64 Bytes;
+
+		/// <summary>
+		/// Histogram of the stage's durations.
+		/// </summary>
+		///
+		/// <remarks><para>Each bin of the histogram has twice wider range of durations than the previous bin.
+		/// Bin <b>i</b> counts durations, which are less than 2<sup>i</sup> microseconds
+		/// (but not less than 2<sup>i-1</sup> microseconds). The last bin counts all longer durations as well.
+		/// See <see cref="VideoStatistics::HistogramBins"/>.</para></remarks>
+		///
+		array<Int64>^ Histogram;
+
+		/// <summary>
+		/// Average time spent in the stage.
+		/// </summary>
+		property TimeSpan AverageTime
+		{
+			TimeSpan get( )
+			{
+				return ( Count == 0 ) ? TimeSpan::Zero : TimeSpan( TotalTime.Ticks / Count );
+			}
+		}
+	};
+
+	/// <summary>
+	/// Snapshot of video processing statistics.
+	/// </summary>
+	///
+	/// <remarks><para>The structure is returned by <see cref="VideoStatistics::GetSnapshot"/>.</para></remarks>
+	///
+	public value struct VideoStatisticsSnapshot
+	{
+	public:
+		/// <summary>
+		/// Statistics of all video processing stages, indexed by <see cref="VideoStage"/>.
+		/// </summary>
+		array<VideoStageStatistics>^ Stages;
+
+		/// <summary>
+		/// Number of frames provided later than required by real time playing.
+		/// </summary>
+		///
+		/// <remarks><para>The value is collected by <see cref="VideoFileSource"/> only and counts video frames,
+		/// which could not be provided in time according to the frame rate (the time spent reading and
+		/// processing a frame exceeded frame interval). Such frames are still provided, not skipped.</para></remarks>
+		///
+		Int64 LateFrames;
+	};
+
+	/// <summary>
+	/// Cumulative per stage statistics of video reading and writing.
+	/// </summary>
+	///
+	/// <remarks><para>The class collects number of times, total time, number of processed bytes and
+	/// durations' histogram for each <see cref="VideoStage">video processing stage</see> performed
+	/// by <see cref="VideoFileReader"/>, <see cref="VideoFileWriter"/> and <see cref="VideoFileSource"/>.
+	/// This allows finding which stage is the bottleneck when throughput drops.</para>
+	///
+	/// <para>Statistics collection is based on monotonic timestamps and interlocked counters only, so it
+	/// does not allocate anything and is cheap enough to be always on. The counters are kept in native memory
+	/// and updated directly by the native core of the library, which performs all FFmpeg related stages.
+	/// A snapshot of the statistics may be taken from any thread while video is being processed.</para>
+	///
+	/// <para>Native memory of the statistics is freed on disposing the object, but not before all video
+	/// files, which were opened with the statistics, are closed. Video files opened after disposing the
+	/// object do not collect the statistics.</para>
+	///
+	/// <para>Sample usage:</para>
+	/// <code>
+	/// VideoFileReader reader = new VideoFileReader( );
+	/// // ... read video frames
+	///
+	/// VideoStatisticsSnapshot snapshot = reader.Statistics.GetSnapshot( );
+	/// foreach ( VideoStageStatistics stage in snapshot.Stages )
+	/// {
+	///     Console.WriteLine( "{0}: {1} times, {2} ms average",
+	///         stage.Stage, stage.Count, stage.AverageTime.TotalMilliseconds );
+	/// }
+	/// </code>
+	/// </remarks>
+	///
+	public ref class VideoStatistics : IDisposable
+	{
+	public:
+		/// <summary>
+		/// Number of bins in stages' durations histograms.
+		/// </summary>
+		static const int HistogramBins = AFORGE_HISTOGRAM_BINS;
+
+		/// <summary>
+		/// Initializes a new instance of the <see cref="VideoStatistics"/> class.
+		/// </summary>
+		///
+		VideoStatistics( );
+
+		/// <summary>
+		/// Disposes the object and frees its resources.
+		/// </summary>
+		///
+		~VideoStatistics( );
+
+		/// <summary>
+		/// Get snapshot of the collected statistics.
+		/// </summary>
+		///
+		/// <returns>Returns copy of statistics collected since creation of the object or its last reset.</returns>
+		///
+		/// <exception cref="ObjectDisposedException">The object was already disposed.</exception>
+		///
+		VideoStatisticsSnapshot GetSnapshot( );
+
+		/// <summary>
+		/// Reset all collected statistics.
+		/// </summary>
+		///
+		/// <exception cref="ObjectDisposedException">The object was already disposed.</exception>
+		///
+		void Reset( );
+
+	protected:
+		/// <summary>
+		/// Object's finalizer.
+		/// </summary>
+		///
+		!VideoStatistics( );
+
+	internal:
+		// Get current timestamp (in nanoseconds) to be used as start of a stage
+		static Int64 GetTimestamp( )
+		{
+			return aforge_timestamp( );
+		}
+
+		// Account one execution of the stage started at the specified timestamp,
+		// returning timestamp of the stage's end
+		Int64 Add( VideoStage stage, Int64 startTimestamp, Int64 bytes );
+
+		// Account a late video frame
+		void AddLateFrame( );
+
+		// Get native statistics to be updated by native core of the library, which are kept until
+		// the matching Release( ) call (returns NULL if the object was already disposed)
+		aforge_statistics* Acquire( );
+
+		// Release native statistics, which were acquired for a video file
+		void Release( );
+
+	private:
+		static const int StagesCount = AFORGE_STAGES_COUNT;
+
+		aforge_statistics* m_statistics;
+		// number of video files, which use native statistics
+		int m_references;
+		bool disposed;
+
+		void FreeIfUnused( );
+
+		// Check if the object was already disposed
+		void CheckIfDisposed( )
+		{
+			if ( disposed )
+			{
+				throw gcnew System::ObjectDisposedException( "The object was already disposed." );
+			}
+		}
+	};
+
+} } }
@@ -0,0 +1,138 @@
+﻿using System;
+using System.Drawing;
+using System.Drawing.Imaging;
+using System.Runtime.InteropServices;
+using AForge;
+using AForge.Imaging;
+using AForge.Imaging.Filters;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    [TestFixture]
+    public class BinaryImageTest
+    {
+        private Random rand = new Random( 11 );
+
+        [Test]
+        public void ConversionTest( )
+        {
+            for ( int width = 1; width <= 150; width += 7 )
+            {
+                UnmanagedImage image = CreateBinaryImage( width, 5 );
+                BinaryImage binaryImage = BinaryImage.FromBitmap( image );
+                int count = 0;
+
+                for ( int y = 0; y < image.Height; y++ )
+                {
+                    for ( int x = 0; x < width; x++ )
+                    {
+                        bool isSet = GetByte( image, x, y ) != 0;
+
+                        Assert.AreEqual( isSet, binaryImage.GetPixel( x, y ) );
+
+                        if ( isSet )
+                            count++;
+                    }
+                }
+
+                Assert.AreEqual( count, binaryImage.CountPixels( ) );
+
+                UnmanagedImage result = binaryImage.ToUnmanagedImage( );
+
+                for ( int y = 0; y < image.Height; y++ )
+                {
+                    for ( int x = 0; x < width; x++ )
+                    {
+                        Assert.AreEqual( ( GetByte( image, x, y ) != 0 ) ? 255 : 0, GetByte( result, x, y ) );
+                    }
+                }
+            }
+        }
+
+        [Test]
+        public void MorphologyTest( )
+        {
+            for ( int width = 3; width <= 150; width += 7 )
+            {
+                UnmanagedImage image = CreateBinaryImage( width, 6 );
+                BinaryImage binaryImage = BinaryImage.FromBitmap( image );
+
+                CheckSame( new BinaryErosion3x3( ).Apply( image ), binaryImage.Erode( ) );
+                CheckSame( new BinaryDilatation3x3( ).Apply( image ), binaryImage.Dilate( ) );
+
+                // in place processing
+                binaryImage.Dilate( binaryImage );
+                CheckSame( new BinaryDilatation3x3( ).Apply( image ), binaryImage );
+            }
+        }
+
+        [Test]
+        public void LogicalOperationsTest( )
+        {
+            UnmanagedImage image1 = CreateBinaryImage( 77, 4 );
+            UnmanagedImage image2 = CreateBinaryImage( 77, 4 );
+
+            BinaryImage and = BinaryImage.FromBitmap( image1 );
+            BinaryImage or  = and.Clone( );
+            BinaryImage xor = and.Clone( );
+            BinaryImage other = BinaryImage.FromBitmap( image2 );
+
+            and.And( other );
+            or.Or( other );
+            xor.Xor( other );
+
+            for ( int y = 0; y < 4; y++ )
+            {
+                for ( int x = 0; x < 77; x++ )
+                {
+                    bool a = GetByte( image1, x, y ) != 0;
+                    bool b = GetByte( image2, x, y ) != 0;
+
+                    Assert.AreEqual( a & b, and.GetPixel( x, y ) );
+                    Assert.AreEqual( a | b, or.GetPixel( x, y ) );
+                    Assert.AreEqual( a ^ b, xor.GetPixel( x, y ) );
+                }
+            }
+        }
+
+        private void CheckSame( UnmanagedImage expected, BinaryImage binaryImage )
+        {
+            int count = 0;
+
+            for ( int y = 0; y < expected.Height; y++ )
+            {
+                for ( int x = 0; x < expected.Width; x++ )
+                {
+                    bool isSet = GetByte( expected, x, y ) != 0;
+
+                    Assert.AreEqual( isSet, binaryImage.GetPixel( x, y ) );
+
+                    if ( isSet )
+                        count++;
+                }
+            }
+
+            // make sure bits beyond image's width are not set
+            Assert.AreEqual( count, binaryImage.CountPixels( ) );
+        }
+
+        // Create binary image with 0 and 255 pixels' values
+        private UnmanagedImage CreateBinaryImage( int width, int height )
+        {
+            byte[] bytes = new byte[width * height];
+
+            for ( int i = 0; i < bytes.Length; i++ )
+            {
+                bytes[i] = (byte) ( ( rand.Next( 4 ) == 0 ) ? 0 : 255 );
+            }
+
+            return TestImages.CreateImage( width, height, PixelFormat.Format8bppIndexed, bytes );
+        }
+
+        private byte GetByte( UnmanagedImage image, int x, int y )
+        {
+            return Marshal.ReadByte( image.ImageData, y * image.Stride + x );
+        }
+    }
+}
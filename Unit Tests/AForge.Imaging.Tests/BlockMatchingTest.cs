@@ -0,0 +1,210 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Drawing;
+using System.Drawing.Imaging;
+using AForge;
+using AForge.Imaging;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    [TestFixture]
+    public class BlockMatchingTest
+    {
+        private Random rand = new Random( 7 );
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed, 8 )]
+        [TestCase( PixelFormat.Format8bppIndexed, 13 )]
+        [TestCase( PixelFormat.Format24bppRgb, 7 )]
+        [TestCase( PixelFormat.Format24bppRgb, 16 )]
+        public void KnownShiftTest( PixelFormat pixelFormat, int blockSize )
+        {
+            // shifts inside of the [-R, R-1] window, which was searched by the previous implementation
+            IntPoint[] shifts = new IntPoint[] { new IntPoint( 0, 0 ), new IntPoint( 3, -2 ), new IntPoint( -12, 11 ), new IntPoint( 7, 7 ) };
+
+            foreach ( IntPoint shift in shifts )
+            {
+                UnmanagedImage sourceImage = TestImages.CreateRandomImage( rand, 120, 100, pixelFormat, 0, 256 );
+                UnmanagedImage searchImage = CreateShiftedImage( sourceImage, shift );
+                List<IntPoint> points = CreatePoints( sourceImage, blockSize );
+
+                // only blocks, which are still inside of image after shifting, can be matched
+                points.RemoveAll( delegate( IntPoint point )
+                {
+                    int x = point.X - blockSize / 2 + shift.X;
+                    int y = point.Y - blockSize / 2 + shift.Y;
+
+                    return ( x < 0 ) || ( y < 0 ) || ( x + blockSize > sourceImage.Width ) || ( y + blockSize > sourceImage.Height );
+                } );
+
+                ExhaustiveBlockMatching bm = new ExhaustiveBlockMatching( blockSize, 12 );
+                List<BlockMatch> matches = bm.ProcessImage( sourceImage, points, searchImage );
+
+                Assert.AreEqual( points.Count, matches.Count );
+
+                foreach ( BlockMatch match in matches )
+                {
+                    Assert.AreEqual( match.SourcePoint.X + shift.X, match.MatchPoint.X );
+                    Assert.AreEqual( match.SourcePoint.Y + shift.Y, match.MatchPoint.Y );
+                    Assert.AreEqual( 1.0f, match.Similarity );
+                }
+            }
+        }
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed, 8 )]
+        [TestCase( PixelFormat.Format24bppRgb, 9 )]
+        public void CompareWithBruteForceTest( PixelFormat pixelFormat, int blockSize )
+        {
+            UnmanagedImage sourceImage = TestImages.CreateRandomImage( rand, 100, 90, pixelFormat, 0, 256 );
+            UnmanagedImage searchImage = TestImages.CreateRandomImage( rand, 100, 90, pixelFormat, 0, 256 );
+            List<IntPoint> points = CreatePoints( sourceImage, blockSize );
+
+            ExhaustiveBlockMatching bm = new ExhaustiveBlockMatching( blockSize, 6 );
+            bm.SimilarityThreshold = 0;
+
+            List<BlockMatch> matches = bm.ProcessImage( sourceImage, points, searchImage );
+            Dictionary<IntPoint, BlockMatch> matchesByPoint = new Dictionary<IntPoint, BlockMatch>( );
+
+            foreach ( BlockMatch match in matches )
+            {
+                matchesByPoint.Add( match.SourcePoint, match );
+            }
+
+            Assert.AreEqual( points.Count, matches.Count );
+
+            foreach ( IntPoint point in points )
+            {
+                int minDifference;
+                IntPoint expected = SearchBruteForce( sourceImage, searchImage, point, blockSize, 6, out minDifference );
+                BlockMatch match = matchesByPoint[point];
+                int maxDifference = blockSize * blockSize * 255 * Bitmap.GetPixelFormatSize( pixelFormat ) / 8;
+
+                Assert.AreEqual( expected, match.MatchPoint );
+                Assert.AreEqual( (float) ( maxDifference - minDifference ) / maxDifference, match.Similarity );
+            }
+        }
+
+        [Test]
+        [TestCase( 0 )]
+        [TestCase( 4 )]
+        public void TiesTest( int period )
+        {
+            // flat image or image with vertical stripes, where many locations are equally similar
+            UnmanagedImage image = UnmanagedImage.Create( 80, 80, PixelFormat.Format8bppIndexed );
+
+            for ( int x = 0; x < image.Width; x++ )
+            {
+                Drawing.Line( image, new IntPoint( x, 0 ), new IntPoint( x, image.Height - 1 ),
+                    ( ( period != 0 ) && ( x % period == 0 ) ) ? Color.White : Color.Gray );
+            }
+
+            List<IntPoint> points = CreatePoints( image, 8 );
+
+            foreach ( BlockMatchingBase bm in new BlockMatchingBase[] {
+                new ExhaustiveBlockMatching( 8, 12 ), new ThreeStepBlockMatching( 8, 12 ), new DiamondBlockMatching( 8, 12 ) } )
+            {
+                List<BlockMatch> matches = bm.ProcessImage( image, points, image );
+
+                Assert.AreEqual( points.Count, matches.Count );
+
+                // zero displacement is preferred
+                foreach ( BlockMatch match in matches )
+                {
+                    Assert.AreEqual( match.SourcePoint, match.MatchPoint );
+                    Assert.AreEqual( 1.0f, match.Similarity );
+                }
+            }
+        }
+
+        // Find the best match checking all locations within search window, preferring zero displacement in the case of ties
+        private IntPoint SearchBruteForce( UnmanagedImage sourceImage, UnmanagedImage searchImage, IntPoint point,
+            int blockSize, int searchRadius, out int minDifference )
+        {
+            int pixelSize = Bitmap.GetPixelFormatSize( sourceImage.PixelFormat ) / 8;
+            byte[] source = TestImages.GetBytes( sourceImage );
+            byte[] search = TestImages.GetBytes( searchImage );
+            int lineSize = sourceImage.Width * pixelSize;
+            int blockX = point.X - blockSize / 2;
+            int blockY = point.Y - blockSize / 2;
+
+            IntPoint best = point;
+            minDifference = int.MaxValue;
+
+            for ( int dy = -searchRadius; dy <= searchRadius; dy++ )
+            {
+                for ( int dx = -searchRadius; dx <= searchRadius; dx++ )
+                {
+                    int x = blockX + dx;
+                    int y = blockY + dy;
+
+                    if ( ( x < 0 ) || ( y < 0 ) || ( x + blockSize > sourceImage.Width ) || ( y + blockSize > sourceImage.Height ) )
+                        continue;
+
+                    int difference = 0;
+
+                    for ( int i = 0; i < blockSize; i++ )
+                    {
+                        for ( int j = 0; j < blockSize * pixelSize; j++ )
+                        {
+                            difference += System.Math.Abs( source[( blockY + i ) * lineSize + blockX * pixelSize + j] -
+                                                           search[( y + i ) * lineSize + x * pixelSize + j] );
+                        }
+                    }
+
+                    if ( ( difference < minDifference ) || ( ( difference == minDifference ) && ( dx == 0 ) && ( dy == 0 ) ) )
+                    {
+                        minDifference = difference;
+                        best = new IntPoint( point.X + dx, point.Y + dy );
+                    }
+                }
+            }
+
+            return best;
+        }
+
+        // Create reference points, which blocks are inside of image, including points near image's edges
+        private List<IntPoint> CreatePoints( UnmanagedImage image, int blockSize )
+        {
+            List<IntPoint> points = new List<IntPoint>( );
+            int blockRadius = blockSize / 2;
+
+            for ( int y = blockRadius; y + blockRadius < image.Height; y += 11 )
+            {
+                for ( int x = blockRadius; x + blockRadius < image.Width; x += 13 )
+                {
+                    points.Add( new IntPoint( x, y ) );
+                }
+            }
+
+            return points;
+        }
+
+        // Create image, which is the specified image shifted by the specified displacement with random values in uncovered areas
+        private UnmanagedImage CreateShiftedImage( UnmanagedImage image, IntPoint shift )
+        {
+            UnmanagedImage shifted = TestImages.CreateRandomImage( rand, image.Width, image.Height, image.PixelFormat, 0, 256 );
+            int pixelSize = Bitmap.GetPixelFormatSize( image.PixelFormat ) / 8;
+            byte[] bytes = TestImages.GetBytes( image );
+            byte[] shiftedBytes = TestImages.GetBytes( shifted );
+            int lineSize = image.Width * pixelSize;
+
+            for ( int y = 0; y < image.Height; y++ )
+            {
+                for ( int x = 0; x < image.Width; x++ )
+                {
+                    int sx = x + shift.X;
+                    int sy = y + shift.Y;
+
+                    if ( ( sx >= 0 ) && ( sy >= 0 ) && ( sx < image.Width ) && ( sy < image.Height ) )
+                    {
+                        Array.Copy( bytes, y * lineSize + x * pixelSize, shiftedBytes, sy * lineSize + sx * pixelSize, pixelSize );
+                    }
+                }
+            }
+
+            return TestImages.CreateImage( image.Width, image.Height, image.PixelFormat, shiftedBytes );
+        }
+    }
+}
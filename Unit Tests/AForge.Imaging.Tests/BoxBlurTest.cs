@@ -0,0 +1,126 @@
+﻿using System;
+using System.Drawing;
+using System.Drawing.Imaging;
+using AForge;
+using AForge.Imaging;
+using AForge.Imaging.Filters;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    // The tests check that box blur based on running sums gives exactly the same result as
+    // direct averaging of pixels in the window
+    [TestFixture]
+    public class BoxBlurTest
+    {
+        private Random rand = new Random( 11 );
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed, 3 )]
+        [TestCase( PixelFormat.Format8bppIndexed, 5 )]
+        [TestCase( PixelFormat.Format8bppIndexed, 15 )]
+        [TestCase( PixelFormat.Format8bppIndexed, 31 )]
+        [TestCase( PixelFormat.Format8bppIndexed, 101 )]
+        [TestCase( PixelFormat.Format24bppRgb, 3 )]
+        [TestCase( PixelFormat.Format24bppRgb, 15 )]
+        [TestCase( PixelFormat.Format32bppArgb, 5 )]
+        [TestCase( PixelFormat.Format32bppArgb, 31 )]
+        public void CompareWithDirectAveragingTest( PixelFormat pixelFormat, int kernelSize )
+        {
+            BoxBlur filter = new BoxBlur( kernelSize );
+            TestImages.ReferenceFilter reference = CreateReference( kernelSize );
+
+            foreach ( Size size in TestImages.SmallSizes )
+            {
+                UnmanagedImage image = TestImages.CreateRandomImage( rand, size.Width, size.Height, pixelFormat, 0, 255 );
+
+                TestImages.CheckFilter( filter, image, new Rectangle( 0, 0, size.Width, size.Height ), reference );
+                TestImages.CheckFilter( filter, image, TestImages.GetRandomRectangle( rand, size ), reference );
+
+                image.Dispose( );
+            }
+        }
+
+        // The test checks that the filter with the smallest window gives the same result as convolution with mean kernel
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed )]
+        [TestCase( PixelFormat.Format24bppRgb )]
+        [TestCase( PixelFormat.Format32bppArgb )]
+        public void CompareWithMeanTest( PixelFormat pixelFormat )
+        {
+            // box blur copies alpha channel
+            Mean mean = new Mean( );
+            mean.ProcessAlpha = false;
+
+            foreach ( Size size in TestImages.SmallSizes )
+            {
+                UnmanagedImage image = TestImages.CreateRandomImage( rand, size.Width, size.Height, pixelFormat, 0, 255 );
+                Rectangle rect = TestImages.GetRandomRectangle( rand, size );
+
+                UnmanagedImage expected = image.Clone( );
+                mean.ApplyInPlace( expected, rect );
+                new BoxBlur( ).ApplyInPlace( image, rect );
+
+                Assert.AreEqual( TestImages.GetBytes( expected ), TestImages.GetBytes( image ) );
+
+                image.Dispose( );
+                expected.Dispose( );
+            }
+        }
+
+        // The test checks that the window size is kept odd and in the allowed range
+        [Test]
+        [TestCase( 0, 3 )]
+        [TestCase( 3, 3 )]
+        [TestCase( 4, 5 )]
+        [TestCase( 100, 101 )]
+        [TestCase( 1001, 1001 )]
+        [TestCase( 2000, 1001 )]
+        public void KernelSizeTest( int kernelSize, int expectedKernelSize )
+        {
+            Assert.AreEqual( expectedKernelSize, new BoxBlur( kernelSize ).KernelSize );
+        }
+
+        // Create direct averaging in the window of the specified size
+        private static TestImages.ReferenceFilter CreateReference( int kernelSize )
+        {
+            return delegate( byte[] src, int width, int pixelSize, Rectangle rect )
+            {
+                return Average( src, width, pixelSize, rect, kernelSize );
+            };
+        }
+
+        // Average image's bytes in the window of the specified size
+        private static byte[] Average( byte[] src, int width, int pixelSize, Rectangle rect, int kernelSize )
+        {
+            byte[] dst = (byte[]) src.Clone( );
+            int radius = kernelSize / 2;
+            // alpha channel is copied
+            int channels = ( pixelSize == 4 ) ? 3 : pixelSize;
+
+            for ( int y = rect.Top; y < rect.Bottom; y++ )
+            {
+                for ( int x = rect.Left; x < rect.Right; x++ )
+                {
+                    for ( int c = 0; c < channels; c++ )
+                    {
+                        int sum = 0, count = 0;
+
+                        for ( int ty = System.Math.Max( rect.Top, y - radius ); ty <= System.Math.Min( rect.Bottom - 1, y + radius ); ty++ )
+                        {
+                            for ( int tx = System.Math.Max( rect.Left, x - radius ); tx <= System.Math.Min( rect.Right - 1, x + radius ); tx++ )
+                            {
+                                sum += src[( ty * width + tx ) * pixelSize + c];
+                                count++;
+                            }
+                        }
+
+                        dst[( y * width + x ) * pixelSize + c] = (byte) ( sum / count );
+                    }
+                }
+            }
+
+            return dst;
+        }
+    }
+}
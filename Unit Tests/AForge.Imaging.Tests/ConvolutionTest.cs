@@ -0,0 +1,200 @@
+﻿using System;
+using System.Drawing;
+using System.Drawing.Imaging;
+using AForge;
+using AForge.Imaging;
+using AForge.Imaging.Filters;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    // The tests check that convolution with kernels, which are outer product of two 1D kernels and
+    // are processed in two 1D passes, gives exactly the same result as direct 2D convolution
+    [TestFixture]
+    public class ConvolutionTest
+    {
+        private Random rand = new Random( 7 );
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed, false )]
+        [TestCase( PixelFormat.Format24bppRgb, false )]
+        [TestCase( PixelFormat.Format32bppArgb, false )]
+        [TestCase( PixelFormat.Format32bppArgb, true )]
+        public void CompareWithDirectConvolutionTest( PixelFormat pixelFormat, bool processAlpha )
+        {
+            for ( int k = 0; k < 20; k++ )
+            {
+                int kernelSize = 3 + 2 * rand.Next( 4 );
+                int[] horizontalKernel = CreateRandomKernel( kernelSize, k );
+                int[] verticalKernel   = CreateRandomKernel( kernelSize, k + 1 );
+                int[,] kernel = OuterProduct( horizontalKernel, verticalKernel );
+
+                foreach ( Size size in TestImages.SmallSizes )
+                {
+                    int divisor = rand.Next( 1, 100 ) * ( ( rand.Next( 4 ) == 0 ) ? -1 : 1 );
+
+                    Convolution convolution = new Convolution( kernel, divisor );
+                    SeparableConvolution separableConvolution = new SeparableConvolution( horizontalKernel, verticalKernel, divisor );
+
+                    convolution.Threshold = separableConvolution.Threshold = rand.Next( -50, 50 );
+                    convolution.DynamicDivisorForEdges = separableConvolution.DynamicDivisorForEdges = ( rand.Next( 2 ) == 0 );
+                    convolution.ProcessAlpha = separableConvolution.ProcessAlpha = processAlpha;
+
+                    UnmanagedImage image = TestImages.CreateRandomImage( rand, size.Width, size.Height, pixelFormat );
+                    Rectangle rect = TestImages.GetRandomRectangle( rand, size );
+                    TestImages.ReferenceFilter reference = CreateReference( convolution );
+
+                    TestImages.CheckFilter( convolution, image, rect, reference );
+                    TestImages.CheckFilter( separableConvolution, image, rect, reference );
+
+                    image.Dispose( );
+                }
+            }
+        }
+
+        // The test checks kernels, which are not outer product of two 1D kernels and so are processed directly
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed )]
+        [TestCase( PixelFormat.Format24bppRgb )]
+        public void NonSeparableKernelTest( PixelFormat pixelFormat )
+        {
+            int[,] kernel = OuterProduct( new int[] { 1, 2, 1 }, new int[] { 1, 2, 1 } );
+            // break the product in the middle of the kernel
+            kernel[1, 1] = -4;
+
+            Convolution convolution = new Convolution( kernel );
+
+            foreach ( Size size in TestImages.SmallSizes )
+            {
+                UnmanagedImage image = TestImages.CreateRandomImage( rand, size.Width, size.Height, pixelFormat );
+
+                TestImages.CheckFilter( convolution, image, TestImages.GetRandomRectangle( rand, size ), CreateReference( convolution ) );
+
+                image.Dispose( );
+            }
+        }
+
+        // The test checks that the filter does not keep using decomposition of its kernel, when the kernel
+        // is changed in place after the filter was applied
+        [Test]
+        public void KernelChangedInPlaceTest( )
+        {
+            int[,] kernel = OuterProduct( new int[] { 1, 4, 6, 4, 1 }, new int[] { 1, 4, 6, 4, 1 } );
+            Convolution convolution = new Convolution( kernel, 256 );
+            UnmanagedImage image = TestImages.CreateRandomImage( rand, 45, 35, PixelFormat.Format24bppRgb );
+            Rectangle rect = new Rectangle( 0, 0, image.Width, image.Height );
+
+            TestImages.CheckFilter( convolution, image, rect, CreateReference( convolution ) );
+
+            // still separable, but with other 1D kernels
+            for ( int i = 0; i < 5; i++ )
+            {
+                kernel[i, 0] = kernel[i, 4] = 0;
+            }
+            TestImages.CheckFilter( convolution, image, rect, CreateReference( convolution ) );
+
+            // not separable any more
+            kernel[2, 2] = 0;
+            TestImages.CheckFilter( convolution, image, rect, CreateReference( convolution ) );
+
+            image.Dispose( );
+        }
+
+        // Get 2D kernel, which is outer product of the specified 1D kernels
+        private static int[,] OuterProduct( int[] horizontalKernel, int[] verticalKernel )
+        {
+            int[,] kernel = new int[verticalKernel.Length, horizontalKernel.Length];
+
+            for ( int i = 0; i < verticalKernel.Length; i++ )
+            {
+                for ( int j = 0; j < horizontalKernel.Length; j++ )
+                {
+                    kernel[i, j] = verticalKernel[i] * horizontalKernel[j];
+                }
+            }
+
+            return kernel;
+        }
+
+        // Create direct convolution with current settings of the filter
+        private static TestImages.ReferenceFilter CreateReference( Convolution convolution )
+        {
+            int[,] kernel = (int[,]) convolution.Kernel.Clone( );
+            int divisor = convolution.Divisor;
+            int threshold = convolution.Threshold;
+            bool dynamicDivisorForEdges = convolution.DynamicDivisorForEdges;
+            bool processAlpha = convolution.ProcessAlpha;
+
+            return delegate( byte[] src, int width, int pixelSize, Rectangle rect )
+            {
+                return Convolve( src, width, pixelSize, rect, kernel, divisor, threshold, dynamicDivisorForEdges, processAlpha );
+            };
+        }
+
+        // Create random 1D kernel, which also has negative and zero elements
+        private int[] CreateRandomKernel( int size, int seed )
+        {
+            int[] kernel = new int[size];
+
+            for ( int i = 0; i < size; i++ )
+            {
+                kernel[i] = ( seed % 3 == 0 ) ? rand.Next( 1, 10 ) : rand.Next( -5, 10 );
+            }
+
+            return kernel;
+        }
+
+        // Convolve image's bytes directly with the 2D kernel
+        private static byte[] Convolve( byte[] src, int width, int pixelSize, Rectangle rect, int[,] kernel,
+            int divisor, int threshold, bool dynamicDivisorForEdges, bool processAlpha )
+        {
+            byte[] dst = (byte[]) src.Clone( );
+            int kernelSize = kernel.GetLength( 0 );
+            int radius = kernelSize / 2;
+            // alpha channel is the last one and is copied if it is not processed
+            int channels = ( ( pixelSize == 4 ) && ( !processAlpha ) ) ? 3 : pixelSize;
+
+            for ( int y = rect.Top; y < rect.Bottom; y++ )
+            {
+                for ( int x = rect.Left; x < rect.Right; x++ )
+                {
+                    for ( int c = 0; c < channels; c++ )
+                    {
+                        long sum = 0, div = 0;
+                        int count = 0;
+
+                        for ( int i = 0; i < kernelSize; i++ )
+                        {
+                            for ( int j = 0; j < kernelSize; j++ )
+                            {
+                                int ty = y + i - radius;
+                                int tx = x + j - radius;
+
+                                if ( ( ty < rect.Top ) || ( ty >= rect.Bottom ) || ( tx < rect.Left ) || ( tx >= rect.Right ) )
+                                    continue;
+
+                                sum += kernel[i, j] * src[( ty * width + tx ) * pixelSize + c];
+                                div += kernel[i, j];
+                                count++;
+                            }
+                        }
+
+                        if ( ( count == kernelSize * kernelSize ) || ( !dynamicDivisorForEdges ) )
+                        {
+                            div = divisor;
+                        }
+                        if ( div != 0 )
+                        {
+                            sum /= div;
+                        }
+                        sum += threshold;
+
+                        dst[( y * width + x ) * pixelSize + c] = (byte) System.Math.Max( 0, System.Math.Min( 255, sum ) );
+                    }
+                }
+            }
+
+            return dst;
+        }
+    }
+}
@@ -0,0 +1,237 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Drawing;
+using System.Drawing.Imaging;
+using System.Runtime.InteropServices;
+using AForge;
+using AForge.Imaging;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    [TestFixture]
+    public class CorrelationTemplateMatchingTest
+    {
+        private Random rand = new Random( 7 );
+
+        // positions the template is copied to with changed brightness and contrast
+        private IntPoint[] copies = new IntPoint[] { new IntPoint( 5, 7 ), new IntPoint( 61, 14 ), new IntPoint( 30, 50 ), new IntPoint( 98, 63 ) };
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed )]
+        [TestCase( PixelFormat.Format24bppRgb )]
+        public void CompareWithBruteForceTest( PixelFormat pixelFormat )
+        {
+            UnmanagedImage template;
+            UnmanagedImage image = CreateImage( 140, 100, 12, 10, pixelFormat, 1, out template );
+            Rectangle searchZone = new Rectangle( 3, 2, 130, 95 );
+
+            CorrelationTemplateMatching tm = new CorrelationTemplateMatching( 0.7f );
+            TemplateMatch[] matchings = tm.ProcessImage( image, template, searchZone );
+
+            double[,] map = CalculateMap( image, template, searchZone );
+            List<IntPoint> expected = new List<IntPoint>( );
+
+            // local maximums of similarity map in 5x5 window
+            for ( int y = 0, height = map.GetLength( 0 ); y < height; y++ )
+            {
+                for ( int x = 0, width = map.GetLength( 1 ); x < width; x++ )
+                {
+                    bool isMaximum = ( map[y, x] >= 0.7 );
+
+                    for ( int i = System.Math.Max( 0, y - 2 ); ( isMaximum ) && ( i <= System.Math.Min( height - 1, y + 2 ) ); i++ )
+                    {
+                        for ( int j = System.Math.Max( 0, x - 2 ); j <= System.Math.Min( width - 1, x + 2 ); j++ )
+                        {
+                            if ( map[i, j] > map[y, x] )
+                                isMaximum = false;
+                        }
+                    }
+
+                    if ( isMaximum )
+                        expected.Add( new IntPoint( x + searchZone.X, y + searchZone.Y ) );
+                }
+            }
+
+            // place the template was taken from is outside of the search zone
+            Assert.AreEqual( copies.Length, expected.Count );
+            Assert.AreEqual( expected.Count, matchings.Length );
+
+            foreach ( TemplateMatch m in matchings )
+            {
+                Assert.IsTrue( expected.Contains( new IntPoint( m.Rectangle.X, m.Rectangle.Y ) ) );
+                Assert.AreEqual( template.Width, m.Rectangle.Width );
+                Assert.AreEqual( template.Height, m.Rectangle.Height );
+                Assert.AreEqual( map[m.Rectangle.Y - searchZone.Y, m.Rectangle.X - searchZone.X], m.Similarity, 1e-4 );
+            }
+        }
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed, 1 )]
+        [TestCase( PixelFormat.Format24bppRgb, 1 )]
+        [TestCase( PixelFormat.Format8bppIndexed, 2 )]
+        public void PyramidTest( PixelFormat pixelFormat, int pyramidLevels )
+        {
+            UnmanagedImage template;
+            UnmanagedImage image = CreateImage( 160, 120, 36, 32, pixelFormat, 8, out template );
+            Rectangle searchZone = new Rectangle( 0, 0, image.Width, image.Height );
+
+            CorrelationTemplateMatching tm = new CorrelationTemplateMatching( 0.8f );
+            tm.PyramidLevels = pyramidLevels;
+
+            TemplateMatch[] matchings = tm.ProcessImage( image, template );
+            double[,] map = CalculateMap( image, template, searchZone );
+
+            // similarities of found matchings are calculated at full resolution
+            foreach ( TemplateMatch m in matchings )
+            {
+                Assert.AreEqual( map[m.Rectangle.Y, m.Rectangle.X], m.Similarity, 1e-4 );
+                Assert.IsTrue( m.Similarity >= 0.8f );
+            }
+
+            // all copies of template are found
+            foreach ( IntPoint copy in copies )
+            {
+                bool found = false;
+
+                foreach ( TemplateMatch m in matchings )
+                {
+                    if ( ( m.Rectangle.X == copy.X ) && ( m.Rectangle.Y == copy.Y ) )
+                        found = true;
+                }
+
+                Assert.IsTrue( found );
+            }
+        }
+
+        [Test]
+        public void WideTemplateTest( )
+        {
+            // template's line is longer than the largest block of Fourier transformation
+            UnmanagedImage image    = CreateBlocksImage( 5500, 6, PixelFormat.Format24bppRgb, 1 );
+            UnmanagedImage template = new AForge.Imaging.Filters.Crop( new Rectangle( 3, 1, 5490, 4 ) ).Apply( image );
+
+            CorrelationTemplateMatching tm = new CorrelationTemplateMatching( 0.9f );
+            TemplateMatch[] matchings = tm.ProcessImage( image, template );
+
+            Assert.AreEqual( 1, matchings.Length );
+            Assert.AreEqual( new Rectangle( 3, 1, 5490, 4 ), matchings[0].Rectangle );
+            Assert.AreEqual( 1.0, matchings[0].Similarity, 1e-4 );
+        }
+
+        // Create random image with template taken from it and copied to few other places with changed brightness and contrast and added noise
+        private UnmanagedImage CreateImage( int width, int height, int templateWidth, int templateHeight,
+            PixelFormat pixelFormat, int blockSize, out UnmanagedImage template )
+        {
+            UnmanagedImage image = CreateBlocksImage( width, height, pixelFormat, blockSize );
+
+            template = new AForge.Imaging.Filters.Crop( new Rectangle( width - templateWidth - 3, height - templateHeight - 3,
+                templateWidth, templateHeight ) ).Apply( image );
+
+            int lineSize = templateWidth * Bitmap.GetPixelFormatSize( pixelFormat ) / 8;
+            byte[] line = new byte[lineSize];
+
+            for ( int c = 0; c < copies.Length; c++ )
+            {
+                IntPoint copy = copies[c];
+
+                for ( int y = 0; y < templateHeight; y++ )
+                {
+                    Marshal.Copy( new IntPtr( template.ImageData.ToInt64( ) + y * template.Stride ), line, 0, lineSize );
+
+                    for ( int i = 0; i < lineSize; i++ )
+                    {
+                        // add more noise to each next copy, so they have different similarity
+                        line[i] = (byte) ( line[i] / 2 + 60 + rand.Next( c * 15 + 1 ) );
+                    }
+
+                    Marshal.Copy( line, 0, new IntPtr( image.ImageData.ToInt64( ) + ( copy.Y + y ) * image.Stride +
+                        copy.X * lineSize / templateWidth ), lineSize );
+                }
+            }
+
+            return image;
+        }
+
+        // Create image of random blocks of the specified size, so it is not flat at pyramid's coarse levels
+        private UnmanagedImage CreateBlocksImage( int width, int height, PixelFormat pixelFormat, int blockSize )
+        {
+            int pixelSize = Bitmap.GetPixelFormatSize( pixelFormat ) / 8;
+            int lineSize  = width * pixelSize;
+            byte[] bytes  = new byte[lineSize * height];
+
+            for ( int y = 0; y < height; y++ )
+            {
+                for ( int i = 0, k = y * lineSize; i < lineSize; i++, k++ )
+                {
+                    bytes[k] = ( y % blockSize != 0 ) ? bytes[k - lineSize] :
+                        ( i / pixelSize % blockSize == 0 ) ? (byte) rand.Next( 256 ) : bytes[k - pixelSize];
+                }
+            }
+
+            return TestImages.CreateImage( width, height, pixelFormat, bytes );
+        }
+
+        // Calculate normalized cross correlation of template with search zone of image at all positions
+        private double[,] CalculateMap( UnmanagedImage image, UnmanagedImage template, Rectangle zone )
+        {
+            int pixelSize = Bitmap.GetPixelFormatSize( image.PixelFormat ) / 8;
+            int templateLength = template.Width * pixelSize;
+            int count = templateLength * template.Height;
+
+            byte[] tpl = new byte[count];
+            byte[] src = new byte[image.Stride * image.Height];
+            double templateMean = 0;
+
+            for ( int y = 0; y < template.Height; y++ )
+            {
+                Marshal.Copy( new IntPtr( template.ImageData.ToInt64( ) + y * template.Stride ), tpl, y * templateLength, templateLength );
+            }
+            Marshal.Copy( image.ImageData, src, 0, src.Length );
+
+            foreach ( byte v in tpl )
+            {
+                templateMean += v;
+            }
+            templateMean /= count;
+
+            double[,] map = new double[zone.Height - template.Height + 1, zone.Width - template.Width + 1];
+
+            for ( int my = 0; my < map.GetLength( 0 ); my++ )
+            {
+                for ( int mx = 0; mx < map.GetLength( 1 ); mx++ )
+                {
+                    double sourceMean = 0;
+
+                    for ( int y = 0; y < template.Height; y++ )
+                    {
+                        for ( int i = 0, k = ( zone.Y + my + y ) * image.Stride + ( zone.X + mx ) * pixelSize; i < templateLength; i++, k++ )
+                        {
+                            sourceMean += src[k];
+                        }
+                    }
+                    sourceMean /= count;
+
+                    double correlation = 0, sourceVariance = 0, templateVariance = 0;
+
+                    for ( int y = 0; y < template.Height; y++ )
+                    {
+                        for ( int i = 0, k = ( zone.Y + my + y ) * image.Stride + ( zone.X + mx ) * pixelSize; i < templateLength; i++, k++ )
+                        {
+                            double s = src[k] - sourceMean;
+                            double t = tpl[y * templateLength + i] - templateMean;
+
+                            correlation      += s * t;
+                            sourceVariance   += s * s;
+                            templateVariance += t * t;
+                        }
+                    }
+
+                    map[my, mx] = correlation / System.Math.Sqrt( sourceVariance * templateVariance );
+                }
+            }
+
+            return map;
+        }
+    }
+}
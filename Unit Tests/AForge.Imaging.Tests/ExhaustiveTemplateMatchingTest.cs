@@ -0,0 +1,62 @@
+﻿using System;
+using System.Drawing;
+using System.Drawing.Imaging;
+using AForge;
+using AForge.Imaging;
+using AForge.Imaging.Filters;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    [TestFixture]
+    public class ExhaustiveTemplateMatchingTest
+    {
+        private Random rand = new Random( 7 );
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed, 0.8f )]
+        [TestCase( PixelFormat.Format8bppIndexed, 0.9f )]
+        [TestCase( PixelFormat.Format24bppRgb, 0.8f )]
+        [TestCase( PixelFormat.Format24bppRgb, 0.9f )]
+        public void ProcessTemplatesGroupTest( PixelFormat pixelFormat, float threshold )
+        {
+            UnmanagedImage image = TestImages.CreateRandomImage( rand, 160, 130, pixelFormat, 96, 160 );
+            Rectangle searchZone = new Rectangle( 7, 5, 140, 120 );
+
+            // templates of the same size are processed as group, the rest are processed one by one
+            Rectangle[] templatesRects = new Rectangle[]
+            {
+                new Rectangle( 10, 10, 8, 6 ), new Rectangle( 50, 30, 8, 6 ), new Rectangle( 90, 70, 8, 6 ),
+                new Rectangle( 20, 40, 5, 9 ), new Rectangle( 100, 100, 5, 9 ),
+                new Rectangle( 60, 60, 11, 11 )
+            };
+
+            UnmanagedImage[] templates = new UnmanagedImage[templatesRects.Length];
+
+            for ( int i = 0; i < templates.Length; i++ )
+            {
+                templates[i] = new Crop( templatesRects[i] ).Apply( image );
+            }
+
+            ExhaustiveTemplateMatching tm = new ExhaustiveTemplateMatching( threshold );
+            TemplateMatch[][] groupMatchings = tm.ProcessImage( image, templates, searchZone );
+
+            Assert.AreEqual( templates.Length, groupMatchings.Length );
+
+            for ( int i = 0; i < templates.Length; i++ )
+            {
+                TemplateMatch[] matchings = tm.ProcessImage( image, templates[i], searchZone );
+
+                Assert.AreEqual( matchings.Length, groupMatchings[i].Length );
+                // template must be found at least at the place it was taken from
+                Assert.Greater( matchings.Length, 0 );
+
+                for ( int j = 0; j < matchings.Length; j++ )
+                {
+                    Assert.AreEqual( matchings[j].Rectangle, groupMatchings[i][j].Rectangle );
+                    Assert.AreEqual( matchings[j].Similarity, groupMatchings[i][j].Similarity );
+                }
+            }
+        }
+    }
+}
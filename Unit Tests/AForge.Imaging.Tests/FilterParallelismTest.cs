@@ -0,0 +1,122 @@
+﻿using System;
+using System.Drawing;
+using System.Drawing.Imaging;
+using AForge;
+using AForge.Imaging;
+using AForge.Imaging.Filters;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    // The tests check that filters, which process image's stripes in parallel, produce exactly
+    // the same result as processing of the entire image in a single thread
+    [TestFixture]
+    public class FilterParallelismTest
+    {
+        private Random rand = new Random( 7 );
+
+        private BaseUsingCopyPartialFilter[] CreateNeighbourhoodFilters( )
+        {
+            short[,] cross = new short[,] { { 0, 1, 0 }, { 1, 1, 1 }, { 0, 1, 0 } };
+            short[,] hitAndMiss = new short[,] { { -1, 1, -1 }, { 0, 1, 1 }, { 0, 0, -1 } };
+
+            SobelEdgeDetector sobel = new SobelEdgeDetector( );
+            sobel.ScaleIntensity = false;
+
+            return new BaseUsingCopyPartialFilter[]
+            {
+                new Median( 3 ), new Median( 7 ), new ConservativeSmoothing( ), new OilPainting( 5 ),
+                new BoxBlur( 3 ), new BoxBlur( 9 ), new GaussianBlur( 1.4, 7 ), new Sharpen( ),
+                new SeparableConvolution( new int[] { 1, 2, 1 }, new int[] { 1, 4, 6, 4, 1 } ),
+                new Erosion( ), new Dilatation( ), new Erosion( cross ), new Dilatation( cross ),
+                new HitAndMiss( hitAndMiss, HitAndMiss.Modes.HitAndMiss ), new HitAndMiss( hitAndMiss, HitAndMiss.Modes.Thinning ),
+                new Erosion3x3( ), new Dilatation3x3( ), new BinaryErosion3x3( ), new BinaryDilatation3x3( ),
+                sobel, new DifferenceEdgeDetector( ), new HomogenityEdgeDetector( )
+            };
+        }
+
+        [Test]
+        public void NeighbourhoodFiltersTest( )
+        {
+            Rectangle rect = new Rectangle( 13, 7, 600, 450 );
+
+            foreach ( BaseUsingCopyPartialFilter filter in CreateNeighbourhoodFilters( ) )
+            {
+                foreach ( PixelFormat pixelFormat in filter.FormatTranslations.Keys )
+                {
+                    string message = filter.GetType( ).Name + " " + pixelFormat;
+                    UnmanagedImage image = TestImages.CreateRandomImage( rand, 640, 480, pixelFormat );
+
+                    // processing to new image
+                    filter.MaxDegreeOfParallelism = 1;
+                    byte[] expected = TestImages.GetBytes( filter.Apply( image ) );
+                    filter.MaxDegreeOfParallelism = 4;
+                    Assert.AreEqual( expected, TestImages.GetBytes( filter.Apply( image ) ), message );
+
+                    // in place processing of image's part
+                    UnmanagedImage serialImage   = image.Clone( );
+                    UnmanagedImage parallelImage = image.Clone( );
+
+                    filter.MaxDegreeOfParallelism = 1;
+                    filter.ApplyInPlace( serialImage, rect );
+                    filter.MaxDegreeOfParallelism = 4;
+                    filter.ApplyInPlace( parallelImage, rect );
+
+                    Assert.AreEqual( TestImages.GetBytes( serialImage ), TestImages.GetBytes( parallelImage ), message );
+                }
+            }
+        }
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed )]
+        [TestCase( PixelFormat.Format24bppRgb )]
+        public void ImageStatisticsTest( PixelFormat pixelFormat )
+        {
+            UnmanagedImage image = TestImages.CreateRandomImage( rand, 640, 480, pixelFormat );
+            int maxDegreeOfParallelism = FilterParallelism.MaxDegreeOfParallelism;
+            ImageStatistics serialStatistics, parallelStatistics;
+
+            try
+            {
+                FilterParallelism.MaxDegreeOfParallelism = 1;
+                serialStatistics = new ImageStatistics( image );
+                FilterParallelism.MaxDegreeOfParallelism = 4;
+                parallelStatistics = new ImageStatistics( image );
+            }
+            finally
+            {
+                FilterParallelism.MaxDegreeOfParallelism = maxDegreeOfParallelism;
+            }
+
+            Assert.AreEqual( serialStatistics.PixelsCount, parallelStatistics.PixelsCount );
+            Assert.AreEqual( serialStatistics.PixelsCountWithoutBlack, parallelStatistics.PixelsCountWithoutBlack );
+
+            if ( pixelFormat == PixelFormat.Format8bppIndexed )
+            {
+                Assert.AreEqual( serialStatistics.Gray.Values, parallelStatistics.Gray.Values );
+                Assert.AreEqual( serialStatistics.GrayWithoutBlack.Values, parallelStatistics.GrayWithoutBlack.Values );
+            }
+            else
+            {
+                Assert.AreEqual( serialStatistics.Red.Values, parallelStatistics.Red.Values );
+                Assert.AreEqual( serialStatistics.Green.Values, parallelStatistics.Green.Values );
+                Assert.AreEqual( serialStatistics.Blue.Values, parallelStatistics.Blue.Values );
+                Assert.AreEqual( serialStatistics.BlueWithoutBlack.Values, parallelStatistics.BlueWithoutBlack.Values );
+            }
+        }
+
+        [Test]
+        public void OtsuThresholdTest( )
+        {
+            UnmanagedImage image = TestImages.CreateRandomImage( rand, 640, 480, PixelFormat.Format8bppIndexed, 30, 200 );
+            Rectangle rect = new Rectangle( 13, 7, 600, 450 );
+            OtsuThreshold filter = new OtsuThreshold( );
+
+            filter.MaxDegreeOfParallelism = 1;
+            int expected = filter.CalculateThreshold( image, rect );
+            filter.MaxDegreeOfParallelism = 4;
+
+            Assert.AreEqual( expected, filter.CalculateThreshold( image, rect ) );
+        }
+    }
+}
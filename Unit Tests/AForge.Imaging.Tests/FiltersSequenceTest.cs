@@ -0,0 +1,247 @@
+﻿using System;
+using System.Drawing;
+using System.Drawing.Imaging;
+using System.Reflection;
+using AForge;
+using AForge.Imaging;
+using AForge.Imaging.Filters;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    // The tests check that filters' sequence, which fuses lookup tables of adjacent filters and
+    // reuses buffers, produces exactly the same result as applying its filters one by one
+    [TestFixture]
+    public class FiltersSequenceTest
+    {
+        private delegate long AllocatedBytesGetter( );
+
+        private Random rand = new Random( 3 );
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed )]
+        [TestCase( PixelFormat.Format24bppRgb )]
+        [TestCase( PixelFormat.Format32bppArgb )]
+        public void LookupTablesFusionTest( PixelFormat pixelFormat )
+        {
+            CheckSequence( pixelFormat, CreateLookupTableFilters( pixelFormat ) );
+        }
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed )]
+        [TestCase( PixelFormat.Format24bppRgb )]
+        [TestCase( PixelFormat.Format32bppArgb )]
+        public void NonLookupTableFilterInMiddleTest( PixelFormat pixelFormat )
+        {
+            IFilter[] before = CreateLookupTableFilters( pixelFormat );
+            IFilter[] after  = CreateLookupTableFilters( pixelFormat );
+            IFilter[] filters = new IFilter[before.Length + after.Length + 1];
+
+            before.CopyTo( filters, 0 );
+            filters[before.Length] = new Median( );
+            after.CopyTo( filters, before.Length + 1 );
+
+            CheckSequence( pixelFormat, filters );
+        }
+
+        [Test]
+        public void PixelFormatChangeTest( )
+        {
+            // tables of the filters following grayscaling must be taken for grayscale image
+            CheckSequence( PixelFormat.Format24bppRgb, new IFilter[] {
+                new Invert( ), new GammaCorrection( 0.7 ), Grayscale.CommonAlgorithms.BT709,
+                new LevelsLinear( ), new Invert( ), new Threshold( 90 ) } );
+        }
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed )]
+        [TestCase( PixelFormat.Format24bppRgb )]
+        public void ReuseBuffersTest( PixelFormat pixelFormat )
+        {
+            // neighbourhood filters keep working memory between calls, which must not affect results
+            // of next images (the images are big enough to be processed in several stripes)
+            IFilter[] filters = CreateNeighbourhoodFilters( );
+            FiltersSequence sequence = new FiltersSequence( filters );
+            sequence.ReuseBuffers = true;
+
+            for ( int i = 0; i < 3; i++ )
+            {
+                UnmanagedImage image    = TestImages.CreateRandomImage( rand, 640, 480, pixelFormat );
+                UnmanagedImage expected = ApplyOneByOne( image, filters );
+                UnmanagedImage result   = UnmanagedImage.Create( 640, 480, pixelFormat );
+
+                sequence.Apply( image, result );
+
+                Assert.AreEqual( TestImages.GetBytes( expected ), TestImages.GetBytes( result ) );
+
+                image.Dispose( );
+                expected.Dispose( );
+                result.Dispose( );
+            }
+        }
+
+        [Test]
+        public void PointFiltersAllocationTest( )
+        {
+            CheckAllocations( PixelFormat.Format24bppRgb, new IFilter[] {
+                new LevelsLinear( ), new Invert( ), new GammaCorrection( 0.8 ),
+                Grayscale.CommonAlgorithms.BT709, new Threshold( 100 ), new Invert( ) } );
+        }
+
+        [Test]
+        public void NeighbourhoodFiltersAllocationTest( )
+        {
+            CheckAllocations( PixelFormat.Format24bppRgb, CreateNeighbourhoodFilters( ) );
+        }
+
+        // Create chain of filters using neighbour pixels, which need working memory
+        private IFilter[] CreateNeighbourhoodFilters( )
+        {
+            short[,] se = new short[5, 5];
+
+            for ( int i = 0; i < 5; i++ )
+            {
+                for ( int j = 0; j < 5; j++ )
+                {
+                    se[i, j] = 1;
+                }
+            }
+
+            return new IFilter[] { new Median( 5 ), new Invert( ), new Erosion( se ), new BoxBlur( ),
+                new Dilatation( se ), new Mean( ), new Median( ) };
+        }
+
+        // Check that the sequence with reused buffers does not allocate managed memory, when parallel
+        // processing is disabled
+        private void CheckAllocations( PixelFormat pixelFormat, IFilter[] filters )
+        {
+            // the method is not available in older frameworks
+            MethodInfo method = typeof( GC ).GetMethod( "GetAllocatedBytesForCurrentThread", Type.EmptyTypes );
+
+            if ( method == null )
+                Assert.Ignore( "Allocated memory can not be measured." );
+
+            AllocatedBytesGetter getAllocatedBytes = (AllocatedBytesGetter) Delegate.CreateDelegate( typeof( AllocatedBytesGetter ), method );
+
+            UnmanagedImage image  = TestImages.CreateRandomImage( rand, 320, 240, pixelFormat );
+            FiltersSequence sequence = new FiltersSequence( filters );
+            sequence.ReuseBuffers = true;
+
+            UnmanagedImage result = sequence.Apply( image );
+            int maxDegreeOfParallelism = FilterParallelism.MaxDegreeOfParallelism;
+            // runtime itself may allocate memory while it recompiles methods, so the lowest
+            // value of several measurements is taken
+            long allocated = long.MaxValue;
+
+            try
+            {
+                FilterParallelism.MaxDegreeOfParallelism = 1;
+                sequence.Apply( image, result );
+
+                for ( int round = 0; round < 5; round++ )
+                {
+                    long allocatedBefore = getAllocatedBytes( );
+
+                    for ( int i = 0; i < 10; i++ )
+                    {
+                        sequence.Apply( image, result );
+                    }
+
+                    allocated = System.Math.Min( allocated, getAllocatedBytes( ) - allocatedBefore );
+                }
+            }
+            finally
+            {
+                FilterParallelism.MaxDegreeOfParallelism = maxDegreeOfParallelism;
+            }
+
+            Assert.AreEqual( 0, allocated );
+
+            image.Dispose( );
+            result.Dispose( );
+        }
+
+        // Create chain of filters providing lookup tables for the pixel format
+        private IFilter[] CreateLookupTableFilters( PixelFormat pixelFormat )
+        {
+            LevelsLinear levels = new LevelsLinear( );
+            levels.Input  = new IntRange( 30, 220 );
+            levels.Output = new IntRange( 10, 240 );
+            // make tables of color channels different to check they are not mixed up
+            levels.InRed   = new IntRange( 0, 180 );
+            levels.OutBlue = new IntRange( 50, 255 );
+
+            switch ( pixelFormat )
+            {
+                case PixelFormat.Format8bppIndexed:
+                    return new IFilter[] { new Invert( ), levels, new Threshold( 120 ) };
+
+                case PixelFormat.Format24bppRgb:
+                    return new IFilter[] { new Invert( ), levels, new GammaCorrection( 0.6 ), new BrightnessCorrection( 20 ) };
+
+                default:
+                    // 32 bpp images are not supported by invert and gamma correction filters
+                    byte[] redMap   = new byte[256];
+                    byte[] greenMap = new byte[256];
+                    byte[] blueMap  = new byte[256];
+
+                    rand.NextBytes( redMap );
+                    rand.NextBytes( greenMap );
+                    rand.NextBytes( blueMap );
+
+                    return new IFilter[] { levels, new BrightnessCorrection( -30 ),
+                        new ColorRemapping( redMap, greenMap, blueMap ), new ContrastCorrection( 25 ) };
+            }
+        }
+
+        // Check that the sequence of filters produces the same result as its filters applied one by one
+        private void CheckSequence( PixelFormat pixelFormat, IFilter[] filters )
+        {
+            UnmanagedImage image = TestImages.CreateRandomImage( rand, 67, 45, pixelFormat );
+            byte[] sourceBytes = TestImages.GetBytes( image );
+            UnmanagedImage expected = ApplyOneByOne( image, filters );
+
+            byte[] expectedBytes = TestImages.GetBytes( expected );
+            FiltersSequence sequence = new FiltersSequence( filters );
+
+            foreach ( bool reuseBuffers in new bool[] { false, true } )
+            {
+                sequence.ReuseBuffers = reuseBuffers;
+
+                UnmanagedImage result = sequence.Apply( image );
+
+                Assert.AreEqual( expected.PixelFormat, result.PixelFormat );
+                Assert.AreEqual( expectedBytes, TestImages.GetBytes( result ) );
+
+                UnmanagedImage destination = UnmanagedImage.Create( expected.Width, expected.Height, expected.PixelFormat );
+                sequence.Apply( image, destination );
+
+                Assert.AreEqual( expectedBytes, TestImages.GetBytes( destination ) );
+
+                result.Dispose( );
+                destination.Dispose( );
+            }
+
+            // source image must be kept unchanged
+            Assert.AreEqual( sourceBytes, TestImages.GetBytes( image ) );
+
+            expected.Dispose( );
+            image.Dispose( );
+        }
+
+        // Apply filters one by one
+        private static UnmanagedImage ApplyOneByOne( UnmanagedImage image, IFilter[] filters )
+        {
+            UnmanagedImage result = image.Clone( );
+
+            foreach ( IFilter filter in filters )
+            {
+                UnmanagedImage next = filter.Apply( result );
+                result.Dispose( );
+                result = next;
+            }
+
+            return result;
+        }
+    }
+}
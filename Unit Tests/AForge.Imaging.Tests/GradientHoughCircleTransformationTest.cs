@@ -0,0 +1,112 @@
+﻿using System;
+using System.Drawing;
+using System.Drawing.Imaging;
+using AForge;
+using AForge.Imaging;
+using AForge.Imaging.Filters;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    [TestFixture]
+    public class GradientHoughCircleTransformationTest
+    {
+        private Random rand = new Random( 7 );
+
+        // circles' centers relative to image's size and circles' radiuses
+        private static readonly double[,] circles = new double[,]
+        {
+            { 0.25, 0.30, 30 }, { 0.62, 0.53, 45 }, { 0.82, 0.20, 20 }, { 0.30, 0.73, 25 }, { 0.55, 0.15, 12 }
+        };
+
+        [Test]
+        [TestCase( 400, 300, 180, 60 )]
+        [TestCase( 400, 300, 60, 180 )]
+        [TestCase( 900, 700, 180, 60 )]
+        public void DetectCirclesTest( int width, int height, int foreground, int background )
+        {
+            UnmanagedImage image = CreateCirclesImage( width, height, foreground, background );
+
+            GradientHoughCircleTransformation circleTransform = new GradientHoughCircleTransformation( 10, 60 );
+            circleTransform.ProcessImage( new GaussianBlur( 1.5, 7 ).Apply( image ) );
+
+            HoughCircle[] found = circleTransform.GetMostIntensiveCircles( circleTransform.CirclesCount );
+
+            Assert.AreEqual( circles.GetLength( 0 ), found.Length );
+            Assert.AreEqual( 1.0, found[0].RelativeIntensity, 1e-10 );
+
+            for ( int i = 0; i < circles.GetLength( 0 ); i++ )
+            {
+                int x = (int) ( circles[i, 0] * width );
+                int y = (int) ( circles[i, 1] * height );
+                int r = (int) circles[i, 2];
+                int matches = 0;
+
+                foreach ( HoughCircle circle in found )
+                {
+                    if ( ( System.Math.Abs( circle.X - x ) <= 2 ) && ( System.Math.Abs( circle.Y - y ) <= 2 ) &&
+                         ( System.Math.Abs( circle.Radius - r ) <= 1 ) )
+                    {
+                        matches++;
+                    }
+                }
+
+                Assert.AreEqual( 1, matches );
+            }
+        }
+
+        [Test]
+        public void NoCirclesTest( )
+        {
+            // rectangles' edges vote for centers, but edge pixels do not make circles around them
+            byte[] bytes = new byte[400 * 300];
+
+            for ( int y = 0, i = 0; y < 300; y++ )
+            {
+                for ( int x = 0; x < 400; x++, i++ )
+                {
+                    bool inside = ( ( x >= 50 ) && ( x < 130 ) && ( y >= 40 ) && ( y < 120 ) ) ||
+                                  ( ( x >= 220 ) && ( x < 330 ) && ( y >= 150 ) && ( y < 210 ) );
+
+                    bytes[i] = (byte) ( ( inside ? 180 : 60 ) + rand.Next( 20 ) );
+                }
+            }
+
+            UnmanagedImage image = TestImages.CreateImage( 400, 300, PixelFormat.Format8bppIndexed, bytes );
+
+            GradientHoughCircleTransformation circleTransform = new GradientHoughCircleTransformation( 10, 60 );
+            circleTransform.ProcessImage( new GaussianBlur( 1.5, 7 ).Apply( image ) );
+
+            Assert.AreEqual( 0, circleTransform.CirclesCount );
+        }
+
+        // Create noisy image with circles from the list
+        private UnmanagedImage CreateCirclesImage( int width, int height, int foreground, int background )
+        {
+            byte[] bytes = new byte[width * height];
+
+            for ( int y = 0, i = 0; y < height; y++ )
+            {
+                for ( int x = 0; x < width; x++, i++ )
+                {
+                    int value = background;
+
+                    for ( int k = 0; k < circles.GetLength( 0 ); k++ )
+                    {
+                        double dx = x - (int) ( circles[k, 0] * width );
+                        double dy = y - (int) ( circles[k, 1] * height );
+
+                        if ( dx * dx + dy * dy <= circles[k, 2] * circles[k, 2] )
+                        {
+                            value = foreground;
+                        }
+                    }
+
+                    bytes[i] = (byte) ( value + rand.Next( 20 ) );
+                }
+            }
+
+            return TestImages.CreateImage( width, height, PixelFormat.Format8bppIndexed, bytes );
+        }
+    }
+}
@@ -0,0 +1,159 @@
+﻿using System;
+using System.Drawing;
+using System.Drawing.Imaging;
+using AForge;
+using AForge.Imaging;
+using AForge.Math.Geometry;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    [TestFixture]
+    public class HoughLineTransformationTest
+    {
+        private Random rand = new Random( 7 );
+
+        // The test checks that Hough map calculated with fixed point tables is exactly the same
+        // as the one calculated in floating point for each pixel and angle
+        [Test]
+        [TestCase( 1, 200, 150, false )]
+        [TestCase( 10, 200, 150, true )]
+        [TestCase( 1, 640, 480, false )]
+        [TestCase( 3, 641, 479, true )]
+        public void CompareWithFloatingPointTest( int stepsPerDegree, int width, int height, bool useRectangle )
+        {
+            UnmanagedImage image = CreateEdgesImage( width, height );
+            Rectangle rect = ( useRectangle ) ?
+                new Rectangle( 13, 7, width - 30, height - 20 ) : new Rectangle( 0, 0, width, height );
+
+            HoughLineTransformation lineTransform = new HoughLineTransformation( );
+            lineTransform.StepsPerDegree = stepsPerDegree;
+            lineTransform.ProcessImage( image, rect );
+
+            short[,] map = CalculateMap( image, rect, stepsPerDegree );
+            short maxIntensity = 0;
+
+            foreach ( short intensity in map )
+            {
+                maxIntensity = System.Math.Max( maxIntensity, intensity );
+            }
+
+            Assert.AreEqual( maxIntensity, lineTransform.MaxIntensity );
+            // map's image keeps all values only if scaling does not decrease them
+            Assert.LessOrEqual( maxIntensity, 255 );
+
+            byte[] expected = new byte[map.Length];
+            float scale = 255.0f / maxIntensity;
+            int k = 0;
+
+            foreach ( short intensity in map )
+            {
+                expected[k++] = (byte) System.Math.Min( 255, (int) ( scale * intensity ) );
+            }
+
+            Assert.AreEqual( expected, TestImages.GetBytes( UnmanagedImage.FromManagedImage( lineTransform.ToBitmap( ) ) ) );
+
+            // found lines must have intensities of the map
+            int halfHoughWidth = map.GetLength( 1 ) / 2;
+
+            foreach ( HoughLine line in lineTransform.GetMostIntensiveLines( lineTransform.LinesCount ) )
+            {
+                int theta = (int) System.Math.Round( line.Theta * stepsPerDegree );
+
+                Assert.AreEqual( map[theta, line.Radius + halfHoughWidth], line.Intensity );
+            }
+        }
+
+        [Test]
+        public void RandomSeedTest( )
+        {
+            UnmanagedImage image = CreateEdgesImage( 300, 200 );
+
+            HoughLineTransformation lineTransform = new HoughLineTransformation( );
+            lineTransform.MinLineIntensity = 40;
+
+            lineTransform.RandomSeed = 5;
+            LineSegment[] segments1 = lineTransform.FindLineSegments( image );
+            lineTransform.RandomSeed = 5;
+            LineSegment[] segments2 = lineTransform.FindLineSegments( image );
+
+            Assert.AreEqual( 5, lineTransform.RandomSeed );
+            Assert.Greater( segments1.Length, 0 );
+            Assert.AreEqual( segments1.Length, segments2.Length );
+
+            for ( int i = 0; i < segments1.Length; i++ )
+            {
+                Assert.AreEqual( segments1[i].Start, segments2[i].Start );
+                Assert.AreEqual( segments1[i].End, segments2[i].End );
+            }
+        }
+
+        // Create binary image of few line segments and random noise pixels
+        private UnmanagedImage CreateEdgesImage( int width, int height )
+        {
+            byte[] bytes = new byte[width * height];
+
+            for ( int i = 0; i < bytes.Length; i++ )
+            {
+                bytes[i] = (byte) ( ( rand.Next( 60 ) == 0 ) ? 255 : 0 );
+            }
+
+            // segments are not longer than 150 pixels, so intensities of Hough map stay below 256
+            for ( int i = 0; i < 6; i++ )
+            {
+                double angle = rand.NextDouble( ) * System.Math.PI;
+                double dx = System.Math.Cos( angle ), dy = System.Math.Sin( angle );
+                int x0 = rand.Next( width ), y0 = rand.Next( height );
+
+                for ( int t = 0; t < 150; t++ )
+                {
+                    int x = x0 + (int) System.Math.Round( t * dx );
+                    int y = y0 + (int) System.Math.Round( t * dy );
+
+                    if ( ( x >= 0 ) && ( y >= 0 ) && ( x < width ) && ( y < height ) )
+                    {
+                        bytes[y * width + x] = 255;
+                    }
+                }
+            }
+
+            return TestImages.CreateImage( width, height, PixelFormat.Format8bppIndexed, bytes );
+        }
+
+        // Calculate Hough map in floating point for each pixel and angle
+        private short[,] CalculateMap( UnmanagedImage image, Rectangle rect, int stepsPerDegree )
+        {
+            byte[] bytes = TestImages.GetBytes( image );
+            int halfWidth  = image.Width / 2;
+            int halfHeight = image.Height / 2;
+            int halfHoughWidth = (int) System.Math.Sqrt( halfWidth * halfWidth + halfHeight * halfHeight );
+            int houghWidth  = halfHoughWidth * 2;
+            int houghHeight = 180 * stepsPerDegree;
+            double thetaStep = System.Math.PI / houghHeight;
+
+            short[,] map = new short[houghHeight, houghWidth];
+
+            for ( int y = rect.Top; y < rect.Bottom; y++ )
+            {
+                for ( int x = rect.Left; x < rect.Right; x++ )
+                {
+                    if ( bytes[y * image.Width + x] == 0 )
+                        continue;
+
+                    for ( int theta = 0; theta < houghHeight; theta++ )
+                    {
+                        int radius = (int) System.Math.Round( System.Math.Cos( theta * thetaStep ) * ( x - halfWidth ) -
+                            System.Math.Sin( theta * thetaStep ) * ( y - halfHeight ) ) + halfHoughWidth;
+
+                        if ( ( radius >= 0 ) && ( radius < houghWidth ) )
+                        {
+                            map[theta, radius]++;
+                        }
+                    }
+                }
+            }
+
+            return map;
+        }
+    }
+}
@@ -0,0 +1,135 @@
+﻿using System;
+using System.Drawing;
+using System.Drawing.Imaging;
+using AForge;
+using AForge.Imaging;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    [TestFixture]
+    public class ImagePyramidTest
+    {
+        private Random rand = new Random( 19 );
+
+        private static readonly int[] weights = new int[] { 1, 4, 6, 4, 1 };
+
+        // The test checks that all levels are exactly the same as the result of direct
+        // smoothing with 5x5 Gaussian kernel and taking every second pixel
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed )]
+        [TestCase( PixelFormat.Format24bppRgb )]
+        [TestCase( PixelFormat.Format32bppArgb )]
+        public void CompareWithDirectSmoothingTest( PixelFormat pixelFormat )
+        {
+            using ( ImagePyramid pyramid = new ImagePyramid( 5 ) )
+            {
+                foreach ( Size size in TestImages.SmallSizes )
+                {
+                    CheckLevels( pyramid, size, pixelFormat );
+                }
+
+                // sizes, which become 1 pixel wide or high at different levels
+                CheckLevels( pyramid, new Size( 2, 1 ), pixelFormat );
+                CheckLevels( pyramid, new Size( 1, 3 ), pixelFormat );
+                CheckLevels( pyramid, new Size( 64, 5 ), pixelFormat );
+            }
+        }
+
+        // The test checks image big enough to be reduced in parallel - pyramid splits rows
+        // between threads itself and not through FilterParallelism
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed )]
+        [TestCase( PixelFormat.Format24bppRgb )]
+        public void ParallelReductionTest( PixelFormat pixelFormat )
+        {
+            using ( ImagePyramid pyramid = new ImagePyramid( 3 ) )
+            {
+                CheckLevels( pyramid, new Size( 600, 500 ), pixelFormat );
+            }
+        }
+
+        // The test checks that levels' memory is reused for images of the same size and format
+        [Test]
+        public void ReuseLevelsTest( )
+        {
+            using ( ImagePyramid pyramid = new ImagePyramid( 3 ) )
+            {
+                pyramid.Build( TestImages.CreateRandomImage( rand, 40, 30, PixelFormat.Format24bppRgb ) );
+                UnmanagedImage level = pyramid.GetLevel( 2 );
+
+                UnmanagedImage image = TestImages.CreateRandomImage( rand, 40, 30, PixelFormat.Format24bppRgb );
+                pyramid.Build( image );
+
+                Assert.AreSame( level, pyramid.GetLevel( 2 ) );
+                Assert.AreEqual( TestImages.GetBytes( image ), TestImages.GetBytes( pyramid.GetLevel( 0 ) ) );
+
+                pyramid.Build( TestImages.CreateRandomImage( rand, 40, 30, PixelFormat.Format8bppIndexed ) );
+
+                Assert.AreEqual( PixelFormat.Format8bppIndexed, pyramid.GetLevel( 2 ).PixelFormat );
+            }
+        }
+
+        // Check that all levels of pyramid built for random image are the same as the result of direct smoothing
+        private void CheckLevels( ImagePyramid pyramid, Size size, PixelFormat pixelFormat )
+        {
+            UnmanagedImage image = TestImages.CreateRandomImage( rand, size.Width, size.Height, pixelFormat, 0, 255 );
+            pyramid.Build( image );
+
+            int pixelSize = Bitmap.GetPixelFormatSize( pixelFormat ) / 8;
+            int width  = size.Width;
+            int height = size.Height;
+            byte[] expected = TestImages.GetBytes( image );
+
+            for ( int i = 0; i < pyramid.LevelsCount; i++ )
+            {
+                UnmanagedImage level = pyramid.GetLevel( i );
+
+                Assert.AreEqual( width, level.Width );
+                Assert.AreEqual( height, level.Height );
+                Assert.AreEqual( expected, TestImages.GetBytes( level ) );
+
+                expected = Reduce( expected, width, height, pixelSize );
+                width  = ( width + 1 ) / 2;
+                height = ( height + 1 ) / 2;
+            }
+
+            image.Dispose( );
+        }
+
+        // Smooth image's bytes with 5x5 Gaussian kernel (repeating border pixels) and take every second pixel
+        private static byte[] Reduce( byte[] src, int width, int height, int pixelSize )
+        {
+            int dstWidth  = ( width + 1 ) / 2;
+            int dstHeight = ( height + 1 ) / 2;
+            byte[] dst = new byte[dstWidth * dstHeight * pixelSize];
+
+            for ( int y = 0; y < dstHeight; y++ )
+            {
+                for ( int x = 0; x < dstWidth; x++ )
+                {
+                    for ( int c = 0; c < pixelSize; c++ )
+                    {
+                        int sum = 0;
+
+                        for ( int i = 0; i < 5; i++ )
+                        {
+                            int sy = System.Math.Max( 0, System.Math.Min( height - 1, y * 2 + i - 2 ) );
+
+                            for ( int j = 0; j < 5; j++ )
+                            {
+                                int sx = System.Math.Max( 0, System.Math.Min( width - 1, x * 2 + j - 2 ) );
+
+                                sum += weights[i] * weights[j] * src[( sy * width + sx ) * pixelSize + c];
+                            }
+                        }
+
+                        dst[( y * dstWidth + x ) * pixelSize + c] = (byte) ( ( sum + 128 ) >> 8 );
+                    }
+                }
+            }
+
+            return dst;
+        }
+    }
+}
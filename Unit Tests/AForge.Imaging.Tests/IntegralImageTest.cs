@@ -2,6 +2,7 @@
 using System.Collections.Generic;
 using System.Drawing;
 using System.Drawing.Imaging;
+using System.Runtime.InteropServices;
 using AForge;
 using AForge.Imaging;
 using NUnit.Framework;
@@ -12,6 +13,7 @@ namespace AForge.Imaging.Tests
     public class IntegralImageTest
     {
         private IntegralImage integralImage = null;
+        private IntegralImage64 integralImage64 = null;
 
         public IntegralImageTest( )
         {
@@ -26,6 +28,7 @@ namespace AForge.Imaging.Tests
             }
 
             integralImage = IntegralImage.FromBitmap( uImage );
+            integralImage64 = IntegralImage64.FromBitmap( uImage, true );
         }
 
         [Test]
@@ -123,5 +126,80 @@ namespace AForge.Imaging.Tests
             int value = integralImage.GetHaarYWavelet( x, y, radius );
             Assert.AreEqual( value, expectedValue );
         }
+
+        [Test]
+        [TestCase( 0, 0, 0, 0, 0L )]
+        [TestCase( 0, 0, 1, 1, 2L )]
+        [TestCase( -1, -1, 1, 1, 2L )]
+        [TestCase( 0, 0, 9, 9, 50L )]
+        [TestCase( 9, 9, 10, 10, 0L )]
+        [TestCase( 2, 1, 4, 3, 5L )]
+        public void GetRectangleSum64Test( int x1, int y1, int x2, int y2, long expectedSum )
+        {
+            Assert.AreEqual( expectedSum, integralImage64.GetRectangleSum( x1, y1, x2, y2 ) );
+            // all pixels are 0 or 1, so sum of squares is the same
+            Assert.AreEqual( expectedSum, integralImage64.GetRectangleSquaredSum( x1, y1, x2, y2 ) );
+        }
+
+        [Test]
+        [TestCase( 0, 0, 0, 0, 0.0 )]
+        [TestCase( 9, 0, 9, 0, 0.0 )]
+        [TestCase( 0, 0, 1, 0, 0.25 )]
+        [TestCase( 0, 0, 1, 1, 0.25 )]
+        [TestCase( 0, 0, 9, 9, 0.25 )]
+        [TestCase( 0, 0, 2, 2, 0.2469135802 )]
+        public void GetRectangleVarianceTest( int x1, int y1, int x2, int y2, double expectedVariance )
+        {
+            Assert.AreEqual( expectedVariance, integralImage64.GetRectangleVariance( x1, y1, x2, y2 ), 1e-9 );
+            Assert.AreEqual( expectedVariance, integralImage64.GetRectangleVarianceUnsafe( x1, y1, x2, y2 ), 1e-9 );
+        }
+
+        [Test]
+        public void LargeImageTest( )
+        {
+            // big enough image to be processed in parallel
+            int width = 701, height = 403;
+            Random rand = new Random( 7 );
+            UnmanagedImage uImage = UnmanagedImage.Create( width, height, PixelFormat.Format8bppIndexed );
+            byte[,] pixels = new byte[height, width];
+
+            for ( int y = 0; y < height; y++ )
+            {
+                for ( int x = 0; x < width; x++ )
+                {
+                    pixels[y, x] = (byte) rand.Next( 256 );
+                    Marshal.WriteByte( uImage.ImageData, y * uImage.Stride + x, pixels[y, x] );
+                }
+            }
+
+            IntegralImage im32 = IntegralImage.FromBitmap( uImage );
+            IntegralImage64 im64 = new IntegralImage64( true );
+
+            // build twice to make sure memory is reused
+            im64.Update( UnmanagedImage.Create( width, height, PixelFormat.Format8bppIndexed ) );
+            long[,] data = im64.InternalData;
+            im64.Update( uImage );
+            Assert.AreSame( data, im64.InternalData );
+
+            for ( int i = 0; i < 100; i++ )
+            {
+                int x1 = rand.Next( width ), x2 = x1 + rand.Next( width - x1 );
+                int y1 = rand.Next( height ), y2 = y1 + rand.Next( height - y1 );
+                long sum = 0, squaredSum = 0;
+
+                for ( int y = y1; y <= y2; y++ )
+                {
+                    for ( int x = x1; x <= x2; x++ )
+                    {
+                        sum += pixels[y, x];
+                        squaredSum += pixels[y, x] * pixels[y, x];
+                    }
+                }
+
+                Assert.AreEqual( (uint) sum, im32.GetRectangleSum( x1, y1, x2, y2 ) );
+                Assert.AreEqual( sum, im64.GetRectangleSum( x1, y1, x2, y2 ) );
+                Assert.AreEqual( squaredSum, im64.GetRectangleSquaredSum( x1, y1, x2, y2 ) );
+            }
+        }
     }
 }
@@ -0,0 +1,103 @@
+﻿using System;
+using System.Drawing;
+using System.Drawing.Imaging;
+using AForge;
+using AForge.Imaging;
+using AForge.Imaging.Filters;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    // The tests check that median filter based on histograms gives exactly the same result as
+    // sorting pixels in the processing square
+    [TestFixture]
+    public class MedianTest
+    {
+        private Random rand = new Random( 13 );
+
+        // The same filter is used for all squares and images, so working memory kept between calls is
+        // reused for both smaller and bigger images
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed )]
+        [TestCase( PixelFormat.Format24bppRgb )]
+        [TestCase( PixelFormat.Format32bppArgb )]
+        public void CompareWithSortingTest( PixelFormat pixelFormat )
+        {
+            Median filter = new Median( );
+
+            for ( int squareSize = 3; squareSize <= 25; squareSize += 2 )
+            {
+                filter.Size = squareSize;
+
+                foreach ( Size size in TestImages.SmallSizes )
+                {
+                    // images with few values have many equal values in each square
+                    int minValue = ( rand.Next( 2 ) == 0 ) ? 0 : 100;
+                    int maxValue = ( minValue == 0 ) ? 255 : 103;
+
+                    UnmanagedImage image = TestImages.CreateRandomImage( rand, size.Width, size.Height, pixelFormat, minValue, maxValue );
+
+                    TestImages.CheckFilter( filter, image, TestImages.GetRandomRectangle( rand, size ), CreateReference( squareSize ) );
+
+                    image.Dispose( );
+                }
+            }
+        }
+
+        // The test checks that the square size is kept odd and in the allowed range
+        [Test]
+        [TestCase( 0, 3 )]
+        [TestCase( 3, 3 )]
+        [TestCase( 4, 5 )]
+        [TestCase( 25, 25 )]
+        [TestCase( 26, 25 )]
+        [TestCase( 101, 25 )]
+        public void SizeTest( int size, int expectedSize )
+        {
+            Assert.AreEqual( expectedSize, new Median( size ).Size );
+        }
+
+        // Create sorting of pixels in the processing square of the specified size
+        private static TestImages.ReferenceFilter CreateReference( int squareSize )
+        {
+            return delegate( byte[] src, int width, int pixelSize, Rectangle rect )
+            {
+                return FindMedians( src, width, pixelSize, rect, squareSize );
+            };
+        }
+
+        // Find medians of image's bytes by sorting them in the processing square
+        private static byte[] FindMedians( byte[] src, int width, int pixelSize, Rectangle rect, int squareSize )
+        {
+            byte[] dst = (byte[]) src.Clone( );
+            byte[] values = new byte[squareSize * squareSize];
+            int radius = squareSize / 2;
+            // alpha channel is not changed
+            int channels = ( pixelSize == 4 ) ? 3 : pixelSize;
+
+            for ( int y = rect.Top; y < rect.Bottom; y++ )
+            {
+                for ( int x = rect.Left; x < rect.Right; x++ )
+                {
+                    for ( int c = 0; c < channels; c++ )
+                    {
+                        int count = 0;
+
+                        for ( int ty = System.Math.Max( rect.Top, y - radius ); ty <= System.Math.Min( rect.Bottom - 1, y + radius ); ty++ )
+                        {
+                            for ( int tx = System.Math.Max( rect.Left, x - radius ); tx <= System.Math.Min( rect.Right - 1, x + radius ); tx++ )
+                            {
+                                values[count++] = src[( ty * width + tx ) * pixelSize + c];
+                            }
+                        }
+
+                        Array.Sort( values, 0, count );
+                        dst[( y * width + x ) * pixelSize + c] = values[count >> 1];
+                    }
+                }
+            }
+
+            return dst;
+        }
+    }
+}
@@ -0,0 +1,163 @@
+﻿using System;
+using System.Drawing;
+using System.Drawing.Imaging;
+using AForge;
+using AForge.Imaging;
+using AForge.Imaging.Filters;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    // The tests check that erosion and dilatation with rectangular structuring elements, which are
+    // processed by van Herk/Gil-Werman algorithm, give exactly the same result as direct search
+    // of minimum/maximum in structuring element
+    [TestFixture]
+    public class MorphologyTest
+    {
+        private Random rand = new Random( 17 );
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed, false )]
+        [TestCase( PixelFormat.Format8bppIndexed, true )]
+        [TestCase( PixelFormat.Format24bppRgb, false )]
+        [TestCase( PixelFormat.Format24bppRgb, true )]
+        [TestCase( PixelFormat.Format16bppGrayScale, false )]
+        [TestCase( PixelFormat.Format48bppRgb, true )]
+        public void CompareWithDirectSearchTest( PixelFormat pixelFormat, bool dilatation )
+        {
+            for ( int k = 0; k < 30; k++ )
+            {
+                int seSize = 3 + 2 * rand.Next( 8 );
+                short[,] se = new short[seSize, seSize];
+
+                // rectangle of random size and position, which also gives horizontal and vertical lines
+                // as well as rectangles not containing structuring element's center
+                int seWidth  = ( k % 3 == 1 ) ? 1 : rand.Next( 1, seSize + 1 );
+                int seHeight = ( k % 3 == 2 ) ? 1 : rand.Next( 1, seSize + 1 );
+                int seX = ( k % 2 == 0 ) ? ( seSize - seWidth ) / 2 : rand.Next( seSize - seWidth + 1 );
+                int seY = ( k % 2 == 0 ) ? ( seSize - seHeight ) / 2 : rand.Next( seSize - seHeight + 1 );
+
+                for ( int i = 0; i < seSize; i++ )
+                {
+                    for ( int j = 0; j < seSize; j++ )
+                    {
+                        se[i, j] = (short) ( ( ( i >= seY ) && ( i < seY + seHeight ) &&
+                                               ( j >= seX ) && ( j < seX + seWidth ) ) ? 1 : -1 );
+                    }
+                }
+
+                CheckFilter( pixelFormat, se, dilatation );
+            }
+        }
+
+        // The test checks structuring elements, which are not rectangles and so are processed directly
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed, false )]
+        [TestCase( PixelFormat.Format24bppRgb, true )]
+        [TestCase( PixelFormat.Format48bppRgb, false )]
+        public void NonRectangularElementTest( PixelFormat pixelFormat, bool dilatation )
+        {
+            for ( int k = 0; k < 10; k++ )
+            {
+                int seSize = 3 + 2 * rand.Next( 4 );
+                short[,] se = new short[seSize, seSize];
+
+                // elements, which are not 1, are not used
+                for ( int i = 0; i < seSize; i++ )
+                {
+                    for ( int j = 0; j < seSize; j++ )
+                    {
+                        se[i, j] = (short) rand.Next( -1, 2 );
+                    }
+                }
+                // make sure the element is not a rectangle
+                se[0, 0] = 1;
+                se[seSize - 1, seSize - 1] = 1;
+                se[seSize - 1, 0] = -1;
+
+                CheckFilter( pixelFormat, se, dilatation );
+            }
+        }
+
+        // Check erosion or dilatation filter with the structuring element on images of all small sizes
+        private void CheckFilter( PixelFormat pixelFormat, short[,] se, bool dilatation )
+        {
+            IInPlacePartialFilter filter = ( dilatation ) ? (IInPlacePartialFilter) new Dilatation( se ) : new Erosion( se );
+            TestImages.ReferenceFilter reference = CreateReference( pixelFormat, se, dilatation );
+
+            foreach ( Size size in TestImages.SmallSizes )
+            {
+                UnmanagedImage image = TestImages.CreateRandomImage( rand, size.Width, size.Height, pixelFormat, 0, 255 );
+
+                TestImages.CheckFilter( filter, image, TestImages.GetRandomRectangle( rand, size ), reference );
+
+                image.Dispose( );
+            }
+        }
+
+        // Create direct search of minimum/maximum in the structuring element
+        private static TestImages.ReferenceFilter CreateReference( PixelFormat pixelFormat, short[,] se, bool dilatation )
+        {
+            // 16 and 48 bpp images have 2 bytes per channel
+            int sampleSize = ( ( pixelFormat == PixelFormat.Format16bppGrayScale ) ||
+                               ( pixelFormat == PixelFormat.Format48bppRgb ) ) ? 2 : 1;
+
+            return delegate( byte[] src, int width, int pixelSize, Rectangle rect )
+            {
+                return Search( src, width, pixelSize, sampleSize, rect, se, dilatation );
+            };
+        }
+
+        // Search minimum/maximum of image's values in the structuring element
+        private static byte[] Search( byte[] src, int width, int pixelSize, int sampleSize, Rectangle rect, short[,] se, bool dilatation )
+        {
+            byte[] dst = (byte[]) src.Clone( );
+            int seSize = se.GetLength( 0 );
+            int radius = seSize / 2;
+
+            for ( int y = rect.Top; y < rect.Bottom; y++ )
+            {
+                for ( int x = rect.Left; x < rect.Right; x++ )
+                {
+                    for ( int c = 0; c < pixelSize; c += sampleSize )
+                    {
+                        int dstOffset = ( y * width + x ) * pixelSize + c;
+                        int value = -1;
+
+                        for ( int i = 0; i < seSize; i++ )
+                        {
+                            for ( int j = 0; j < seSize; j++ )
+                            {
+                                int ty = y + i - radius;
+                                int tx = x + j - radius;
+
+                                if ( ( se[i, j] != 1 ) || ( ty < rect.Top ) || ( ty >= rect.Bottom ) || ( tx < rect.Left ) || ( tx >= rect.Right ) )
+                                    continue;
+
+                                int offset = ( ty * width + tx ) * pixelSize + c;
+                                int v = ( sampleSize == 1 ) ? src[offset] : src[offset] | ( src[offset + 1] << 8 );
+
+                                if ( ( value == -1 ) || ( ( dilatation ) ? ( v > value ) : ( v < value ) ) )
+                                {
+                                    value = v;
+                                }
+                            }
+                        }
+
+                        // source value is kept, if structuring element does not cover any pixel
+                        if ( value != -1 )
+                        {
+                            dst[dstOffset] = (byte) value;
+                            if ( sampleSize == 2 )
+                            {
+                                dst[dstOffset + 1] = (byte) ( value >> 8 );
+                            }
+                        }
+                    }
+                }
+            }
+
+            return dst;
+        }
+    }
+}
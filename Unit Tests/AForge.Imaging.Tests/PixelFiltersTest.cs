@@ -0,0 +1,146 @@
+﻿using System;
+using System.Drawing;
+using System.Drawing.Imaging;
+using AForge;
+using AForge.Imaging;
+using AForge.Imaging.Filters;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    // The tests check that filters, which process several pixels at once, produce exactly
+    // the same result as per pixel calculation for images of different widths
+    [TestFixture]
+    public class PixelFiltersTest
+    {
+        private delegate int BytesOperation( int x, int y );
+
+        private Random rand = new Random( 7 );
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed )]
+        [TestCase( PixelFormat.Format24bppRgb )]
+        [TestCase( PixelFormat.Format32bppArgb )]
+        public void TwoSourceFiltersTest( PixelFormat pixelFormat )
+        {
+            for ( int width = 1; width <= 40; width++ )
+            {
+                UnmanagedImage image   = TestImages.CreateRandomImage( rand, width, 3, pixelFormat );
+                UnmanagedImage overlay = TestImages.CreateRandomImage( rand, width, 3, pixelFormat );
+
+                CheckTwoSourceFilter( new Add( overlay ), image, overlay,
+                    delegate( int x, int y ) { return System.Math.Min( x + y, 255 ); } );
+                CheckTwoSourceFilter( new Subtract( overlay ), image, overlay,
+                    delegate( int x, int y ) { return System.Math.Max( x - y, 0 ); } );
+                CheckTwoSourceFilter( new Difference( overlay ), image, overlay,
+                    delegate( int x, int y ) { return System.Math.Abs( x - y ); } );
+                CheckTwoSourceFilter( new Intersect( overlay ), image, overlay,
+                    delegate( int x, int y ) { return System.Math.Min( x, y ); } );
+                CheckTwoSourceFilter( new Merge( overlay ), image, overlay,
+                    delegate( int x, int y ) { return System.Math.Max( x, y ); } );
+            }
+        }
+
+        [Test]
+        [TestCase( 0 )]
+        [TestCase( 1 )]
+        [TestCase( 100 )]
+        [TestCase( 254 )]
+        [TestCase( 255 )]
+        [TestCase( 300 )]
+        public void ThresholdedDifferenceTest( int threshold )
+        {
+            for ( int width = 1; width <= 40; width++ )
+            {
+                UnmanagedImage image   = TestImages.CreateRandomImage( rand, width, 3, PixelFormat.Format8bppIndexed );
+                UnmanagedImage overlay = TestImages.CreateRandomImage( rand, width, 3, PixelFormat.Format8bppIndexed );
+
+                ThresholdedDifference filter = new ThresholdedDifference( threshold );
+                filter.UnmanagedOverlayImage = overlay;
+
+                byte[] result = TestImages.GetBytes( filter.Apply( image ) );
+                byte[] src = TestImages.GetBytes( image );
+                byte[] ovr = TestImages.GetBytes( overlay );
+                int whitePixels = 0;
+
+                for ( int i = 0; i < src.Length; i++ )
+                {
+                    byte expected = (byte) ( ( System.Math.Abs( src[i] - ovr[i] ) > threshold ) ? 255 : 0 );
+
+                    Assert.AreEqual( expected, result[i] );
+
+                    if ( expected == 255 )
+                        whitePixels++;
+                }
+
+                Assert.AreEqual( whitePixels, filter.WhitePixelsCount );
+            }
+        }
+
+        [Test]
+        [TestCase( 0 )]
+        [TestCase( 128 )]
+        [TestCase( 255 )]
+        [TestCase( 256 )]
+        public void ThresholdTest( int threshold )
+        {
+            for ( int width = 1; width <= 40; width++ )
+            {
+                UnmanagedImage image = TestImages.CreateRandomImage( rand, width, 3, PixelFormat.Format8bppIndexed );
+                byte[] src = TestImages.GetBytes( image );
+
+                new Threshold( threshold ).ApplyInPlace( image );
+
+                byte[] result = TestImages.GetBytes( image );
+
+                for ( int i = 0; i < src.Length; i++ )
+                {
+                    Assert.AreEqual( ( src[i] >= threshold ) ? 255 : 0, result[i] );
+                }
+            }
+        }
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed )]
+        [TestCase( PixelFormat.Format24bppRgb )]
+        public void InvertTest( PixelFormat pixelFormat )
+        {
+            int pixelSize = Bitmap.GetPixelFormatSize( pixelFormat ) / 8;
+
+            for ( int width = 3; width <= 40; width++ )
+            {
+                UnmanagedImage image = TestImages.CreateRandomImage( rand, width, 3, pixelFormat );
+                byte[] src = TestImages.GetBytes( image );
+
+                // process image's part to check unaligned start of rows
+                Rectangle rect = new Rectangle( 1, 1, width - 2, 1 );
+                new Invert( ).ApplyInPlace( image, rect );
+
+                byte[] result = TestImages.GetBytes( image );
+                int lineSize = width * pixelSize;
+
+                for ( int i = 0; i < src.Length; i++ )
+                {
+                    int x = ( i % lineSize ) / pixelSize;
+                    int y = i / lineSize;
+
+                    byte expected = ( rect.Contains( x, y ) ) ? (byte) ( 255 - src[i] ) : src[i];
+
+                    Assert.AreEqual( expected, result[i] );
+                }
+            }
+        }
+
+        private void CheckTwoSourceFilter( BaseInPlaceFilter2 filter, UnmanagedImage image, UnmanagedImage overlay, BytesOperation operation )
+        {
+            byte[] src = TestImages.GetBytes( image );
+            byte[] ovr = TestImages.GetBytes( overlay );
+            byte[] result = TestImages.GetBytes( filter.Apply( image ) );
+
+            for ( int i = 0; i < src.Length; i++ )
+            {
+                Assert.AreEqual( operation( src[i], ovr[i] ), result[i], filter.GetType( ).Name );
+            }
+        }
+    }
+}
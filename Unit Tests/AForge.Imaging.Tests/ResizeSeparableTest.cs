@@ -0,0 +1,243 @@
+﻿using System;
+using System.Drawing;
+using System.Drawing.Imaging;
+using AForge;
+using AForge.Imaging;
+using AForge.Imaging.Filters;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    // The tests check results of separable resize filter against resizing with double precision for
+    // tiny source images, where interpolation windows are clipped by image's borders, and for sizes
+    // of real images, where all interpolation windows are used
+    [TestFixture]
+    public class ResizeSeparableTest
+    {
+        private Random rand = new Random( 7 );
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed )]
+        [TestCase( PixelFormat.Format24bppRgb )]
+        [TestCase( PixelFormat.Format32bppArgb )]
+        public void BilinearTest( PixelFormat pixelFormat )
+        {
+            // ResizeBilinear does not align pixels' centers, so both filters sample the same source
+            // positions only for dimensions, which are either kept or equal to 1 in source image
+            for ( int width = 1; width <= 2; width++ )
+            {
+                for ( int height = 1; height <= 2; height++ )
+                {
+                    UnmanagedImage image = TestImages.CreateRandomImage( rand, width, height, pixelFormat );
+
+                    for ( int newWidth = 1; newWidth <= 7; newWidth++ )
+                    {
+                        for ( int newHeight = 1; newHeight <= 7; newHeight++ )
+                        {
+                            if ( ( ( width != 1 ) && ( newWidth != width ) ) || ( ( height != 1 ) && ( newHeight != height ) ) )
+                                continue;
+
+                            UnmanagedImage expected = new ResizeBilinear( newWidth, newHeight ).Apply( image );
+                            UnmanagedImage result = new ResizeSeparable( newWidth, newHeight,
+                                ResizeSeparable.InterpolationMethod.Bilinear ).Apply( image );
+
+                            // ResizeBilinear truncates its floating point result, so allow difference of 1
+                            CheckSimilar( TestImages.GetBytes( expected ), TestImages.GetBytes( result ), 1 );
+                        }
+                    }
+                }
+            }
+        }
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed, ResizeSeparable.InterpolationMethod.Bilinear )]
+        [TestCase( PixelFormat.Format8bppIndexed, ResizeSeparable.InterpolationMethod.Bicubic )]
+        [TestCase( PixelFormat.Format8bppIndexed, ResizeSeparable.InterpolationMethod.Area )]
+        [TestCase( PixelFormat.Format24bppRgb, ResizeSeparable.InterpolationMethod.Bilinear )]
+        [TestCase( PixelFormat.Format24bppRgb, ResizeSeparable.InterpolationMethod.Bicubic )]
+        [TestCase( PixelFormat.Format24bppRgb, ResizeSeparable.InterpolationMethod.Area )]
+        public void TinyImagesTest( PixelFormat pixelFormat, ResizeSeparable.InterpolationMethod method )
+        {
+            for ( int width = 1; width <= 3; width++ )
+            {
+                for ( int height = 1; height <= 3; height++ )
+                {
+                    UnmanagedImage image = TestImages.CreateRandomImage( rand, width, height, pixelFormat );
+
+                    for ( int newWidth = 1; newWidth <= 7; newWidth++ )
+                    {
+                        for ( int newHeight = 1; newHeight <= 7; newHeight++ )
+                        {
+                            CheckFilter( image, newWidth, newHeight, method );
+                        }
+                    }
+                }
+            }
+        }
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed, ResizeSeparable.InterpolationMethod.Bilinear )]
+        [TestCase( PixelFormat.Format8bppIndexed, ResizeSeparable.InterpolationMethod.Bicubic )]
+        [TestCase( PixelFormat.Format8bppIndexed, ResizeSeparable.InterpolationMethod.Area )]
+        [TestCase( PixelFormat.Format24bppRgb, ResizeSeparable.InterpolationMethod.Bilinear )]
+        [TestCase( PixelFormat.Format24bppRgb, ResizeSeparable.InterpolationMethod.Bicubic )]
+        [TestCase( PixelFormat.Format24bppRgb, ResizeSeparable.InterpolationMethod.Area )]
+        [TestCase( PixelFormat.Format32bppRgb, ResizeSeparable.InterpolationMethod.Bilinear )]
+        [TestCase( PixelFormat.Format32bppRgb, ResizeSeparable.InterpolationMethod.Bicubic )]
+        [TestCase( PixelFormat.Format32bppRgb, ResizeSeparable.InterpolationMethod.Area )]
+        [TestCase( PixelFormat.Format32bppArgb, ResizeSeparable.InterpolationMethod.Bilinear )]
+        [TestCase( PixelFormat.Format32bppArgb, ResizeSeparable.InterpolationMethod.Bicubic )]
+        [TestCase( PixelFormat.Format32bppArgb, ResizeSeparable.InterpolationMethod.Area )]
+        public void RealImagesTest( PixelFormat pixelFormat, ResizeSeparable.InterpolationMethod method )
+        {
+            // integer and fractional downscales, upscale, big downscale and downscale of full HD frame
+            int[,] sizes = new int[,]
+            {
+                { 320, 240, 80, 60 }, { 320, 240, 211, 157 }, { 97, 61, 400, 300 },
+                { 640, 480, 33, 17 }, { 1920, 1080, 640, 360 }
+            };
+
+            for ( int i = 0; i < sizes.GetLength( 0 ); i++ )
+            {
+                UnmanagedImage image = TestImages.CreateRandomImage( rand, sizes[i, 0], sizes[i, 1], pixelFormat );
+
+                CheckFilter( image, sizes[i, 2], sizes[i, 3], method );
+
+                image.Dispose( );
+            }
+        }
+
+        // Check the filter against resizing with double precision
+        private void CheckFilter( UnmanagedImage image, int newWidth, int newHeight, ResizeSeparable.InterpolationMethod method )
+        {
+            UnmanagedImage result = new ResizeSeparable( newWidth, newHeight, method ).Apply( image );
+            byte[] expected = Resize( TestImages.GetBytes( image ), image.Width, image.Height,
+                Bitmap.GetPixelFormatSize( image.PixelFormat ) / 8, newWidth, newHeight, method );
+
+            CheckSimilar( expected, TestImages.GetBytes( result ), 1 );
+
+            result.Dispose( );
+        }
+
+        // Resize image's bytes with double precision doing horizontal pass and then vertical pass
+        private byte[] Resize( byte[] src, int width, int height, int pixelSize, int newWidth, int newHeight,
+            ResizeSeparable.InterpolationMethod method )
+        {
+            int[][] xIndexes, yIndexes;
+            double[][] xWeights, yWeights;
+
+            GetWeights( width, newWidth, method, out xIndexes, out xWeights );
+            GetWeights( height, newHeight, method, out yIndexes, out yWeights );
+
+            double[] rows = new double[height * newWidth * pixelSize];
+            byte[] dst = new byte[newHeight * newWidth * pixelSize];
+
+            for ( int y = 0; y < height; y++ )
+            {
+                for ( int x = 0; x < newWidth; x++ )
+                {
+                    for ( int c = 0; c < pixelSize; c++ )
+                    {
+                        double v = 0;
+
+                        for ( int k = 0; k < xIndexes[x].Length; k++ )
+                        {
+                            v += xWeights[x][k] * src[( y * width + xIndexes[x][k] ) * pixelSize + c];
+                        }
+
+                        rows[( y * newWidth + x ) * pixelSize + c] = v;
+                    }
+                }
+            }
+
+            for ( int y = 0; y < newHeight; y++ )
+            {
+                for ( int i = 0; i < newWidth * pixelSize; i++ )
+                {
+                    double v = 0;
+
+                    for ( int k = 0; k < yIndexes[y].Length; k++ )
+                    {
+                        v += yWeights[y][k] * rows[yIndexes[y][k] * newWidth * pixelSize + i];
+                    }
+
+                    dst[y * newWidth * pixelSize + i] = (byte) System.Math.Max( 0, System.Math.Min( 255, System.Math.Round( v ) ) );
+                }
+            }
+
+            return dst;
+        }
+
+        // Get indexes and interpolation weights of source pixels for each destination pixel (pixels outside
+        // of image are replaced with border pixels)
+        private void GetWeights( int size, int newSize, ResizeSeparable.InterpolationMethod method,
+            out int[][] indexes, out double[][] weights )
+        {
+            double factor = (double) size / newSize;
+
+            indexes = new int[newSize][];
+            weights = new double[newSize][];
+
+            for ( int x = 0; x < newSize; x++ )
+            {
+                if ( method == ResizeSeparable.InterpolationMethod.Area )
+                {
+                    // average of source pixels weighted by their part covered by destination pixel
+                    double x1 = x * factor;
+                    double x2 = ( x + 1 ) * factor;
+                    int first = (int) System.Math.Floor( x1 );
+                    int count = System.Math.Max( 1, (int) System.Math.Ceiling( x2 ) - first );
+
+                    indexes[x] = new int[count];
+                    weights[x] = new double[count];
+
+                    for ( int k = 0; k < count; k++ )
+                    {
+                        indexes[x][k] = System.Math.Min( size - 1, first + k );
+                        weights[x][k] = System.Math.Max( 0, System.Math.Min( x2, first + k + 1 ) - System.Math.Max( x1, first + k ) ) / factor;
+                    }
+                }
+                else
+                {
+                    double center = ( x + 0.5 ) * factor - 0.5;
+                    int floor = (int) System.Math.Floor( center );
+
+                    indexes[x] = new int[4];
+                    weights[x] = new double[4];
+
+                    for ( int k = -1; k <= 2; k++ )
+                    {
+                        double d = center - ( floor + k );
+
+                        indexes[x][k + 1] = System.Math.Max( 0, System.Math.Min( size - 1, floor + k ) );
+                        weights[x][k + 1] = ( method == ResizeSeparable.InterpolationMethod.Bicubic ) ?
+                            BiCubicKernel( d ) : System.Math.Max( 0, 1 - System.Math.Abs( d ) );
+                    }
+                }
+            }
+        }
+
+        // Bicubic kernel with coefficient a = -0.5 (same as used by ResizeBicubic)
+        private double BiCubicKernel( double x )
+        {
+            x = System.Math.Abs( x );
+
+            if ( x <= 1 )
+                return ( 1.5 * x - 2.5 ) * x * x + 1;
+            if ( x < 2 )
+                return ( ( -0.5 * x + 2.5 ) * x - 4 ) * x + 2;
+
+            return 0;
+        }
+
+        private void CheckSimilar( byte[] expected, byte[] result, int tolerance )
+        {
+            Assert.AreEqual( expected.Length, result.Length );
+
+            for ( int i = 0; i < expected.Length; i++ )
+            {
+                Assert.LessOrEqual( System.Math.Abs( expected[i] - result[i] ), tolerance );
+            }
+        }
+    }
+}
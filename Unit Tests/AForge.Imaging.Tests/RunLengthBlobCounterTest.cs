@@ -0,0 +1,159 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Drawing;
+using System.Drawing.Imaging;
+using AForge;
+using AForge.Imaging;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    [TestFixture]
+    public class RunLengthBlobCounterTest
+    {
+        private Random rand = new Random( 7 );
+
+        [Test]
+        [TestCase( false )]
+        [TestCase( true )]
+        public void ProcessRegionsTest( bool filterBlobs )
+        {
+            UnmanagedImage image = UnmanagedImage.Create( 200, 150, PixelFormat.Format8bppIndexed );
+
+            DrawRandomObjects( image, new Rectangle( 0, 0, image.Width, image.Height ), 60 );
+
+            RunLengthBlobCounter regionsCounter = new RunLengthBlobCounter( );
+            RunLengthBlobCounter imageCounter = new RunLengthBlobCounter( );
+
+            foreach ( RunLengthBlobCounter bc in new RunLengthBlobCounter[] { regionsCounter, imageCounter } )
+            {
+                bc.FilterBlobs = filterBlobs;
+                bc.MinWidth  = 3;
+                bc.MinHeight = 3;
+                bc.MaxWidth  = 40;
+                bc.MaxHeight = 40;
+            }
+
+            regionsCounter.ProcessImage( image );
+
+            for ( int frame = 0; frame < 200; frame++ )
+            {
+                // change few regions of the image
+                Rectangle[] regions = new Rectangle[rand.Next( 1, 4 )];
+
+                for ( int i = 0; i < regions.Length; i++ )
+                {
+                    regions[i] = new Rectangle( rand.Next( -10, image.Width ), rand.Next( -10, image.Height ),
+                                                rand.Next( 1, 50 ), rand.Next( 1, 50 ) );
+                    regions[i].Intersect( new Rectangle( 0, 0, image.Width, image.Height ) );
+
+                    if ( ( regions[i].Width > 0 ) && ( regions[i].Height > 0 ) )
+                    {
+                        Drawing.FillRectangle( image, regions[i], Color.Black );
+                        DrawRandomObjects( image, regions[i], rand.Next( 5 ) );
+                    }
+                }
+
+                regionsCounter.ProcessRegions( image, regions, frame % 2 );
+                imageCounter.ProcessImage( image );
+
+                CheckSameBlobs( imageCounter, regionsCounter );
+            }
+        }
+
+        [Test]
+        [TestCase( PixelFormat.Format8bppIndexed, 1 )]
+        [TestCase( PixelFormat.Format8bppIndexed, 0 )]
+        [TestCase( PixelFormat.Format24bppRgb, 0 )]
+        [TestCase( PixelFormat.Format32bppArgb, 0 )]
+        public void CompareWithBlobCounterTest( PixelFormat pixelFormat, int maxDegreeOfParallelism )
+        {
+            UnmanagedImage image = UnmanagedImage.Create( 200, 150, pixelFormat );
+
+            DrawRandomObjects( image, new Rectangle( 0, 0, image.Width, image.Height ), 60 );
+
+            // rows with many runs, which do not fit into initial arrays of runs
+            for ( int x = 0; x < image.Width; x += 2 )
+            {
+                image.SetPixel( x, 70, Color.FromArgb( 200, 100, 50 ) );
+                image.SetPixel( x + 1, 71, Color.FromArgb( 50, 100, 200 ) );
+                image.SetPixel( x, 149, Color.FromArgb( 255, 255, 255 ) );
+            }
+
+            RunLengthBlobCounter runLengthCounter = new RunLengthBlobCounter( );
+            BlobCounter blobCounter = new BlobCounter( );
+
+            runLengthCounter.MaxDegreeOfParallelism = maxDegreeOfParallelism;
+            runLengthCounter.BackgroundThreshold = blobCounter.BackgroundThreshold = Color.FromArgb( 10, 20, 30 );
+
+            // process twice to check reuse of arrays
+            for ( int i = 0; i < 2; i++ )
+            {
+                blobCounter.ProcessImage( image );
+                runLengthCounter.ProcessImage( image );
+
+                CheckSameBlobs( blobCounter, runLengthCounter );
+            }
+        }
+
+        // Check that two blob counters found the same blobs, which may have different IDs
+        private void CheckSameBlobs( BlobCounterBase expected, BlobCounterBase actual )
+        {
+            Assert.AreEqual( expected.ObjectsCount, actual.ObjectsCount );
+
+            Blob[] expectedBlobs = expected.GetObjectsInformation( );
+            Blob[] actualBlobs   = actual.GetObjectsInformation( );
+            // IDs of actual blobs for IDs of expected blobs
+            int[] idsMap = new int[expected.ObjectsCount + 1];
+
+            for ( int i = 0, n = expected.ObjectLabels.Length; i < n; i++ )
+            {
+                int expectedLabel = expected.ObjectLabels[i];
+                int actualLabel   = actual.ObjectLabels[i];
+
+                Assert.AreEqual( expectedLabel == 0, actualLabel == 0 );
+
+                if ( idsMap[expectedLabel] == 0 )
+                    idsMap[expectedLabel] = actualLabel;
+
+                Assert.AreEqual( idsMap[expectedLabel], actualLabel );
+            }
+
+            Dictionary<int, Blob> actualBlobsByID = new Dictionary<int, Blob>( );
+
+            foreach ( Blob blob in actualBlobs )
+            {
+                actualBlobsByID.Add( blob.ID, blob );
+            }
+
+            foreach ( Blob blob in expectedBlobs )
+            {
+                Blob actualBlob = actualBlobsByID[idsMap[blob.ID]];
+
+                Assert.AreEqual( blob.Rectangle, actualBlob.Rectangle );
+                Assert.AreEqual( blob.Area, actualBlob.Area );
+                Assert.AreEqual( blob.CenterOfGravity, actualBlob.CenterOfGravity );
+                Assert.AreEqual( blob.ColorMean, actualBlob.ColorMean );
+            }
+        }
+
+        // Draw random rectangles, lines and dots inside of the specified rectangle of image
+        private void DrawRandomObjects( UnmanagedImage image, Rectangle rect, int count )
+        {
+            for ( int i = 0; i < count; i++ )
+            {
+                Rectangle objectRect = new Rectangle(
+                    rect.Left + rand.Next( rect.Width ), rect.Top + rand.Next( rect.Height ),
+                    1 + rand.Next( 50 ), 1 + rand.Next( ( i % 3 == 0 ) ? 2 : 20 ) );
+
+                objectRect.Intersect( rect );
+                Drawing.FillRectangle( image, objectRect, Color.FromArgb( 255, 255, 255 ) );
+            }
+
+            for ( int i = 0; i < count * 10; i++ )
+            {
+                image.SetPixel( rect.Left + rand.Next( rect.Width ), rect.Top + rand.Next( rect.Height ), Color.FromArgb( 128, 128, 128 ) );
+            }
+        }
+    }
+}
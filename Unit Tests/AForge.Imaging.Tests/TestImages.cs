@@ -0,0 +1,106 @@
+﻿using System;
+using System.Drawing;
+using System.Drawing.Imaging;
+using System.Runtime.InteropServices;
+using AForge;
+using AForge.Imaging;
+using AForge.Imaging.Filters;
+using NUnit.Framework;
+
+namespace AForge.Imaging.Tests
+{
+    // Helpers creating images for tests, reading their pixels and checking filters against reference implementations
+    internal static class TestImages
+    {
+        // Reference implementation of a filter, which processes rectangle of image given by its bytes without rows' padding
+        public delegate byte[] ReferenceFilter( byte[] src, int width, int pixelSize, Rectangle rect );
+
+        // Sizes of small images, which have all pixels close to edges
+        public static readonly Size[] SmallSizes = new Size[]
+        {
+            new Size( 1, 1 ), new Size( 2, 5 ), new Size( 4, 2 ), new Size( 9, 13 ), new Size( 45, 35 )
+        };
+
+        // Get either rectangle of the entire image or rectangle of its inner part
+        public static Rectangle GetRandomRectangle( Random rand, Size size )
+        {
+            return ( rand.Next( 2 ) == 0 ) ? new Rectangle( 0, 0, size.Width, size.Height ) :
+                new Rectangle( size.Width / 4, size.Height / 3, size.Width - size.Width / 2, size.Height - size.Height / 3 );
+        }
+
+        // Check that the filter applied to the rectangle of image gives exactly the same result as the reference
+        public static void CheckFilter( IInPlacePartialFilter filter, UnmanagedImage image, Rectangle rect, ReferenceFilter reference )
+        {
+            byte[] expected = reference( GetBytes( image ), image.Width, Bitmap.GetPixelFormatSize( image.PixelFormat ) / 8, rect );
+
+            UnmanagedImage result = image.Clone( );
+            filter.ApplyInPlace( result, rect );
+
+            Assert.AreEqual( expected, GetBytes( result ), filter.GetType( ).Name + " " + image.PixelFormat );
+
+            result.Dispose( );
+        }
+
+        // Get size of image's line in bytes without padding
+        public static int GetLineSize( int width, PixelFormat pixelFormat )
+        {
+            return width * Bitmap.GetPixelFormatSize( pixelFormat ) / 8;
+        }
+
+        // Create image from pixels' bytes given without rows' padding
+        public static UnmanagedImage CreateImage( int width, int height, PixelFormat pixelFormat, byte[] bytes )
+        {
+            UnmanagedImage image = UnmanagedImage.Create( width, height, pixelFormat );
+            int lineSize = GetLineSize( width, pixelFormat );
+
+            for ( int y = 0; y < height; y++ )
+            {
+                Marshal.Copy( bytes, y * lineSize, new IntPtr( image.ImageData.ToInt64( ) + y * image.Stride ), lineSize );
+            }
+
+            return image;
+        }
+
+        // Create image filled with random values, which also include a lot of extreme values
+        public static UnmanagedImage CreateRandomImage( Random rand, int width, int height, PixelFormat pixelFormat )
+        {
+            byte[] bytes = new byte[GetLineSize( width, pixelFormat ) * height];
+
+            for ( int i = 0; i < bytes.Length; i++ )
+            {
+                int r = rand.Next( 8 );
+                bytes[i] = (byte) ( ( r == 0 ) ? 0 : ( r == 1 ) ? 255 : ( r == 2 ) ? 128 : rand.Next( 256 ) );
+            }
+
+            return CreateImage( width, height, pixelFormat, bytes );
+        }
+
+        // Create image filled with random values from the [minValue, maxValue) range
+        public static UnmanagedImage CreateRandomImage( Random rand, int width, int height, PixelFormat pixelFormat,
+            int minValue, int maxValue )
+        {
+            byte[] bytes = new byte[GetLineSize( width, pixelFormat ) * height];
+
+            for ( int i = 0; i < bytes.Length; i++ )
+            {
+                bytes[i] = (byte) rand.Next( minValue, maxValue );
+            }
+
+            return CreateImage( width, height, pixelFormat, bytes );
+        }
+
+        // Get image's pixels' bytes without rows' padding
+        public static byte[] GetBytes( UnmanagedImage image )
+        {
+            int lineSize = GetLineSize( image.Width, image.PixelFormat );
+            byte[] bytes = new byte[lineSize * image.Height];
+
+            for ( int y = 0; y < image.Height; y++ )
+            {
+                Marshal.Copy( new IntPtr( image.ImageData.ToInt64( ) + y * image.Stride ), bytes, y * lineSize, lineSize );
+            }
+
+            return bytes;
+        }
+    }
+}
@@ -0,0 +1,196 @@
+﻿using System;
+using System.Reflection;
+using System.Threading;
+using NUnit.Framework;
+
+namespace AForge.Tests
+{
+    [TestFixture]
+    public class ParallelTest
+    {
+        [TestCase( 0, 0 )]
+        [TestCase( 0, 1 )]
+        [TestCase( 5, 17 )]
+        [TestCase( -100, 1000 )]
+        public void ForTest( int start, int stop )
+        {
+            int[] counters = new int[Math.Max( 0, stop - start )];
+
+            Parallel.For( start, stop, delegate( int i )
+            {
+                Interlocked.Increment( ref counters[i - start] );
+            } );
+
+            foreach ( int counter in counters )
+            {
+                Assert.AreEqual( 1, counter );
+            }
+        }
+
+        [TestCase( 0, 1 )]
+        [TestCase( 3, 1000 )]
+        public void ForRangeTest( int start, int stop )
+        {
+            int[] counters = new int[stop - start];
+
+            Parallel.ForRange( start, stop, delegate( int rangeStart, int rangeStop )
+            {
+                Assert.IsTrue( rangeStart < rangeStop );
+
+                for ( int i = rangeStart; i < rangeStop; i++ )
+                {
+                    Interlocked.Increment( ref counters[i - start] );
+                }
+            } );
+
+            foreach ( int counter in counters )
+            {
+                Assert.AreEqual( 1, counter );
+            }
+        }
+
+        [Test]
+        public void ForLocalTest( )
+        {
+            int[] values = new int[10000];
+            int[] expectedHistogram = new int[16];
+
+            for ( int i = 0; i < values.Length; i++ )
+            {
+                values[i] = ( i * 7919 ) % 16;
+                expectedHistogram[values[i]]++;
+            }
+
+            int[] histogram = new int[16];
+
+            Parallel.For<int[]>( 0, values.Length,
+                delegate { return new int[16]; },
+                delegate( int i, int[] localHistogram )
+                {
+                    localHistogram[values[i]]++;
+                    return localHistogram;
+                },
+                delegate( int[] localHistogram )
+                {
+                    for ( int i = 0; i < 16; i++ )
+                    {
+                        histogram[i] += localHistogram[i];
+                    }
+                } );
+
+            Assert.AreEqual( expectedHistogram, histogram );
+        }
+
+        [TestCase( 0, 0, 100, 50, 16, 16 )]
+        [TestCase( 3, 5, 40, 41, 7, 100 )]
+        [TestCase( 0, 0, 1, 1, 1, 1 )]
+        public void ForTilesTest( int startX, int startY, int stopX, int stopY, int tileWidth, int tileHeight )
+        {
+            int[,] counters = new int[stopY - startY, stopX - startX];
+
+            Parallel.ForTiles( startX, startY, stopX, stopY, tileWidth, tileHeight,
+                delegate( int tileStartX, int tileStartY, int tileStopX, int tileStopY )
+                {
+                    Assert.IsTrue( tileStopX - tileStartX <= tileWidth );
+                    Assert.IsTrue( tileStopY - tileStartY <= tileHeight );
+
+                    for ( int y = tileStartY; y < tileStopY; y++ )
+                    {
+                        for ( int x = tileStartX; x < tileStopX; x++ )
+                        {
+                            Interlocked.Increment( ref counters[y - startY, x - startX] );
+                        }
+                    }
+                } );
+
+            foreach ( int counter in counters )
+            {
+                Assert.AreEqual( 1, counter );
+            }
+        }
+
+        [Test]
+        public void NestedLoopsTest( )
+        {
+            int[,] counters = new int[20, 30];
+
+            Parallel.For( 0, 20, delegate( int i )
+            {
+                Parallel.For( 0, 30, delegate( int j )
+                {
+                    Interlocked.Increment( ref counters[i, j] );
+                } );
+            } );
+
+            foreach ( int counter in counters )
+            {
+                Assert.AreEqual( 1, counter );
+            }
+        }
+
+        [Test]
+        public void ConcurrentLoopsTest( )
+        {
+            const int threadsCount = 4;
+            long[] sums = new long[threadsCount];
+            Thread[] threads = new Thread[threadsCount];
+
+            for ( int t = 0; t < threadsCount; t++ )
+            {
+                int thread = t;
+
+                threads[t] = new Thread( delegate( )
+                {
+                    for ( int k = 0; k < 50; k++ )
+                    {
+                        Parallel.For( 0, 1000, delegate( int i )
+                        {
+                            Interlocked.Add( ref sums[thread], i );
+                        } );
+                    }
+                } );
+                threads[t].Start( );
+            }
+
+            for ( int t = 0; t < threadsCount; t++ )
+            {
+                threads[t].Join( );
+                Assert.AreEqual( 50L * 999 * 1000 / 2, sums[t] );
+            }
+        }
+
+        [Test]
+        public void ExceptionTest( )
+        {
+            try
+            {
+                Parallel.For( 0, 1000, delegate( int i )
+                {
+                    if ( i == 500 )
+                    {
+                        throw new ArgumentException( "test" );
+                    }
+                } );
+
+                Assert.Fail( "Exception was not thrown." );
+            }
+            catch ( TargetInvocationException ex )
+            {
+                // original exception is kept together with its stack trace
+                Assert.IsInstanceOf<ArgumentException>( ex.InnerException );
+                Assert.AreEqual( "test", ex.InnerException.Message );
+                Assert.IsNotNull( ex.InnerException.StackTrace );
+            }
+
+            // the loop is still usable after a failed one
+            int count = 0;
+
+            Parallel.For( 0, 100, delegate( int i )
+            {
+                Interlocked.Increment( ref count );
+            } );
+
+            Assert.AreEqual( 100, count );
+        }
+    }
+}